@@ -0,0 +1,63 @@
+/**
+ * @file FreeRTOSConfig.h
+ * @brief FreeRTOS kernel configuration, used when building with USE_FREERTOS
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @note Only static allocation is used, so no heap implementation needs to be linked
+ */
+#ifndef INC_FREERTOSCONFIG_H_
+#define INC_FREERTOSCONFIG_H_
+#include <stdint.h>
+
+extern uint32_t SystemCoreClock;
+
+//scheduling
+#define configUSE_PREEMPTION						0		///< Cooperative : tasks keep the run-to-completion contract of the bare-metal scheduler
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION		1		///< Pick the highest-priority ready task with CLZ
+#define configUSE_TIME_SLICING						0
+#define configMAX_PRIORITIES						32
+#define configCPU_CLOCK_HZ							(SystemCoreClock)
+#define configTICK_RATE_HZ							((TickType_t)1000)
+#define configUSE_16_BIT_TICKS						0
+#define configIDLE_SHOULD_YIELD						1
+#define configUSE_TASK_NOTIFICATIONS				1
+
+//memory
+#define configSUPPORT_STATIC_ALLOCATION				1
+#define configSUPPORT_DYNAMIC_ALLOCATION			0
+#define configMINIMAL_STACK_SIZE					((uint16_t)128)
+#define configMAX_TASK_NAME_LEN						8
+#define configCHECK_FOR_STACK_OVERFLOW				0
+
+//features not used
+#define configUSE_IDLE_HOOK							1
+#define configUSE_TICK_HOOK							0
+#define configUSE_MUTEXES							0
+#define configUSE_COUNTING_SEMAPHORES				0
+#define configUSE_TIMERS							0
+#define configUSE_CO_ROUTINES						0
+#define configQUEUE_REGISTRY_SIZE					0
+
+//API functions included
+#define INCLUDE_vTaskDelay							1
+#define INCLUDE_xTaskGetSchedulerState				1
+#define INCLUDE_vTaskPrioritySet					0
+#define INCLUDE_uxTaskPriorityGet					0
+#define INCLUDE_vTaskDelete							0
+#define INCLUDE_vTaskSuspend						0
+
+//interrupts priorities (4 bits on the STM32F1)
+#define configPRIO_BITS									4
+#define configLIBRARY_LOWEST_INTERRUPT_PRIORITY			15
+#define configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY		5		///< Interrupts calling the kernel (EXTI0, DMA) must have a priority of 5 or lower
+#define configKERNEL_INTERRUPT_PRIORITY					(configLIBRARY_LOWEST_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY			(configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - configPRIO_BITS))
+
+#define configASSERT(x)		if((x) == 0) {__asm volatile("cpsid i"); for(;;);}
+
+//handlers mapping (SVCall and PendSV handlers not generated by CubeMX, SysTick forwarded by schedulerTick() as HAL also uses it)
+#define vPortSVCHandler		SVC_Handler
+#define xPortPendSVHandler	PendSV_Handler
+
+#endif /* INC_FREERTOSCONFIG_H_ */
@@ -0,0 +1,42 @@
+#ifndef INC_CONCURRENCY_CONCURRENCY_H_
+#define INC_CONCURRENCY_CONCURRENCY_H_
+#include <stdint.h>
+#include "errorstack.h"
+
+/**
+ * @brief Event flags word, set by producers and atomically tested and cleared by the consumer
+ */
+typedef volatile uint32_t eventFlags_t;
+
+/**
+ * @brief Sequence lock protecting a snapshot written by a single writer
+ * @note Readers must never preempt the writer (e.g. writer in an ISR, readers in the main loop)
+ */
+typedef struct{
+	volatile uint32_t	sequence;	///< Sequence counter, odd while the snapshot is being written
+}seqlock_t;
+
+/**
+ * @brief Single-producer single-consumer ring of 32-bit values
+ */
+typedef struct{
+	uint32_t*			buffer;		///< Values storage
+	uint32_t			mask;		///< Capacity - 1 (capacity is a power of two)
+	volatile uint32_t	head;		///< Number of values pushed since the initialisation (written by the producer only)
+	volatile uint32_t	tail;		///< Number of values popped since the initialisation (written by the consumer only)
+}spscRing_t;
+
+void		eventSet(eventFlags_t* flags, uint32_t mask);
+uint32_t	eventTestAndClear(eventFlags_t* flags, uint32_t mask);
+
+void		seqlockWriteBegin(seqlock_t* lock);
+void		seqlockWriteEnd(seqlock_t* lock);
+uint32_t	seqlockReadBegin(const seqlock_t* lock);
+uint8_t		seqlockReadRetry(const seqlock_t* lock, uint32_t start);
+
+errorCode_u	spscInitialise(spscRing_t* ring, uint32_t buffer[], uint32_t capacity);
+uint8_t		spscPush(spscRing_t* ring, uint32_t value);
+uint8_t		spscPop(spscRing_t* ring, uint32_t* value);
+void		spscFlush(spscRing_t* ring);
+
+#endif /* INC_CONCURRENCY_CONCURRENCY_H_ */
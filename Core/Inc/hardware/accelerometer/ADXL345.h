@@ -2,24 +2,98 @@
 #define INC_ADXL345_H_
 #include <stm32f1xx.h>
 #include "errorstack.h"
+#include "concurrency.h"
+#include "sensor.h"
 
-extern volatile uint8_t		adxlINT1occurred;
+//definitions
+#define ADXL_SCALE_UG_PER_LSB	3900U	///< Scale of the measurements in full resolution (in ug per LSB)
+#define ADXL_ONE_G_LSB			256		///< Typical measurement of 1 g in full resolution (in LSB)
+#define ADXL_EVENT_INT1			0x01U	///< Event raised on an INT1 falling edge
+#define ADXL_MIN_AVERAGING		2U		///< Lowest number of samples averaged per block
+#define ADXL_MAX_AVERAGING		32U		///< Highest number of samples averaged per block (FIFO size)
+#define ADXL_AVERAGING_FAST		10U		///< Samples averaged in fast mode (a block every 50 ms at 200 Hz)
+#define ADXL_AVERAGING_PRECISE	32U		///< Samples averaged in precise mode (a block every 160 ms at 200 Hz)
+#define ADXL_FINE_SHIFT			8U		///< Number of fractional bits kept in the fine measurements
+
+extern eventFlags_t			adxlEvents;
 extern volatile uint16_t	adxlTimer_ms;
+extern spscRing_t			adxlINT1edges;
 
 /**
- * @brief Enumeration of the axis of which to get measurements
+ * @brief Enumeration of the output data rates supported (values match the register rate codes)
  */
 typedef enum{
-	X_AXIS = 0,
-	Y_AXIS,
-	Z_AXIS,
-	NB_AXIS
-}axis_e;
+	ADXL_ODR_100HZ = 0x0A,
+	ADXL_ODR_200HZ,
+	ADXL_ODR_400HZ,
+	ADXL_ODR_800HZ,
+	ADXL_ODR_1600HZ,
+	ADXL_ODR_3200HZ
+}adxlDataRate_e;
+
+/**
+ * @brief Structure holding the results of a SPI bus speed tested during negotiation
+ */
+typedef struct{
+	uint32_t	prescaler;		///< SPI baud rate prescaler tested
+	uint32_t	frequency_Hz;	///< Resulting SPI clock frequency (in Hz)
+	uint32_t	drainTime_us;	///< Time taken to drain a full FIFO block (in us)
+	uint8_t		reliable;		///< 1 if the bus speed passed the verification
+}adxlSPItiming_t;
 
 errorCode_u	ADXL345initialise(const SPI_HandleTypeDef* handle);
 errorCode_u	ADXL345update();
 uint8_t		ADXL345hasChanged(axis_e axis);
+uint8_t		ADXL345hasNewBlock();
+sensorGesture_e	ADXL345getGesture();
+void		ADXL345watchActivity(uint8_t enabled);
+uint8_t		ADXL345hasActivity();
+uint8_t		ADXL345isWaiting();
+uint8_t		ADXL345getBlock(axis_e axis, const int16_t** samples);
+errorCode_u	ADXL345setDataRate(uint16_t rate_Hz);
+errorCode_u	ADXL345setAveraging(uint8_t nbSamples);
+uint8_t		ADXL345getAveraging();
+void		ADXL345setOffsets(const int16_t offsets[NB_AXIS]);
 int16_t		ADXL345getValue(axis_e axis);
+void		ADXL345getVector(int16_t vector[NB_AXIS]);
+void		ADXL345getFineVector(int32_t vector[NB_AXIS]);
 float		measureToAngleDegrees(int16_t axisValue);
+float		vectorToAngleDegrees(int32_t direction, int32_t axisZ);
+uint8_t		ADXL345getSPItimings(const adxlSPItiming_t** timings);
+uint32_t	ADXL345getSPIfrequency();
+void		ADXL345getBlockTiming(sensorBlockTiming_t* timing);
+uint32_t	ADXL345getSampleTime_us(uint8_t index);
+
+/**
+ * @brief Operations table of the ADXL345, selected by accelerometer.h
+ */
+static const sensorOps_t adxl345Sensor = {
+	.initialise		= ADXL345initialise,
+	.update			= ADXL345update,
+	.isWaiting		= ADXL345isWaiting,
+	.hasNewBlock	= ADXL345hasNewBlock,
+	.getBlock		= ADXL345getBlock,
+	.getBlockTiming	= ADXL345getBlockTiming,
+	.hasChanged		= ADXL345hasChanged,
+	.getValue		= ADXL345getValue,
+	.getVector		= ADXL345getVector,
+	.getFineVector	= ADXL345getFineVector,
+	.measureToAngle	= measureToAngleDegrees,
+	.vectorToAngle	= vectorToAngleDegrees,
+	.setDataRate	= ADXL345setDataRate,
+	.setAveraging	= ADXL345setAveraging,
+	.getAveraging	= ADXL345getAveraging,
+	.setOffsets		= ADXL345setOffsets,
+	.getGesture		= ADXL345getGesture,
+	.watchActivity	= ADXL345watchActivity,
+	.hasActivity	= ADXL345hasActivity,
+	.format			= {
+		.scale_ug		= ADXL_SCALE_UG_PER_LSB,
+		.oneG			= ADXL_ONE_G_LSB,
+		.fineShift		= ADXL_FINE_SHIFT,
+		.minAveraging	= ADXL_MIN_AVERAGING,
+		.maxAveraging	= ADXL_MAX_AVERAGING,
+	},
+};
 
 #endif /* INC_ADXL345_H_ */
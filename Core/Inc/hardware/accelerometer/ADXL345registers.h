@@ -29,6 +29,17 @@
 #define ADXL_INT_OVERRUN	0x01
 #define ADXL_INT_MAP_INT1	0x00
 
+#define ADXL_TAP_SUPPRESS	0x08		///< Double tap suppressed if acceleration above threshold during latency
+#define ADXL_TAP_X_ENABLE	0x04		///< X axis participates in tap detection
+#define ADXL_TAP_Y_ENABLE	0x02		///< Y axis participates in tap detection
+#define ADXL_TAP_Z_ENABLE	0x01		///< Z axis participates in tap detection
+
+#define ADXL_ACT_AC			0x80		///< Activity compared to the acceleration when enabled (AC coupled), instead of 0 g
+#define ADXL_ACT_X_ENABLE	0x40		///< X axis participates in activity detection
+#define ADXL_ACT_Y_ENABLE	0x20		///< Y axis participates in activity detection
+#define ADXL_ACT_Z_ENABLE	0x10		///< Z axis participates in activity detection
+#define ADXL_ACT_DISABLED	0x00		///< No axis participates in activity detection
+
 #define ADXL_SELF_TEST		0x80
 #define ADXL_NO_SELF_TEST	0x00
 #define ADXL_SPI_3WIRE		0x40
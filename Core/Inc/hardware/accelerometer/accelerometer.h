@@ -0,0 +1,13 @@
+#ifndef INC_ACCELEROMETER_H_
+#define INC_ACCELEROMETER_H_
+#include "sensor.h"
+
+//accelerometer selected at compile time (ACCELEROMETER cache variable)
+#if defined(ACCELEROMETER_ADXL345)
+#include "ADXL345.h"
+#define SENSOR	adxl345Sensor	///< Operations table of the accelerometer used
+#else
+#error "No accelerometer selected (define ACCELEROMETER_<model>)"
+#endif
+
+#endif /* INC_ACCELEROMETER_H_ */
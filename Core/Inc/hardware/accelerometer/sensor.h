@@ -0,0 +1,76 @@
+#ifndef INC_SENSOR_H_
+#define INC_SENSOR_H_
+#include <stm32f1xx.h>
+#include "errorstack.h"
+
+/**
+ * @brief Enumeration of the axis of which to get measurements
+ */
+typedef enum{
+	X_AXIS = 0,
+	Y_AXIS,
+	Z_AXIS,
+	NB_AXIS
+}axis_e;
+
+/**
+ * @brief Enumeration of the tap gestures detected by an accelerometer
+ */
+typedef enum{
+	SENSOR_NO_GESTURE = 0,
+	SENSOR_SINGLE_TAP,
+	SENSOR_DOUBLE_TAP
+}sensorGesture_e;
+
+/**
+ * @brief Structure holding the timing information of a samples block
+ */
+typedef struct{
+	uint32_t	timestamp_us;		///< Timestamp of the interrupt which signalled the block (in us)
+	uint32_t	samplePeriod_ns;	///< Sample period, corrected with the estimated drift (in ns)
+	int32_t		drift_ppm;			///< Estimated drift of the sensor clock against the MCU clock (in ppm)
+	uint8_t		nbSamples;			///< Number of samples in the block (0 if no block stamped yet)
+	uint8_t		contiguous;			///< 1 if no sample has been lost since the previous block
+}sensorBlockTiming_t;
+
+/**
+ * @brief Structure describing the samples format of an accelerometer
+ */
+typedef struct{
+	uint32_t	scale_ug;		///< Scale of the samples (in ug per LSB)
+	int16_t		oneG;			///< Typical sample of 1 g (in LSB)
+	uint8_t		fineShift;		///< Number of fractional bits kept in the fine measurements
+	uint8_t		minAveraging;	///< Lowest number of samples averaged per block
+	uint8_t		maxAveraging;	///< Highest number of samples averaged per block (FIFO size)
+}sensorFormat_t;
+
+/**
+ * @brief Structure holding the operations of an accelerometer driver, and its samples format
+ * @details Each driver exposes a static const table in its header, and accelerometer.h selects one at compile time.
+ * 			The table being constant and visible, the calls through it are folded into direct calls
+ * 			(at any optimisation level but -O0), so that a single sensor build costs nothing more than calling the driver.
+ */
+typedef struct{
+	errorCode_u		(*initialise)(const SPI_HandleTypeDef* handle);			///< Set the bus used, the state machine starting at the next update
+	errorCode_u		(*update)();											///< Run the state machine (on its interrupts, timer expiries, and while not waiting)
+	uint8_t			(*isWaiting)();											///< Check if the state machine only waits for its interrupt or its timer
+	uint8_t			(*hasNewBlock)();										///< Check if a samples block has been integrated since the last call
+	uint8_t			(*getBlock)(axis_e axis, const int16_t** samples);		///< Get the raw samples of the last block for an axis, and their number
+	void			(*getBlockTiming)(sensorBlockTiming_t* timing);			///< Get the timing information of the last block
+	uint8_t			(*hasChanged)(axis_e axis);								///< Check if the average of an axis changed since the last call
+	int16_t			(*getValue)(axis_e axis);								///< Get the last average of an axis (in LSB)
+	void			(*getVector)(int16_t vector[NB_AXIS]);					///< Get a consistent snapshot of the last averages (in LSB)
+	void			(*getFineVector)(int32_t vector[NB_AXIS]);				///< Get a consistent snapshot of the last averages (in LSB, with fineShift fractional bits)
+	float			(*measureToAngle)(int16_t axisValue);					///< Get the angle of an axis average with the Z axis one (in degrees)
+	float			(*vectorToAngle)(int32_t direction, int32_t axisZ);	///< Get the angle of a vector with its Z component (in degrees)
+	errorCode_u		(*setDataRate)(uint16_t rate_Hz);						///< Request an output data rate
+	errorCode_u		(*setAveraging)(uint8_t nbSamples);						///< Request a number of samples averaged per block
+	uint8_t			(*getAveraging)();										///< Get the number of samples averaged per block requested
+	void			(*setOffsets)(const int16_t offsets[NB_AXIS]);			///< Set the offsets subtracted from every sample (in LSB)
+	sensorGesture_e	(*getGesture)();										///< Get (and clear) the last tap gesture detected, a single tap once no double tap can follow (none if not supported)
+	void			(*watchActivity)(uint8_t enabled);						///< Request the detection of a motion from the current position, until detected once
+	uint8_t			(*hasActivity)();										///< Check (and clear) if a motion has been detected since watched
+	sensorFormat_t	format;													///< Samples format
+}sensorOps_t;
+
+#endif /* INC_SENSOR_H_ */
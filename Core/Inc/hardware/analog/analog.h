@@ -0,0 +1,19 @@
+#ifndef INC_HARDWARE_ANALOG_ANALOG_H_
+#define INC_HARDWARE_ANALOG_ANALOG_H_
+#include <stm32f1xx.h>
+#include "errorstack.h"
+
+/**
+ * @brief Structure holding the latest filtered analog values
+ */
+typedef struct{
+	uint16_t	supply_mV;			///< Analog supply voltage (in mV)
+	uint16_t	battery_mV;			///< Battery voltage (in mV)
+	uint8_t		batteryPercent;		///< Battery charge estimation (in %)
+	int16_t		temperature_dC;		///< Die temperature (in tenths of degrees)
+}analogValues_t;
+
+errorCode_u	analogInitialise(const ADC_HandleTypeDef* handle);
+errorCode_u	analogGetValues(analogValues_t* values);
+
+#endif /* INC_HARDWARE_ANALOG_ANALOG_H_ */
@@ -0,0 +1,18 @@
+#ifndef INC_L3GD20_H_
+#define INC_L3GD20_H_
+#include <stm32f1xx.h>
+#include "errorstack.h"
+
+//definitions
+#define L3GD_NB_AXIS			3U		///< Number of axis in a sample (X, Y, Z)
+#define L3GD_FIFO_SIZE			32U		///< Number of samples the FIFO can hold
+#define L3GD_SCALE_UDPS_PER_LSB	8750U	///< Scale of the rates at 250 dps full scale (in micro-degrees per second per LSB)
+#define L3GD_SAMPLE_PERIOD_US	5263U	///< Sample period at the 190 Hz output data rate (in us)
+
+errorCode_u	L3GD20initialise(const SPI_HandleTypeDef* handle);
+errorCode_u	L3GD20update();
+uint8_t		L3GD20isPresent();
+uint8_t		L3GD20getSamples(const int16_t (**samples)[L3GD_NB_AXIS]);
+uint32_t	L3GD20getLostSamples();
+
+#endif /* INC_L3GD20_H_ */
@@ -0,0 +1,61 @@
+#ifndef INC_L3GD20REGISTERS_H_
+#define INC_L3GD20REGISTERS_H_
+
+#define L3GD_DEVICE_ID		0xD4		///< WHO_AM_I value of the L3GD20
+#define L3GD_DEVICE_ID_H	0xD7		///< WHO_AM_I value of the L3GD20H (register compatible)
+
+#define L3GD_WRITE			0x00		///< MSB configuration for write operations
+#define L3GD_READ			0x80		///< MSB configuration for read operations
+#define L3GD_SINGLE			0x00		///< Bit 6 configuration for single register operations
+#define L3GD_MULTIPLE		0x40		///< Bit 6 configuration for multiple register operations (address auto-increment)
+
+#define L3GD_ODR_95HZ		0x00		///< CTRL_REG1 output data rate of 95 Hz
+#define L3GD_ODR_190HZ		0x40		///< CTRL_REG1 output data rate of 190 Hz
+#define L3GD_ODR_380HZ		0x80		///< CTRL_REG1 output data rate of 380 Hz
+#define L3GD_ODR_760HZ		0xC0		///< CTRL_REG1 output data rate of 760 Hz
+#define L3GD_BANDWIDTH_LOW	0x00		///< CTRL_REG1 lowest cut-off frequency at the output data rate (12.5 Hz at 190 Hz)
+#define L3GD_POWER_NORMAL	0x08		///< CTRL_REG1 normal mode (power-down otherwise)
+#define L3GD_AXES_ENABLED	0x07		///< CTRL_REG1 X, Y and Z axes enabled
+
+#define L3GD_BLOCK_UPDATE	0x80		///< CTRL_REG4 output registers not updated until both bytes read
+#define L3GD_RANGE_250DPS	0x00		///< CTRL_REG4 full scale of 250 dps
+#define L3GD_RANGE_500DPS	0x10		///< CTRL_REG4 full scale of 500 dps
+#define L3GD_RANGE_2000DPS	0x20		///< CTRL_REG4 full scale of 2000 dps
+
+#define L3GD_REBOOT			0x80		///< CTRL_REG5 reboot of the memory content
+#define L3GD_FIFO_ENABLE	0x40		///< CTRL_REG5 FIFO enabled
+
+#define L3GD_MODE_BYPASS	0x00		///< FIFO_CTRL_REG bypass mode
+#define L3GD_MODE_FIFO		0x20		///< FIFO_CTRL_REG FIFO mode
+#define L3GD_MODE_STREAM	0x40		///< FIFO_CTRL_REG stream mode
+
+#define L3GD_FIFO_WATERMARK	0x80		///< FIFO_SRC_REG watermark level reached
+#define L3GD_FIFO_OVERRUN	0x40		///< FIFO_SRC_REG FIFO full, oldest samples overwritten
+#define L3GD_FIFO_EMPTY		0x20		///< FIFO_SRC_REG FIFO empty
+#define L3GD_FIFO_LEVEL		0x1F		///< FIFO_SRC_REG number of unread samples
+
+#define L3GD_NB_DATA_REGISTERS	6U		///< Number of data registers of a sample (X, Y, Z, low byte first)
+
+typedef enum{
+	WHO_AM_I		= 0x0F,
+	CTRL_REG1		= 0x20,
+	CTRL_REG2,
+	CTRL_REG3,
+	CTRL_REG4,
+	CTRL_REG5,
+	REFERENCE,
+	OUT_TEMP,
+	STATUS_REG,
+	OUT_X_L,
+	OUT_X_H,
+	OUT_Y_L,
+	OUT_Y_H,
+	OUT_Z_L,
+	OUT_Z_H,
+	FIFO_CTRL_REG,
+	FIFO_SRC_REG,
+	L3GD_NB_REGISTERS = 0x39
+}l3gd20Registers_e;
+
+
+#endif /* INC_L3GD20REGISTERS_H_ */
@@ -0,0 +1,42 @@
+#ifndef INC_HARDWARE_SCREEN_SH1106_H_
+#define INC_HARDWARE_SCREEN_SH1106_H_
+#include <stdint.h>
+#include <stm32f1xx.h>
+#include "errorstack.h"
+#include "display.h"
+
+//definitions
+#define SH1106_WIDTH		128U	///< Number of visible columns of the panel
+#define SH1106_NB_PAGES		8U		///< Number of pages of the panel
+
+errorCode_u SH1106initialise(SPI_HandleTypeDef* handle);
+errorCode_u SH1106update();
+uint8_t SH1106isReady();
+uint8_t SH1106isWaiting();
+errorCode_u SH1106setWindow(const displayWindow_t* window);
+errorCode_u SH1106stream(const displayWindow_t* window, displaySource source);
+errorCode_u SH1106setInverted(uint8_t inverted);
+errorCode_u SH1106setContrast(uint8_t contrast);
+errorCode_u SH1106setPower(uint8_t on);
+
+/**
+ * @brief Display backend of the SH1106, selected by panel.h
+ */
+static const displayBackend_t sh1106Panel = {
+	.initialise		= SH1106initialise,
+	.update			= SH1106update,
+	.isReady		= SH1106isReady,
+	.isWaiting		= SH1106isWaiting,
+	.setWindow		= SH1106setWindow,
+	.stream			= SH1106stream,
+	.setInverted	= SH1106setInverted,
+	.setContrast	= SH1106setContrast,
+	.setPower		= SH1106setPower,
+	.format			= {
+		.width			= SH1106_WIDTH,
+		.nbPages		= SH1106_NB_PAGES,
+		.pixelFormat	= DISPLAY_PAGES_1BPP,
+	},
+};
+
+#endif /* INC_HARDWARE_SCREEN_SH1106_H_ */
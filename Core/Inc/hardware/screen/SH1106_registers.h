@@ -0,0 +1,52 @@
+#ifndef INC_HARDWARE_SCREEN_SH1106_REGISTERS_H_
+#define INC_HARDWARE_SCREEN_SH1106_REGISTERS_H_
+
+#define SH_CONTRAST_LOWEST		0x00U	///< Value to set the contrast to the lowest value
+#define SH_CONTRAST_MID			0x80U	///< Value to set the contrast to the middle value (reset value)
+#define SH_CONTRAST_HIGHEST		0xFFU	///< Value to set the contrast to the highest value
+
+#define SH_DC_DC_OFF			0x8AU	///< Value to turn the DC-DC converter off
+#define SH_DC_DC_ON				0x8BU	///< Value to turn the DC-DC converter on (reset value)
+
+#define SH_PAD_CONFIG_SEQ		0x02U	///< Value to set the sequential common pads configuration
+#define SH_PAD_CONFIG_ALT		0x12U	///< Value to set the alternative common pads configuration (reset value)
+
+#define SH_PAGE_MASK			0x07U	///< Page address bits of the page address command
+#define SH_NIBBLE_MASK			0x0FU	///< Column nibble bits of the column address commands
+#define SH_NIBBLE_SHIFT			4U		///< Shift of the higher column nibble
+
+
+/**
+ * @brief Enumeration of all the SH1106 commands listed in the datasheet
+ * @note Unlike the SSD1306, the SH1106 only has the page addressing mode
+ */
+typedef enum{
+	SH_LOW_COLUMN_ADDR		= 0x00,	///< Set Lower Column Address (4 lower bits)
+	SH_HIGH_COLUMN_ADDR		= 0x10,	///< Set Higher Column Address (4 higher bits)
+	SH_PUMP_VOLTAGE			= 0x30,	///< Set Pump voltage value (2 lower bits)
+	SH_DISPLAY_START_LINE	= 0x40,	///< Set Display Start Line (6 lower bits)
+	SH_CONTRAST_CONTROL		= 0x81,	///< Set Contrast Control Register
+	SH_SEGMENT_REMAP_0		= 0xA0,	///< Set Segment Re-map - column address 0 is mapped to SEG0
+	SH_SEGMENT_REMAP_131	= 0xA1,	///< Set Segment Re-map - column address 131 is mapped to SEG0
+	SH_DISPLAY_FOLLOW_RAM	= 0xA4,	///< Set Entire Display OFF - Output follows RAM content
+	SH_DISPLAY_ALL_ON		= 0xA5,	///< Set Entire Display ON - Output ignores RAM content
+	SH_DISPLAY_NORMAL		= 0xA6,	///< Set Normal/Reverse Display - Normal display
+	SH_DISPLAY_INVERSE		= 0xA7,	///< Set Normal/Reverse Display - Reverse display
+	SH_MUX_RATIO			= 0xA8,	///< Set Multiplex Ration
+	SH_DC_DC_CONTROL		= 0xAD,	///< Set DC-DC ON/OFF
+	SH_DISPLAY_OFF			= 0xAE,	///< Display OFF
+	SH_DISPLAY_ON			= 0xAF,	///< Display ON
+	SH_PAGE_ADDRESS			= 0xB0,	///< Set Page Address (3 lower bits)
+	SH_SCAN_DIRECTION_0_N1	= 0xC0,	///< Set Common Output Scan Direction - Scan from COM0 to COM[N-1]
+	SH_SCAN_DIRECTION_N1_0	= 0xC8,	///< Set Common Output Scan Direction - Scan from COM[N-1] to COM0
+	SH_DISPLAY_OFFSET		= 0xD3,	///< Set Display Offset
+	SH_CLOCK_DIVIDE_RATIO	= 0xD5,	///< Set Display Clock Divide Ratio/Oscillator Frequency
+	SH_PRECHARGE_PERIOD		= 0xD9,	///< Set Dis-charge/Pre-charge Period
+	SH_PADS_CONFIG			= 0xDA,	///< Set Common pads hardware configuration
+	SH_VCOM_DESELECT_LVL	= 0xDB,	///< Set VCOM Deselect Level
+	SH_READ_MODIFY_WRITE	= 0xE0,	///< Read-Modify-Write start
+	SH_NOP					= 0xE3,	///< Command for no operation
+	SH_END					= 0xEE,	///< Read-Modify-Write end
+}SH1106register_e;
+
+#endif /* INC_HARDWARE_SCREEN_SH1106_REGISTERS_H_ */
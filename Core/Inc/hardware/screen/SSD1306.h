@@ -3,19 +3,40 @@
 #include <stdint.h>
 #include <stm32f1xx.h>
 #include "errorstack.h"
+#include "display.h"
 
-//screen defaults
-#define SSD1306_LINE1_PAGE		0U		///< Page number of the first screen line
-#define SSD1306_LINE1_COLUMN	0U		///< Column number of the first screen line
-#define SSD1306_LINE2_PAGE		3U		///< Page number of the second screen line
-#define SSD1306_LINE2_COLUMN	0U		///< Column number of the second screen line
-
-extern volatile uint16_t	screenTimer_ms;
+//definitions
+#define SSD1306_WIDTH		128U	///< Number of columns of the panel
+#define SSD1306_NB_PAGES	8U		///< Number of pages of the panel
 
 errorCode_u SSD1306initialise(SPI_HandleTypeDef* handle);
 errorCode_u SSD1306update();
-uint8_t isScreenReady();
-errorCode_u SSD1306clearScreen();
-errorCode_u SSD1306_printAngle(float angle, uint8_t page, uint8_t column);
+uint8_t SSD1306isReady();
+uint8_t SSD1306isWaiting();
+errorCode_u SSD1306setWindow(const displayWindow_t* window);
+errorCode_u SSD1306stream(const displayWindow_t* window, displaySource source);
+errorCode_u SSD1306setInverted(uint8_t inverted);
+errorCode_u SSD1306setContrast(uint8_t contrast);
+errorCode_u SSD1306setPower(uint8_t on);
+
+/**
+ * @brief Display backend of the SSD1306, selected by panel.h
+ */
+static const displayBackend_t ssd1306Panel = {
+	.initialise		= SSD1306initialise,
+	.update			= SSD1306update,
+	.isReady		= SSD1306isReady,
+	.isWaiting		= SSD1306isWaiting,
+	.setWindow		= SSD1306setWindow,
+	.stream			= SSD1306stream,
+	.setInverted	= SSD1306setInverted,
+	.setContrast	= SSD1306setContrast,
+	.setPower		= SSD1306setPower,
+	.format			= {
+		.width			= SSD1306_WIDTH,
+		.nbPages		= SSD1306_NB_PAGES,
+		.pixelFormat	= DISPLAY_PAGES_1BPP,
+	},
+};
 
 #endif /* INC_HARDWARE_SCREEN_SSD1306_H_ */
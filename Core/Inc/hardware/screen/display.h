@@ -0,0 +1,67 @@
+#ifndef INC_HARDWARE_SCREEN_DISPLAY_H_
+#define INC_HARDWARE_SCREEN_DISPLAY_H_
+#include <stdint.h>
+#include <stm32f1xx.h>
+#include "errorstack.h"
+
+//definitions
+#define DISPLAY_CHUNK_SIZE	128U	///< Number of bytes in each half of the streaming buffer (one page of the widest panel)
+
+extern volatile uint16_t	screenTimer_ms;
+
+/**
+ * @brief Enumeration of the native pixel formats of the panels
+ */
+typedef enum{
+	DISPLAY_PAGES_1BPP = 0,		///< Monochrome, pages of 8 rows, one byte per column (LSB on top)
+}displayPixelFormat_e;
+
+/**
+ * @brief Structure describing a region of the panel (inclusive bounds, in panel coordinates)
+ */
+typedef struct{
+	uint8_t	firstColumn;	///< First column of the region
+	uint8_t	lastColumn;		///< Last column of the region
+	uint8_t	firstPage;		///< First page of the region
+	uint8_t	lastPage;		///< Last page of the region
+}displayWindow_t;
+
+/**
+ * @brief Function rendering a page of the region streamed, in the panel native pixel format
+ * @note Called from the DMA interrupts while the other half of the streaming buffer is sent,
+ * 		 so it must not take longer than a page transfer
+ *
+ * @param chunk Half of the streaming buffer to fill with the page bytes (one per column of the region)
+ * @param page Page to render, relative to the region (0 for the first one)
+ */
+typedef void (*displaySource)(uint8_t chunk[], uint8_t page);
+
+/**
+ * @brief Structure describing the panel driven by a backend
+ */
+typedef struct{
+	uint8_t					width;			///< Number of visible columns
+	uint8_t					nbPages;		///< Number of pages (rows / 8)
+	displayPixelFormat_e	pixelFormat;	///< Native pixel format of the data streamed
+}displayFormat_t;
+
+/**
+ * @brief Structure holding the operations of a display backend, and its panel format
+ * @details Each backend exposes a static const table in its header, and panel.h selects one at compile time.
+ * 			The backend owns the transfers and the two halves of the streaming buffer : it asks the renderer for a region
+ * 			page by page, and sends the pages in the pattern best suited to its controller, so a full frame never sits in RAM.
+ */
+typedef struct{
+	errorCode_u	(*initialise)(SPI_HandleTypeDef* handle);								///< Reset the controller and send its initialisation commands
+	errorCode_u	(*update)();															///< Run the transfers state machine (on its DMA interrupts, timer expiries, and while not waiting)
+	uint8_t		(*isReady)();															///< Check if the backend is ready to accept a new stream or command
+	uint8_t		(*isWaiting)();															///< Check if the state machine only waits for a transfer end or its timer (or has nothing to do)
+	errorCode_u	(*setWindow)(const displayWindow_t* window);							///< Point the controller at the first byte of a region
+	errorCode_u	(*stream)(const displayWindow_t* window, displaySource source);		///< Queue the transfer of a region, rendered page by page
+	errorCode_u	(*setInverted)(uint8_t inverted);										///< Invert the display or restore it
+	errorCode_u	(*setContrast)(uint8_t contrast);										///< Queue a contrast change (0 to 255)
+	errorCode_u	(*setPower)(uint8_t on);												///< Queue the panel and its voltage supply turning off or on
+	displayFormat_t	format;																///< Panel format
+}displayBackend_t;
+
+#endif /* INC_HARDWARE_SCREEN_DISPLAY_H_ */
@@ -24,6 +24,7 @@ typedef enum{
 	INDEX_PLUS,
 	INDEX_MINUS,
 	INDEX_DEG,
+	INDEX_SPACE,
 	NB_NUMBERS
 }numbers_e;
 
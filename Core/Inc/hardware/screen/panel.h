@@ -0,0 +1,16 @@
+#ifndef INC_HARDWARE_SCREEN_PANEL_H_
+#define INC_HARDWARE_SCREEN_PANEL_H_
+#include "display.h"
+
+//display backend selected at compile time (SCREEN cache variable)
+#if defined(SCREEN_SSD1306)
+#include "SSD1306.h"
+#define PANEL	ssd1306Panel	///< Display backend of the panel used
+#elif defined(SCREEN_SH1106)
+#include "SH1106.h"
+#define PANEL	sh1106Panel		///< Display backend of the panel used
+#else
+#error "No screen selected (define SCREEN_<controller>)"
+#endif
+
+#endif /* INC_HARDWARE_SCREEN_PANEL_H_ */
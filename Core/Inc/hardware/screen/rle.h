@@ -0,0 +1,29 @@
+#ifndef INC_HARDWARE_SCREEN_RLE_H_
+#define INC_HARDWARE_SCREEN_RLE_H_
+#include <stdint.h>
+
+/**
+ * @brief Structure describing an image compressed by tools/imagepack/image_pack.py
+ */
+typedef struct{
+	const uint8_t*	data;		///< Run-length-encoded stream of the image bytes (pages of 8 rows, one byte per column)
+	uint16_t		size;		///< Number of bytes in the encoded stream
+	uint8_t			width;		///< Width of the image (in columns)
+	uint8_t			nbPages;	///< Height of the image (in pages)
+}rleImage_t;
+
+/**
+ * @brief Structure holding the state of a streaming decoder, so that an image can be expanded in several chunks
+ */
+typedef struct{
+	const uint8_t*	next;		///< Next byte of the encoded stream
+	const uint8_t*	end;		///< End of the encoded stream
+	uint8_t			remaining;	///< Number of bytes left to produce in the current token
+	uint8_t			repeated;	///< 1 if the current token is a run of a single byte
+	uint8_t			value;		///< Byte repeated by the current run
+}rleDecoder_t;
+
+void		rleStart(rleDecoder_t* decoder, const rleImage_t* image);
+uint16_t	rleDecode(rleDecoder_t* decoder, uint8_t output[], uint16_t size);
+
+#endif /* INC_HARDWARE_SCREEN_RLE_H_ */
@@ -0,0 +1,31 @@
+#ifndef INC_HARDWARE_SCREEN_SCREEN_H_
+#define INC_HARDWARE_SCREEN_SCREEN_H_
+#include <stdint.h>
+#include <stm32f1xx.h>
+#include "errorstack.h"
+#include "rle.h"
+
+//screen defaults
+#define SCREEN_LINE1_PAGE		0U		///< Page number of the first screen line
+#define SCREEN_LINE1_COLUMN		0U		///< Column number of the first screen line
+#define SCREEN_LINE2_PAGE		3U		///< Page number of the second screen line
+#define SCREEN_LINE2_COLUMN		0U		///< Column number of the second screen line
+#define SCREEN_GAUGE_PAGE		0U		///< Page number of the battery gauge
+#define SCREEN_GAUGE_COLUMN		104U	///< Column number of the battery gauge
+
+errorCode_u screenInitialise(SPI_HandleTypeDef* handle);
+errorCode_u screenUpdate();
+uint8_t isScreenReady();
+uint8_t isScreenWaiting();
+errorCode_u screenClear();
+errorCode_u screenSetInverted(uint8_t inverted);
+errorCode_u screenSetContrast(uint8_t contrast);
+errorCode_u screenSetPower(uint8_t on);
+errorCode_u screenPrintAngle(float angle, uint8_t page, uint8_t column);
+errorCode_u screenPrintPreciseAngle(float angle, uint8_t page, uint8_t column);
+errorCode_u screenPrintNumber(uint16_t number, uint8_t page, uint8_t column);
+errorCode_u screenPrintTemperature(int16_t temperature_dC, uint8_t page, uint8_t column);
+errorCode_u screenPrintGauge(uint8_t percent, uint8_t page, uint8_t column);
+errorCode_u screenDrawImage(const rleImage_t* image, uint8_t page, uint8_t column);
+
+#endif /* INC_HARDWARE_SCREEN_SCREEN_H_ */
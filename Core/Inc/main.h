@@ -36,6 +36,17 @@ extern "C" {
 
 /* Exported types ------------------------------------------------------------*/
 /* USER CODE BEGIN ET */
+/**
+ * @brief Enumeration of the tasks priorities (the higher the number, the higher the priority)
+ */
+typedef enum{
+	TASK_ANALOG = 0,		///< Temperature compensation and battery gauge follow-up
+	TASK_INTERFACE,			///< Tap gestures and application mode update
+	TASK_PROCESSING,		///< Analysis of the last samples block
+	TASK_SCREEN,			///< Screen state machine
+	TASK_GYROSCOPE,			///< Gyroscope state machine and attitude fusion (USE_GYRO builds only)
+	TASK_ACCELEROMETER,		///< Accelerometer state machine
+}taskPriority_e;
 
 /* USER CODE END ET */
 
@@ -57,6 +68,10 @@ void Error_Handler(void);
 /* USER CODE END EFP */
 
 /* Private defines -----------------------------------------------------------*/
+#define BATTERY_SENSE_Pin GPIO_PIN_1
+#define BATTERY_SENSE_GPIO_Port GPIOA
+#define GYRO_CS_Pin GPIO_PIN_3
+#define GYRO_CS_GPIO_Port GPIOA
 #define ADXL_CS_Pin GPIO_PIN_4
 #define ADXL_CS_GPIO_Port GPIOA
 #define ADXL_SCK_Pin GPIO_PIN_5
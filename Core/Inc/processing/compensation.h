@@ -0,0 +1,15 @@
+#ifndef INC_PROCESSING_COMPENSATION_H_
+#define INC_PROCESSING_COMPENSATION_H_
+#include <stdint.h>
+#include "errorstack.h"
+
+//definitions
+#define COMPENSATION_NB_AXIS	3U		///< Number of axis compensated
+#define COMPENSATION_FIRST_DC	(-100)	///< Temperature of the first table entry (in tenths of degrees)
+#define COMPENSATION_STEP_DC	100		///< Temperature step between two table entries (in tenths of degrees)
+
+void		compensationUpdate(int16_t temperature_dC, int16_t offsets[COMPENSATION_NB_AXIS]);
+errorCode_u	compensationCalibrate(const int16_t measured[COMPENSATION_NB_AXIS], const int16_t expected[COMPENSATION_NB_AXIS]);
+uint8_t		compensationGetNbCalibrated();
+
+#endif /* INC_PROCESSING_COMPENSATION_H_ */
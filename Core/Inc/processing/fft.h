@@ -0,0 +1,20 @@
+#ifndef INC_PROCESSING_FFT_H_
+#define INC_PROCESSING_FFT_H_
+#include <stdint.h>
+
+//definitions
+#ifndef FFT_SIZE
+#define FFT_SIZE		256U	///< Number of points of the transform (power of two, 16 to 1024)
+#endif
+#define FFT_MAX_SIZE	1024U	///< Number of points covered by the sine table
+
+#if (FFT_SIZE < 16) || (FFT_SIZE > FFT_MAX_SIZE) || (FFT_SIZE & (FFT_SIZE - 1))
+#error FFT_SIZE must be a power of two between 16 and FFT_MAX_SIZE
+#endif
+
+int16_t	sineQ15(uint16_t angle);
+int16_t	cosineQ15(uint16_t angle);
+void	fftQ15ApplyHann(int16_t buffer[]);
+void	fftQ15Transform(int16_t buffer[]);
+
+#endif /* INC_PROCESSING_FFT_H_ */
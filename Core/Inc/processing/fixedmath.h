@@ -0,0 +1,7 @@
+#ifndef INC_PROCESSING_FIXEDMATH_H_
+#define INC_PROCESSING_FIXEDMATH_H_
+#include <stdint.h>
+
+uint32_t	fixedmathSquareRoot(uint64_t value);
+
+#endif /* INC_PROCESSING_FIXEDMATH_H_ */
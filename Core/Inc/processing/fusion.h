@@ -0,0 +1,17 @@
+#ifndef INC_PROCESSING_FUSION_H_
+#define INC_PROCESSING_FUSION_H_
+#include <stdint.h>
+#include "errorstack.h"
+
+//definitions
+#define FUSION_NB_AXIS		3U		///< Number of axis in a vector
+#define FUSION_NB_ANGLES	2U		///< Number of angles estimated (X and Y axis angles, as in level mode)
+
+errorCode_u	fusionInitialise(uint32_t rateScale_udps, uint32_t samplePeriod_us);
+void		fusionReset();
+void		fusionSetReference(const int32_t vector[FUSION_NB_AXIS], int32_t oneG, uint32_t age_us);
+void		fusionAddRates(const int16_t rates[][FUSION_NB_AXIS], uint8_t nbSamples);
+uint8_t		fusionIsSettled();
+void		fusionGetAngles(float angles[FUSION_NB_ANGLES]);
+
+#endif /* INC_PROCESSING_FUSION_H_ */
@@ -0,0 +1,18 @@
+#ifndef INC_PROCESSING_GOERTZEL_H_
+#define INC_PROCESSING_GOERTZEL_H_
+#include <stdint.h>
+#include "errorstack.h"
+
+//definitions
+#define GOERTZEL_NB_FILTERS	4U		///< Number of filters in the bank
+#define GOERTZEL_SEGMENT	25U		///< Number of samples per segment of the sliding window
+#define GOERTZEL_NB_SEGMENTS	8U		///< Number of complete segments in the sliding window
+#define GOERTZEL_LENGTH		200U	///< Number of samples in the complete segments of the sliding window
+
+errorCode_u	goertzelSetFrequency(uint8_t filter, uint16_t frequency_dHz);
+void		goertzelReset();
+void		goertzelAddSamples(const int16_t samples[], uint8_t nbSamples, uint32_t samplePeriod_ns);
+uint8_t		goertzelHasNewResults();
+uint16_t	goertzelGetAmplitude(uint8_t filter);
+
+#endif /* INC_PROCESSING_GOERTZEL_H_ */
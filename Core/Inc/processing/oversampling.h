@@ -0,0 +1,13 @@
+#ifndef INC_PROCESSING_OVERSAMPLING_H_
+#define INC_PROCESSING_OVERSAMPLING_H_
+#include <stdint.h>
+
+//definitions
+#define OVERSAMPLING_NB_AXIS	3U		///< Number of axis in a vector
+#define OVERSAMPLING_NB_BLOCKS	32U		///< Number of block averages summed by the sliding window (power of two)
+
+void		oversamplingReset();
+uint8_t		oversamplingAddVector(const int32_t vector[OVERSAMPLING_NB_AXIS]);
+void		oversamplingGetSums(int32_t sums[OVERSAMPLING_NB_AXIS]);
+
+#endif /* INC_PROCESSING_OVERSAMPLING_H_ */
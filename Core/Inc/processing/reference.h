@@ -0,0 +1,14 @@
+#ifndef INC_PROCESSING_REFERENCE_H_
+#define INC_PROCESSING_REFERENCE_H_
+#include <stdint.h>
+#include "errorstack.h"
+
+//definitions
+#define REFERENCE_NB_AXIS	3U	///< Number of axis in a vector
+
+errorCode_u	referenceInitialise();
+errorCode_u	referenceCapture(const int16_t vector[REFERENCE_NB_AXIS]);
+uint8_t		referenceIsSet();
+void		referenceApply(const int16_t vector[REFERENCE_NB_AXIS], int16_t relative[REFERENCE_NB_AXIS]);
+
+#endif /* INC_PROCESSING_REFERENCE_H_ */
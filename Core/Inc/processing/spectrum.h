@@ -0,0 +1,18 @@
+#ifndef INC_PROCESSING_SPECTRUM_H_
+#define INC_PROCESSING_SPECTRUM_H_
+#include <stdint.h>
+#include "fft.h"
+
+/**
+ * @brief Structure holding the dominant component of a spectrum
+ */
+typedef struct{
+	uint16_t	frequency_Hz;	///< Frequency of the dominant component (in Hz)
+	uint16_t	amplitude;		///< Peak amplitude of the dominant component (in input units)
+}spectrumPeak_t;
+
+void	spectrumReset();
+uint8_t	spectrumAddSamples(const int16_t samples[], uint8_t nbSamples);
+void	spectrumCompute(uint32_t samplePeriod_ns, spectrumPeak_t* peak);
+
+#endif /* INC_PROCESSING_SPECTRUM_H_ */
@@ -0,0 +1,36 @@
+#ifndef INC_SCHEDULER_SCHEDULER_H_
+#define INC_SCHEDULER_SCHEDULER_H_
+#include <stdint.h>
+#include "errorstack.h"
+
+//definitions
+#define SCHEDULER_NB_PRIORITIES	32U		///< Number of priorities available (one task per priority, the highest runs first)
+
+/**
+ * @brief Task function prototype (runs to completion)
+ *
+ * @return Error code of the task
+ */
+typedef errorCode_u (*task_t)();
+
+/**
+ * @brief Structure holding the execution statistics of a task
+ */
+typedef struct{
+	uint32_t	nbRuns;				///< Number of times the task ran
+	uint32_t	lastDuration_us;	///< Execution time of the last run (in us)
+	uint32_t	maxDuration_us;		///< Longest execution time (in us)
+	uint32_t	totalDuration_us;	///< Cumulated execution time (in us)
+	uint32_t	maxLatency_us;		///< Longest time between the task becoming ready and the end of its run (in us)
+	uint32_t	deadlineMisses;		///< Number of runs which ended after the deadline
+	errorCode_u	lastError;			///< Last error returned by the task
+}taskStats_t;
+
+errorCode_u	schedulerAddTask(uint8_t priority, task_t task, uint16_t period_ms, uint32_t deadline_us);
+void		schedulerSignal(uint8_t priority);
+void		schedulerTick();
+void		schedulerRunNext();
+errorCode_u	schedulerGetStats(uint8_t priority, taskStats_t* stats);
+uint32_t	schedulerGetIdleTime_us();
+
+#endif /* INC_SCHEDULER_SCHEDULER_H_ */
@@ -51,13 +51,14 @@ void HardFault_Handler(void);
 void MemManage_Handler(void);
 void BusFault_Handler(void);
 void UsageFault_Handler(void);
-void SVC_Handler(void);
 void DebugMon_Handler(void);
-void PendSV_Handler(void);
 void SysTick_Handler(void);
 void EXTI0_IRQHandler(void);
+void DMA1_Channel1_IRQHandler(void);
 void DMA1_Channel5_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void SVC_Handler(void);
+void PendSV_Handler(void);
 
 /* USER CODE END EFP */
 
@@ -0,0 +1,27 @@
+#ifndef INC_STORAGE_SETTINGS_H_
+#define INC_STORAGE_SETTINGS_H_
+#include <stdint.h>
+#include "errorstack.h"
+
+//definitions
+#define SETTINGS_NB_AXIS	3U	///< Number of axis stored in the vectors
+#define SETTINGS_NB_TEMPS	6U	///< Number of temperatures in the offsets compensation table
+
+/**
+ * @brief Structure holding all the settings kept across resets
+ */
+typedef struct{
+	uint32_t	magic;								///< Value identifying valid settings of the current layout
+	int16_t		reference[SETTINGS_NB_AXIS];		///< Reference vector used in relative mode
+	uint16_t	referenceSet;						///< 1 if the reference vector has been captured
+	int16_t		offsets[SETTINGS_NB_TEMPS][SETTINGS_NB_AXIS];	///< Offsets compensation table, per temperature and per axis
+	int16_t		offsetsTemperature_dC[SETTINGS_NB_TEMPS];		///< Temperatures at which the offsets have been calibrated (in tenths of degrees)
+	uint16_t	offsetsValid;						///< Bit mask of the offsets compensation table temperatures calibrated
+	uint32_t	checksum;							///< Checksum of all the previous fields
+}settings_t;
+
+errorCode_u	settingsInitialise();
+settings_t*	settingsGet();
+errorCode_u	settingsSave();
+
+#endif /* INC_STORAGE_SETTINGS_H_ */
@@ -0,0 +1,7 @@
+#ifndef INC_TIMING_TIMESTAMP_H_
+#define INC_TIMING_TIMESTAMP_H_
+#include <stdint.h>
+
+uint32_t timestampGet_us();
+
+#endif /* INC_TIMING_TIMESTAMP_H_ */
@@ -0,0 +1,62 @@
+#ifndef INC_TIMING_TRACER_H_
+#define INC_TIMING_TRACER_H_
+#include <stdint.h>
+#include "errorstack.h"
+
+//definitions
+#define TRACE_NB_BINS		18U				///< Number of bins in a histogram (bin n counts the durations in [2^(n-1), 2^n[ us, the last one everything above)
+#define TRACE_MAGIC			0x45435254U		///< Magic number at the start of the exported snapshot ("TRCE" in little endian)
+#define TRACE_VERSION		1U				///< Version of the exported snapshot layout
+
+/**
+ * @brief Enumeration of the trace points, in the order a block goes through them
+ */
+typedef enum{
+	TRACE_EDGE = 0,		///< Watermark interrupt edge (block tagged)
+	TRACE_INTEGRATED,	///< FIFO block integrated
+	TRACE_COMPUTED,		///< Angles computed by the application
+	TRACE_PRINTED,		///< Angle rendered in the screen buffer
+	TRACE_DISPLAYED,	///< Last page of the region sent by the screen DMA
+	TRACE_NB_POINTS
+}tracePoint_e;
+
+/**
+ * @brief Enumeration of the traced stages (durations between two consecutive points, and end to end)
+ */
+typedef enum{
+	TRACE_ACQUISITION = 0,	///< Edge to integrated : interrupt servicing, FIFO read and integration
+	TRACE_QUEUEING,			///< Integrated to computed : waiting for the application to pick the values up
+	TRACE_COMPUTE,			///< Computed to printed : angle rendering
+	TRACE_TRANSFER,			///< Printed to displayed : waiting for the screen, then DMA transfer
+	TRACE_TOTAL,			///< Edge to displayed
+	TRACE_NB_STAGES
+}traceStage_e;
+
+/**
+ * @brief Structure holding the durations histogram of a stage
+ */
+typedef struct{
+	uint32_t	bins[TRACE_NB_BINS];	///< Number of durations per power-of-two bin
+	uint32_t	max_us;					///< Longest duration (in us)
+	uint32_t	total_us;				///< Cumulated duration (in us)
+}traceHistogram_t;
+
+/**
+ * @brief Structure holding the snapshot exported to the host (dumped from RAM with the debugger)
+ */
+typedef struct{
+	uint32_t			magic;							///< TRACE_MAGIC
+	uint16_t			version;						///< TRACE_VERSION
+	uint16_t			nbStages;						///< TRACE_NB_STAGES
+	uint32_t			nbTraces;						///< Number of blocks traced end to end
+	uint32_t			lastTag;						///< Tag of the last block traced (tags are sequential, so lastTag - nbTraces blocks were never displayed)
+	traceHistogram_t	histograms[TRACE_NB_STAGES];	///< Histogram of each stage
+}traceSnapshot_t;
+
+extern traceSnapshot_t tracerSnapshot;
+
+void		tracerTag(uint32_t edgeTimestamp_us);
+void		tracerMark(tracePoint_e point);
+errorCode_u	tracerGetHistogram(traceStage_e stage, traceHistogram_t* histogram);
+
+#endif /* INC_TIMING_TRACER_H_ */
@@ -0,0 +1,199 @@
+/**
+ * @file concurrency.c
+ * @brief Implement the primitives used to share data between interrupts and the main loop
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * - Event flags : producers set bits, the consumer tests and clears them in a single atomic
+ *   operation (LDREX/STREX), so an event raised between the test and the clear is never lost.
+ * - Sequence lock : the writer makes the sequence odd while writing, readers copy the snapshot
+ *   and retry if the sequence was odd or changed. Readers never block the writer.
+ * - SPSC ring : lock-free queue between one producer and one consumer, each one owning its index.
+ *
+ * On hosts (e.g. simulation), the compiler atomic builtins replace the Cortex-M3 exclusive accesses.
+ */
+#include "concurrency.h"
+
+#ifdef __arm__
+#include <stm32f1xx.h>
+#define MEMORY_BARRIER()	__DMB()		///< Make sure all the memory accesses before are done before the following ones
+#else
+#define MEMORY_BARRIER()	__atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+/**
+ * @brief Enumeration of the function IDs of the concurrency primitives
+ */
+typedef enum _concurrencyFunctionCodes_e{
+	SPSC_INIT = 0,	///< spscInitialise()
+}concurrencyFunctionCodes_e;
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Atomically set event flags
+ *
+ * @param flags Event flags word
+ * @param mask Flags to set
+ */
+void eventSet(eventFlags_t* flags, uint32_t mask){
+#ifdef __arm__
+	uint32_t value;
+
+	do{
+		value = __LDREXW(flags);
+	}while(__STREXW(value | mask, flags));
+#else
+	__atomic_fetch_or(flags, mask, __ATOMIC_SEQ_CST);
+#endif
+	MEMORY_BARRIER();
+}
+
+/**
+ * @brief Atomically test and clear event flags
+ *
+ * @param flags Event flags word
+ * @param mask Flags to test and clear
+ * @return Flags of the mask which were set
+ */
+uint32_t eventTestAndClear(eventFlags_t* flags, uint32_t mask){
+	uint32_t value;
+
+	//if none of the flags set, no need to lock
+	if(!(*flags & mask))
+		return (0);
+
+#ifdef __arm__
+	do{
+		value = __LDREXW(flags);
+	}while(__STREXW(value & ~mask, flags));
+#else
+	value = __atomic_fetch_and(flags, ~mask, __ATOMIC_SEQ_CST);
+#endif
+	MEMORY_BARRIER();
+
+	return (value & mask);
+}
+
+/**
+ * @brief Signal the snapshot is about to be written
+ *
+ * @param lock Sequence lock
+ */
+void seqlockWriteBegin(seqlock_t* lock){
+	lock->sequence = lock->sequence + 1;
+	MEMORY_BARRIER();
+}
+
+/**
+ * @brief Signal the snapshot has been written
+ *
+ * @param lock Sequence lock
+ */
+void seqlockWriteEnd(seqlock_t* lock){
+	MEMORY_BARRIER();
+	lock->sequence = lock->sequence + 1;
+}
+
+/**
+ * @brief Get the sequence before reading the snapshot
+ *
+ * @param lock Sequence lock
+ * @return Sequence to provide to seqlockReadRetry()
+ */
+uint32_t seqlockReadBegin(const seqlock_t* lock){
+	uint32_t sequence = lock->sequence;
+
+	MEMORY_BARRIER();
+	return (sequence);
+}
+
+/**
+ * @brief Check if the snapshot read is consistent
+ *
+ * @param lock Sequence lock
+ * @param start Sequence returned by seqlockReadBegin()
+ * @retval 0 Snapshot consistent
+ * @retval 1 Snapshot written in the meantime, it must be read again
+ */
+uint8_t seqlockReadRetry(const seqlock_t* lock, uint32_t start){
+	MEMORY_BARRIER();
+	return ((start & 1U) || (lock->sequence != start));
+}
+
+/**
+ * @brief Initialise a SPSC ring
+ *
+ * @param ring Ring to initialise
+ * @param buffer Values storage
+ * @param capacity Number of values in the storage (power of two)
+ * @retval 0 Success
+ * @retval 1 Capacity is not a power of two
+ */
+errorCode_u spscInitialise(spscRing_t* ring, uint32_t buffer[], uint32_t capacity){
+	if(!capacity || (capacity & (capacity - 1U)))
+		return (createErrorCode(SPSC_INIT, 1, ERR_ERROR));
+
+	ring->buffer = buffer;
+	ring->mask = capacity - 1U;
+	ring->head = 0;
+	ring->tail = 0;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Push a value in a SPSC ring (producer side)
+ *
+ * @param ring Ring in which push the value
+ * @param value Value to push
+ * @retval 0 Ring full, value dropped
+ * @retval 1 Success
+ */
+uint8_t spscPush(spscRing_t* ring, uint32_t value){
+	uint32_t head = ring->head;
+
+	if((head - ring->tail) > ring->mask)
+		return (0);
+
+	//store the value before publishing it
+	ring->buffer[head & ring->mask] = value;
+	MEMORY_BARRIER();
+	ring->head = head + 1U;
+	return (1);
+}
+
+/**
+ * @brief Pop the oldest value from a SPSC ring (consumer side)
+ *
+ * @param ring Ring from which pop the value
+ * @param[out] value Value popped
+ * @retval 0 Ring empty
+ * @retval 1 Success
+ */
+uint8_t spscPop(spscRing_t* ring, uint32_t* value){
+	uint32_t tail = ring->tail;
+
+	if(tail == ring->head)
+		return (0);
+
+	//read the value before releasing its slot
+	MEMORY_BARRIER();
+	*value = ring->buffer[tail & ring->mask];
+	MEMORY_BARRIER();
+	ring->tail = tail + 1U;
+	return (1);
+}
+
+/**
+ * @brief Drop all the values of a SPSC ring (consumer side)
+ *
+ * @param ring Ring to flush
+ */
+void spscFlush(spscRing_t* ring){
+	MEMORY_BARRIER();
+	ring->tail = ring->head;
+}
@@ -11,27 +11,50 @@
 #include "ADXL345.h"
 #include "ADXL345registers.h"
 #include "main.h"
+#include "timestamp.h"
+#include "tracer.h"
+#include "concurrency.h"
 #include <math.h>
+#include <stdlib.h>
 
 //definitions
 #define SPI_TIMEOUT_MS	10U		///< SPI direct transmission timeout span in milliseconds
 #define INT_TIMEOUT_MS	1000U	///< Maximum number of milliseconds before watermark int. timeout
 #define ST_WAIT_MS		25U		///< Maximum number of milliseconds before watermark int. timeout
-#define BYTE_OFFSET		8U		///< Number of bits to offset a byte
-#define X_INDEX_MSB		1U		///< Index of the X MSB in the measurements
-#define X_INDEX_LSB		0U		///< Index of the X LSB in the measurements
-#define Y_INDEX_MSB		3U		///< Index of the Y MSB in the measurements
-#define Y_INDEX_LSB		2U		///< Index of the Y LSB in the measurements
-#define Z_INDEX_MSB		5U		///< Index of the Z MSB in the measurements
-#define Z_INDEX_LSB		4U		///< Index of the Z LSB in the measurements
-#define NB_REG_INIT		5U		///< Number of registers configured at initialisation
+#define STARTUP_RETRY_MS	10U	///< Number of milliseconds before reading an invalid device ID again
+#define HALFWORD_SHIFT	16U		///< Number of bits to shift a word to reach its upper half
+#define WORDS_PER_PAIR	3U		///< Number of 32-bit words holding two samples
+#define RECIPROCAL_SHIFT	32U	///< Number of fractional bits of the averaging depth reciprocal
+#define SUM_BIAS_SHIFT	20U		///< Shift giving the bias which makes any sum positive (|sum| <= 32 * 32768)
+#define NB_REG_INIT		12U		///< Number of registers configured at initialisation
+#define EDGES_CAPACITY	4U		///< Number of INT1 edges timestamps the ring can hold
 #define DEGREES_180		180.0f	///< Value representing a flat angle
+#define TAP_THRESHOLD_3G	0x30U	///< Tap threshold of 3g (62.5 mg/LSB)
+#define TAP_DURATION_10MS	0x10U	///< Maximum tap duration of 10ms (625 us/LSB)
+#define TAP_LATENCY_80MS	0x40U	///< Wait of 80ms after a tap before the double tap window (1.25 ms/LSB)
+#define TAP_WINDOW_250MS	0xC8U	///< Double tap window of 250ms after the latency (1.25 ms/LSB)
+#define TAP_DECISION_US	340000U	///< Time after a single tap past which no double tap can follow (latency + window + 10 ms margin, in us)
+#define ACT_THRESHOLD_190MG	0x03U	///< Activity threshold of 187.5 mg, about 11 degrees of tilt (62.5 mg/LSB)
+#define ACT_AXES_WATCHED	(ADXL_ACT_AC | ADXL_ACT_X_ENABLE | ADXL_ACT_Y_ENABLE | ADXL_ACT_Z_ENABLE)	///< Activity detection settings while watched
+#define SPI_MAX_FREQ_HZ	5000000U	///< Maximum SPI clock frequency supported by the ADXL345 (in Hz)
+#define NB_PRESCALERS	8U		///< Number of SPI baud rate prescalers available
+#define PRESCALER_MAX	256U	///< Highest SPI baud rate prescaler divider
+#define NB_PATTERNS		2U		///< Number of patterns written and read back to validate a bus speed
+#define HZ_PER_MHZ		1000000U	///< Number of Hz in a MHz
+#define NS_PER_US		1000U	///< Number of nanoseconds in a microsecond
+#define PPM				1000000	///< Number of parts per million in a unit
+#define ODR_3200HZ_NS	312500U	///< Sample period at the highest output data rate (in ns)
+#define ODR_LOWEST_HZ	100U	///< Lowest output data rate supported (in Hz)
+#define DRIFT_REJECT_SHIFT	6U	///< Shift giving the maximum deviation of a block interval before it is rejected (1/64th)
+#define DRIFT_FILTER_SHIFT	3U	///< Shift giving the weight of a new drift measurement in the drift filter (1/8th)
 
 //integration sampling
-#define ADXL_AVG_SAMPLES	ADXL_SAMPLES_32
-#define ADXL_AVG_SHIFT		5U
-#if (ADXL_AVG_SAMPLES >> ADXL_AVG_SHIFT) != 1
-#error TADXL_AVG_SHIFT does not divide all the samples configured with ADXL_AVG_NB
+#define ADXL_DEFAULT_AVERAGING	ADXL_AVERAGING_PRECISE	///< Number of samples averaged per block at startup
+#define ADXL_DEFAULT_RATE	ADXL_ODR_200HZ			///< Output data rate used at startup
+#define FIFO_WORDS			(((ADXL_MAX_AVERAGING * ADXL_NB_DATA_REGISTERS) + 3U) >> 2)	///< Number of 32-bit words holding the raw samples of the largest FIFO block
+
+#if (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error The FIFO samples are decoded with word loads, which requires a little-endian core
 #endif
 
 //type definitions
@@ -51,7 +74,12 @@ typedef enum _ADXLfunctionCodes_e{
 	GET_X_ANGLE,		///< ADXL345getXangleDegrees()
 	GET_Y_ANGLE,		///< ADXL345getYangleDegrees()
 	INTEGRATE,			///< integrateFIFO()
-	STARTUP				///< stStartup()
+	STARTUP,			///< stStartup()
+	NEGOTIATE_SPEED,	///< stNegotiatingSpeed()
+	SET_PRESCALER,		///< setSPIprescaler()
+	SET_RATE,			///< ADXL345setDataRate()
+	CHANGE_SETTINGS,	///< applySettings()
+	SET_AVERAGING		///< ADXL345setAveraging()
 }ADXLfunctionCodes_e;
 
 /**
@@ -79,6 +107,7 @@ typedef errorCode_u (*adxlState)();
 
 //machine state
 static errorCode_u stStartup();
+static errorCode_u stNegotiatingSpeed();
 static errorCode_u stConfiguring();
 static errorCode_u stSelfTestingOFF();
 static errorCode_u stEnablingST();
@@ -91,36 +120,103 @@ static errorCode_u stError();
 static errorCode_u writeRegister(adxl345Registers_e registerNumber, uint8_t value);
 static errorCode_u readRegisters(adxl345Registers_e firstRegister, uint8_t* value, uint8_t size);
 static errorCode_u integrateFIFO(int16_t* xValue, int16_t* yValue, int16_t* zValue);
+static void decodeBlock(const uint32_t words[], uint8_t nbSamples, int16_t block[NB_AXIS][ADXL_MAX_AVERAGING], int32_t sums[NB_AXIS]);
+static errorCode_u setSPIprescaler(uint8_t index);
+static errorCode_u verifyBusSpeed(uint32_t* drainTime_us);
+static void updateBlockTiming(uint32_t edgeTimestamp_us);
+static errorCode_u applySettings();
+static void publishValues(int16_t xValue, int16_t yValue, int16_t zValue);
+static void flushINT1edges();
 
 //tool functions
 static inline void setSPIstatus(spiStatus_e value);
-static inline float atanDegrees(int16_t direction, int16_t axisZ);
+static inline float atanDegrees(int32_t direction, int32_t axisZ);
+static inline uint8_t fifoControl(uint8_t depth);
+static void setDepth(uint8_t depth);
+static inline int16_t average(int32_t sum);
+static inline int32_t fineAverage(int32_t sum);
 
 /**
  * @brief Array of all the registers/values to write at initialisation
  * @note Two values are written in FIFO_CONTROL to clear the FIFO at startup
  */
 static const uint8_t initialisationArray[NB_REG_INIT][2] = {
-	{BANDWIDTH_POWERMODE,	ADXL_POWER_NORMAL | ADXL_RATE_200HZ},
+	{BANDWIDTH_POWERMODE,	ADXL_POWER_NORMAL | ADXL_DEFAULT_RATE},
+	{TAP_THRESHOLD,			TAP_THRESHOLD_3G},
+	{TAP_DURATION,			TAP_DURATION_10MS},
+	{TAP_LATENCY,			TAP_LATENCY_80MS},
+	{TAP_WINDOW,			TAP_WINDOW_250MS},
+	{TAP_AXES,				ADXL_TAP_SUPPRESS | ADXL_TAP_Z_ENABLE},
+	{ACTIVITY_THRESHOLD,	ACT_THRESHOLD_190MG},
+	{INTERRUPT_MAPPING,		ADXL_INT_MAP_INT1},
 	{FIFO_CONTROL,			ADXL_MODE_BYPASS},
-	{FIFO_CONTROL,			ADXL_MODE_FIFO | ADXL_TRIGGER_INT1 | (ADXL_AVG_SAMPLES - 1)},
+	{FIFO_CONTROL,			ADXL_MODE_FIFO | ADXL_TRIGGER_INT1 | (ADXL_DEFAULT_AVERAGING - 1U)},
 	{INTERRUPT_ENABLE,		ADXL_INT_WATERMARK},
 	{POWER_CONTROL,			ADXL_MEASURE_MODE},
 };
 
+/**
+ * @brief Array of all the SPI baud rate prescalers, from the slowest to the fastest
+ */
+static const uint32_t spiPrescalers[NB_PRESCALERS] = {
+	SPI_BAUDRATEPRESCALER_256,
+	SPI_BAUDRATEPRESCALER_128,
+	SPI_BAUDRATEPRESCALER_64,
+	SPI_BAUDRATEPRESCALER_32,
+	SPI_BAUDRATEPRESCALER_16,
+	SPI_BAUDRATEPRESCALER_8,
+	SPI_BAUDRATEPRESCALER_4,
+	SPI_BAUDRATEPRESCALER_2,
+};
+
+/**
+ * @brief Patterns written then read back in a scratch register to validate a bus speed
+ */
+static const uint8_t verificationPatterns[NB_PATTERNS] = {0x55U, 0xAAU};
+
+// Interrupts enabled once self-test is over (the activity only fires while its axes are enabled)
+static const uint8_t interruptsMeasuring = (ADXL_INT_WATERMARK | ADXL_INT_SINGLETAP | ADXL_INT_DOUBLETAP | ADXL_INT_ACTIVITY);
+
 // Default data format (register 0x31) value
 static const uint8_t dataFormatDefault = (ADXL_NO_SELF_TEST | ADXL_SPI_4WIRE | ADXL_INT_ACTIV_LOW | ADXL_RANGE_16G);
 
+//INT1 edges timestamps storage
+static uint32_t				_edgesBuffer[EDGES_CAPACITY];	///< Storage of the INT1 edges timestamps ring
+
 //global variables
-volatile uint8_t			adxlINT1occurred = 0;		///< Flag used to indicate the ADXL triggered an interrupt
+eventFlags_t				adxlEvents = 0;				///< Events raised by the ADXL interrupts
 volatile uint16_t			adxlTimer_ms = 0;			///< Timer used in various states of the ADXL (in ms)
+spscRing_t					adxlINT1edges = {_edgesBuffer, EDGES_CAPACITY - 1U, 0, 0};	///< Timestamps of the INT1 falling edges (in us), pushed by the EXTI ISR
 
 //state variables
 static SPI_HandleTypeDef*	_spiHandle = NULL;			///< SPI handle used with the ADXL345
 static adxlState			_state = stStartup;			///< State machine current state
 static uint8_t				_measurementsUpdated = 0;	///< Flag used to indicate new integrated measurements are ready within the ADXL345
 static adxlValues_t			_finalValues[NB_AXIS];		///< Array of axis values
+static int32_t				_fineValues[NB_AXIS];		///< Axis values with ADXL_FINE_SHIFT fractional bits
+static int32_t				_blockFine[NB_AXIS];		///< Fine averages of the last FIFO block integrated, not published yet
+static seqlock_t			_valuesLock;				///< Sequence lock protecting the axis values snapshot
 static errorCode_u 			_result;					///< Variables used to store error codes
+static adxlSPItiming_t		_spiTimings[NB_PRESCALERS];	///< Bus speed negotiation results, from the slowest to the fastest prescaler
+static uint8_t				_nbSPItimings = 0;			///< Number of bus speeds tested during negotiation
+static uint8_t				_speedIndex = 0;			///< Index of the prescaler currently tested
+static uint8_t				_bestSpeedIndex = NB_PRESCALERS;	///< Index of the fastest reliable prescaler found (NB_PRESCALERS if none)
+static sensorBlockTiming_t	_blockTiming;				///< Timing information of the last FIFO block integrated
+static sensorGesture_e		_gesture = SENSOR_NO_GESTURE;	///< Last tap gesture detected, not retrieved yet
+static uint8_t				_singleTapPending = 0;		///< 1 while a single tap waits for its double tap window to expire
+static uint32_t				_singleTap_us = 0;			///< Timestamp of the single tap pending (in us)
+static uint8_t				_activityWatched = 0;		///< 1 while the activity detection is enabled
+static uint8_t				_activityRequested = 0;		///< Activity detection state to apply as soon as measuring
+static uint8_t				_activity = 0;				///< 1 if a motion has been detected, not retrieved yet
+static int16_t				_block[NB_AXIS][ADXL_MAX_AVERAGING];	///< Raw samples of the last FIFO block integrated, per axis
+static uint32_t				_fifoWords[FIFO_WORDS];		///< Data registers of the FIFO block samples, back to back (word-aligned)
+static adxlDataRate_e		_dataRate = ADXL_DEFAULT_RATE;		///< Output data rate currently used
+static adxlDataRate_e		_requestedRate = ADXL_DEFAULT_RATE;	///< Output data rate to apply as soon as measuring
+static uint8_t				_depth = ADXL_DEFAULT_AVERAGING;			///< Number of samples averaged per block
+static uint8_t				_requestedDepth = ADXL_DEFAULT_AVERAGING;	///< Number of samples averaged per block to apply as soon as measuring
+static uint8_t				_depthShift = 0;			///< Shift dividing by the averaging depth (power of two depths only)
+static uint32_t				_depthReciprocal = 0;		///< Reciprocal of the averaging depth, in Q0.32 rounded up (0 if power of two)
+static int16_t				_offsets[NB_AXIS] = {0};	///< Offsets subtracted from every sample, per axis
 
 
 /********************************************************************************************************************************************/
@@ -135,6 +231,7 @@ static errorCode_u 			_result;					///< Variables used to store error codes
  */
 errorCode_u ADXL345initialise(const SPI_HandleTypeDef* handle){
 	_spiHandle = (SPI_HandleTypeDef*)handle;
+	setDepth(ADXL_DEFAULT_AVERAGING);
 	return (ERR_SUCCESS);
 }
 
@@ -160,6 +257,210 @@ uint8_t ADXL345hasChanged(axis_e axis){
 	return (tmp);
 }
 
+/**
+ * @brief Check if a new FIFO block has been integrated since the last call
+ *
+ * @retval 0 No new block available
+ * @retval 1 New block available
+ */
+uint8_t ADXL345hasNewBlock(){
+	uint8_t tmp = _measurementsUpdated;
+	_measurementsUpdated = 0;
+
+	return (tmp);
+}
+
+/**
+ * @brief Get the last tap gesture detected, and clear it
+ * @details The ADXL raises a single tap on the first tap of a double tap.
+ * 			A single tap is then only reported once its double tap window expired without a second tap.
+ *
+ * @return Gesture detected
+ */
+sensorGesture_e ADXL345getGesture(){
+	if(_singleTapPending && ((timestampGet_us() - _singleTap_us) >= TAP_DECISION_US)){
+		_singleTapPending = 0;
+		_gesture = SENSOR_SINGLE_TAP;
+	}
+
+	sensorGesture_e tmp = _gesture;
+	_gesture = SENSOR_NO_GESTURE;
+
+	return (tmp);
+}
+
+/**
+ * @brief Request the detection of a motion, or cancel it
+ * @details The detection is AC coupled : the position when the detection gets enabled is the reference,
+ * 			and any axis moving away from it by more than the threshold is a motion.
+ * 			The detection is disabled as soon as a motion is detected, and must be requested again.
+ *
+ * @param enabled 1 to watch for a motion from the current position, 0 to stop watching
+ */
+void ADXL345watchActivity(uint8_t enabled){
+	_activityRequested = (enabled != 0);
+}
+
+/**
+ * @brief Check if a motion has been detected since watched, and clear it
+ *
+ * @retval 0 No motion detected
+ * @retval 1 Motion detected
+ */
+uint8_t ADXL345hasActivity(){
+	uint8_t tmp = _activity;
+	_activity = 0;
+
+	return (tmp);
+}
+
+/**
+ * @brief Check if the state machine only waits for an INT1 edge or its timer to expire
+ * @details Used to run the machine on events only : while not waiting, it has work to do right away
+ * 			(state handed over, INT1 still asserted, settings requested).
+ *
+ * @retval 0 Work to do on the next update
+ * @retval 1 Nothing to do until INT1 or the timer
+ */
+uint8_t ADXL345isWaiting(){
+	const uint8_t edgePending = ((adxlEvents & ADXL_EVENT_INT1) != 0);
+
+	if(_state == stError)
+		return (1);
+
+	//once the timer expired, the state has to handle it
+	if(!adxlTimer_ms)
+		return (0);
+
+	if(_state == stMeasuring)
+		return (!edgePending && (_requestedRate == _dataRate) && (_requestedDepth == _depth) && (_activityRequested == _activityWatched));
+	if((_state == stSelfTestingOFF) || (_state == stSelfTestingON))
+		return (!edgePending);
+
+	return ((_state == stStartup) || (_state == stWaitingForSTenabled));
+}
+
+/**
+ * @brief Get the raw samples of the last FIFO block integrated for an axis
+ *
+ * @param axis Axis of which get the samples
+ * @param[out] samples Samples of the axis, from the oldest to the newest
+ * @return Number of samples in the block
+ */
+uint8_t ADXL345getBlock(axis_e axis, const int16_t** samples){
+	if(axis >= NB_AXIS)
+		axis = X_AXIS;
+
+	*samples = _block[axis];
+	return (_blockTiming.nbSamples);
+}
+
+/**
+ * @brief Request a new output data rate
+ * @note The rate is applied as soon as the ADXL is measuring, and the FIFO is cleared
+ *
+ * @param rate_Hz Output data rate to apply (in Hz, 100 Hz doubled up to 3200 Hz)
+ * @retval 0 Success
+ * @retval 1 Rate not supported
+ */
+errorCode_u ADXL345setDataRate(uint16_t rate_Hz){
+	adxlDataRate_e rate = ADXL_ODR_100HZ;
+	uint16_t supported_Hz = ODR_LOWEST_HZ;
+
+	//each rate code doubles the previous rate
+	while((supported_Hz < rate_Hz) && (rate < ADXL_ODR_3200HZ)){
+		supported_Hz <<= 1;
+		rate++;
+	}
+
+	if(supported_Hz != rate_Hz)
+		return (createErrorCode(SET_RATE, 1, ERR_WARNING));
+
+	_requestedRate = rate;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Request a new averaging depth (number of samples integrated per block)
+ * @details Shallow depths give faster updates, deep depths give less noise.
+ * 			The depth is applied as soon as the ADXL is measuring, and the FIFO is cleared.
+ *
+ * @param nbSamples Number of samples to average (ADXL_MIN_AVERAGING to ADXL_MAX_AVERAGING)
+ * @retval 0 Success
+ * @retval 1 Depth out of the range supported
+ */
+errorCode_u ADXL345setAveraging(uint8_t nbSamples){
+	if((nbSamples < ADXL_MIN_AVERAGING) || (nbSamples > ADXL_MAX_AVERAGING))
+		return (createErrorCode(SET_AVERAGING, 1, ERR_WARNING));
+
+	_requestedDepth = nbSamples;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Get the averaging depth requested
+ *
+ * @return Number of samples averaged per block
+ */
+uint8_t ADXL345getAveraging(){
+	return (_requestedDepth);
+}
+
+/**
+ * @brief Set the offsets subtracted from every sample (e.g. temperature drift compensation)
+ *
+ * @param offsets Offsets, per axis (in LSB)
+ */
+void ADXL345setOffsets(const int16_t offsets[NB_AXIS]){
+	for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++)
+		_offsets[axis] = offsets[axis];
+}
+
+/**
+ * @brief Get the results of the SPI bus speed negotiation
+ *
+ * @param[out] timings Array of the settings tested, from the slowest to the fastest
+ * @return Number of settings tested
+ */
+uint8_t ADXL345getSPItimings(const adxlSPItiming_t** timings){
+	*timings = _spiTimings;
+	return (_nbSPItimings);
+}
+
+/**
+ * @brief Get the SPI clock frequency selected by the bus speed negotiation
+ *
+ * @return SPI clock frequency (in Hz), 0 if negotiation is not over
+ */
+uint32_t ADXL345getSPIfrequency(){
+	if(_bestSpeedIndex >= NB_PRESCALERS)
+		return (0);
+
+	return (_spiTimings[_bestSpeedIndex].frequency_Hz);
+}
+
+/**
+ * @brief Get the timing information of the last FIFO block integrated
+ *
+ * @param[out] timing Timing information
+ */
+void ADXL345getBlockTiming(sensorBlockTiming_t* timing){
+	*timing = _blockTiming;
+}
+
+/**
+ * @brief Reconstruct the time at which a sample of the last FIFO block was acquired
+ * @note Sample times are interpolated from the watermark edge with the drift-corrected sample period
+ *
+ * @param index Index of the sample in the block (0 being the oldest)
+ * @return Sample timestamp (in us)
+ */
+uint32_t ADXL345getSampleTime_us(uint8_t index){
+	int32_t offset_ns = ((int32_t)index - (int32_t)(_depth - 2U)) * (int32_t)_blockTiming.samplePeriod_ns;
+
+	return (_blockTiming.timestamp_us + (uint32_t)(offset_ns / (int32_t)NS_PER_US));
+}
+
 /**
  * @brief Write a single register on the ADXL345
  *
@@ -263,6 +564,38 @@ int16_t ADXL345getValue(axis_e axis){
 	return (_finalValues[axis].current);
 }
 
+/**
+ * @brief Get a consistent snapshot of the last known integrated measurements of all the axis
+ *
+ * @param[out] vector Last known integrated measurements, per axis
+ */
+void ADXL345getVector(int16_t vector[NB_AXIS]){
+	uint32_t sequence;
+
+	do{
+		sequence = seqlockReadBegin(&_valuesLock);
+		for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++)
+			vector[axis] = _finalValues[axis].current;
+	}while(seqlockReadRetry(&_valuesLock, sequence));
+}
+
+/**
+ * @brief Get a consistent snapshot of the last known integrated measurements of all the axis, fractional bits included
+ * @details The block averages keep ADXL_FINE_SHIFT fractional bits instead of being truncated to whole LSBs,
+ * 			so that they can be averaged further without losing the resolution gained
+ *
+ * @param[out] vector Last known integrated measurements, per axis (in 1/256th of LSB)
+ */
+void ADXL345getFineVector(int32_t vector[NB_AXIS]){
+	uint32_t sequence;
+
+	do{
+		sequence = seqlockReadBegin(&_valuesLock);
+		for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++)
+			vector[axis] = _fineValues[axis];
+	}while(seqlockReadRetry(&_valuesLock, sequence));
+}
+
 /**
  * @brief Transpose a measurement to an angle in degrees with the Z axis
  *
@@ -273,6 +606,18 @@ float measureToAngleDegrees(int16_t axisValue){
 	return (atanDegrees(axisValue, _finalValues[Z_AXIS].current));
 }
 
+/**
+ * @brief Transpose a vector given by its components to an angle in degrees with its Z component
+ * @note Only the ratio of the components matters, so they can be in any fixed-point format (as long as both are the same)
+ *
+ * @param direction Component of the vector in the direction of the angle
+ * @param axisZ Z component of the vector
+ * @return Angle with the Z component
+ */
+float vectorToAngleDegrees(int32_t direction, int32_t axisZ){
+	return (atanDegrees(direction, axisZ));
+}
+
 /**
  * @brief Compute the angle (in degrees) between any axis and the Z axis
  *
@@ -280,13 +625,79 @@ float measureToAngleDegrees(int16_t axisValue){
  * @param axisZ Value (in G) of the Z axis
  * @return Angle between direction and the Z axis
  */
-static inline float atanDegrees(int16_t direction, int16_t axisZ){
+static inline float atanDegrees(int32_t direction, int32_t axisZ){
 	if(!axisZ)
 		return (0.0f);
 
 	return ((atanf((float)direction / (float)axisZ) * DEGREES_180) / (float)M_PI);
 }
 
+/**
+ * @brief Get the FIFO control register value for an averaging depth
+ * @details The FIFO runs in FIFO mode, and the watermark interrupt fires one entry before the depth
+ *
+ * @param depth Number of samples averaged per block
+ * @return FIFO_CONTROL value
+ */
+static inline uint8_t fifoControl(uint8_t depth){
+	return ((uint8_t)(ADXL_MODE_FIFO | ADXL_TRIGGER_INT1 | (depth - 1U)));
+}
+
+/**
+ * @brief Set the averaging depth used to integrate the blocks
+ * @details Power of two depths divide with a shift, the others with a reciprocal multiplication
+ *
+ * @param depth Number of samples averaged per block
+ */
+static void setDepth(uint8_t depth){
+	_depth = depth;
+	_depthShift = (uint8_t)(31U - __CLZ(depth));												// @suppress("Avoid magic numbers")
+	_depthReciprocal = 0;
+	if(depth & (depth - 1U))
+		_depthReciprocal = (uint32_t)(((1ULL << RECIPROCAL_SHIFT) + depth - 1U) / depth);
+}
+
+/**
+ * @brief Divide a block sum by the averaging depth, rounding towards minus infinity
+ * @details Power of two depths use an arithmetic shift.
+ * 			Other depths bias the sum by a multiple of the depth to make it positive,
+ * 			multiply it by the reciprocal of the depth (Q0.32, rounded up), then remove the bias.
+ * 			The biased sum stays under 2^26, which keeps the result exact (error under 2^26 * 32 / 2^32 < 1).
+ *
+ * @param sum Sum of the samples of a block
+ * @return Average of the samples
+ */
+static inline int16_t average(int32_t sum){
+	uint32_t biased;
+
+	if(!_depthReciprocal)
+		return ((int16_t)(sum >> _depthShift));
+
+	biased = (uint32_t)(sum + ((int32_t)_depth << SUM_BIAS_SHIFT));
+	return ((int16_t)((int32_t)(((uint64_t)biased * _depthReciprocal) >> RECIPROCAL_SHIFT) - (1 << SUM_BIAS_SHIFT)));
+}
+
+/**
+ * @brief Divide a block sum by the averaging depth, keeping ADXL_FINE_SHIFT fractional bits and rounding towards minus infinity
+ * @details |sum| <= 32 * 32768, so the scaled sum stays under 2^28.
+ * 			Power of two depths use an arithmetic shift, the others a hardware division (SDIV, 12 cycles at most on the Cortex-M3),
+ * 			the three divisions per block not being worth a reciprocal at this precision.
+ *
+ * @param sum Sum of the samples of a block
+ * @return Average of the samples (in 1/256th of LSB)
+ */
+static inline int32_t fineAverage(int32_t sum){
+	sum *= ((int32_t)1 << ADXL_FINE_SHIFT);
+
+	if(!_depthReciprocal)
+		return (sum >> _depthShift);
+
+	//C divisions truncate towards zero : shift the negative sums to floor them
+	if(sum < 0)
+		sum -= (int32_t)_depth - 1;
+	return (sum / (int32_t)_depth);
+}
+
 /**
  * brief Set the SPI CS pin to enable/disable a SPI transmission
  *
@@ -296,6 +707,161 @@ static inline void setSPIstatus(spiStatus_e value){
 	HAL_GPIO_WritePin(ADXL_CS_GPIO_Port, ADXL_CS_Pin, (value == ENABLED ? GPIO_PIN_RESET : GPIO_PIN_SET));
 }
 
+/**
+ * @brief Reconfigure the SPI baud rate prescaler
+ *
+ * @param index Index of the prescaler in the prescalers array
+ * @retval 0 Success
+ * @retval 1 Error while reinitialising the SPI peripheral
+ */
+static errorCode_u setSPIprescaler(uint8_t index){
+	HAL_StatusTypeDef HALresult;
+
+	_spiHandle->Init.BaudRatePrescaler = spiPrescalers[index];
+	HALresult = HAL_SPI_Init(_spiHandle);
+	if(HALresult != HAL_OK)
+		return (createErrorCodeLayer1(SET_PRESCALER, 1, HALresult, ERR_ERROR));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Check the communication with the ADXL345 is reliable at the current bus speed
+ * @note The OFFSET_X register is used as a scratch register, restored to its reset value on success only
+ * 		 (restored by stNegotiatingSpeed() once a reliable bus speed is set back)
+ *
+ * @param[out] drainTime_us Time taken to read a full FIFO block (in us)
+ * @retval 0 Success
+ * @retval 1 Error while reading the device ID
+ * @retval 2 Invalid device ID
+ * @retval 3 Error while writing a pattern
+ * @retval 4 Error while reading a pattern back
+ * @retval 5 Pattern read back is different from the one written
+ * @retval 6 Error while restoring the scratch register
+ * @retval 7 Error while draining the data registers
+ */
+static errorCode_u verifyBusSpeed(uint32_t* drainTime_us){
+	uint8_t buffer[ADXL_NB_DATA_REGISTERS];
+	uint32_t startCycles;
+
+	//read the device ID back
+	_result = readRegisters(DEVICE_ID, buffer, 1);
+	if(IS_ERROR(_result))
+		return (pushErrorCode(_result, NEGOTIATE_SPEED, 1));
+	if(buffer[0] != ADXL_DEVICE_ID)
+		return (createErrorCode(NEGOTIATE_SPEED, 2, ERR_WARNING));
+
+	//write and read back all the patterns in the scratch register
+	for(uint8_t i = 0 ; i < NB_PATTERNS ; i++){
+		_result = writeRegister(OFFSET_X, verificationPatterns[i]);
+		if(IS_ERROR(_result))
+			return (pushErrorCode(_result, NEGOTIATE_SPEED, 3)); 	// @suppress("Avoid magic numbers")
+
+		_result = readRegisters(OFFSET_X, buffer, 1);
+		if(IS_ERROR(_result))
+			return (pushErrorCode(_result, NEGOTIATE_SPEED, 4)); 	// @suppress("Avoid magic numbers")
+		if(buffer[0] != verificationPatterns[i])
+			return (createErrorCode(NEGOTIATE_SPEED, 5, ERR_WARNING)); 	// @suppress("Avoid magic numbers")
+	}
+
+	//restore the scratch register
+	_result = writeRegister(OFFSET_X, 0x00U);
+	if(IS_ERROR(_result))
+		return (pushErrorCode(_result, NEGOTIATE_SPEED, 6)); 	// @suppress("Avoid magic numbers")
+
+	//time as many data registers reads as the deepest FIFO drain requires
+	startCycles = DWT->CYCCNT;
+	for(uint8_t i = 0 ; i < ADXL_MAX_AVERAGING ; i++){
+		_result = readRegisters(DATA_X0, buffer, ADXL_NB_DATA_REGISTERS);
+		if(IS_ERROR(_result))
+			return (pushErrorCode(_result, NEGOTIATE_SPEED, 7)); 	// @suppress("Avoid magic numbers")
+	}
+	*drainTime_us = (DWT->CYCCNT - startCycles) / (HAL_RCC_GetHCLKFreq() / HZ_PER_MHZ);
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Apply the output data rate and averaging depth requested, and restart the FIFO
+ *
+ * @retval 0 Success
+ * @retval 1 Error while writing the rate
+ * @retval 2 Error while clearing the FIFO
+ * @retval 3 Error while restarting the FIFO
+ */
+static errorCode_u applySettings(){
+	_result = writeRegister(BANDWIDTH_POWERMODE, ADXL_POWER_NORMAL | (uint8_t)_requestedRate);
+	if(IS_ERROR(_result))
+		return (pushErrorCode(_result, CHANGE_SETTINGS, 1));
+
+	_result = writeRegister(FIFO_CONTROL, ADXL_MODE_BYPASS);
+	if(IS_ERROR(_result))
+		return (pushErrorCode(_result, CHANGE_SETTINGS, 2));
+
+	flushINT1edges();
+	_result = writeRegister(FIFO_CONTROL, fifoControl(_requestedDepth));
+	if(IS_ERROR(_result))
+		return (pushErrorCode(_result, CHANGE_SETTINGS, 3)); 	// @suppress("Avoid magic numbers")
+
+	//samples timing restarts from scratch with the new settings
+	_dataRate = _requestedRate;
+	setDepth(_requestedDepth);
+	_blockTiming.nbSamples = 0;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Stamp a new FIFO block and update the estimation of the ADXL clock drift
+ * @details The interval between two watermark edges is compared to the one expected from the ODR.
+ * 			Intervals too far off (e.g. samples lost because the FIFO was drained late) are discarded.
+ * 			A positive drift means the ADXL samples slower than its nominal ODR, as seen by the MCU clock.
+ *
+ * @param edgeTimestamp_us Timestamp of the watermark edge (in us)
+ */
+static void updateBlockTiming(uint32_t edgeTimestamp_us){
+	const uint32_t nominalPeriod_ns = ODR_3200HZ_NS << (ADXL_ODR_3200HZ - _dataRate);
+	const uint32_t expected_us = (nominalPeriod_ns * _depth) / NS_PER_US;
+	int32_t deviation_us = (int32_t)(edgeTimestamp_us - _blockTiming.timestamp_us - expected_us);
+	int32_t measuredDrift_ppm;
+
+	//if a previous block has been stamped and the interval is plausible, filter the new drift measurement in
+	_blockTiming.contiguous = (_blockTiming.nbSamples && ((uint32_t)abs(deviation_us) < (expected_us >> DRIFT_REJECT_SHIFT)));
+	if(_blockTiming.contiguous){
+		measuredDrift_ppm = (int32_t)(((int64_t)deviation_us * PPM) / (int64_t)expected_us);
+		_blockTiming.drift_ppm += (measuredDrift_ppm - _blockTiming.drift_ppm) / (1 << DRIFT_FILTER_SHIFT);
+	}
+
+	//stamp the block and correct the sample period with the estimated drift
+	_blockTiming.timestamp_us = edgeTimestamp_us;
+	_blockTiming.nbSamples = _depth;
+	_blockTiming.samplePeriod_ns = (uint32_t)((int64_t)nominalPeriod_ns + (((int64_t)nominalPeriod_ns * _blockTiming.drift_ppm) / PPM));
+}
+
+/**
+ * @brief Publish new integrated measurements and the fine averages of the last block, under the values sequence lock
+ *
+ * @param xValue Integrated X axis value
+ * @param yValue Integrated Y axis value
+ * @param zValue Integrated Z axis value
+ */
+static void publishValues(int16_t xValue, int16_t yValue, int16_t zValue){
+	seqlockWriteBegin(&_valuesLock);
+	_finalValues[X_AXIS].current = xValue;
+	_finalValues[Y_AXIS].current = yValue;
+	_finalValues[Z_AXIS].current = zValue;
+	for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++)
+		_fineValues[axis] = _blockFine[axis];
+	seqlockWriteEnd(&_valuesLock);
+}
+
+/**
+ * @brief Drop the pending INT1 event and edges timestamps (e.g. before restarting the FIFO)
+ */
+static void flushINT1edges(){
+	eventTestAndClear(&adxlEvents, ADXL_EVENT_INT1);
+	spscFlush(&adxlINT1edges);
+}
+
 /**
  * @brief Retrieve and average the values held in the ADXL FIFOs
  *
@@ -306,33 +872,79 @@ static inline void setSPIstatus(spiStatus_e value){
  * @retval 1 Error while retrieving values from the FIFO
  */
 errorCode_u integrateFIFO(int16_t* xValue, int16_t* yValue, int16_t* zValue){
-	static uint8_t buffer[ADXL_NB_DATA_REGISTERS];
-
-	*xValue = *yValue = *zValue = 0;
+	uint8_t* sample = (uint8_t*)_fifoWords;
+	int32_t sums[NB_AXIS];
 
-	//for eatch of the 16 samples to read
-	for(uint8_t i = 0 ; i < ADXL_AVG_SAMPLES ; i++){
-		//read all data registers for 1 sample
-		_result = readRegisters(DATA_X0, buffer, ADXL_NB_DATA_REGISTERS);
+	//read all data registers of each sample, back to back
+	for(uint8_t i = 0 ; i < _depth ; i++){
+		_result = readRegisters(DATA_X0, sample, ADXL_NB_DATA_REGISTERS);
 		if(IS_ERROR(_result)){
 			_state = stError;
 			return (pushErrorCode(_result, INTEGRATE, 1));
 		}
-
-		//add the measurements (formatted from a two's complement) to their final value buffer
-		*xValue += (int16_t)(((uint16_t)(buffer[X_INDEX_MSB]) << BYTE_OFFSET) | (uint16_t)(buffer[X_INDEX_LSB]));
-		*yValue += (int16_t)(((uint16_t)(buffer[Y_INDEX_MSB]) << BYTE_OFFSET) | (uint16_t)(buffer[Y_INDEX_LSB]));
-		*zValue += (int16_t)(((uint16_t)(buffer[Z_INDEX_MSB]) << BYTE_OFFSET) | (uint16_t)(buffer[Z_INDEX_LSB]));
+		sample += ADXL_NB_DATA_REGISTERS;
 	}
 
-	//divide the buffers to average out
-	*xValue >>= ADXL_AVG_SHIFT;
-	*yValue >>= ADXL_AVG_SHIFT;
-	*zValue >>= ADXL_AVG_SHIFT;
+	//decode and sum the whole block, then divide the sums to average out (whole and fine values)
+	decodeBlock(_fifoWords, _depth, _block, sums);
+	*xValue = average(sums[X_AXIS]);
+	*yValue = average(sums[Y_AXIS]);
+	*zValue = average(sums[Z_AXIS]);
+	for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++)
+		_blockFine[axis] = fineAverage(sums[axis]);
 
 	return (ERR_SUCCESS);
 }
 
+/**
+ * @brief Decode a block of raw samples, store them minus their offsets, and sum them per axis
+ * @details Each sample is made of three little-endian 16-bit values (X, Y, Z), so two samples fill three words
+ * 			(X0 Y0, Z0 X1, Y1 Z1, low half first) : each word load gives two values at once.
+ * 			The sums are kept on 32 bits, which can not overflow whatever the range and the number of samples.
+ *
+ * @param words Raw samples, as read from the data registers
+ * @param nbSamples Number of samples in the block (ADXL_MAX_AVERAGING at most)
+ * @param[out] block Samples minus their offsets, per axis
+ * @param[out] sums Sums of the samples minus their offsets, per axis
+ */
+static void decodeBlock(const uint32_t words[], uint8_t nbSamples, int16_t block[NB_AXIS][ADXL_MAX_AVERAGING], int32_t sums[NB_AXIS]){
+	const int16_t xOffset = _offsets[X_AXIS], yOffset = _offsets[Y_AXIS], zOffset = _offsets[Z_AXIS];
+	int32_t xSum = 0, ySum = 0, zSum = 0;
+	uint8_t i = 0;
+
+	//two samples per three words
+	for( ; (uint8_t)(i + 1U) < nbSamples ; i = (uint8_t)(i + 2U)){
+		const uint32_t first = words[0], middle = words[1], last = words[2];
+
+		block[X_AXIS][i]		= (int16_t)((int16_t)first - xOffset);
+		block[Y_AXIS][i]		= (int16_t)((int16_t)(first >> HALFWORD_SHIFT) - yOffset);
+		block[Z_AXIS][i]		= (int16_t)((int16_t)middle - zOffset);
+		block[X_AXIS][i + 1U]	= (int16_t)((int16_t)(middle >> HALFWORD_SHIFT) - xOffset);
+		block[Y_AXIS][i + 1U]	= (int16_t)((int16_t)last - yOffset);
+		block[Z_AXIS][i + 1U]	= (int16_t)((int16_t)(last >> HALFWORD_SHIFT) - zOffset);
+
+		xSum += block[X_AXIS][i] + block[X_AXIS][i + 1U];
+		ySum += block[Y_AXIS][i] + block[Y_AXIS][i + 1U];
+		zSum += block[Z_AXIS][i] + block[Z_AXIS][i + 1U];
+		words += WORDS_PER_PAIR;
+	}
+
+	//odd number of samples : the last one starts on a word boundary
+	if(i < nbSamples){
+		block[X_AXIS][i] = (int16_t)((int16_t)words[0] - xOffset);
+		block[Y_AXIS][i] = (int16_t)((int16_t)(words[0] >> HALFWORD_SHIFT) - yOffset);
+		block[Z_AXIS][i] = (int16_t)((int16_t)words[1] - zOffset);
+
+		xSum += block[X_AXIS][i];
+		ySum += block[Y_AXIS][i];
+		zSum += block[Z_AXIS][i];
+	}
+
+	sums[X_AXIS] = xSum;
+	sums[Y_AXIS] = ySum;
+	sums[Z_AXIS] = zSum;
+}
+
 
 /********************************************************************************************************************************************/
 /********************************************************************************************************************************************/
@@ -344,11 +956,15 @@ errorCode_u integrateFIFO(int16_t* xValue, int16_t* yValue, int16_t* zValue){
  * @retval 0 Success
  * @retval 1 No SPI handle has been specified
  * @retval 2 Unable to read device ID
- * @retval 3 Device ID invalid
+ * @retval 3 Device ID invalid (read again later)
  */
 errorCode_u stStartup(){
 	uint8_t deviceID = 0;
 
+	//if waiting before reading the device ID again, exit
+	if(adxlTimer_ms)
+		return (ERR_SUCCESS);
+
 	//if no handle specified, go error
 	if(_spiHandle == NULL){
 		_state = stError;
@@ -362,9 +978,95 @@ errorCode_u stStartup(){
 		return (pushErrorCode(_result, STARTUP, 2));
 	}
 
-	//if invalid device ID, go error
-	if(deviceID != ADXL_DEVICE_ID)
+	//if invalid device ID, read it again later
+	if(deviceID != ADXL_DEVICE_ID){
+		adxlTimer_ms = STARTUP_RETRY_MS;
 		return (createErrorCode(STARTUP, 3, ERR_CRITICAL)); 	// @suppress("Avoid magic numbers")
+	}
+
+	//enable the cycles counter used to time the FIFO drains
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	_speedIndex = 0;
+	_nbSPItimings = 0;
+	_bestSpeedIndex = NB_PRESCALERS;
+	_state = stNegotiatingSpeed;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief State in which the fastest reliable SPI bus speed is negotiated
+ * @details Prescalers are tested one per call, from the slowest to the fastest,
+ * 			as long as the resulting clock stays under the ADXL345 maximum frequency.
+ * 			As soon as a bus speed fails, the last reliable one is kept.
+ *
+ * @retval 0 Success
+ * @retval 1 Error while setting a prescaler
+ * @retval 2 No reliable bus speed found
+ * @retval 3 Error while clearing the scratch register
+ * @retval 4 Error while reading the scratch register back
+ * @retval 5 Scratch register not cleared
+ */
+errorCode_u stNegotiatingSpeed(){
+	adxlSPItiming_t* timing = &_spiTimings[_speedIndex];
+	errorCode_u verification;
+	uint8_t scratch = 0xFFU;
+
+	//if all the bus speeds under the ADXL maximum have been tested, exit negotiation
+	if((_speedIndex < NB_PRESCALERS) && ((HAL_RCC_GetPCLK2Freq() / (PRESCALER_MAX >> _speedIndex)) <= SPI_MAX_FREQ_HZ)){
+		//set the bus speed to test
+		_result = setSPIprescaler(_speedIndex);
+		if(IS_ERROR(_result)){
+			_state = stError;
+			return (pushErrorCode(_result, NEGOTIATE_SPEED, 1));
+		}
+
+		//test it and store the results
+		timing->prescaler = spiPrescalers[_speedIndex];
+		timing->frequency_Hz = HAL_RCC_GetPCLK2Freq() / (PRESCALER_MAX >> _speedIndex);
+		timing->drainTime_us = 0;
+		verification = verifyBusSpeed(&timing->drainTime_us);
+		timing->reliable = IS_SUCCESS(verification);
+		_nbSPItimings++;
+
+		//if reliable, try the next faster bus speed
+		if(timing->reliable){
+			_bestSpeedIndex = _speedIndex++;
+			return (ERR_SUCCESS);
+		}
+	}
+
+	//if no reliable bus speed found, error
+	if(_bestSpeedIndex >= NB_PRESCALERS){
+		_state = stError;
+		return (createErrorCode(NEGOTIATE_SPEED, 2, ERR_CRITICAL));
+	}
+
+	//fall back on the fastest reliable bus speed
+	_result = setSPIprescaler(_bestSpeedIndex);
+	if(IS_ERROR(_result)){
+		_state = stError;
+		return (pushErrorCode(_result, NEGOTIATE_SPEED, 1));
+	}
+
+	//clear the scratch register, which still holds a pattern if the last bus speed tested has been rejected
+	_result = writeRegister(OFFSET_X, 0x00U);
+	if(IS_ERROR(_result)){
+		_state = stError;
+		return (pushErrorCode(_result, NEGOTIATE_SPEED, 3)); 	// @suppress("Avoid magic numbers")
+	}
+
+	_result = readRegisters(OFFSET_X, &scratch, 1);
+	if(IS_ERROR(_result)){
+		_state = stError;
+		return (pushErrorCode(_result, NEGOTIATE_SPEED, 4)); 	// @suppress("Avoid magic numbers")
+	}
+	if(scratch){
+		_state = stError;
+		return (createErrorCode(NEGOTIATE_SPEED, 5, ERR_CRITICAL)); 	// @suppress("Avoid magic numbers")
+	}
 
 	_state = stConfiguring;
 	return (ERR_SUCCESS);
@@ -408,6 +1110,8 @@ errorCode_u stConfiguring(){
  * @retval 2 Error while integrating the FIFOs
  */
 errorCode_u stSelfTestingOFF(){
+	int16_t xValue, yValue, zValue;
+
 	//if timeout, go error
 	if(!adxlTimer_ms){
 		_state = stError;
@@ -415,15 +1119,16 @@ errorCode_u stSelfTestingOFF(){
 	}
 
 	//if watermark interrupt not fired, exit
-	if(!adxlINT1occurred)
+	if(!eventTestAndClear(&adxlEvents, ADXL_EVENT_INT1))
 		return (ERR_SUCCESS);
 
 	//retrieve the integrated measurements
-	_result = integrateFIFO(&_finalValues[X_AXIS].current, &_finalValues[Y_AXIS].current, &_finalValues[Z_AXIS].current);
+	_result = integrateFIFO(&xValue, &yValue, &zValue);
 	if(IS_ERROR(_result)){
 		_state = stError;
 		return (pushErrorCode(_result, SELF_TESTING_OFF, 2));
 	}
+	publishValues(xValue, yValue, zValue);
 
 	//get to next state
 	_state = stEnablingST;
@@ -465,12 +1170,13 @@ errorCode_u stEnablingST(){
  * @return 1 Error while re-enabling FIFOs
  */
 errorCode_u stWaitingForSTenabled(){
-	if(!adxlTimer_ms)
+	//if still waiting for the self-test to settle, exit
+	if(adxlTimer_ms)
 		return (ERR_SUCCESS);
 
 	//enable FIFOs
-	adxlINT1occurred = 0;
-	_result = writeRegister(FIFO_CONTROL, ADXL_MODE_FIFO | ADXL_TRIGGER_INT1 | (ADXL_AVG_SAMPLES - 1));
+	flushINT1edges();
+	_result = writeRegister(FIFO_CONTROL, fifoControl(_depth));
 	if(IS_ERROR(_result)){
 		_state = stError;
 		return (pushErrorCode(_result, SELF_TEST_WAIT, 1)); 	// @suppress("Avoid magic numbers")
@@ -490,6 +1196,7 @@ errorCode_u stWaitingForSTenabled(){
  * @retval 2 Error while integrating the FIFOs
  * @retval 3 Error while resetting the data format
  * @retval 4 Self-test values out of range
+ * @retval 5 Error while enabling the tap interrupts
  */
 errorCode_u stSelfTestingON(){
 	int16_t _finalXSTon = 0;
@@ -503,11 +1210,10 @@ errorCode_u stSelfTestingON(){
 	}
 
 	//if watermark interrupt not fired, exit
-	if(!adxlINT1occurred)
+	if(!eventTestAndClear(&adxlEvents, ADXL_EVENT_INT1))
 		return (ERR_SUCCESS);
 
 	//integrate the FIFOs
-	adxlINT1occurred = 0;
 	_result = integrateFIFO(&_finalXSTon, &_finalYSTon, &_finalZSTon);
 	if(IS_ERROR(_result)){
 		_state = stError;
@@ -535,6 +1241,13 @@ errorCode_u stSelfTestingON(){
 		return (pushErrorCode(_result, SELF_TESTING_ON, 4)); 	// @suppress("Avoid magic numbers")
 	}
 
+	//enable the tap detection along with the watermark
+	_result = writeRegister(INTERRUPT_ENABLE, interruptsMeasuring);
+	if(IS_ERROR(_result)){
+		_state = stError;
+		return (pushErrorCode(_result, SELF_TESTING_ON, 5)); 	// @suppress("Avoid magic numbers")
+	}
+
 	//reset timer and get to next state
 	adxlTimer_ms = INT_TIMEOUT_MS;
 	_state = stMeasuring;
@@ -547,30 +1260,93 @@ errorCode_u stSelfTestingON(){
  * @retval 0 Success
  * @retval 1 Timeout occurred while waiting for watermark interrupt
  * @retval 2 Error occurred while integrating the FIFOs
+ * @retval 3 Error occurred while applying a new output data rate or averaging depth
+ * @retval 4 Error occurred while reading the interrupt sources
+ * @retval 5 Error occurred while enabling or disabling the activity detection
  */
 errorCode_u stMeasuring(){
+	uint32_t edgeTimestamp_us;
+	int16_t xValue, yValue, zValue;
+	uint8_t sources;
+
 	//if timeout, go error
 	if(!adxlTimer_ms){
 		_state = stError;
 		return (createErrorCode(MEASURE, 1, ERR_ERROR));
 	}
 
-	//if watermark interrupt not fired, exit
-	if(!adxlINT1occurred)
+	//if a new output data rate or averaging depth has been requested, apply it
+	if((_requestedRate != _dataRate) || (_requestedDepth != _depth)){
+		adxlTimer_ms = INT_TIMEOUT_MS;
+		_result = applySettings();
+		if(IS_ERROR(_result)){
+			_state = stError;
+			return (pushErrorCode(_result, MEASURE, 3)); 	// @suppress("Avoid magic numbers")
+		}
 		return (ERR_SUCCESS);
+	}
 
-	//reset flags
-	adxlTimer_ms = INT_TIMEOUT_MS;
-	adxlINT1occurred = 0;
+	//if the activity detection has been requested or cancelled, apply it (the position is then taken as reference)
+	if(_activityRequested != _activityWatched){
+		_result = writeRegister(ACTIVITY_CONTROL, (_activityRequested ? ACT_AXES_WATCHED : ADXL_ACT_DISABLED));
+		if(IS_ERROR(_result)){
+			_state = stError;
+			return (pushErrorCode(_result, MEASURE, 5)); 	// @suppress("Avoid magic numbers")
+		}
+		_activityWatched = _activityRequested;
+	}
 
-	//integrate the FIFOs
-	_result = integrateFIFO(&_finalValues[X_AXIS].current, &_finalValues[Y_AXIS].current, &_finalValues[Z_AXIS].current);
+	//if no interrupt fired, exit (flag atomically cleared, a new edge raises it again)
+	if(!eventTestAndClear(&adxlEvents, ADXL_EVENT_INT1))
+		return (ERR_SUCCESS);
+
+	//keep the latest edge timestamp (now if serviced again without a new edge)
+	edgeTimestamp_us = timestampGet_us();
+	while(spscPop(&adxlINT1edges, &edgeTimestamp_us));
+
+	//read the interrupt sources (clears the tap events)
+	_result = readRegisters(INTERRUPT_SOURCE, &sources, 1);
 	if(IS_ERROR(_result)){
 		_state = stError;
-		return (pushErrorCode(_result, MEASURE, 2));
+		return (pushErrorCode(_result, MEASURE, 4)); 	// @suppress("Avoid magic numbers")
 	}
 
-	_measurementsUpdated = 1;
+	//decode the tap gestures (a single tap is held until no double tap can follow, and dropped if one does)
+	if(sources & ADXL_INT_DOUBLETAP){
+		_singleTapPending = 0;
+		_gesture = SENSOR_DOUBLE_TAP;
+	}
+	else if(sources & ADXL_INT_SINGLETAP){
+		_singleTapPending = 1;
+		_singleTap_us = edgeTimestamp_us;
+	}
+
+	//a motion is reported once, the detection being disabled until requested again
+	if((sources & ADXL_INT_ACTIVITY) && _activityWatched){
+		_activity = 1;
+		_activityRequested = 0;
+	}
+
+	//if watermark reached, integrate the FIFOs
+	if(sources & ADXL_INT_WATERMARK){
+		adxlTimer_ms = INT_TIMEOUT_MS;
+		tracerTag(edgeTimestamp_us);
+		_result = integrateFIFO(&xValue, &yValue, &zValue);
+		if(IS_ERROR(_result)){
+			_state = stError;
+			return (pushErrorCode(_result, MEASURE, 2));
+		}
+		publishValues(xValue, yValue, zValue);
+		tracerMark(TRACE_INTEGRATED);
+
+		updateBlockTiming(edgeTimestamp_us);
+		_measurementsUpdated = 1;
+	}
+
+	//if INT1 is still asserted (source raised in the meantime), no new edge will come : service it again
+	if(HAL_GPIO_ReadPin(ADXL_INT1_GPIO_Port, ADXL_INT1_Pin) == GPIO_PIN_RESET)
+		eventSet(&adxlEvents, ADXL_EVENT_INT1);
+
 	return (ERR_SUCCESS);
 }
 
@@ -0,0 +1,191 @@
+/**
+ * @file analog.c
+ * @brief Implement the background acquisition of the battery voltage and the die temperature via ADC and DMA
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * ADC1 continuously scans the internal reference voltage, the internal temperature sensor
+ * and the battery voltage divider, and the DMA transfers the results in a circular buffer.
+ * Each time half of the buffer is filled, the DMA callbacks average it per channel
+ * and low-pass filter the averages, without any CPU time spent in the acquisition loop.
+ *
+ * The filtered raw values are published under a sequence lock : readers copy them
+ * and retry if the callbacks wrote them in the meantime, so no interrupt needs to be masked.
+ * Conversions to voltages and temperature are done by the reader.
+ *
+ * The internal reference voltage is used to cancel out the supply voltage variations.
+ *
+ * @note Reference manual RM0008 : section 11.10 (temperature sensor),
+ * 		 datasheet DS5319 : section 5.3.19 (V25 and average slope typical values)
+ */
+#include "analog.h"
+#include "main.h"
+#include "concurrency.h"
+
+//definitions
+#define SEQUENCES_PER_HALF		32U			///< Number of scan sequences in each half of the DMA buffer
+#define SEQUENCES_SHIFT			5U			///< Shift dividing a sum by SEQUENCES_PER_HALF
+#define FILTER_SHIFT			4U			///< Shift applied to the low-pass filters coefficient
+#define ADC_FULL_SCALE			4095U		///< Raw value of a full-scale conversion
+#define VREFINT_MV				1200U		///< Internal reference voltage (in mV)
+#define VREFINT_UV				1200000U	///< Internal reference voltage (in uV)
+#define V25_UV					1430000		///< Temperature sensor voltage at 25 degrees (in uV)
+#define SLOPE_UV_PER_DC			430			///< Temperature sensor average slope (in uV per tenth of degree)
+#define TEMPERATURE_25_DC		250			///< 25 degrees, in tenths of degrees
+#define BATTERY_DIVIDER			2U			///< Ratio of the battery voltage divider
+#define BATTERY_EMPTY_MV		3300U		///< Battery voltage considered empty (in mV)
+#define BATTERY_FULL_MV			4200U		///< Battery voltage considered full (in mV)
+#define PERCENT					100U		///< 100 %
+
+/**
+ * @brief Enumeration of the function IDs of the analog acquisitions
+ */
+typedef enum _analogFunctionCodes_e{
+	INIT = 0,	///< analogInitialise()
+	GET_VALUES,	///< analogGetValues()
+}analogFunctionCodes_e;
+
+/**
+ * @brief Enumeration of the channels in the scan sequence
+ */
+typedef enum{
+	VREFINT_INDEX = 0,	///< Internal reference voltage
+	TEMPERATURE_INDEX,	///< Internal temperature sensor
+	BATTERY_INDEX,		///< Battery voltage divider
+	NB_CHANNELS
+}analogChannels_e;
+
+//tool functions
+static void averageHalf(const uint16_t half[SEQUENCES_PER_HALF][NB_CHANNELS]);
+
+//state variables
+static ADC_HandleTypeDef*	_adcHandle = NULL;		///< ADC handle used
+static uint16_t				_buffer[2][SEQUENCES_PER_HALF][NB_CHANNELS];	///< DMA circular buffer, in two halves
+static uint32_t				_filtered[NB_CHANNELS];	///< Filtered raw values published by the callbacks, per channel (scaled by 2^FILTER_SHIFT)
+static seqlock_t			_filteredLock;			///< Sequence lock protecting the filtered raw values
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Calibrate the ADC and start the continuous acquisitions
+ *
+ * @param handle ADC handle used
+ * @retval 0 Success
+ * @retval 1 Error while calibrating the ADC
+ * @retval 2 Error while starting the acquisitions
+ */
+errorCode_u analogInitialise(const ADC_HandleTypeDef* handle){
+	HAL_StatusTypeDef HALresult;
+
+	_adcHandle = (ADC_HandleTypeDef*)handle;
+
+	//calibrate the ADC before any conversion
+	HALresult = HAL_ADCEx_Calibration_Start(_adcHandle);
+	if(HALresult != HAL_OK)
+		return (createErrorCodeLayer1(INIT, 1, HALresult, ERR_ERROR));
+
+	//start the continuous scan, in circular DMA mode
+	HALresult = HAL_ADC_Start_DMA(_adcHandle, (uint32_t*)_buffer, sizeof(_buffer) / sizeof(uint16_t));
+	if(HALresult != HAL_OK)
+		return (createErrorCodeLayer1(INIT, 2, HALresult, ERR_ERROR));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Get the latest filtered values
+ * @details Vx = Vrefint * rawX / rawVrefint, which cancels out the supply voltage
+ *
+ * @param[out] values Latest filtered values
+ * @retval 0 Success
+ * @retval 1 No values available yet
+ */
+errorCode_u analogGetValues(analogValues_t* values){
+	uint32_t filtered[NB_CHANNELS];
+	uint32_t sequence;
+	int32_t sense_uV;
+	uint32_t battery_mV;
+
+	//copy the snapshot, and retry if the callbacks updated it in the meantime
+	do{
+		sequence = seqlockReadBegin(&_filteredLock);
+		for(uint8_t i = 0 ; i < NB_CHANNELS ; i++)
+			filtered[i] = _filtered[i];
+	}while(seqlockReadRetry(&_filteredLock, sequence));
+
+	if(!filtered[VREFINT_INDEX])
+		return (createErrorCode(GET_VALUES, 1, ERR_WARNING));
+
+	//compute the voltages (all the values share the same scale, so it cancels out)
+	values->supply_mV = (uint16_t)((VREFINT_MV * ADC_FULL_SCALE * (1U << FILTER_SHIFT)) / filtered[VREFINT_INDEX]);
+	battery_mV = (VREFINT_MV * BATTERY_DIVIDER * filtered[BATTERY_INDEX]) / filtered[VREFINT_INDEX];
+	values->battery_mV = (uint16_t)battery_mV;
+
+	//compute the battery charge estimation
+	if(battery_mV <= BATTERY_EMPTY_MV)
+		values->batteryPercent = 0;
+	else if(battery_mV >= BATTERY_FULL_MV)
+		values->batteryPercent = PERCENT;
+	else
+		values->batteryPercent = (uint8_t)(((battery_mV - BATTERY_EMPTY_MV) * PERCENT) / (BATTERY_FULL_MV - BATTERY_EMPTY_MV));
+
+	//compute the temperature
+	sense_uV = (int32_t)(((uint64_t)VREFINT_UV * filtered[TEMPERATURE_INDEX]) / filtered[VREFINT_INDEX]);
+	values->temperature_dC = (int16_t)(((V25_UV - sense_uV) / SLOPE_UV_PER_DC) + TEMPERATURE_25_DC);
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Callback triggered by the DMA once the first half of the buffer is filled
+ *
+ * @param hadc ADC handle which triggered the callback
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc){
+	if(hadc == _adcHandle)
+		averageHalf(_buffer[0]);
+}
+
+/**
+ * @brief Callback triggered by the DMA once the second half of the buffer is filled
+ *
+ * @param hadc ADC handle which triggered the callback
+ */
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc){
+	if(hadc == _adcHandle)
+		averageHalf(_buffer[1]);
+}
+
+/**
+ * @brief Average a half of the DMA buffer per channel, then filter and publish the averages
+ * @note Runs in the DMA interrupt, while the DMA fills the other half
+ *
+ * @param half Half of the buffer to average
+ */
+static void averageHalf(const uint16_t half[SEQUENCES_PER_HALF][NB_CHANNELS]){
+	static uint8_t seeded = 0;
+	uint32_t sums[NB_CHANNELS] = {0};
+
+	for(uint8_t sequence = 0 ; sequence < SEQUENCES_PER_HALF ; sequence++){
+		for(uint8_t channel = 0 ; channel < NB_CHANNELS ; channel++)
+			sums[channel] += half[sequence][channel];
+	}
+
+	//publish the filtered averages
+	seqlockWriteBegin(&_filteredLock);
+	for(uint8_t channel = 0 ; channel < NB_CHANNELS ; channel++){
+		uint32_t average = (sums[channel] >> SEQUENCES_SHIFT) << FILTER_SHIFT;
+
+		if(seeded)
+			_filtered[channel] = _filtered[channel] - (_filtered[channel] >> FILTER_SHIFT) + (average >> FILTER_SHIFT);
+		else
+			_filtered[channel] = average;
+	}
+	seqlockWriteEnd(&_filteredLock);
+
+	seeded = 1;
+}
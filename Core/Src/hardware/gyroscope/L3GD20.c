@@ -0,0 +1,357 @@
+/**
+ * @file L3GD20.c
+ * @brief Implement the L3GD20 gyroscope communication
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The gyroscope is optional (USE_GYRO builds) : it shares SPI1 with the ADXL345, on its own chip select (GYRO_CS).
+ * Both are SPI mode 3, and the bus speed negotiated by the ADXL345 (5 MHz at most) suits the L3GD20 (10 MHz at most).
+ * The tasks run to completion, so the two drivers never interleave their transfers.
+ *
+ * The rates are sampled at 190 Hz, 250 dps full scale, and buffered in the 32 entries FIFO in stream mode :
+ * each update drains the samples stored since the previous one, so the scheduling jitter does not lose any
+ * as long as the FIFO is drained at least every 160 ms.
+ *
+ * If the device does not answer with a known identity, it is considered absent and the driver stays idle.
+ *
+ * @note Datasheet : https://www.st.com/resource/en/datasheet/l3gd20.pdf
+ */
+#include "L3GD20.h"
+#include "L3GD20registers.h"
+#include "main.h"
+
+//definitions
+#define SPI_TIMEOUT_MS	10U		///< SPI direct transmission timeout span in milliseconds
+#define NB_REG_INIT		4U		///< Number of registers configured at initialisation
+#define BYTE_SHIFT		8U		///< Number of bits in a byte
+
+/**
+ * @brief Enumeration of the function IDs of the L3GD20
+ */
+typedef enum _L3GDfunctionCodes_e{
+	INIT = 0,			///< L3GD20initialise()
+	STARTUP,			///< stStartup()
+	CONFIGURE,			///< stConfiguring()
+	MEASURE,			///< stMeasuring()
+	WRITE_REGISTER,		///< writeRegister()
+	READ_REGISTERS,		///< readRegisters()
+}L3GDfunctionCodes_e;
+
+/**
+ * @brief SPI CS pin status enumeration
+ */
+typedef enum{
+	DISABLED = 0,
+	ENABLED,
+}spiStatus_e;
+
+/**
+ * @brief State machine state prototype
+ *
+ * @return Error code of the state
+ */
+typedef errorCode_u (*l3gdState)();
+
+//machine state
+static errorCode_u stStartup();
+static errorCode_u stConfiguring();
+static errorCode_u stMeasuring();
+static errorCode_u stAbsent();
+static errorCode_u stError();
+
+//manipulation functions
+static errorCode_u writeRegister(l3gd20Registers_e registerNumber, uint8_t value);
+static errorCode_u readRegisters(l3gd20Registers_e firstRegister, uint8_t* value, uint8_t size);
+static inline void setSPIstatus(spiStatus_e value);
+
+//initialisation values
+static const uint8_t initialisationArray[NB_REG_INIT][2] = {
+	{CTRL_REG4,		L3GD_RANGE_250DPS},
+	{CTRL_REG5,		L3GD_FIFO_ENABLE},
+	{FIFO_CTRL_REG,	L3GD_MODE_STREAM},
+	{CTRL_REG1,		L3GD_ODR_190HZ | L3GD_BANDWIDTH_LOW | L3GD_POWER_NORMAL | L3GD_AXES_ENABLED},
+};
+
+//state variables
+static SPI_HandleTypeDef*	_spiHandle = NULL;		///< SPI handle used with the L3GD20
+static l3gdState			_state = stStartup;		///< State machine current state
+static errorCode_u			_result;				///< Variables used to store error codes
+static int16_t				_samples[L3GD_FIFO_SIZE][L3GD_NB_AXIS];	///< Rates drained from the FIFO during the last update, per sample
+static uint8_t				_nbSamples = 0;			///< Number of samples drained and not retrieved yet
+static uint32_t				_lostSamples = 0;		///< Number of FIFO overruns detected since startup
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Initialise the L3GD20
+ *
+ * @param handle SPI handle used (shared with the ADXL345)
+ * @retval 0 Success
+ * @retval 1 No handle given
+ */
+errorCode_u L3GD20initialise(const SPI_HandleTypeDef* handle){
+	if(!handle)
+		return (createErrorCode(INIT, 1, ERR_CRITICAL));
+
+	_spiHandle = (SPI_HandleTypeDef*)handle;
+	_state = stStartup;
+	_nbSamples = 0;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Run the state machine
+ *
+ * @return Return code of the current state
+ */
+errorCode_u L3GD20update(){
+	return ((*_state)());
+}
+
+/**
+ * @brief Check if a gyroscope answered during startup
+ *
+ * @retval 0 Gyroscope absent, not identified yet or in error
+ * @retval 1 Gyroscope measuring
+ */
+uint8_t L3GD20isPresent(){
+	return (_state == stMeasuring);
+}
+
+/**
+ * @brief Retrieve the samples drained during the last update
+ * @note The samples stay valid until the next update
+ *
+ * @param[out] samples Rates of each sample (X, Y, Z, in LSB)
+ * @return Number of new samples (0 if already retrieved)
+ */
+uint8_t L3GD20getSamples(const int16_t (**samples)[L3GD_NB_AXIS]){
+	uint8_t nbSamples = _nbSamples;
+
+	*samples = _samples;
+	_nbSamples = 0;
+	return (nbSamples);
+}
+
+/**
+ * @brief Get the number of FIFO overruns detected since startup
+ *
+ * @return Number of overruns (at least one sample lost each)
+ */
+uint32_t L3GD20getLostSamples(){
+	return (_lostSamples);
+}
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Write a single register on the L3GD20
+ *
+ * @param registerNumber Register number
+ * @param value Register value
+ * @retval 0 Success
+ * @retval 1 No SPI handle set
+ * @retval 2 Error while writing the command
+ * @retval 3 Error while writing the value
+ */
+static errorCode_u writeRegister(l3gd20Registers_e registerNumber, uint8_t value){
+	HAL_StatusTypeDef HALresult;
+	errorCode_u ret = ERR_SUCCESS;
+	uint8_t instruction = L3GD_WRITE | L3GD_SINGLE | registerNumber;
+
+	//if handle not set, error
+	if(_spiHandle == NULL)
+		return (createErrorCode(WRITE_REGISTER, 1, ERR_CRITICAL));
+
+	setSPIstatus(ENABLED);
+
+	//transmit the write instruction
+	HALresult = HAL_SPI_Transmit(_spiHandle, &instruction, 1, SPI_TIMEOUT_MS);
+	if(HALresult != HAL_OK){
+		setSPIstatus(DISABLED);
+		return (createErrorCodeLayer1(WRITE_REGISTER, 2, HALresult, ERR_ERROR));
+	}
+
+	//transmit the value
+	HALresult = HAL_SPI_Transmit(_spiHandle, &value, 1, SPI_TIMEOUT_MS);
+	if(HALresult != HAL_OK)
+		ret = createErrorCodeLayer1(WRITE_REGISTER, 3, HALresult, ERR_ERROR); 	// @suppress("Avoid magic numbers")
+
+	setSPIstatus(DISABLED);
+	return (ret);
+}
+
+/**
+ * @brief Read several consecutive registers on the L3GD20
+ *
+ * @param firstRegister Number of the first register to read
+ * @param[out] value Registers value array
+ * @param size Number of registers to read
+ * @retval 0 Success
+ * @retval 1 No SPI handle set
+ * @retval 2 Error while writing the command
+ * @retval 3 Error while reading the values
+ */
+static errorCode_u readRegisters(l3gd20Registers_e firstRegister, uint8_t* value, uint8_t size){
+	HAL_StatusTypeDef HALresult;
+	errorCode_u ret = ERR_SUCCESS;
+	uint8_t instruction = L3GD_READ | L3GD_MULTIPLE | firstRegister;
+
+	//if handle not set, error
+	if(_spiHandle == NULL)
+		return (createErrorCode(READ_REGISTERS, 1, ERR_CRITICAL));
+
+	setSPIstatus(ENABLED);
+
+	//transmit the read instruction
+	HALresult = HAL_SPI_Transmit(_spiHandle, &instruction, 1, SPI_TIMEOUT_MS);
+	if(HALresult != HAL_OK){
+		setSPIstatus(DISABLED);
+		return (createErrorCodeLayer1(READ_REGISTERS, 2, HALresult, ERR_ERROR));
+	}
+
+	//receive the reply
+	HALresult = HAL_SPI_Receive(_spiHandle, value, size, SPI_TIMEOUT_MS);
+	if(HALresult != HAL_OK)
+		ret = createErrorCodeLayer1(READ_REGISTERS, 3, HALresult, ERR_ERROR); 	// @suppress("Avoid magic numbers")
+
+	setSPIstatus(DISABLED);
+	return (ret);
+}
+
+/**
+ * @brief Set the SPI CS pin to enable/disable a SPI transmission
+ *
+ * @param value New CS pin status
+ */
+static inline void setSPIstatus(spiStatus_e value){
+	HAL_GPIO_WritePin(GYRO_CS_GPIO_Port, GYRO_CS_Pin, (value == ENABLED ? GPIO_PIN_RESET : GPIO_PIN_SET));
+}
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Begin state of the state machine
+ *
+ * @retval 0 Success
+ * @retval 1 No SPI handle has been specified
+ * @retval 2 Unable to read the device identity
+ * @retval 3 Unknown device identity (gyroscope absent)
+ */
+static errorCode_u stStartup(){
+	uint8_t deviceID = 0;
+
+	//if no handle specified, go error
+	if(_spiHandle == NULL){
+		_state = stError;
+		return (createErrorCode(STARTUP, 1, ERR_CRITICAL));
+	}
+
+	//if unable to read the identity, go error
+	_result = readRegisters(WHO_AM_I, &deviceID, 1);
+	if(IS_ERROR(_result)){
+		_state = stError;
+		return (pushErrorCode(_result, STARTUP, 2));
+	}
+
+	//if unknown identity, consider no gyroscope fitted
+	if((deviceID != L3GD_DEVICE_ID) && (deviceID != L3GD_DEVICE_ID_H)){
+		_state = stAbsent;
+		return (createErrorCode(STARTUP, 3, ERR_INFO)); 	// @suppress("Avoid magic numbers")
+	}
+
+	_state = stConfiguring;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief State in which the registers are configured, the device being powered up last
+ *
+ * @retval 0 Success
+ * @retval 1 Error while writing a register
+ */
+static errorCode_u stConfiguring(){
+	for(uint8_t i = 0 ; i < NB_REG_INIT ; i++){
+		_result = writeRegister(initialisationArray[i][0], initialisationArray[i][1]);
+		if(IS_ERROR(_result)){
+			_state = stError;
+			return (pushErrorCode(_result, CONFIGURE, 1));
+		}
+	}
+
+	_state = stMeasuring;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief State in which the samples stored in the FIFO are drained
+ *
+ * @retval 0 Success
+ * @retval 1 Error while reading the FIFO status
+ * @retval 2 Error while reading a sample
+ */
+static errorCode_u stMeasuring(){
+	uint8_t registers[L3GD_NB_DATA_REGISTERS];
+	uint8_t status;
+	uint8_t nbSamples;
+
+	//read the number of samples stored
+	_result = readRegisters(FIFO_SRC_REG, &status, 1);
+	if(IS_ERROR(_result)){
+		_state = stError;
+		return (pushErrorCode(_result, MEASURE, 1));
+	}
+
+	if(status & L3GD_FIFO_EMPTY)
+		return (ERR_SUCCESS);
+
+	//if the FIFO overran, it is full
+	nbSamples = status & L3GD_FIFO_LEVEL;
+	if(status & L3GD_FIFO_OVERRUN){
+		nbSamples = L3GD_FIFO_SIZE;
+		_lostSamples++;
+	}
+
+	//read each sample (the oldest FIFO entry is popped each time the data registers are read)
+	for(uint8_t i = 0 ; i < nbSamples ; i++){
+		_result = readRegisters(OUT_X_L, registers, L3GD_NB_DATA_REGISTERS);
+		if(IS_ERROR(_result)){
+			_state = stError;
+			return (pushErrorCode(_result, MEASURE, 2));
+		}
+
+		for(uint8_t axis = 0 ; axis < L3GD_NB_AXIS ; axis++)
+			_samples[i][axis] = (int16_t)((registers[(axis << 1) + 1U] << BYTE_SHIFT) | registers[axis << 1]);
+	}
+
+	_nbSamples = nbSamples;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief State in which the driver stays idle, no gyroscope being fitted
+ *
+ * @return Success
+ */
+static errorCode_u stAbsent(){
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief State in which the L3GD20 stays in an error state forever
+ *
+ * @return Success
+ */
+static errorCode_u stError(){
+	return (ERR_SUCCESS);
+}
@@ -0,0 +1,457 @@
+/**
+ * @file SH1106.c
+ * @brief Implement the SH1106 OLED screen display backend via SPI and DMA
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The SH1106 only has the page addressing mode, and 132 columns of which the 128 visible ones start at column 2.
+ * A region is then streamed one page at a time : the page and column addresses are sent in a single command transfer,
+ * followed by a DMA transfer of the page bytes. The next page is chained as soon as the previous transfer ends,
+ * without waiting for the next update.
+ * As the address commands come between the pages, the DMA can not run in circles : the two halves of the streaming buffer
+ * are sent in turn, and the transfer-complete interrupt renders the page after next in the half just sent.
+ *
+ * The contrast and power changes are queued, and sent in a single DMA command transfer from the next update.
+ *
+ * @note Datasheet : https://www.velleman.eu/downloads/29/infosheets/sh1106_datasheet.pdf
+ */
+#include "SH1106.h"
+#include "SH1106_registers.h"
+#include "main.h"
+#include "tracer.h"
+
+//definitions
+#define SPI_TIMEOUT_MS		10U		///< Maximum number of milliseconds SPI traffic should last before timeout
+#define COLUMN_OFFSET		2U		///< RAM column shown on the first visible column (132 columns centred on 128)
+#define NB_ADDRESS_BYTES	3U		///< Number of command bytes setting the page and column addresses
+#define NB_INIT_BYTES		6U		///< Number of command bytes sent at initialisation
+#define MAX_QUEUED_BYTES	3U		///< Maximum number of command bytes queued for a DMA transfer
+
+/**
+ * @brief Enumeration of the function IDs of the SH1106
+ */
+typedef enum _SH1106functionCodes_e{
+	INIT = 0,		///< SH1106initialise()
+	SEND_CMD,		///< sendCommands()
+	SET_WINDOW,		///< SH1106setWindow()
+	SENDING_PAGE,	///< stSendingPage()
+	WAITING_DMA_RDY,///< stWaitingForTXdone()
+	STREAM,			///< SH1106stream()
+	SET_INVERTED,	///< SH1106setInverted()
+	SET_CONTRAST,	///< SH1106setContrast()
+	SET_POWER,		///< SH1106setPower()
+	SENDING_CMDS,	///< stSendingCommands()
+}_SH1106functionCodes_e;
+
+/**
+ * @brief SPI CS pin status enumeration
+ */
+typedef enum{
+	DISABLED = 0,
+	ENABLED,
+}spiStatus_e;
+
+/**
+ * @brief SPI Data/command pin status enumeration
+ */
+typedef enum{
+	COMMAND = 0,
+	DATA,
+}dataStatus_e;
+
+/**
+ * @brief Screen state machine state prototype
+ *
+ * @return Return code of the state
+ */
+typedef errorCode_u (*screenState)();
+
+//communication functions with the SH1106
+static inline void setSPIstatus(spiStatus_e value);
+static inline void setDataStatus(dataStatus_e value);
+static errorCode_u sendCommands(const uint8_t commands[], uint8_t nbBytes);
+
+//state machine
+static errorCode_u stIdle();
+static errorCode_u stSendingPage();
+static errorCode_u stSendingCommands();
+static errorCode_u stWaitingForTXdone();
+
+static const uint8_t initCommands[NB_INIT_BYTES] = {	///< Commands (and parameters) used to initialise the registers
+		SH_SCAN_DIRECTION_N1_0,
+		SH_SEGMENT_REMAP_131,
+		SH_CONTRAST_CONTROL,	SH_CONTRAST_HIGHEST,
+		SH_DC_DC_CONTROL,		SH_DC_DC_ON,
+};
+
+//state variables
+static SPI_HandleTypeDef*	_SH_SPIhandle = NULL;			///< SPI handle used with the SH1106
+static screenState			_state = stIdle;				///< State machine current state
+static displaySource		_source = NULL;					///< Function rendering the pages of the region
+static displayWindow_t		_window;						///< Region to stream (first page updated as pages are sent)
+static uint8_t				_pageSize;						///< Number of bytes in a page of the region
+static uint8_t				_nbPages;						///< Number of pages in the region
+static uint8_t				_page;							///< Page of the region being sent
+static uint8_t				_buffer[2U * DISPLAY_CHUNK_SIZE];	///< Streaming buffer, in two halves of a region page each
+static uint8_t				_commands[MAX_QUEUED_BYTES];	///< Command bytes queued for a DMA transfer
+static uint8_t				_nbCommands;					///< Number of command bytes queued
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Initialise the SH1106
+ *
+ * @param handle SPI handle used
+ * @retval 0 Success
+ * @retval 1 Error while initialising the registers
+ * @retval 2 Error while turning the display on
+ */
+errorCode_u SH1106initialise(SPI_HandleTypeDef* handle){
+	const uint8_t displayOn = SH_DISPLAY_ON;
+	errorCode_u result;
+	_SH_SPIhandle = handle;
+
+	//make sure to disable SH1106 SPI communication
+	setSPIstatus(DISABLED);
+
+	//reset the chip
+	HAL_GPIO_WritePin(SSD1306_RST_GPIO_Port, SSD1306_RST_Pin, GPIO_PIN_RESET);
+	HAL_GPIO_WritePin(SSD1306_RST_GPIO_Port, SSD1306_RST_Pin, GPIO_PIN_SET);
+
+	//set the orientation and contrast, then make sure the DC-DC converter is on before turning the display on
+	//	values which don't change from reset values aren't modified
+	result = sendCommands(initCommands, NB_INIT_BYTES);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, INIT, 1));
+
+	result = sendCommands(&displayOn, 1);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, INIT, 2));		// @suppress("Avoid magic numbers")
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * brief Set the SPI CS pin to enable/disable a SPI transmission
+ *
+ * @param value New CS pin status
+ */
+static inline void setSPIstatus(spiStatus_e value){
+	HAL_GPIO_WritePin(SSD1306_CS_GPIO_Port, SSD1306_CS_Pin, (value == ENABLED ? GPIO_PIN_RESET : GPIO_PIN_SET));
+}
+
+/**
+ * brief Set the Data/Command pin
+ *
+ * @param value Value of the data/command pin
+ */
+static inline void setDataStatus(dataStatus_e value){
+	HAL_GPIO_WritePin(SSD1306_DC_GPIO_Port, SSD1306_DC_Pin, (value == COMMAND ? GPIO_PIN_RESET : GPIO_PIN_SET));
+}
+
+/**
+ * @brief Send command bytes (and their parameters) in a single transfer
+ * @note The SH1106 parameters are sent as command bytes, right after their command
+ *
+ * @param commands Command bytes
+ * @param nbBytes Number of command bytes
+ * @retval 0 Success
+ * @retval 1 Error while sending the commands
+ */
+static errorCode_u sendCommands(const uint8_t commands[], uint8_t nbBytes){
+	HAL_StatusTypeDef HALresult;
+
+	setDataStatus(COMMAND);
+	setSPIstatus(ENABLED);
+
+	HALresult = HAL_SPI_Transmit(_SH_SPIhandle, (uint8_t*)commands, nbBytes, SPI_TIMEOUT_MS);
+	setSPIstatus(DISABLED);
+	if(HALresult != HAL_OK)
+		return (createErrorCodeLayer1(SEND_CMD, 1, HALresult, ERR_ERROR));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Point the page and column addresses at the first byte of a region
+ * @note The column address then only moves along the page, the next pages must be pointed at again
+ *
+ * @param window Region in which the next data bytes are written
+ * @retval 0 Success
+ * @retval 1 Error while sending the addresses
+ */
+errorCode_u SH1106setWindow(const displayWindow_t* window){
+	const uint8_t column = (uint8_t)(window->firstColumn + COLUMN_OFFSET);
+	const uint8_t addresses[NB_ADDRESS_BYTES] = {
+		(uint8_t)(SH_PAGE_ADDRESS | (window->firstPage & SH_PAGE_MASK)),
+		(uint8_t)(SH_LOW_COLUMN_ADDR | (column & SH_NIBBLE_MASK)),
+		(uint8_t)(SH_HIGH_COLUMN_ADDR | (column >> SH_NIBBLE_SHIFT)),
+	};
+	errorCode_u result;
+
+	result = sendCommands(addresses, NB_ADDRESS_BYTES);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, SET_WINDOW, 1));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Queue the transfer of a region, rendered and sent page by page from the next update
+ *
+ * @param window Region to stream
+ * @param source Function rendering the pages of the region
+ * @retval 0 Success
+ * @retval 1 Region out of the panel
+ */
+errorCode_u SH1106stream(const displayWindow_t* window, displaySource source){
+	if((window->lastColumn >= SH1106_WIDTH) || (window->firstColumn > window->lastColumn)
+			|| (window->lastPage >= SH1106_NB_PAGES) || (window->firstPage > window->lastPage))
+		return (createErrorCode(STREAM, 1, ERR_WARNING));
+
+	_source = source;
+	_window = *window;
+	_pageSize = (uint8_t)(window->lastColumn - window->firstColumn + 1U);
+	_nbPages = (uint8_t)(window->lastPage - window->firstPage + 1U);
+	_page = 0;
+
+	_state = stSendingPage;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Invert the display (pixels on become off and vice versa)
+ * @note The screen must be ready to accept new commands
+ *
+ * @param inverted 1 to invert the display, 0 to restore it
+ * @retval 0 Success
+ * @retval 1 Error while sending the command
+ */
+errorCode_u SH1106setInverted(uint8_t inverted){
+	const uint8_t command = (inverted ? SH_DISPLAY_INVERSE : SH_DISPLAY_NORMAL);
+	errorCode_u result;
+
+	result = sendCommands(&command, 1);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, SET_INVERTED, 1));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Queue a contrast change, sent from the next update
+ * @note The screen must be ready to accept new commands
+ *
+ * @param contrast New contrast (0 to 255)
+ * @retval 0 Success
+ * @retval 1 Screen busy
+ */
+errorCode_u SH1106setContrast(uint8_t contrast){
+	if(_state != stIdle)
+		return (createErrorCode(SET_CONTRAST, 1, ERR_WARNING));
+
+	_commands[0] = SH_CONTRAST_CONTROL;
+	_commands[1] = contrast;
+	_nbCommands = 2U;
+
+	_state = stSendingCommands;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Queue the panel turning off or on, with its DC-DC converter, sent from the next update
+ * @note The screen must be ready to accept new commands
+ * @note The RAM is kept while the panel is off, so it shows the same image when turned back on
+ *
+ * @param on 1 to turn the DC-DC converter then the panel on, 0 to turn the panel then the DC-DC converter off
+ * @retval 0 Success
+ * @retval 1 Screen busy
+ */
+errorCode_u SH1106setPower(uint8_t on){
+	if(_state != stIdle)
+		return (createErrorCode(SET_POWER, 1, ERR_WARNING));
+
+	if(on){
+		_commands[0] = SH_DC_DC_CONTROL;
+		_commands[1] = SH_DC_DC_ON;
+		_commands[2] = SH_DISPLAY_ON;
+	}
+	else{
+		_commands[0] = SH_DISPLAY_OFF;
+		_commands[1] = SH_DC_DC_CONTROL;
+		_commands[2] = SH_DC_DC_OFF;
+	}
+	_nbCommands = 3U;														// @suppress("Avoid magic numbers")
+
+	_state = stSendingCommands;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Check if the screen is ready to accept new commands
+ *
+ * @return 1 if ready
+ */
+uint8_t SH1106isReady(){
+	return (_state == stIdle);
+}
+
+/**
+ * @brief Check if the state machine has nothing to do until the DMA interrupt or the timer expiry
+ *
+ * @return 1 if idle or waiting for a transmission to end
+ */
+uint8_t SH1106isWaiting(){
+	return ((_state == stIdle) || (_state == stWaitingForTXdone));
+}
+
+/**
+ * @brief Run the state machine
+ *
+ * @return Return code of the current state
+ */
+errorCode_u SH1106update(){
+	return ((*_state)());
+}
+
+/**
+ * @brief Callback triggered by the DMA once a page (or the queued commands) is sent
+ * @details Renders the page after next in the half just sent, while the next page is sent from the other half,
+ * 			and marks the trace once the last page of the region is sent
+ *
+ * @param hspi SPI handle which triggered the callback
+ */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi){
+	if(hspi != _SH_SPIhandle)
+		return;
+
+	if((_page + 2U) < _nbPages)
+		(*_source)(&_buffer[(_page & 1U) * _pageSize], (uint8_t)(_page + 2U));
+	else if((_page + 1U) >= _nbPages)
+		tracerMark(TRACE_DISPLAYED);
+}
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief State in which the screen awaits for commands
+ *
+ * @return Success
+ */
+errorCode_u stIdle(){
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief State in which the next page of the region is sent to the screen
+ *
+ * @retval 0 Success
+ * @retval 1 Error occurred while setting the addresses
+ * @retval 2 Error occurred while sending the data
+ */
+errorCode_u stSendingPage(){
+	errorCode_u result;
+	HAL_StatusTypeDef HALresult;
+
+	//render the first two pages of the region (the next ones are rendered by the transfer-complete interrupt)
+	if(!_page){
+		(*_source)(_buffer, 0);
+		if(_nbPages > 1U)
+			(*_source)(&_buffer[_pageSize], 1);
+	}
+
+	//point at the first column of the page
+	result = SH1106setWindow(&_window);
+	if(IS_ERROR(result)){
+		_state = stIdle;
+		return (pushErrorCode(result, SENDING_PAGE, 1));
+	}
+
+	//set GPIOs
+	setDataStatus(DATA);
+	setSPIstatus(ENABLED);
+
+	//send the page
+	screenTimer_ms = SPI_TIMEOUT_MS;
+	HALresult = HAL_SPI_Transmit_DMA(_SH_SPIhandle, &_buffer[(_page & 1U) * _pageSize], _pageSize);
+	if(HALresult != HAL_OK){
+		_state = stIdle;
+		return (createErrorCodeLayer1(SENDING_PAGE, 2, HALresult, ERR_ERROR)); 	// @suppress("Avoid magic numbers")
+	}
+
+	//get to next
+	_state = stWaitingForTXdone;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief State in which the queued command bytes are sent to the screen
+ *
+ * @retval 0 Success
+ * @retval 1 Error occurred while sending the commands
+ */
+errorCode_u stSendingCommands(){
+	HAL_StatusTypeDef HALresult;
+
+	//make sure the transfer interrupt doesn't render any page
+	_nbPages = 0;
+	_page = 0;
+
+	//set GPIOs
+	setDataStatus(COMMAND);
+	setSPIstatus(ENABLED);
+
+	//send the commands in a single transfer
+	screenTimer_ms = SPI_TIMEOUT_MS;
+	HALresult = HAL_SPI_Transmit_DMA(_SH_SPIhandle, _commands, _nbCommands);
+	if(HALresult != HAL_OK){
+		setSPIstatus(DISABLED);
+		_state = stIdle;
+		return (createErrorCodeLayer1(SENDING_CMDS, 1, HALresult, ERR_ERROR));
+	}
+
+	//get to next
+	_state = stWaitingForTXdone;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief State in which the machine waits for a DMA transmission to end
+ *
+ * @retval 0 Success
+ * @retval 1 Timeout while waiting for transmission to end
+ */
+errorCode_u stWaitingForTXdone(){
+	//if timer elapsed, stop DMA and error
+	if(!screenTimer_ms){
+		setSPIstatus(DISABLED);
+		HAL_SPI_DMAStop(_SH_SPIhandle);
+		_state = stIdle;
+		return (createErrorCode(WAITING_DMA_RDY, 1, ERR_ERROR));
+	}
+
+	//if TX not done yet, exit
+	if(HAL_SPI_GetState(_SH_SPIhandle) != HAL_SPI_STATE_READY)
+		return (ERR_SUCCESS);
+
+	//disable SPI
+	setSPIstatus(DISABLED);
+
+	//if the region is complete, get to idle state
+	if((_page + 1U) >= _nbPages){
+		_state = stIdle;
+		return (ERR_SUCCESS);
+	}
+
+	//chain the next page right away
+	_window.firstPage++;
+	_page++;
+	return (stSendingPage());
+}
@@ -1,33 +1,31 @@
 /**
  * @file SSD1306.c
- * @brief Implement the functioning of the SSD1306 OLED screen via SPI and DMA
+ * @brief Implement the SSD1306 OLED screen display backend via SPI and DMA
  * @author Gilles Henrard
  * @date 17/11/2023
  *
+ * @details
+ * The controller is set in horizontal addressing mode, so a region is streamed
+ * with a single column/page window, whatever its number of pages.
+ * Its pages are then sent one DMA transfer each, in normal mode, the next page being chained as soon as the previous transfer ends,
+ * without waiting for the next update. The GDDRAM address keeps incrementing from one transfer to the next.
+ * The two halves of the streaming buffer are sent in turn, and the transfer-complete interrupt renders the page after next
+ * in the half just sent.
+ *
+ * The contrast and power changes are queued the same way, and sent in a single DMA command transfer from the next update.
+ *
  * @note Datasheet : https://cdn-shop.adafruit.com/datasheets/SSD1306.pdf
  */
 #include "SSD1306.h"
-#include "numbersVerdana16.h"
 #include "SSD1306_registers.h"
 #include "main.h"
+#include "tracer.h"
 
 //definitions
 #define SPI_TIMEOUT_MS		10U		///< Maximum number of milliseconds SPI traffic should last before timeout
 #define MAX_PARAMETERS		6U		///< Maximum number of parameters a command can have
-#define MAX_DATA_SIZE		1024U	///< Maximum data size (128 * 64 bits / 8 bits per bytes)
-#define MIN_ANGLE_DEG		-90.0f	///< Minimum angle allowed (in degrees)
-#define MAX_ANGLE_DEG		90.0f	///< Maximum angle allowed (in degrees)
-#define FLOAT_FACTOR_10		10.0f	///< Factor of 10 used in float calculations
-#define INT_FACTOR_10		10U		///< Factor of 10 used in integer calculations
-#define NEG_THRESHOLD		-0.05f	///< Threshold above which an angle is considered positive (circumvents float incaccuracies)
-#define INDEX_SIGN			0		///< Index of the sign in the angle indexes array
-#define INDEX_TENS			1U		///< Index of the tens in the angle indexes array
-#define INDEX_UNITS			2U		///< Index of the units in the angle indexes array
-#define INDEX_TENTHS		4U		///< Index of the tenths in the angle indexes array
-#define ANGLE_NB_CHARS		6U		///< Number of characters in the angle array
 #define NB_INIT_REGISERS	8U		///< Number of registers set at initialisation
-#define SSD_LAST_COLUMN		127U	///< Index of the highest column
-#define SSD_LAST_PAGE		31U		///< Index of the highest page
+#define MAX_QUEUED_BYTES	3U		///< Maximum number of command bytes queued for a DMA transfer
 
 /**
  * @brief Enumeration of the function IDs of the SSD1306
@@ -35,9 +33,14 @@
 typedef enum _SSD1306functionCodes_e{
 	INIT = 0,		///< SSD1306initialise()
 	SEND_CMD,		///< SSD1306sendCommand()
-	PRT_ANGLE,		///< SSD1306_printAngle()
-	SENDING_DATA,	///< stSendingData()
-	WAITING_DMA_RDY	///< stWaitingForTXdone()
+	SET_WINDOW,		///< SSD1306setWindow()
+	SENDING_PAGE,	///< stSendingPage()
+	WAITING_DMA_RDY,///< stWaitingForTXdone()
+	STREAM,			///< SSD1306stream()
+	SET_INVERTED,	///< SSD1306setInverted()
+	SET_CONTRAST,	///< SSD1306setContrast()
+	SET_POWER,		///< SSD1306setPower()
+	SENDING_CMDS,	///< stSendingCommands()
 }_SSD1306functionCodes_e;
 
 /**
@@ -79,7 +82,8 @@ static errorCode_u sendCommand(SSD1306register_e regNumber, const uint8_t parame
 
 //state machine
 static errorCode_u stIdle();
-static errorCode_u stSendingData();
+static errorCode_u stSendingPage();
+static errorCode_u stSendingCommands();
 static errorCode_u stWaitingForTXdone();
 
 static const SSD1306init_t initCommands[NB_INIT_REGISERS] = {			///< Array used to initialise the registers
@@ -94,13 +98,16 @@ static const SSD1306init_t initCommands[NB_INIT_REGISERS] = {			///< Array used
 };
 
 //state variables
-volatile uint16_t			screenTimer_ms = 0;				///< Timer used with screen SPI transmissions
 static SPI_HandleTypeDef*	_SSD_SPIhandle = NULL;			///< SPI handle used with the SSD1306
 static screenState			_state = stIdle;				///< State machine current state
-static uint8_t				_screenBuffer[MAX_DATA_SIZE];	///< Buffer used to send data to the screen
-static uint8_t 				_limitColumns[2];				///< Buffer used to set the first and last column to send
-static uint8_t				_limitPages[2];					///< Buffer used to set the first and last page to send
-static uint16_t				_size;							///< Number of bytes to send
+static displaySource		_source = NULL;					///< Function rendering the pages of the region
+static displayWindow_t		_window;						///< Region to stream
+static uint8_t				_pageSize;						///< Number of bytes in a page of the region
+static uint8_t				_nbPages;						///< Number of pages in the region
+static uint8_t				_page;							///< Page of the region being sent
+static uint8_t				_buffer[2U * DISPLAY_CHUNK_SIZE];	///< Streaming buffer, in two halves of a region page each
+static uint8_t				_commands[MAX_QUEUED_BYTES];	///< Command bytes queued for a DMA transfer
+static uint8_t				_nbCommands;					///< Number of command bytes queued
 
 
 /********************************************************************************************************************************************/
@@ -113,7 +120,6 @@ static uint16_t				_size;							///< Number of bytes to send
  * @param handle SPI handle used
  * @retval 0 Success
  * @retval 1 Error while initialising the registers
- * @retval 2 Error while clearing the screen
  */
 errorCode_u SSD1306initialise(SPI_HandleTypeDef* handle){
 	errorCode_u result;
@@ -135,10 +141,6 @@ errorCode_u SSD1306initialise(SPI_HandleTypeDef* handle){
 			return (pushErrorCode(result, INIT, 1));
 	}
 
-	result = SSD1306clearScreen();
-	if(IS_ERROR(result))
-		return (pushErrorCode(result, INIT, 2));		// @suppress("Avoid magic numbers")
-
 	return (ERR_SUCCESS);
 }
 
@@ -203,86 +205,137 @@ errorCode_u sendCommand(SSD1306register_e regNumber, const uint8_t parameters[],
 }
 
 /**
- * @brief Send the whole screen buffer to wipe it
+ * @brief Set the column and page windows of the horizontal addressing mode
  *
- * @return Success
+ * @param window Region in which the next data bytes are written
+ * @retval 0 Success
+ * @retval 1 Error while sending the column address command
+ * @retval 2 Error while sending the page address command
  */
-errorCode_u SSD1306clearScreen(){
-	uint8_t* iterator = _screenBuffer;
+errorCode_u SSD1306setWindow(const displayWindow_t* window){
+	const uint8_t columns[2] = {window->firstColumn, window->lastColumn};
+	const uint8_t pages[2] = {window->firstPage, window->lastPage};
+	errorCode_u result;
 
-	_limitColumns[0] = 0;
-	_limitColumns[1] = SSD_LAST_COLUMN;
-	_limitPages[0] = 0;
-	_limitPages[1] = SSD_LAST_PAGE;
-	_size = MAX_DATA_SIZE;
+	result = sendCommand(COLUMN_ADDRESS, columns, 2);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, SET_WINDOW, 1));
 
-	for(uint16_t i = 0 ; i < MAX_DATA_SIZE ; i++)
-		*(iterator++) = 0x00U;
+	result = sendCommand(PAGE_ADDRESS, pages, 2);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, SET_WINDOW, 2));		// @suppress("Avoid magic numbers")
 
-	_state = stSendingData;
 	return (ERR_SUCCESS);
 }
 
 /**
- * @brief Check if the screen is ready to accept new commands
+ * @brief Queue the transfer of a region, rendered and sent page by page from the next update
  *
- * @return 1 if ready
+ * @param window Region to stream
+ * @param source Function rendering the pages of the region
+ * @retval 0 Success
+ * @retval 1 Region out of the panel
  */
-uint8_t isScreenReady(){
-	return (_state == stIdle);
+errorCode_u SSD1306stream(const displayWindow_t* window, displaySource source){
+	if((window->lastColumn >= SSD1306_WIDTH) || (window->firstColumn > window->lastColumn)
+			|| (window->lastPage >= SSD1306_NB_PAGES) || (window->firstPage > window->lastPage))
+		return (createErrorCode(STREAM, 1, ERR_WARNING));
+
+	_source = source;
+	_window = *window;
+	_pageSize = (uint8_t)(window->lastColumn - window->firstColumn + 1U);
+	_nbPages = (uint8_t)(window->lastPage - window->firstPage + 1U);
+	_page = 0;
+
+	_state = stSendingPage;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Invert the display (pixels on become off and vice versa)
+ * @note The screen must be ready to accept new commands
+ *
+ * @param inverted 1 to invert the display, 0 to restore it
+ * @retval 0 Success
+ * @retval 1 Error while sending the command
+ */
+errorCode_u SSD1306setInverted(uint8_t inverted){
+	errorCode_u result;
+
+	result = sendCommand((inverted ? DISPLAY_INVERSE : DISPLAY_NORMAL), NULL, 0);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, SET_INVERTED, 1));
+
+	return (ERR_SUCCESS);
 }
 
 /**
- * @brief Print an angle (in degrees, with sign) on the screen
+ * @brief Queue a contrast change, sent from the next update
+ * @note The screen must be ready to accept new commands
  *
- * @param angle	Angle to print
- * @param page	First page on which to print the angle (screen line)
- * @param column First column on which to print the angle
+ * @param contrast New contrast (0 to 255)
+ * @retval 0 Success
+ * @retval 1 Screen busy
+ */
+errorCode_u SSD1306setContrast(uint8_t contrast){
+	if(_state != stIdle)
+		return (createErrorCode(SET_CONTRAST, 1, ERR_WARNING));
+
+	_commands[0] = CONTRAST_CONTROL;
+	_commands[1] = contrast;
+	_nbCommands = 2U;
+
+	_state = stSendingCommands;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Queue the panel turning off or on, with its charge pump, sent from the next update
+ * @note The screen must be ready to accept new commands
+ * @note The GDDRAM is kept while the panel is off, so it shows the same image when turned back on
  *
+ * @param on 1 to turn the charge pump then the panel on, 0 to turn the panel then the charge pump off
  * @retval 0 Success
- * @retval 1 Angle above maximum amplitude
+ * @retval 1 Screen busy
  */
-errorCode_u SSD1306_printAngle(float angle, uint8_t page, uint8_t column){
-	uint8_t charIndexes[ANGLE_NB_CHARS] = {INDEX_PLUS, 0, 0, INDEX_DOT, 0, INDEX_DEG};
-	uint8_t* iterator = _screenBuffer;
-
-	//if angle out of bounds, return error
-	if((angle < MIN_ANGLE_DEG) || (angle > MAX_ANGLE_DEG))
-		return (createErrorCode(PRT_ANGLE, 1, ERR_WARNING));
-
-	//store the values
-	_limitColumns[0] = column;
-	_limitColumns[1] = column + (VERDANA_CHAR_WIDTH * ANGLE_NB_CHARS) - 1;
-	_limitPages[0] = page;
-	_limitPages[1] = page + 1;
-	_size = ANGLE_NB_CHARS * VERDANA_NB_BYTES_CHAR;
-
-	//if angle negative, replace plus sign with minus sign
-	if(angle < NEG_THRESHOLD){
-		charIndexes[INDEX_SIGN] = INDEX_MINUS;
-		angle = -angle;
+errorCode_u SSD1306setPower(uint8_t on){
+	if(_state != stIdle)
+		return (createErrorCode(SET_POWER, 1, ERR_WARNING));
+
+	if(on){
+		_commands[0] = CHG_PUMP_REGULATOR;
+		_commands[1] = SSD_ENABLE_CHG_PUMP;
+		_commands[2] = DISPLAY_ON;
 	}
-
-	//fill the angle characters indexes array with the float values (tens, units, tenths)
-	charIndexes[INDEX_TENS] = (uint8_t)(angle / FLOAT_FACTOR_10);
-	charIndexes[INDEX_UNITS] = ((uint8_t)angle) % INT_FACTOR_10;
-	charIndexes[INDEX_TENTHS] = (uint8_t)((uint16_t)(angle * FLOAT_FACTOR_10) % INT_FACTOR_10);
-
-	//fill the buffer with all the required bitmaps bytes (column by column, then character by character, then page by page)
-	for(page = 0 ; page < VERDANA_NB_PAGES ; page++){
-		for(uint8_t character = 0 ; character < ANGLE_NB_CHARS ; character++){
-			for(column = 0 ; column < VERDANA_CHAR_WIDTH ; column++){
-				*iterator = verdana_16ptNumbers[charIndexes[character]][(VERDANA_CHAR_WIDTH * page) + column];
-				iterator++;
-			}
-		}
+	else{
+		_commands[0] = DISPLAY_OFF;
+		_commands[1] = CHG_PUMP_REGULATOR;
+		_commands[2] = SSD_DISABLE_CHG_PUMP;
 	}
+	_nbCommands = 3U;														// @suppress("Avoid magic numbers")
 
-	//get to printing state
-	_state = stSendingData;
+	_state = stSendingCommands;
 	return (ERR_SUCCESS);
 }
 
+/**
+ * @brief Check if the screen is ready to accept new commands
+ *
+ * @return 1 if ready
+ */
+uint8_t SSD1306isReady(){
+	return (_state == stIdle);
+}
+
+/**
+ * @brief Check if the state machine has nothing to do until the DMA interrupt or the timer expiry
+ *
+ * @return 1 if idle or waiting for a transmission to end
+ */
+uint8_t SSD1306isWaiting(){
+	return ((_state == stIdle) || (_state == stWaitingForTXdone));
+}
+
 /**
  * @brief Run the state machine
  *
@@ -292,6 +345,23 @@ errorCode_u SSD1306update(){
 	return ((*_state)());
 }
 
+/**
+ * @brief Callback triggered by the DMA once a page (or the queued commands) is sent
+ * @details Renders the page after next in the half just sent, while the next page is sent from the other half,
+ * 			and marks the trace once the last page of the region is sent
+ *
+ * @param hspi SPI handle which triggered the callback
+ */
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi){
+	if(hspi != _SSD_SPIhandle)
+		return;
+
+	if((_page + 2U) < _nbPages)
+		(*_source)(&_buffer[(_page & 1U) * _pageSize], (uint8_t)(_page + 2U));
+	else if((_page + 1U) >= _nbPages)
+		tracerMark(TRACE_DISPLAYED);
+}
+
 
 /********************************************************************************************************************************************/
 /********************************************************************************************************************************************/
@@ -307,41 +377,71 @@ errorCode_u stIdle(){
 }
 
 /**
- * @brief State in which data is sent to the screen
+ * @brief State in which the next page of the region is sent to the screen
  *
  * @retval 0 Success
- * @retval 1 Error occurred while sending the column address command
- * @retval 1 Error occurred while sending the page address command
- * @retval 1 Error occurred while sending the data
+ * @retval 1 Error occurred while setting the window
+ * @retval 2 Error occurred while sending the data
  */
-errorCode_u stSendingData(){
+errorCode_u stSendingPage(){
 	errorCode_u result;
 	HAL_StatusTypeDef HALresult;
 
-	//send the set start and end column addresses
-	result = sendCommand(COLUMN_ADDRESS, _limitColumns, 2);
-	if(IS_ERROR(result)){
-		_state = stIdle;
-		return (pushErrorCode(result, SENDING_DATA, 1));
+	//set the start and end column and page addresses, and render the first two pages (once per region)
+	if(!_page){
+		result = SSD1306setWindow(&_window);
+		if(IS_ERROR(result)){
+			_state = stIdle;
+			return (pushErrorCode(result, SENDING_PAGE, 1));
+		}
+
+		(*_source)(_buffer, 0);
+		if(_nbPages > 1U)
+			(*_source)(&_buffer[_pageSize], 1);
 	}
 
-	//send the set start and end page addresses
-	/*result = */sendCommand(PAGE_ADDRESS, _limitPages, 2);
-	if(IS_ERROR(result)){
+	//set GPIOs
+	setDataStatus(DATA);
+	setSPIstatus(ENABLED);
+
+	//send the page (the next ones are rendered by the transfer-complete interrupt)
+	screenTimer_ms = SPI_TIMEOUT_MS;
+	HALresult = HAL_SPI_Transmit_DMA(_SSD_SPIhandle, &_buffer[(_page & 1U) * _pageSize], _pageSize);
+	if(HALresult != HAL_OK){
+		setSPIstatus(DISABLED);
 		_state = stIdle;
-		return (pushErrorCode(result, SENDING_DATA, 2));
+		return (createErrorCodeLayer1(SENDING_PAGE, 2, HALresult, ERR_ERROR)); 	// @suppress("Avoid magic numbers")
 	}
 
+	//get to next
+	_state = stWaitingForTXdone;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief State in which the queued command bytes are sent to the screen
+ *
+ * @retval 0 Success
+ * @retval 1 Error occurred while sending the commands
+ */
+errorCode_u stSendingCommands(){
+	HAL_StatusTypeDef HALresult;
+
+	//make sure the transfer interrupt doesn't render any page
+	_nbPages = 0;
+	_page = 0;
+
 	//set GPIOs
-	setDataStatus(DATA);
+	setDataStatus(COMMAND);
 	setSPIstatus(ENABLED);
 
-	//send the data
+	//send the commands in a single transfer
 	screenTimer_ms = SPI_TIMEOUT_MS;
-	HALresult = HAL_SPI_Transmit_DMA(_SSD_SPIhandle, _screenBuffer, _size);
+	HALresult = HAL_SPI_Transmit_DMA(_SSD_SPIhandle, _commands, _nbCommands);
 	if(HALresult != HAL_OK){
+		setSPIstatus(DISABLED);
 		_state = stIdle;
-		return (createErrorCodeLayer1(SENDING_DATA, 3, HALresult, ERR_ERROR)); 	// @suppress("Avoid magic numbers")
+		return (createErrorCodeLayer1(SENDING_CMDS, 1, HALresult, ERR_ERROR));
 	}
 
 	//get to next
@@ -368,8 +468,16 @@ errorCode_u stWaitingForTXdone(){
 	if(HAL_SPI_GetState(_SSD_SPIhandle) != HAL_SPI_STATE_READY)
 		return (ERR_SUCCESS);
 
-	//disable SPI and get to idle state
+	//disable SPI
 	setSPIstatus(DISABLED);
-	_state = stIdle;
-	return (ERR_SUCCESS);
+
+	//if the region is complete, get to idle state
+	if((_page + 1U) >= _nbPages){
+		_state = stIdle;
+		return (ERR_SUCCESS);
+	}
+
+	//chain the next page right away
+	_page++;
+	return (stSendingPage());
 }
@@ -0,0 +1,95 @@
+/**
+ * @file rle.c
+ * @brief Implement the streaming decoder of the run-length-encoded images
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The images are encoded at build time by tools/imagepack/image_pack.py, as a stream of tokens :
+ * - control byte 0x00-0x7F : literal, the next (control + 1) bytes are copied
+ * - control byte 0x80-0xFF : run, the next byte is repeated ((control & 0x7F) + 3) times
+ *
+ * The decoder keeps its position between calls, so that an image can be expanded
+ * straight into the screen buffer, or chunk by chunk into a transfer buffer.
+ */
+#include "rle.h"
+
+//definitions
+#define RLE_RUN_FLAG	0x80U	///< Flag of the run tokens control byte
+#define RLE_COUNT_MASK	0x7FU	///< Count bits of a control byte
+#define RLE_MIN_RUN		3U		///< Shortest run encoded (shorter ones are cheaper as literals)
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Start decoding an image from its first byte
+ *
+ * @param[out] decoder Decoder state
+ * @param image Image to decode
+ */
+void rleStart(rleDecoder_t* decoder, const rleImage_t* image){
+	decoder->next = image->data;
+	decoder->end = image->data + image->size;
+	decoder->remaining = 0;
+	decoder->repeated = 0;
+	decoder->value = 0;
+}
+
+/**
+ * @brief Expand the next bytes of the image
+ *
+ * @param decoder Decoder state
+ * @param[out] output Buffer in which to expand the bytes
+ * @param size Number of bytes requested
+ * @return Number of bytes expanded (lower than requested once the end of the stream is reached)
+ */
+uint16_t rleDecode(rleDecoder_t* decoder, uint8_t output[], uint16_t size){
+	uint16_t produced = 0;
+	uint8_t count;
+
+	while(produced < size){
+		//if the current token is exhausted, read the next control byte
+		if(!decoder->remaining){
+			if(decoder->next >= decoder->end)
+				break;
+
+			count = *(decoder->next++);
+			if(count & RLE_RUN_FLAG){
+				if(decoder->next >= decoder->end)
+					break;
+				decoder->remaining = (uint8_t)((count & RLE_COUNT_MASK) + RLE_MIN_RUN);
+				decoder->repeated = 1;
+				decoder->value = *(decoder->next++);
+			}
+			else{
+				decoder->remaining = (uint8_t)(count + 1U);
+				decoder->repeated = 0;
+			}
+		}
+
+		//produce as much of the token as the output can take
+		count = decoder->remaining;
+		if(count > (size - produced))
+			count = (uint8_t)(size - produced);
+		decoder->remaining -= count;
+
+		if(decoder->repeated){
+			while(count--)
+				output[produced++] = decoder->value;
+		}
+		else{
+			//a truncated literal only produces the bytes available
+			if(count > (decoder->end - decoder->next))
+				count = (uint8_t)(decoder->end - decoder->next);
+			while(count--)
+				output[produced++] = *(decoder->next++);
+			if(decoder->next >= decoder->end)
+				decoder->remaining = 0;
+		}
+	}
+
+	return (produced);
+}
@@ -0,0 +1,506 @@
+/**
+ * @file screen.c
+ * @brief Implement the rendering of the angles, numbers and gauge, streamed through the display backend selected
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The bitmaps are rendered in the panel native pixel format (pages of 8 rows, one byte per column),
+ * one page at a time, when the backend which owns the transfers asks for them (see panel.h).
+ * The print functions then only keep what the pages are rendered from (characters, gauge filling, image decoder),
+ * and the pages are rendered straight into the backend streaming buffer, from the DMA interrupts :
+ * a full frame never sits in RAM.
+ * The images stored in flash are run-length-encoded (see rle.c), and expanded page by page.
+ */
+#include "screen.h"
+#include "panel.h"
+#include "numbersVerdana16.h"
+#include "tracer.h"
+
+//definitions
+#define MIN_ANGLE_DEG		-90.0f	///< Minimum angle allowed (in degrees)
+#define MAX_ANGLE_DEG		90.0f	///< Maximum angle allowed (in degrees)
+#define FLOAT_FACTOR_10		10.0f	///< Factor of 10 used in float calculations
+#define INT_FACTOR_10		10U		///< Factor of 10 used in integer calculations
+#define FLOAT_FACTOR_100	100.0f	///< Factor of 100 used in float calculations
+#define INT_FACTOR_100		100U	///< Factor of 100 used in integer calculations
+#define INT_FACTOR_1000		1000U	///< Factor of 1000 used in integer calculations
+#define ROUNDING_HALF		0.5f	///< Half a unit, added to round to the nearest integer
+#define NEG_THRESHOLD		-0.05f	///< Threshold above which an angle is considered positive (circumvents float incaccuracies)
+#define PRECISE_NEG_THRESHOLD	-0.005f	///< Threshold above which a precise angle is considered positive (rounds to +0.00)
+#define INDEX_SIGN			0		///< Index of the sign in the angle indexes array
+#define INDEX_TENS			1U		///< Index of the tens in the angle indexes array
+#define INDEX_UNITS			2U		///< Index of the units in the angle indexes array
+#define INDEX_TENTHS		4U		///< Index of the tenths in the angle indexes array
+#define INDEX_HUNDREDTHS	5U		///< Index of the hundredths in the precise angle indexes array
+#define ANGLE_NB_CHARS		6U		///< Number of characters in the angle array
+#define PRECISE_NB_CHARS	7U		///< Number of characters in the precise angle array
+#define NUMBER_NB_CHARS		5U		///< Number of characters used to print an unsigned number
+#define TEMPERATURE_NB_CHARS	7U	///< Number of characters used to print a temperature (sign, 3 digits, dot, tenths, degree)
+#define MAX_TEMPERATURE_DC	9999U	///< Highest temperature magnitude printable (in tenths of degrees)
+#define GAUGE_WIDTH			24U		///< Width of the gauge (in pixels)
+#define GAUGE_INSIDE		20U		///< Number of columns inside the gauge outline
+#define GAUGE_SIDE			0x7EU	///< Bitmap of the gauge outline sides
+#define GAUGE_EMPTY			0x42U	///< Bitmap of an empty gauge column (top and bottom outline)
+#define GAUGE_FULL			0x7EU	///< Bitmap of a filled gauge column
+#define GAUGE_TIP			0x18U	///< Bitmap of the gauge tip columns
+#define PERCENT_FULL		100U	///< 100 %
+#define MAX_NB_CHARS		PRECISE_NB_CHARS	///< Maximum number of characters printed at once
+
+/**
+ * @brief Enumeration of the function IDs of the screen rendering
+ */
+typedef enum _screenFunctionCodes_e{
+	INIT = 0,		///< screenInitialise()
+	PRT_ANGLE,		///< screenPrintAngle()
+	PRT_NUMBER,		///< screenPrintNumber()
+	SET_INVERTED,	///< screenSetInverted()
+	PRT_GAUGE,		///< screenPrintGauge()
+	PRT_PRECISE,	///< screenPrintPreciseAngle()
+	CLEAR,			///< screenClear()
+	PRT_CHARS,		///< printCharacters()
+	DRAW_IMAGE,		///< screenDrawImage()
+	SET_CONTRAST,	///< screenSetContrast()
+	SET_POWER,		///< screenSetPower()
+	PRT_TEMPERATURE,	///< screenPrintTemperature()
+}_screenFunctionCodes_e;
+
+//tool functions
+static errorCode_u printCharacters(const uint8_t charIndexes[], uint8_t nbCharacters, uint8_t page, uint8_t column);
+
+//page sources
+static void renderBlank(uint8_t chunk[], uint8_t page);
+static void renderCharacters(uint8_t chunk[], uint8_t page);
+static void renderGauge(uint8_t chunk[], uint8_t page);
+static void renderImage(uint8_t chunk[], uint8_t page);
+
+//state variables
+volatile uint16_t			screenTimer_ms = 0;				///< Timer used with screen SPI transmissions
+static uint8_t				_charIndexes[MAX_NB_CHARS];		///< Indexes of the characters streamed
+static uint8_t				_nbCharacters;					///< Number of characters streamed
+static uint8_t				_gaugeFilled;					///< Number of filled columns in the gauge streamed
+static rleDecoder_t			_decoder;						///< Decoder of the image streamed
+static uint8_t				_imageWidth;					///< Width of the image streamed
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Initialise the panel, then clear it
+ *
+ * @param handle SPI handle used
+ * @retval 0 Success
+ * @retval 1 Pixel format of the panel not rendered
+ * @retval 2 Error while initialising the panel
+ * @retval 3 Error while clearing the screen
+ */
+errorCode_u screenInitialise(SPI_HandleTypeDef* handle){
+	errorCode_u result;
+
+	//the bitmaps are rendered in pages (folded away for the panels using them)
+	if(PANEL.format.pixelFormat != DISPLAY_PAGES_1BPP)
+		return (createErrorCode(INIT, 1, ERR_CRITICAL));
+
+	result = PANEL.initialise(handle);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, INIT, 2));		// @suppress("Avoid magic numbers")
+
+	result = screenClear();
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, INIT, 3));		// @suppress("Avoid magic numbers")
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Run the panel state machine
+ *
+ * @return Return code of the current state
+ */
+errorCode_u screenUpdate(){
+	return (PANEL.update());
+}
+
+/**
+ * @brief Check if the screen is ready to accept new commands
+ *
+ * @return 1 if ready
+ */
+uint8_t isScreenReady(){
+	return (PANEL.isReady());
+}
+
+/**
+ * @brief Check if the panel state machine only waits for its DMA interrupt or its timer
+ *
+ * @return 1 if waiting (no need to run the machine until then)
+ */
+uint8_t isScreenWaiting(){
+	return (PANEL.isWaiting());
+}
+
+/**
+ * @brief Stream blank pages over the whole screen to wipe it
+ *
+ * @retval 0 Success
+ * @retval 1 Error while streaming the pages
+ */
+errorCode_u screenClear(){
+	const displayWindow_t window = {0, (uint8_t)(PANEL.format.width - 1U), 0, (uint8_t)(PANEL.format.nbPages - 1U)};
+	errorCode_u result;
+
+	result = PANEL.stream(&window, renderBlank);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, CLEAR, 1));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Invert the display (pixels on become off and vice versa)
+ * @note The screen must be ready to accept new commands
+ *
+ * @param inverted 1 to invert the display, 0 to restore it
+ * @retval 0 Success
+ * @retval 1 Error while sending the command
+ */
+errorCode_u screenSetInverted(uint8_t inverted){
+	errorCode_u result;
+
+	result = PANEL.setInverted(inverted);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, SET_INVERTED, 1));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Queue a contrast change, sent by the next screen updates
+ * @note The screen must be ready to accept new commands
+ *
+ * @param contrast New contrast (0 to 255)
+ * @retval 0 Success
+ * @retval 1 Error while queuing the command
+ */
+errorCode_u screenSetContrast(uint8_t contrast){
+	errorCode_u result;
+
+	result = PANEL.setContrast(contrast);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, SET_CONTRAST, 1));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Queue the panel turning off (with its voltage supply) or back on, sent by the next screen updates
+ * @note The screen must be ready to accept new commands
+ * @note The panel keeps its image while off
+ *
+ * @param on 1 to turn the panel on, 0 to turn it off
+ * @retval 0 Success
+ * @retval 1 Error while queuing the commands
+ */
+errorCode_u screenSetPower(uint8_t on){
+	errorCode_u result;
+
+	result = PANEL.setPower(on);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, SET_POWER, 1));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Print an angle (in degrees, with sign) on the screen
+ *
+ * @param angle	Angle to print
+ * @param page	First page on which to print the angle (screen line)
+ * @param column First column on which to print the angle
+ *
+ * @retval 0 Success
+ * @retval 1 Angle above maximum amplitude
+ * @retval 2 Error while streaming the characters
+ */
+errorCode_u screenPrintAngle(float angle, uint8_t page, uint8_t column){
+	uint8_t charIndexes[ANGLE_NB_CHARS] = {INDEX_PLUS, 0, 0, INDEX_DOT, 0, INDEX_DEG};
+	errorCode_u result;
+
+	//if angle out of bounds, return error
+	if((angle < MIN_ANGLE_DEG) || (angle > MAX_ANGLE_DEG))
+		return (createErrorCode(PRT_ANGLE, 1, ERR_WARNING));
+
+	//if angle negative, replace plus sign with minus sign
+	if(angle < NEG_THRESHOLD){
+		charIndexes[INDEX_SIGN] = INDEX_MINUS;
+		angle = -angle;
+	}
+
+	//fill the angle characters indexes array with the float values (tens, units, tenths)
+	charIndexes[INDEX_TENS] = (uint8_t)(angle / FLOAT_FACTOR_10);
+	charIndexes[INDEX_UNITS] = ((uint8_t)angle) % INT_FACTOR_10;
+	charIndexes[INDEX_TENTHS] = (uint8_t)((uint16_t)(angle * FLOAT_FACTOR_10) % INT_FACTOR_10);
+
+	result = printCharacters(charIndexes, ANGLE_NB_CHARS, page, column);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, PRT_ANGLE, 2));	// @suppress("Avoid magic numbers")
+
+	tracerMark(TRACE_PRINTED);
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Print an angle (in degrees, with sign) with two decimals on the screen
+ * @details Unlike screenPrintAngle(), the angle is rounded to the nearest hundredth,
+ * 			as a truncation would bias the readings of a stable angle
+ *
+ * @param angle	Angle to print
+ * @param page	First page on which to print the angle (screen line)
+ * @param column First column on which to print the angle
+ *
+ * @retval 0 Success
+ * @retval 1 Angle above maximum amplitude
+ * @retval 2 Error while streaming the characters
+ */
+errorCode_u screenPrintPreciseAngle(float angle, uint8_t page, uint8_t column){
+	uint8_t charIndexes[PRECISE_NB_CHARS] = {INDEX_PLUS, 0, 0, INDEX_DOT, 0, 0, INDEX_DEG};
+	uint16_t hundredths;
+	errorCode_u result;
+
+	//if angle out of bounds, return error
+	if((angle < MIN_ANGLE_DEG) || (angle > MAX_ANGLE_DEG))
+		return (createErrorCode(PRT_PRECISE, 1, ERR_WARNING));
+
+	//if angle negative, replace plus sign with minus sign
+	if(angle < PRECISE_NEG_THRESHOLD){
+		charIndexes[INDEX_SIGN] = INDEX_MINUS;
+		angle = -angle;
+	}
+
+	//fill the angle characters indexes array with the rounded hundredths (tens, units, tenths, hundredths)
+	hundredths = (uint16_t)((angle * FLOAT_FACTOR_100) + ROUNDING_HALF);
+	charIndexes[INDEX_TENS] = (uint8_t)(hundredths / INT_FACTOR_1000);
+	charIndexes[INDEX_UNITS] = (uint8_t)((hundredths / INT_FACTOR_100) % INT_FACTOR_10);
+	charIndexes[INDEX_TENTHS] = (uint8_t)((hundredths / INT_FACTOR_10) % INT_FACTOR_10);
+	charIndexes[INDEX_HUNDREDTHS] = (uint8_t)(hundredths % INT_FACTOR_10);
+
+	result = printCharacters(charIndexes, PRECISE_NB_CHARS, page, column);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, PRT_PRECISE, 2));	// @suppress("Avoid magic numbers")
+
+	tracerMark(TRACE_PRINTED);
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Print an unsigned number (right-aligned on 5 characters) on the screen
+ *
+ * @param number Number to print
+ * @param page First page on which to print the number (screen line)
+ * @param column First column on which to print the number
+ * @retval 0 Success
+ * @retval 1 Error while streaming the characters
+ */
+errorCode_u screenPrintNumber(uint16_t number, uint8_t page, uint8_t column){
+	uint8_t charIndexes[NUMBER_NB_CHARS];
+	uint8_t character = NUMBER_NB_CHARS;
+	errorCode_u result;
+
+	//fill the characters from the units up, then pad with blanks
+	do{
+		charIndexes[--character] = (uint8_t)(number % INT_FACTOR_10);
+		number /= INT_FACTOR_10;
+	}while(number && character);
+
+	while(character)
+		charIndexes[--character] = INDEX_SPACE;
+
+	result = printCharacters(charIndexes, NUMBER_NB_CHARS, page, column);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, PRT_NUMBER, 1));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Print a temperature (in degrees, with sign and tenths, right-aligned on 7 characters) on the screen
+ * @note Unlike the angles, a temperature is not a measurement result, so the latency tracer is not marked
+ *
+ * @param temperature_dC Temperature to print (in tenths of degrees)
+ * @param page First page on which to print the temperature (screen line)
+ * @param column First column on which to print the temperature
+ * @retval 0 Success
+ * @retval 1 Temperature above maximum amplitude
+ * @retval 2 Error while streaming the characters
+ */
+errorCode_u screenPrintTemperature(int16_t temperature_dC, uint8_t page, uint8_t column){
+	uint8_t charIndexes[TEMPERATURE_NB_CHARS];
+	uint8_t character = TEMPERATURE_NB_CHARS;
+	uint16_t magnitude = (uint16_t)((temperature_dC < 0) ? -temperature_dC : temperature_dC);
+	errorCode_u result;
+
+	if(magnitude > MAX_TEMPERATURE_DC)
+		return (createErrorCode(PRT_TEMPERATURE, 1, ERR_WARNING));
+
+	//fill the characters from the degree sign up (tenths, dot, then the units at least)
+	charIndexes[--character] = INDEX_DEG;
+	charIndexes[--character] = (uint8_t)(magnitude % INT_FACTOR_10);
+	charIndexes[--character] = INDEX_DOT;
+	magnitude /= INT_FACTOR_10;
+	do{
+		charIndexes[--character] = (uint8_t)(magnitude % INT_FACTOR_10);
+		magnitude /= INT_FACTOR_10;
+	}while(magnitude);
+
+	//add the sign before the first digit, then pad with blanks
+	charIndexes[--character] = ((temperature_dC < 0) ? INDEX_MINUS : INDEX_PLUS);
+	while(character)
+		charIndexes[--character] = INDEX_SPACE;
+
+	result = printCharacters(charIndexes, TEMPERATURE_NB_CHARS, page, column);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, PRT_TEMPERATURE, 2));	// @suppress("Avoid magic numbers")
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Print a battery-shaped gauge (one page high) on the screen
+ *
+ * @param percent Gauge filling (in %)
+ * @param page Page on which to print the gauge
+ * @param column First column on which to print the gauge
+ * @retval 0 Success
+ * @retval 1 Filling above 100 %
+ * @retval 2 Error while streaming the gauge
+ */
+errorCode_u screenPrintGauge(uint8_t percent, uint8_t page, uint8_t column){
+	const displayWindow_t window = {column, (uint8_t)(column + GAUGE_WIDTH - 1U), page, page};
+	errorCode_u result;
+
+	if(percent > PERCENT_FULL)
+		return (createErrorCode(PRT_GAUGE, 1, ERR_WARNING));
+
+	_gaugeFilled = (uint8_t)((percent * GAUGE_INSIDE) / PERCENT_FULL);
+
+	result = PANEL.stream(&window, renderGauge);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, PRT_GAUGE, 2));	// @suppress("Avoid magic numbers")
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Draw a compressed image, expanded page by page as it is streamed
+ *
+ * @param image Image to draw
+ * @param page Page on which to draw the top of the image
+ * @param column Column on which to draw the left of the image
+ * @retval 0 Success
+ * @retval 1 Empty image
+ * @retval 2 Error while streaming the image
+ */
+errorCode_u screenDrawImage(const rleImage_t* image, uint8_t page, uint8_t column){
+	const displayWindow_t window = {column, (uint8_t)(column + image->width - 1U), page, (uint8_t)(page + image->nbPages - 1U)};
+	errorCode_u result;
+
+	if(!image->width || !image->nbPages)
+		return (createErrorCode(DRAW_IMAGE, 1, ERR_WARNING));
+
+	rleStart(&_decoder, image);
+	_imageWidth = image->width;
+
+	result = PANEL.stream(&window, renderImage);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, DRAW_IMAGE, 2));			// @suppress("Avoid magic numbers")
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Stream characters bitmaps
+ *
+ * @param charIndexes Indexes of the characters to print
+ * @param nbCharacters Number of characters to print
+ * @param page First page on which to print the characters (screen line)
+ * @param column First column on which to print the characters
+ * @retval 0 Success
+ * @retval 1 Error while streaming the characters
+ */
+static errorCode_u printCharacters(const uint8_t charIndexes[], uint8_t nbCharacters, uint8_t page, uint8_t column){
+	const displayWindow_t window = {column, (uint8_t)(column + (VERDANA_CHAR_WIDTH * nbCharacters) - 1), page, (uint8_t)(page + VERDANA_NB_PAGES - 1)};
+	errorCode_u result;
+
+	//keep the characters until they are rendered
+	for(uint8_t character = 0 ; character < nbCharacters ; character++)
+		_charIndexes[character] = charIndexes[character];
+	_nbCharacters = nbCharacters;
+
+	result = PANEL.stream(&window, renderCharacters);
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, PRT_CHARS, 1));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Render a blank page
+ *
+ * @param chunk Buffer to fill
+ * @param page Unused
+ */
+static void renderBlank(uint8_t chunk[], uint8_t page){
+	(void)page;
+
+	for(uint8_t column = 0 ; column < PANEL.format.width ; column++)
+		chunk[column] = 0x00U;
+}
+
+/**
+ * @brief Render a page of the characters streamed (column by column, then character by character)
+ *
+ * @param chunk Buffer to fill
+ * @param page Page of the characters to render
+ */
+static void renderCharacters(uint8_t chunk[], uint8_t page){
+	for(uint8_t character = 0 ; character < _nbCharacters ; character++){
+		for(uint8_t column = 0 ; column < VERDANA_CHAR_WIDTH ; column++)
+			*(chunk++) = verdana_16ptNumbers[_charIndexes[character]][(VERDANA_CHAR_WIDTH * page) + column];
+	}
+}
+
+/**
+ * @brief Render the gauge streamed : the outline, the filled columns, then the tip
+ *
+ * @param chunk Buffer to fill
+ * @param page Unused (the gauge is one page high)
+ */
+static void renderGauge(uint8_t chunk[], uint8_t page){
+	(void)page;
+
+	*(chunk++) = GAUGE_SIDE;
+	for(uint8_t i = 0 ; i < GAUGE_INSIDE ; i++)
+		*(chunk++) = ((i < _gaugeFilled) ? GAUGE_FULL : GAUGE_EMPTY);
+	*(chunk++) = GAUGE_SIDE;
+	*(chunk++) = GAUGE_TIP;
+	*chunk = GAUGE_TIP;
+}
+
+/**
+ * @brief Expand the next page of the image streamed
+ * @note The pages are expanded in order, and the bytes missing from a truncated stream are left blank
+ *
+ * @param chunk Buffer to fill
+ * @param page Unused (the decoder keeps its position)
+ */
+static void renderImage(uint8_t chunk[], uint8_t page){
+	uint16_t decoded;
+
+	(void)page;
+
+	decoded = rleDecode(&_decoder, chunk, _imageWidth);
+	while(decoded < _imageWidth)
+		chunk[decoded++] = 0x00U;
+}
@@ -21,17 +21,91 @@
 
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
-#include "ADXL345.h"
-#include "SSD1306.h"
+#include "accelerometer.h"
+#include "screen.h"
+#include "screenImages.h"
+#include "spectrum.h"
+#include "goertzel.h"
+#include "settings.h"
+#include "reference.h"
+#include "analog.h"
+#include "compensation.h"
+#include "oversampling.h"
+#include "scheduler.h"
+#include "tracer.h"
+#include "concurrency.h"
+#include <math.h>
+#ifdef USE_GYRO
+#include "L3GD20.h"
+#include "fusion.h"
+#include "timestamp.h"
+#endif
+#ifdef BENCHMARK
+#include "benchmark.h"
+#endif
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
 /* USER CODE BEGIN PTD */
+/**
+ * @brief Enumeration of the application modes
+ */
+typedef enum{
+	MODE_LEVEL = 0,		///< Angles of the X and Y axis displayed
+	MODE_PRECISION,		///< Angles of the X and Y axis averaged over several seconds displayed in hundredths of degrees
+	MODE_RELATIVE,		///< Angles of the X and Y axis relative to the captured reference displayed
+	MODE_SPECTRUM,		///< Dominant vibration frequency and amplitude displayed
+	MODE_MOTOR,			///< Vibration amplitudes at the motor frequencies (Goertzel filters) displayed
+	MODE_CALIBRATION,	///< Temperature and number of offsets calibrated displayed
+	MODE_AVERAGING,		///< Number of samples averaged per measurement and resulting update period displayed
+#ifdef USE_GYRO
+	MODE_DYNAMIC,		///< Angles of the X and Y axis fused with the gyroscope rates displayed
+#endif
+	NB_MODES
+}appMode_e;
+
+/**
+ * @brief Enumeration of the display power states, from the brightest to the darkest
+ */
+typedef enum{
+	POWER_AWAKE = 0,	///< Panel on at full contrast
+	POWER_DIMMED,		///< Panel on at a low contrast
+	POWER_OFF,			///< Panel and its voltage supply off, motion watched by the accelerometer
+}powerState_e;
 
 /* USER CODE END PTD */
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define DEFAULT_MODE		MODE_LEVEL		///< Application mode at startup
+#define ANALYSIS_AXIS		Z_AXIS			///< Axis on which vibrations are analysed
+#define MOTOR_NB_LINES		2U				///< Number of Goertzel filters amplitudes displayed in motor mode
+#define CAPTURE_BLOCKS		2U				///< Number of blocks published after a tap until one has been measured entirely after it
+#define SPECTRUM_RATE		3200U			///< Accelerometer output data rate used in spectrum mode (in Hz)
+#define LEVEL_RATE			200U			///< Accelerometer output data rate used in level mode (in Hz)
+#define LEVEL_SAMPLE_MS		5U				///< Sample period at the level mode output data rate (in ms)
+#define UG_PER_MG			1000U			///< Number of micro-g in a milli-g
+#define DC_PER_DEGREE		10.0f			///< Number of tenths of degrees in a degree
+#define ANALOG_PERIOD_MS	1000U			///< Period of the analog task (in ms)
+#define INTERFACE_PERIOD_MS	5U				///< Period of the interface task (in ms)
+#define GYROSCOPE_PERIOD_MS	10U			///< Period of the gyroscope task (in ms, no interrupt wired, FIFO full after 168 ms)
+#define ACCELEROMETER_DEADLINE_US	1000U	///< Deadline of the accelerometer task (in us)
+#define PROCESSING_DEADLINE_US		5000U	///< Deadline of the processing task (in us)
+#define GYROSCOPE_DEADLINE_US		1000U	///< Deadline of the gyroscope task (in us)
+#define FINE_ONE_G			((int32_t)SENSOR.format.oneG << SENSOR.format.fineShift)	///< 1 g in the fine measurements format
+#define AVERAGING_FAST		10U				///< Samples averaged in fast mode (a block every 50 ms at the level mode rate)
+#define AVERAGING_PRECISE	SENSOR.format.maxAveraging	///< Samples averaged in precise mode (a whole FIFO)
+#define NS_PER_US			1000U			///< Number of nanoseconds in a microsecond
+#define DIM_DELAY_MS		30000U			///< Time without angle change nor tap before the panel is dimmed (in ms)
+#define OFF_DELAY_MS		120000U			///< Time without angle change nor tap before the panel is turned off (in ms)
+#define CONTRAST_AWAKE		0xFFU			///< Panel contrast while awake
+#define CONTRAST_DIMMED		0x10U			///< Panel contrast while dimmed
+#define WAKE_TAP_MS			500U			///< Time after a wake up from off during which the taps only wake up (longer than a double tap detection, in ms)
+#define STILL_DEADBAND		(SENSOR.format.oneG >> 6)	///< Largest axis change still considered as no angle change (about 1 degree, in LSB)
+#define RESULTS_CAPACITY	4U				///< Capacity of the rings carrying the results to the interface task (power of two)
+#define HALF_SHIFT			16U				///< Number of bits to shift a result to reach its upper half
+#define HALF_MASK			0xFFFFU			///< Mask of the lower half of a result
+#define HUNDREDTHS_PER_DEGREE	100.0f		///< Number of hundredths of degrees in a degree
 
 /* USER CODE END PD */
 
@@ -41,12 +115,72 @@
 /* USER CODE END PM */
 
 /* Private variables ---------------------------------------------------------*/
+ADC_HandleTypeDef hadc1;
+DMA_HandleTypeDef hdma_adc1;
+
 SPI_HandleTypeDef hspi1;
 SPI_HandleTypeDef hspi2;
 DMA_HandleTypeDef hdma_spi2_tx;
 
 /* USER CODE BEGIN PV */
-errorCode_u result;
+static appMode_e		_mode = NB_MODES;	///< Current application mode
+static spectrumPeak_t	_peak;				///< Last dominant vibration component received
+static uint8_t			_peakToPrint = 0;	///< Number of spectrum lines still to print
+static uint16_t			_motorAmplitudes[MOTOR_NB_LINES];	///< Last amplitudes received at the motor frequencies (in LSB)
+static uint8_t			_motorToPrint = 0;	///< Number of motor lines still to print
+static uint8_t			_hold = 0;			///< Flag indicating the level angles are held on screen
+static sensorGesture_e	_pendingGesture = SENSOR_NO_GESTURE;	///< Tap gesture waiting for the screen to be ready
+static float			_relativeAngles[2];	///< Last X and Y angles relative to the reference
+static uint8_t			_relativeToPrint = 0;	///< Number of relative angle lines still to print
+static uint8_t			_relativeStale = 0;	///< Flag indicating the relative angles must be recomputed
+static uint8_t			_captureBlocks = 0;	///< Number of blocks still to publish before capturing the measurements asked by a tap (0 if none)
+static uint8_t			_calibrationToPrint = 0;	///< Number of calibration lines still to print
+static uint8_t			_averagingToPrint = 0;	///< Number of averaging lines still to print
+static float			_preciseAngles[2];	///< Last X and Y angles received, averaged over the oversampling window
+static uint8_t			_preciseToPrint = 0;	///< Number of precise angle lines still to print
+static analogValues_t	_analog;			///< Last analog values retrieved
+static uint8_t			_gaugeToPrint = 0;	///< Flag indicating the battery gauge must be printed
+static powerState_e		_power = POWER_AWAKE;	///< Display power state set on the panel
+static uint32_t			_lastActivity_ms = 0;	///< Tick of the last angle change, motion or tap (in ms)
+static int16_t			_stillVector[NB_AXIS];	///< Measurements at the last angle change (in LSB)
+static uint32_t			_wokenUp_ms = 0;		///< Tick of the last wake up from off (in ms)
+#ifdef USE_GYRO
+static int16_t			_dynamicPrinted[FUSION_NB_ANGLES];	///< Fused angles last printed (in tenths of degrees)
+#endif
+
+//results computed by the processing task, queued until the interface task prints them
+static uint32_t			_motorBuffer[RESULTS_CAPACITY];		///< Storage of the motor amplitudes ring
+static uint32_t			_peakBuffer[RESULTS_CAPACITY];		///< Storage of the spectrum peaks ring
+static uint32_t			_preciseBuffer[RESULTS_CAPACITY];	///< Storage of the precise angles ring
+static spscRing_t		_motorResults = {_motorBuffer, RESULTS_CAPACITY - 1U, 0, 0};		///< Amplitudes at the two first motor frequencies (second one in the upper half)
+static spscRing_t		_peakResults = {_peakBuffer, RESULTS_CAPACITY - 1U, 0, 0};		///< Spectrum peaks (frequency in the upper half, amplitude in the lower one)
+static spscRing_t		_preciseResults = {_preciseBuffer, RESULTS_CAPACITY - 1U, 0, 0};	///< Precise angles (X then Y, in signed hundredths of degrees)
+
+/**
+ * @brief Frequencies detected by the Goertzel filters bank in motor mode (in dHz, 0 if disabled), the first ones displayed
+ */
+static const uint16_t goertzelFrequencies_dHz[GOERTZEL_NB_FILTERS] = {
+	250,	//1500 rpm motor
+	500,	//3000 rpm motor
+	0,
+	0,
+};
+
+/**
+ * @brief Screen drawn when entering each mode (blank lines and the mode name at the bottom)
+ */
+static const rleImage_t* const _modeScreens[NB_MODES] = {
+	&imageModeLevel,
+	&imageModePrecision,
+	&imageModeRelative,
+	&imageModeSpectrum,
+	&imageModeMotor,
+	&imageModeCalibration,
+	&imageModeAveraging,
+#ifdef USE_GYRO
+	&imageModeDynamic,
+#endif
+};
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -55,7 +189,29 @@ static void MX_GPIO_Init(void);
 static void MX_DMA_Init(void);
 static void MX_SPI1_Init(void);
 static void MX_SPI2_Init(void);
+static void MX_ADC1_Init(void);
 /* USER CODE BEGIN PFP */
+static void setMode(appMode_e mode);
+static void updateLevel();
+static void updatePrecision();
+static void updateRelative();
+static void updateSpectrum();
+static void updateMotor();
+static void updateCalibration();
+static void updateAveraging();
+#ifdef USE_GYRO
+static void updateDynamic();
+static errorCode_u gyroscopeTask();
+#endif
+static errorCode_u accelerometerTask();
+static errorCode_u screenTask();
+static errorCode_u processingTask();
+static errorCode_u interfaceTask();
+static errorCode_u analogTask();
+static void handleGesture();
+static void captureBlock();
+static void updatePower(uint8_t activity);
+static void signalDrivers();
 
 /* USER CODE END PFP */
 
@@ -95,32 +251,46 @@ int main(void)
   MX_DMA_Init();
   MX_SPI1_Init();
   MX_SPI2_Init();
+  MX_ADC1_Init();
   /* USER CODE BEGIN 2 */
-  ADXL345initialise(&hspi1);
-  SSD1306initialise(&hspi2);
+  settingsInitialise();
+  referenceInitialise();
+  SENSOR.initialise(&hspi1);
+#ifdef USE_GYRO
+  L3GD20initialise(&hspi1);
+  fusionInitialise(L3GD_SCALE_UDPS_PER_LSB, L3GD_SAMPLE_PERIOD_US);
+#endif
+  screenInitialise(&hspi2);
+  analogInitialise(&hadc1);
+  for(uint8_t i = 0 ; i < GOERTZEL_NB_FILTERS ; i++)
+	  goertzelSetFrequency(i, goertzelFrequencies_dHz[i]);
+  setMode(DEFAULT_MODE);
+
+#ifdef BENCHMARK
+  //run the micro-benchmarks instead of the tasks, then wait for benchmark.gdb to read the results
+  benchmarkRunAll(BENCHMARK_ITERATIONS, NULL);
+  while(1)
+	  __WFI();
+#endif
+
+  //the drivers only run on their interrupts, timers expiry and pending work (the gyroscope has no interrupt wired)
+  schedulerAddTask(TASK_ACCELEROMETER, accelerometerTask, 0, ACCELEROMETER_DEADLINE_US);
+  schedulerAddTask(TASK_SCREEN, screenTask, 0, 0);
+#ifdef USE_GYRO
+  schedulerAddTask(TASK_GYROSCOPE, gyroscopeTask, GYROSCOPE_PERIOD_MS, GYROSCOPE_DEADLINE_US);
+#endif
+  schedulerAddTask(TASK_PROCESSING, processingTask, 0, PROCESSING_DEADLINE_US);
+  schedulerAddTask(TASK_INTERFACE, interfaceTask, INTERFACE_PERIOD_MS, 0);
+  schedulerAddTask(TASK_ANALOG, analogTask, ANALOG_PERIOD_MS, 0);
+  signalDrivers();
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-	  //update the accelerometer state machine
-	  result = ADXL345update();
-	  if(IS_ERROR(result))
-		  result.fields.moduleID = 1;
-
-	  //update the screen state machine
-	  result = SSD1306update();
-	  if(IS_ERROR(result))
-		  result.fields.moduleID = 2;
-
-	  //if X axis angle changed, update the screen
-	  if(isScreenReady() && ADXL345hasChanged(X_AXIS))
-		  SSD1306_printAngle(measureToAngleDegrees(ADXL345getValue(X_AXIS)), SSD1306_LINE1_PAGE, SSD1306_LINE1_COLUMN);
-
-	  //if Y axis angle changed, update the screen
-	  if(isScreenReady() && ADXL345hasChanged(Y_AXIS))
-		  SSD1306_printAngle(measureToAngleDegrees(ADXL345getValue(Y_AXIS)), SSD1306_LINE2_PAGE, SSD1306_LINE2_COLUMN);
+	  //run the highest-priority ready task, or sleep until the next interrupt
+	  schedulerRunNext();
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -136,6 +306,7 @@ void SystemClock_Config(void)
 {
   RCC_OscInitTypeDef RCC_OscInitStruct = {0};
   RCC_ClkInitTypeDef RCC_ClkInitStruct = {0};
+  RCC_PeriphCLKInitTypeDef PeriphClkInit = {0};
 
   /** Initializes the RCC Oscillators according to the specified parameters
   * in the RCC_OscInitTypeDef structure.
@@ -165,6 +336,12 @@ void SystemClock_Config(void)
   {
     Error_Handler();
   }
+  PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_ADC;
+  PeriphClkInit.AdcClockSelection = RCC_ADCPCLK2_DIV6;
+  if (HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit) != HAL_OK)
+  {
+    Error_Handler();
+  }
 }
 
 /**
@@ -200,6 +377,7 @@ static void MX_SPI1_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN SPI1_Init 2 */
+  //the baud rate prescaler is renegotiated at runtime by the ADXL345 state machine
 
   /* USER CODE END SPI1_Init 2 */
 
@@ -243,6 +421,72 @@ static void MX_SPI2_Init(void)
 
 }
 
+/**
+  * @brief ADC1 Initialization Function
+  * @param None
+  * @retval None
+  */
+static void MX_ADC1_Init(void)
+{
+
+  /* USER CODE BEGIN ADC1_Init 0 */
+
+  /* USER CODE END ADC1_Init 0 */
+
+  ADC_ChannelConfTypeDef sConfig = {0};
+
+  /* USER CODE BEGIN ADC1_Init 1 */
+
+  /* USER CODE END ADC1_Init 1 */
+
+  /** Common config
+  */
+  hadc1.Instance = ADC1;
+  hadc1.Init.ScanConvMode = ADC_SCAN_ENABLE;
+  hadc1.Init.ContinuousConvMode = ENABLE;
+  hadc1.Init.DiscontinuousConvMode = DISABLE;
+  hadc1.Init.ExternalTrigConv = ADC_SOFTWARE_START;
+  hadc1.Init.DataAlign = ADC_DATAALIGN_RIGHT;
+  hadc1.Init.NbrOfConversion = 3;
+  if (HAL_ADC_Init(&hadc1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /** Configure Regular Channel
+  */
+  sConfig.Channel = ADC_CHANNEL_VREFINT;
+  sConfig.Rank = ADC_REGULAR_RANK_1;
+  sConfig.SamplingTime = ADC_SAMPLETIME_239CYCLES_5;
+  if (HAL_ADC_ConfigChannel(&hadc1, &sConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /** Configure Regular Channel
+  */
+  sConfig.Channel = ADC_CHANNEL_TEMPSENSOR;
+  sConfig.Rank = ADC_REGULAR_RANK_2;
+  if (HAL_ADC_ConfigChannel(&hadc1, &sConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /** Configure Regular Channel
+  */
+  sConfig.Channel = ADC_CHANNEL_1;
+  sConfig.Rank = ADC_REGULAR_RANK_3;
+  if (HAL_ADC_ConfigChannel(&hadc1, &sConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  /* USER CODE BEGIN ADC1_Init 2 */
+  //the channels order must match analogChannels_e
+
+  /* USER CODE END ADC1_Init 2 */
+
+}
+
 /**
   * Enable DMA controller clock
   */
@@ -253,8 +497,11 @@ static void MX_DMA_Init(void)
   __HAL_RCC_DMA1_CLK_ENABLE();
 
   /* DMA interrupt init */
+  /* DMA1_Channel1_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
   /* DMA1_Channel5_IRQn interrupt configuration */
-  HAL_NVIC_SetPriority(DMA1_Channel5_IRQn, 0, 0);
+  HAL_NVIC_SetPriority(DMA1_Channel5_IRQn, 5, 0);
   HAL_NVIC_EnableIRQ(DMA1_Channel5_IRQn);
 
 }
@@ -275,11 +522,16 @@ static void MX_GPIO_Init(void)
   __HAL_RCC_GPIOA_CLK_ENABLE();
   __HAL_RCC_GPIOB_CLK_ENABLE();
 
+  /*Configure GPIO pin Output Level */
+  HAL_GPIO_WritePin(GYRO_CS_GPIO_Port, GYRO_CS_Pin, GPIO_PIN_SET);
+
   /*Configure GPIO pin Output Level */
   HAL_GPIO_WritePin(GPIOA, ADXL_CS_Pin|SSD1306_CS_Pin|SSD1306_DC_Pin|SSD1306_RST_Pin, GPIO_PIN_RESET);
 
-  /*Configure GPIO pins : ADXL_CS_Pin SSD1306_CS_Pin SSD1306_DC_Pin SSD1306_RST_Pin */
-  GPIO_InitStruct.Pin = ADXL_CS_Pin|SSD1306_CS_Pin|SSD1306_DC_Pin|SSD1306_RST_Pin;
+  /*Configure GPIO pins : GYRO_CS_Pin ADXL_CS_Pin SSD1306_CS_Pin SSD1306_DC_Pin
+                           SSD1306_RST_Pin */
+  GPIO_InitStruct.Pin = GYRO_CS_Pin|ADXL_CS_Pin|SSD1306_CS_Pin|SSD1306_DC_Pin
+                          |SSD1306_RST_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
@@ -292,7 +544,7 @@ static void MX_GPIO_Init(void)
   HAL_GPIO_Init(ADXL_INT1_GPIO_Port, &GPIO_InitStruct);
 
   /* EXTI interrupt init*/
-  HAL_NVIC_SetPriority(EXTI0_IRQn, 0, 0);
+  HAL_NVIC_SetPriority(EXTI0_IRQn, 5, 0);
   HAL_NVIC_EnableIRQ(EXTI0_IRQn);
 
 /* USER CODE BEGIN MX_GPIO_Init_2 */
@@ -300,6 +552,569 @@ static void MX_GPIO_Init(void)
 }
 
 /* USER CODE BEGIN 4 */
+/**
+ * @brief Switch the application mode
+ *
+ * @param mode New application mode
+ */
+static void setMode(appMode_e mode){
+	if(mode == _mode)
+		return;
+
+	_mode = mode;
+	_peakToPrint = 0;
+	_motorToPrint = 0;
+	_hold = 0;
+	_relativeToPrint = 0;
+	_relativeStale = 1;
+	_captureBlocks = 0;
+	_calibrationToPrint = 2;
+	_averagingToPrint = 2;
+	_preciseToPrint = 0;
+	_gaugeToPrint = 1;
+	spscFlush(&_motorResults);
+	spscFlush(&_peakResults);
+	spscFlush(&_preciseResults);
+#ifdef USE_GYRO
+	_dynamicPrinted[0] = INT16_MAX;
+	_dynamicPrinted[1] = INT16_MAX;
+#endif
+	screenSetInverted(0);
+	spectrumReset();
+	goertzelReset();
+	oversamplingReset();
+	SENSOR.setDataRate(mode == MODE_SPECTRUM ? SPECTRUM_RATE : LEVEL_RATE);
+	screenDrawImage(_modeScreens[mode], 0, 0);
+}
+
+/**
+ * @brief Print the X and Y angles each time they change
+ */
+static void updateLevel(){
+	float angle;
+
+	//if angles held, leave the screen untouched
+	if(_hold)
+		return;
+
+	//if X axis angle changed, update the screen
+	if(isScreenReady() && SENSOR.hasChanged(X_AXIS)){
+		angle = SENSOR.measureToAngle(SENSOR.getValue(X_AXIS));
+		tracerMark(TRACE_COMPUTED);
+		screenPrintAngle(angle, SCREEN_LINE1_PAGE, SCREEN_LINE1_COLUMN);
+	}
+
+	//if Y axis angle changed, update the screen
+	if(isScreenReady() && SENSOR.hasChanged(Y_AXIS)){
+		angle = SENSOR.measureToAngle(SENSOR.getValue(Y_AXIS));
+		tracerMark(TRACE_COMPUTED);
+		screenPrintAngle(angle, SCREEN_LINE2_PAGE, SCREEN_LINE2_COLUMN);
+	}
+}
+
+/**
+ * @brief Print the X and Y angles averaged over the oversampling window in hundredths of degrees, one line at a time
+ */
+static void updatePrecision(){
+	uint32_t angles;
+
+	//keep the latest angles received
+	while(spscPop(&_preciseResults, &angles)){
+		_preciseAngles[0] = (float)(int16_t)(angles >> HALF_SHIFT) / HUNDREDTHS_PER_DEGREE;
+		_preciseAngles[1] = (float)(int16_t)(angles & HALF_MASK) / HUNDREDTHS_PER_DEGREE;
+		_preciseToPrint = 2;
+	}
+
+	if(!_preciseToPrint || !isScreenReady())
+		return;
+
+	if(_preciseToPrint-- > 1)
+		screenPrintPreciseAngle(_preciseAngles[0], SCREEN_LINE1_PAGE, SCREEN_LINE1_COLUMN);
+	else
+		screenPrintPreciseAngle(_preciseAngles[1], SCREEN_LINE2_PAGE, SCREEN_LINE2_COLUMN);
+}
+
+/**
+ * @brief Print the X and Y angles relative to the reference each time the measurements change, one line at a time
+ */
+static void updateRelative(){
+	int16_t measured[REFERENCE_NB_AXIS];
+	int16_t relative[REFERENCE_NB_AXIS];
+
+	//if any axis changed (all flags cleared), express the measurements in the reference frame
+	if(SENSOR.hasChanged(X_AXIS) | SENSOR.hasChanged(Y_AXIS) | SENSOR.hasChanged(Z_AXIS) | _relativeStale){
+		SENSOR.getVector(measured);
+
+		referenceApply(measured, relative);
+		_relativeAngles[0] = SENSOR.vectorToAngle(relative[X_AXIS], relative[Z_AXIS]);
+		_relativeAngles[1] = SENSOR.vectorToAngle(relative[Y_AXIS], relative[Z_AXIS]);
+		tracerMark(TRACE_COMPUTED);
+		_relativeToPrint = 2;
+		_relativeStale = 0;
+	}
+
+	if(!_relativeToPrint || !isScreenReady())
+		return;
+
+	if(_relativeToPrint-- > 1)
+		screenPrintAngle(_relativeAngles[0], SCREEN_LINE1_PAGE, SCREEN_LINE1_COLUMN);
+	else
+		screenPrintAngle(_relativeAngles[1], SCREEN_LINE2_PAGE, SCREEN_LINE2_COLUMN);
+}
+
+/**
+ * @brief Print the dominant frequency (Hz) and amplitude (mg) of the last spectrum computed, one line at a time
+ */
+static void updateSpectrum(){
+	uint32_t peak;
+
+	//keep the latest peak received
+	while(spscPop(&_peakResults, &peak)){
+		_peak.frequency_Hz = (uint16_t)(peak >> HALF_SHIFT);
+		_peak.amplitude = (uint16_t)(peak & HALF_MASK);
+		_peakToPrint = 2;
+	}
+
+	if(!_peakToPrint || !isScreenReady())
+		return;
+
+	if(_peakToPrint-- > 1)
+		screenPrintNumber(_peak.frequency_Hz, SCREEN_LINE1_PAGE, SCREEN_LINE1_COLUMN);
+	else
+		screenPrintNumber((uint16_t)((_peak.amplitude * SENSOR.format.scale_ug) / UG_PER_MG), SCREEN_LINE2_PAGE, SCREEN_LINE2_COLUMN);
+}
+
+/**
+ * @brief Print the amplitudes (mg) found at the two first motor frequencies, one line at a time
+ */
+static void updateMotor(){
+	uint32_t amplitudes;
+
+	//keep the latest amplitudes received
+	while(spscPop(&_motorResults, &amplitudes)){
+		_motorAmplitudes[0] = (uint16_t)(amplitudes & HALF_MASK);
+		_motorAmplitudes[1] = (uint16_t)(amplitudes >> HALF_SHIFT);
+		_motorToPrint = MOTOR_NB_LINES;
+	}
+
+	if(!_motorToPrint || !isScreenReady())
+		return;
+
+	if(_motorToPrint-- > 1)
+		screenPrintNumber((uint16_t)((_motorAmplitudes[0] * SENSOR.format.scale_ug) / UG_PER_MG), SCREEN_LINE1_PAGE, SCREEN_LINE1_COLUMN);
+	else
+		screenPrintNumber((uint16_t)((_motorAmplitudes[1] * SENSOR.format.scale_ug) / UG_PER_MG), SCREEN_LINE2_PAGE, SCREEN_LINE2_COLUMN);
+}
+
+/**
+ * @brief Print the die temperature (degrees) and the number of temperatures calibrated, one line at a time
+ */
+static void updateCalibration(){
+	if(!_calibrationToPrint || !isScreenReady())
+		return;
+
+	if(_calibrationToPrint-- > 1)
+		screenPrintTemperature(_analog.temperature_dC, SCREEN_LINE1_PAGE, SCREEN_LINE1_COLUMN);
+	else
+		screenPrintNumber(compensationGetNbCalibrated(), SCREEN_LINE2_PAGE, SCREEN_LINE2_COLUMN);
+}
+
+/**
+ * @brief Print the number of samples averaged per measurement and the resulting update period (ms), one line at a time
+ */
+static void updateAveraging(){
+	if(!_averagingToPrint || !isScreenReady())
+		return;
+
+	if(_averagingToPrint-- > 1)
+		screenPrintNumber(SENSOR.getAveraging(), SCREEN_LINE1_PAGE, SCREEN_LINE1_COLUMN);
+	else
+		screenPrintNumber((uint16_t)(SENSOR.getAveraging() * LEVEL_SAMPLE_MS), SCREEN_LINE2_PAGE, SCREEN_LINE2_COLUMN);
+}
+
+#ifdef USE_GYRO
+/**
+ * @brief Print the X and Y angles fused with the gyroscope each time their tenths change
+ * 		  (the accelerometer angles if no gyroscope answered)
+ */
+static void updateDynamic(){
+	float angles[FUSION_NB_ANGLES];
+	int16_t measured[NB_AXIS];
+	int16_t tenths;
+
+	if(L3GD20isPresent())
+		fusionGetAngles(angles);
+	else{
+		SENSOR.getVector(measured);
+		angles[0] = SENSOR.vectorToAngle(measured[X_AXIS], measured[Z_AXIS]);
+		angles[1] = SENSOR.vectorToAngle(measured[Y_AXIS], measured[Z_AXIS]);
+	}
+
+	//if X axis angle changed, update the screen
+	tenths = (int16_t)(angles[0] * DC_PER_DEGREE);
+	if(isScreenReady() && (tenths != _dynamicPrinted[0])){
+		screenPrintAngle(angles[0], SCREEN_LINE1_PAGE, SCREEN_LINE1_COLUMN);
+		_dynamicPrinted[0] = tenths;
+	}
+
+	//if Y axis angle changed, update the screen
+	tenths = (int16_t)(angles[1] * DC_PER_DEGREE);
+	if(isScreenReady() && (tenths != _dynamicPrinted[1])){
+		screenPrintAngle(angles[1], SCREEN_LINE2_PAGE, SCREEN_LINE2_COLUMN);
+		_dynamicPrinted[1] = tenths;
+	}
+}
+#endif
+
+/**
+ * @brief Task retrieving the new analog values, updating the offsets with the temperature and the gauge with the battery charge
+ *
+ * @return Error code of the analog values retrieval
+ */
+static errorCode_u analogTask(){
+	int16_t offsets[COMPENSATION_NB_AXIS];
+	uint8_t previousPercent = _analog.batteryPercent;
+	errorCode_u result;
+
+	result = analogGetValues(&_analog);
+	if(IS_ERROR(result))
+		return (result);
+
+	compensationUpdate(_analog.temperature_dC, offsets);
+	SENSOR.setOffsets(offsets);
+
+	if(_analog.batteryPercent != previousPercent)
+		_gaugeToPrint = 1;
+
+	if(_mode == MODE_CALIBRATION)
+		_calibrationToPrint = 2;
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Task running the accelerometer state machine, and signalling the processing task once a block is complete
+ *
+ * @return Error code of the accelerometer state machine
+ */
+static errorCode_u accelerometerTask(){
+	errorCode_u result;
+
+	result = SENSOR.update();
+	if(SENSOR.hasNewBlock())
+		schedulerSignal(TASK_PROCESSING);
+
+	signalDrivers();
+	return (result);
+}
+
+/**
+ * @brief Task running the screen state machine
+ *
+ * @return Error code of the screen state machine
+ */
+static errorCode_u screenTask(){
+	errorCode_u result;
+
+	result = screenUpdate();
+	signalDrivers();
+	return (result);
+}
+
+/**
+ * @brief Task feeding the last samples block to the Goertzel filters bank if in motor mode, to the spectrum window if in spectrum mode,
+ * 		  and its fine average to the oversampling window if in precision mode (and to the attitude fusion if built with it)
+ *
+ * @return Success
+ */
+static errorCode_u processingTask(){
+	sensorBlockTiming_t timing;
+	spectrumPeak_t peak;
+	const int16_t* samples;
+	uint8_t nbSamples;
+	int32_t fine[NB_AXIS];
+	int16_t angleX, angleY;
+
+	//if samples have been lost, restart the analyses
+	SENSOR.getBlockTiming(&timing);
+	if(!timing.contiguous){
+		goertzelReset();
+		spectrumReset();
+	}
+
+	//once a block has been measured entirely after the tap, capture its measurements
+	if(_captureBlocks && !--_captureBlocks)
+		captureBlock();
+
+	//run the filters bank on every sample, and get the amplitudes of the window ending with the block
+	nbSamples = SENSOR.getBlock(ANALYSIS_AXIS, &samples);
+	if(_mode == MODE_MOTOR){
+		goertzelAddSamples(samples, nbSamples, timing.samplePeriod_ns);
+		if(goertzelHasNewResults()){
+			spscPush(&_motorResults, ((uint32_t)goertzelGetAmplitude(1) << HALF_SHIFT) | goertzelGetAmplitude(0));
+			tracerMark(TRACE_COMPUTED);
+		}
+	}
+
+	//add the block to the spectrum window, and compute it once full
+	if((_mode == MODE_SPECTRUM) && spectrumAddSamples(samples, nbSamples)){
+		spectrumCompute(timing.samplePeriod_ns, &peak);
+		spscPush(&_peakResults, ((uint32_t)peak.frequency_Hz << HALF_SHIFT) | peak.amplitude);
+	}
+
+	//give the fine measurements to the attitude fusion as its reference, measured in the middle of the block
+	SENSOR.getFineVector(fine);
+#ifdef USE_GYRO
+	if(nbSamples)
+		fusionSetReference(fine, FINE_ONE_G, (timestampGet_us() - timing.timestamp_us)
+											 + (((nbSamples - 1U) * timing.samplePeriod_ns) / (NS_PER_US * 2U)));
+#endif
+
+	//average the fine measurements over several blocks, and compute the angles from the sums
+	if(_mode == MODE_PRECISION){
+		oversamplingAddVector(fine);
+		oversamplingGetSums(fine);
+		angleX = (int16_t)lroundf(SENSOR.vectorToAngle(fine[X_AXIS], fine[Z_AXIS]) * HUNDREDTHS_PER_DEGREE);
+		angleY = (int16_t)lroundf(SENSOR.vectorToAngle(fine[Y_AXIS], fine[Z_AXIS]) * HUNDREDTHS_PER_DEGREE);
+		spscPush(&_preciseResults, ((uint32_t)(uint16_t)angleX << HALF_SHIFT) | (uint16_t)angleY);
+		tracerMark(TRACE_COMPUTED);
+	}
+
+	return (ERR_SUCCESS);
+}
+
+#ifdef USE_GYRO
+/**
+ * @brief Task running the gyroscope state machine, and fusing each new sample with the last accelerometer angles
+ *
+ * @return Error code of the gyroscope state machine
+ */
+static errorCode_u gyroscopeTask(){
+	const int16_t (*rates)[L3GD_NB_AXIS];
+	errorCode_u result;
+	uint8_t nbSamples;
+
+	result = L3GD20update();
+	nbSamples = L3GD20getSamples(&rates);
+	if(nbSamples)
+		fusionAddRates(rates, nbSamples);
+
+	return (result);
+}
+#endif
+
+/**
+ * @brief Task handling the tap gestures and the display power, updating the current application mode and printing the battery gauge
+ *
+ * @return Success
+ */
+static errorCode_u interfaceTask(){
+	uint8_t activity;
+
+	//a tap or a motion wakes the panel up
+	if(!_pendingGesture)
+		_pendingGesture = SENSOR.getGesture();
+	activity = (SENSOR.hasActivity() || _pendingGesture);
+	updatePower(activity);
+
+	//a tap on the panel off only wakes it up (the motion of the tap may have woken it up before the tap is reported)
+	if((_power == POWER_OFF) || ((HAL_GetTick() - _wokenUp_ms) < WAKE_TAP_MS))
+		_pendingGesture = SENSOR_NO_GESTURE;
+
+	//handle the tap gestures once the screen is ready
+	if(_pendingGesture && isScreenReady())
+		handleGesture();
+
+	//update the current application mode
+	switch(_mode){
+		case MODE_PRECISION:
+			updatePrecision();
+			break;
+
+		case MODE_RELATIVE:
+			updateRelative();
+			break;
+
+		case MODE_SPECTRUM:
+			updateSpectrum();
+			break;
+
+		case MODE_MOTOR:
+			updateMotor();
+			break;
+
+		case MODE_CALIBRATION:
+			updateCalibration();
+			break;
+
+		case MODE_AVERAGING:
+			updateAveraging();
+			break;
+
+#ifdef USE_GYRO
+		case MODE_DYNAMIC:
+			updateDynamic();
+			break;
+#endif
+
+		case MODE_LEVEL:
+		case NB_MODES:
+		default:
+			updateLevel();
+			break;
+	}
+
+	//print the battery gauge once the mode lines are printed
+	if(_gaugeToPrint && isScreenReady()){
+		screenPrintGauge(_analog.batteryPercent, SCREEN_GAUGE_PAGE, SCREEN_GAUGE_COLUMN);
+		_gaugeToPrint = 0;
+	}
+
+	//run the drivers on the requests just made to them
+	signalDrivers();
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Act on the pending tap gesture
+ * @details A single tap holds/releases the angles in level mode (display inverted while held),
+ * 			or restarts the averaging window in precision mode (e.g. once the device has been moved),
+ * 			or captures the orientation measured after the tap as the reference in relative mode,
+ * 			or stores the offsets measured after the tap at the current temperature in calibration mode (device lying flat),
+ * 			or switches between fast and precise averaging in averaging mode,
+ * 			a double tap switches to the next mode
+ */
+static void handleGesture(){
+	switch(_pendingGesture){
+		case SENSOR_SINGLE_TAP:
+			if(_mode == MODE_LEVEL){
+				_hold = !_hold;
+				screenSetInverted(_hold);
+			}
+			else if(_mode == MODE_PRECISION)
+				oversamplingReset();
+			else if((_mode == MODE_RELATIVE) || (_mode == MODE_CALIBRATION))
+				_captureBlocks = CAPTURE_BLOCKS;
+			else if(_mode == MODE_AVERAGING){
+				SENSOR.setAveraging(SENSOR.getAveraging() == AVERAGING_FAST ? AVERAGING_PRECISE : AVERAGING_FAST);
+				_averagingToPrint = 2;
+			}
+			break;
+
+		case SENSOR_DOUBLE_TAP:
+			setMode((appMode_e)((_mode + 1) % NB_MODES));
+			break;
+
+		case SENSOR_NO_GESTURE:
+		default:
+			break;
+	}
+
+	_pendingGesture = SENSOR_NO_GESTURE;
+}
+
+/**
+ * @brief Capture the measurements of the last block as asked by a tap
+ * @details The block published when the tap is handled may have been measured during the tap shock,
+ * 			this is only called on the first block measured entirely after it.
+ */
+static void captureBlock(){
+	const int16_t flat[COMPENSATION_NB_AXIS] = {0, 0, SENSOR.format.oneG};
+	int16_t measured[NB_AXIS];
+
+	SENSOR.getVector(measured);
+	if(_mode == MODE_RELATIVE){
+		referenceCapture(measured);
+		_relativeStale = 1;
+	}
+	else if(_mode == MODE_CALIBRATION){
+		compensationCalibrate(measured, flat);
+		_calibrationToPrint = 2;
+	}
+}
+
+/**
+ * @brief Bring the display power one step closer to the one suited to the time since the last activity
+ * @details The panel is dimmed after DIM_DELAY_MS without angle change nor tap, and turned off after OFF_DELAY_MS.
+ * 			While off, the accelerometer watches for a motion from the position it was left in : its interrupt
+ * 			fires on the first sample out of the threshold, instead of waiting for a whole block to be averaged.
+ * 			Each step is a command queued in the screen state machine, so a wake up from off takes two tasks runs.
+ *
+ * @param activity 1 if a tap or a motion has been detected since the last call
+ */
+static void updatePower(uint8_t activity){
+	int16_t measured[NB_AXIS];
+	powerState_e target;
+	int16_t delta;
+	uint32_t idle_ms;
+
+	//an axis moving by more than the deadband is an angle change, and the new position to stay still in
+	SENSOR.getVector(measured);
+	for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++){
+		delta = (int16_t)(measured[axis] - _stillVector[axis]);
+		if((delta > STILL_DEADBAND) || (delta < -STILL_DEADBAND))
+			activity = 1;
+	}
+	if(activity){
+		for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++)
+			_stillVector[axis] = measured[axis];
+		_lastActivity_ms = HAL_GetTick();
+	}
+
+	//get the power state suited to the idle time
+	idle_ms = HAL_GetTick() - _lastActivity_ms;
+	if(idle_ms >= OFF_DELAY_MS)
+		target = POWER_OFF;
+	else if(idle_ms >= DIM_DELAY_MS)
+		target = POWER_DIMMED;
+	else
+		target = POWER_AWAKE;
+
+	if((target == _power) || !isScreenReady())
+		return;
+
+	//step towards it (the panel keeps its contrast while off, so it comes back dimmed)
+	switch(_power){
+		case POWER_AWAKE:
+			screenSetContrast(CONTRAST_DIMMED);
+			_power = POWER_DIMMED;
+			break;
+
+		case POWER_DIMMED:
+			if(target == POWER_OFF){
+				screenSetPower(0);
+				SENSOR.watchActivity(1);
+				_power = POWER_OFF;
+			}
+			else{
+				screenSetContrast(CONTRAST_AWAKE);
+				_power = POWER_AWAKE;
+			}
+			break;
+
+		case POWER_OFF:
+		default:
+			SENSOR.watchActivity(0);
+			screenSetPower(1);
+			_wokenUp_ms = HAL_GetTick();
+			_power = POWER_DIMMED;
+			break;
+	}
+}
+
+/**
+ * @brief Signal the drivers tasks whose state machine has work to do right away
+ * @details The drivers tasks are not periodic : their interrupts and timers expiry signal them,
+ * 			and this function signals them again as long as their state machine is not only waiting for one of those
+ * 			(requests made from the other tasks, states chained).
+ */
+static void signalDrivers(){
+	if(!SENSOR.isWaiting())
+		schedulerSignal(TASK_ACCELEROMETER);
+
+	if(!isScreenWaiting())
+		schedulerSignal(TASK_SCREEN);
+}
 
 /* USER CODE END 4 */
 
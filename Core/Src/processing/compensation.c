@@ -0,0 +1,166 @@
+/**
+ * @file compensation.c
+ * @brief Implement the compensation of the accelerometer offsets drift with the temperature
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * A per-device table, stored in the settings, holds the offsets of each axis
+ * along with the temperature at which they have been calibrated. Each entry covers
+ * COMPENSATION_STEP_DC, the first one being centred on COMPENSATION_FIRST_DC
+ * (-10 to +40 degrees with the default values), which keeps the table sorted by temperature.
+ *
+ * The offsets applied at a given temperature are linearly interpolated between
+ * the two closest calibrated entries surrounding it. Outside the calibrated range,
+ * the closest calibrated entry is used as-is. Without any calibration, no offset is applied.
+ *
+ * Calibration is done with the device resting in a known orientation :
+ * the difference between the raw measurement and the expected one is stored in the entry
+ * closest to the current temperature. Repeating it at several temperatures fills the table.
+ */
+#include "compensation.h"
+#include "settings.h"
+
+//definitions
+#define NO_ENTRY	0xFFU	///< Value indicating no calibrated entry has been found
+
+/**
+ * @brief Enumeration of the function IDs of the compensation
+ */
+typedef enum _compensationFunctionCodes_e{
+	CALIBRATE = 0,	///< compensationCalibrate()
+}compensationFunctionCodes_e;
+
+//tool functions
+static uint8_t closestEntry(int16_t temperature_dC);
+static inline uint8_t isCalibrated(uint8_t entry);
+
+//state variables
+static int16_t	_temperature_dC = 0;						///< Temperature of the last update (in tenths of degrees)
+static int16_t	_offsets[COMPENSATION_NB_AXIS] = {0};		///< Offsets computed during the last update
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Compute the offsets to apply at a temperature
+ *
+ * @param temperature_dC Current temperature (in tenths of degrees)
+ * @param[out] offsets Offsets to subtract from the measurements, per axis
+ */
+void compensationUpdate(int16_t temperature_dC, int16_t offsets[COMPENSATION_NB_AXIS]){
+	const settings_t* settings = settingsGet();
+	uint8_t lower = NO_ENTRY;
+	uint8_t upper = NO_ENTRY;
+
+	_temperature_dC = temperature_dC;
+
+	//find the closest calibrated entries below and above the temperature
+	for(uint8_t entry = 0 ; entry < SETTINGS_NB_TEMPS ; entry++){
+		if(!isCalibrated(entry))
+			continue;
+
+		if(settings->offsetsTemperature_dC[entry] <= temperature_dC)
+			lower = entry;
+		else if(upper == NO_ENTRY)
+			upper = entry;
+	}
+
+	//if outside the calibrated range, use the closest entry
+	if(lower == NO_ENTRY)
+		lower = upper;
+	if(upper == NO_ENTRY)
+		upper = lower;
+
+	for(uint8_t axis = 0 ; axis < COMPENSATION_NB_AXIS ; axis++){
+		//no calibration at all
+		if(lower == NO_ENTRY)
+			_offsets[axis] = 0;
+
+		//single entry or temperature out of range
+		else if(lower == upper)
+			_offsets[axis] = settings->offsets[lower][axis];
+
+		//interpolate between the two entries (rounded to the nearest)
+		else{
+			int32_t span = settings->offsetsTemperature_dC[upper] - settings->offsetsTemperature_dC[lower];
+			int32_t position = temperature_dC - settings->offsetsTemperature_dC[lower];
+			int32_t product = (settings->offsets[upper][axis] - settings->offsets[lower][axis]) * position;
+			product += ((product < 0) ? -(span >> 1) : (span >> 1));
+			_offsets[axis] = (int16_t)(settings->offsets[lower][axis] + (product / span));
+		}
+
+		offsets[axis] = _offsets[axis];
+	}
+}
+
+/**
+ * @brief Store the offsets measured at the current temperature in the table entry covering it, and save it
+ * @note The measurement must have been compensated with the offsets of the last update
+ *
+ * @param measured Compensated measurement of the device resting in a known orientation
+ * @param expected Measurement expected in this orientation
+ * @retval 0 Success
+ * @retval 1 Error while saving the settings
+ */
+errorCode_u compensationCalibrate(const int16_t measured[COMPENSATION_NB_AXIS], const int16_t expected[COMPENSATION_NB_AXIS]){
+	settings_t* settings = settingsGet();
+	uint8_t entry = closestEntry(_temperature_dC);
+	errorCode_u result;
+
+	//raw offset = compensated measurement + offset applied - expected measurement
+	for(uint8_t axis = 0 ; axis < COMPENSATION_NB_AXIS ; axis++)
+		settings->offsets[entry][axis] = (int16_t)(measured[axis] + _offsets[axis] - expected[axis]);
+	settings->offsetsTemperature_dC[entry] = _temperature_dC;
+	settings->offsetsValid |= (uint16_t)(1U << entry);
+
+	result = settingsSave();
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, CALIBRATE, 1));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Get the number of temperatures calibrated in the table
+ *
+ * @return Number of temperatures calibrated
+ */
+uint8_t compensationGetNbCalibrated(){
+	uint8_t count = 0;
+
+	for(uint8_t entry = 0 ; entry < SETTINGS_NB_TEMPS ; entry++)
+		count += isCalibrated(entry);
+
+	return (count);
+}
+
+/**
+ * @brief Find the table entry the closest to a temperature
+ *
+ * @param temperature_dC Temperature (in tenths of degrees)
+ * @return Closest entry
+ */
+static uint8_t closestEntry(int16_t temperature_dC){
+	int32_t entry = (temperature_dC - COMPENSATION_FIRST_DC + (COMPENSATION_STEP_DC / 2)) / COMPENSATION_STEP_DC;
+
+	if(temperature_dC < COMPENSATION_FIRST_DC)
+		entry = 0;
+	if(entry >= (int32_t)SETTINGS_NB_TEMPS)
+		entry = SETTINGS_NB_TEMPS - 1;
+
+	return ((uint8_t)entry);
+}
+
+/**
+ * @brief Check if a table entry has been calibrated
+ *
+ * @param entry Table entry
+ * @retval 0 Entry not calibrated
+ * @retval 1 Entry calibrated
+ */
+static inline uint8_t isCalibrated(uint8_t entry){
+	return ((settingsGet()->offsetsValid >> entry) & 1U);
+}
@@ -0,0 +1,232 @@
+/**
+ * @file fft.c
+ * @brief Implement an in-place fixed-point (Q15) radix-4 FFT
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The buffers are arrays of FFT_SIZE complex values, stored as interleaved real and imaginary parts
+ * (the same layout as CMSIS-DSP arm_cfft_q15()).
+ *
+ * The values are reordered in bit-reversed order, then combined by radix-4 butterflies
+ * (each one merging two radix-2 stages, hence half the stages and 25 % fewer twiddle multiplications).
+ * When log2(FFT_SIZE) is odd, a single radix-2 stage without twiddles comes first.
+ *
+ * Each butterfly stage divides its results by its radix to prevent overflows,
+ * so the transform output is scaled down by FFT_SIZE.
+ *
+ * Twiddle factors and window coefficients all come from a single quarter-wave sine table
+ * covering FFT_MAX_SIZE points. Smaller transforms step through it with a compile-time stride,
+ * so no RAM is needed for tables whatever the transform size.
+ */
+#include "fft.h"
+#include <stm32f1xx.h>
+
+//definitions
+#define QUARTER_WAVE	(FFT_MAX_SIZE >> 2)		///< Number of angle steps in a quarter wave
+#define QUADRANT_SHIFT	8U						///< Shift giving the quadrant of an angle
+#define ANGLE_MASK		(FFT_MAX_SIZE - 1U)		///< Mask used to wrap angles around a full wave
+#define TABLE_STRIDE	(FFT_MAX_SIZE / FFT_SIZE)	///< Stride in the sine table for the transform size
+#define Q15_SHIFT		15U						///< Number of fractional bits in a Q15 value
+#define Q15_ONE			32768					///< Value of 1.0 in Q15 (not representable as int16_t)
+#define INT16_BITS		16U						///< Number of bits in a 16-bits integer
+#define REAL			0U						///< Offset of the real part of a complex value
+#define IMAGINARY		1U						///< Offset of the imaginary part of a complex value
+#define RADIX2_SHIFT	1U						///< Shift scaling down the results of a radix-2 butterfly
+#define RADIX4_SHIFT	2U						///< Shift scaling down the results of a radix-4 butterfly
+
+//the radix-4 stages cover two bits each, a radix-2 stage covers the remaining one when log2(FFT_SIZE) is odd
+#if (FFT_SIZE == 32U) || (FFT_SIZE == 128U) || (FFT_SIZE == 512U)
+#define FIRST_RADIX4_SPAN	2U					///< Span of the first radix-4 stage (after the radix-2 one)
+#else
+#define FIRST_RADIX4_SPAN	1U					///< Span of the first radix-4 stage
+#endif
+
+#if (QUARTER_WAVE >> QUADRANT_SHIFT) != 1
+#error QUADRANT_SHIFT does not match the sine table size
+#endif
+
+//tool functions
+static void rotate(const int16_t value[], int32_t twiddleReal, int32_t twiddleImag, int32_t rotated[]);
+
+/**
+ * @brief Quarter-wave sine table in Q15 (sin(pi/2 * i / QUARTER_WAVE))
+ */
+static const int16_t sineTable[QUARTER_WAVE + 1] = {
+	0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210, 2410, 2611, 2811, 3012,
+	3212, 3412, 3612, 3811, 4011, 4210, 4410, 4609, 4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195,
+	6393, 6590, 6786, 6983, 7179, 7375, 7571, 7767, 7962, 8157, 8351, 8545, 8739, 8933, 9126, 9319,
+	9512, 9704, 9896, 10087, 10278, 10469, 10659, 10849, 11039, 11228, 11417, 11605, 11793, 11980, 12167, 12353,
+	12539, 12725, 12910, 13094, 13279, 13462, 13645, 13828, 14010, 14191, 14372, 14553, 14732, 14912, 15090, 15269,
+	15446, 15623, 15800, 15976, 16151, 16325, 16499, 16673, 16846, 17018, 17189, 17360, 17530, 17700, 17869, 18037,
+	18204, 18371, 18537, 18703, 18868, 19032, 19195, 19357, 19519, 19680, 19841, 20000, 20159, 20317, 20475, 20631,
+	20787, 20942, 21096, 21250, 21403, 21554, 21705, 21856, 22005, 22154, 22301, 22448, 22594, 22739, 22884, 23027,
+	23170, 23311, 23452, 23592, 23731, 23870, 24007, 24143, 24279, 24413, 24547, 24680, 24811, 24942, 25072, 25201,
+	25329, 25456, 25582, 25708, 25832, 25955, 26077, 26198, 26319, 26438, 26556, 26674, 26790, 26905, 27019, 27133,
+	27245, 27356, 27466, 27575, 27683, 27790, 27896, 28001, 28105, 28208, 28310, 28411, 28510, 28609, 28706, 28803,
+	28898, 28992, 29085, 29177, 29268, 29358, 29447, 29534, 29621, 29706, 29791, 29874, 29956, 30037, 30117, 30195,
+	30273, 30349, 30424, 30498, 30571, 30643, 30714, 30783, 30852, 30919, 30985, 31050, 31113, 31176, 31237, 31297,
+	31356, 31414, 31470, 31526, 31580, 31633, 31685, 31736, 31785, 31833, 31880, 31926, 31971, 32014, 32057, 32098,
+	32137, 32176, 32213, 32250, 32285, 32318, 32351, 32382, 32412, 32441, 32469, 32495, 32521, 32545, 32567, 32589,
+	32609, 32628, 32646, 32663, 32678, 32692, 32705, 32717, 32728, 32737, 32745, 32752, 32757, 32761, 32765, 32766,
+	32767,
+};
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Get the sine of an angle
+ *
+ * @param angle Angle, in 1/FFT_MAX_SIZE of a full wave
+ * @return Sine of the angle (in Q15)
+ */
+int16_t sineQ15(uint16_t angle){
+	uint16_t step;
+
+	angle &= ANGLE_MASK;
+	step = angle & (QUARTER_WAVE - 1U);
+
+	switch(angle >> QUADRANT_SHIFT){
+		case 0:
+			return (sineTable[step]);
+
+		case 1:
+			return (sineTable[QUARTER_WAVE - step]);
+
+		case 2:
+			return ((int16_t)-sineTable[step]);
+
+		default:
+			return ((int16_t)-sineTable[QUARTER_WAVE - step]);
+	}
+}
+
+/**
+ * @brief Get the cosine of an angle
+ *
+ * @param angle Angle, in 1/FFT_MAX_SIZE of a full wave
+ * @return Cosine of the angle (in Q15)
+ */
+int16_t cosineQ15(uint16_t angle){
+	return (sineQ15((uint16_t)(angle + QUARTER_WAVE)));
+}
+
+/**
+ * @brief Apply a Hann window on the real parts of a buffer
+ *
+ * @param[in,out] buffer Complex buffer of FFT_SIZE values
+ */
+void fftQ15ApplyHann(int16_t buffer[]){
+	int32_t coefficient;
+
+	for(uint16_t i = 0 ; i < FFT_SIZE ; i++){
+		//w(i) = (1 - cos(2.pi.i / N)) / 2
+		coefficient = (Q15_ONE - (int32_t)cosineQ15((uint16_t)(i * TABLE_STRIDE))) >> 1;
+		buffer[(i << 1) + REAL] = (int16_t)((buffer[(i << 1) + REAL] * coefficient) >> Q15_SHIFT);
+	}
+}
+
+/**
+ * @brief Compute the forward FFT of a buffer, in place
+ * @note The results are scaled down by FFT_SIZE
+ *
+ * @param[in,out] buffer Complex buffer of FFT_SIZE values
+ */
+void fftQ15Transform(int16_t buffer[]){
+	uint16_t reversed = 0;
+	uint16_t bit;
+	int16_t swap;
+
+	//reorder the values in bit-reversed order
+	for(uint16_t i = 1 ; i < FFT_SIZE ; i++){
+		bit = FFT_SIZE >> 1;
+		while(reversed & bit){
+			reversed ^= bit;
+			bit >>= 1;
+		}
+		reversed |= bit;
+
+		if(i < reversed){
+			for(uint8_t part = REAL ; part <= IMAGINARY ; part++){
+				swap = buffer[(i << 1) + part];
+				buffer[(i << 1) + part] = buffer[(reversed << 1) + part];
+				buffer[(reversed << 1) + part] = swap;
+			}
+		}
+	}
+
+#if FIRST_RADIX4_SPAN > 1
+	//compute the radix-2 stage (twiddle factors all equal to 1)
+	for(uint16_t top = 0 ; top < FFT_SIZE ; top += 2U){
+		int16_t* upper = &buffer[top << 1];
+		int16_t* lower = &buffer[(top + 1U) << 1];
+		const int32_t lowerReal = lower[REAL];
+		const int32_t lowerImag = lower[IMAGINARY];
+
+		lower[REAL] = (int16_t)((upper[REAL] - lowerReal) >> RADIX2_SHIFT);
+		lower[IMAGINARY] = (int16_t)((upper[IMAGINARY] - lowerImag) >> RADIX2_SHIFT);
+		upper[REAL] = (int16_t)((upper[REAL] + lowerReal) >> RADIX2_SHIFT);
+		upper[IMAGINARY] = (int16_t)((upper[IMAGINARY] + lowerImag) >> RADIX2_SHIFT);
+	}
+#endif
+
+	//compute the radix-4 butterflies stages (values k, k + span, k + 2.span and k + 3.span of each group)
+	for(uint16_t span = FIRST_RADIX4_SPAN ; span < FFT_SIZE ; span <<= 2){
+		const uint16_t angleStep = (uint16_t)((FFT_MAX_SIZE >> 2) / span);
+
+		for(uint16_t k = 0 ; k < span ; k++){
+			//twiddle factors W, W² and W³, with W = exp(-i.pi.k / (2.span))
+			const uint16_t angle = (uint16_t)(k * angleStep);
+			const int32_t twiddles[3][2] = {
+				{cosineQ15((uint16_t)(angle << 1)), -(int32_t)sineQ15((uint16_t)(angle << 1))},
+				{cosineQ15(angle), -(int32_t)sineQ15(angle)},
+				{cosineQ15((uint16_t)(angle * 3U)), -(int32_t)sineQ15((uint16_t)(angle * 3U))},
+			};
+
+			for(uint16_t top = k ; top < FFT_SIZE ; top += (uint16_t)(span << 2)){
+				int16_t* values[4] = {&buffer[top << 1], &buffer[(top + span) << 1], &buffer[(top + (span << 1)) << 1], &buffer[(top + (span * 3U)) << 1]};
+				int32_t rotated[3][2];
+				int32_t sums[2][2];
+				int32_t differences[2][2];
+
+				//rotate the values (the second one by W², the third one by W, the fourth one by W³)
+				for(uint8_t value = 0 ; value < 3U ; value++)
+					rotate(values[value + 1U], twiddles[value][REAL], twiddles[value][IMAGINARY], rotated[value]);
+
+				//combine them in two radix-2 butterflies
+				for(uint8_t part = REAL ; part <= IMAGINARY ; part++){
+					sums[0][part] = values[0][part] + rotated[0][part];
+					differences[0][part] = values[0][part] - rotated[0][part];
+					sums[1][part] = rotated[1][part] + rotated[2][part];
+					differences[1][part] = rotated[1][part] - rotated[2][part];
+				}
+
+				//compute the scaled outputs (the differences of the odd values rotated by -i)
+				values[0][REAL] = (int16_t)__SSAT((sums[0][REAL] + sums[1][REAL]) >> RADIX4_SHIFT, INT16_BITS);
+				values[0][IMAGINARY] = (int16_t)__SSAT((sums[0][IMAGINARY] + sums[1][IMAGINARY]) >> RADIX4_SHIFT, INT16_BITS);
+				values[1][REAL] = (int16_t)__SSAT((differences[0][REAL] + differences[1][IMAGINARY]) >> RADIX4_SHIFT, INT16_BITS);
+				values[1][IMAGINARY] = (int16_t)__SSAT((differences[0][IMAGINARY] - differences[1][REAL]) >> RADIX4_SHIFT, INT16_BITS);
+				values[2][REAL] = (int16_t)__SSAT((sums[0][REAL] - sums[1][REAL]) >> RADIX4_SHIFT, INT16_BITS);
+				values[2][IMAGINARY] = (int16_t)__SSAT((sums[0][IMAGINARY] - sums[1][IMAGINARY]) >> RADIX4_SHIFT, INT16_BITS);
+				values[3][REAL] = (int16_t)__SSAT((differences[0][REAL] - differences[1][IMAGINARY]) >> RADIX4_SHIFT, INT16_BITS);
+				values[3][IMAGINARY] = (int16_t)__SSAT((differences[0][IMAGINARY] + differences[1][REAL]) >> RADIX4_SHIFT, INT16_BITS);
+			}
+		}
+	}
+}
+
+/**
+ * @brief Multiply a complex value by a twiddle factor
+ *
+ * @param value Complex value (interleaved real and imaginary parts)
+ * @param twiddleReal Real part of the twiddle factor (in Q15)
+ * @param twiddleImag Imaginary part of the twiddle factor (in Q15)
+ * @param[out] rotated Rotated value (interleaved real and imaginary parts)
+ */
+static void rotate(const int16_t value[], int32_t twiddleReal, int32_t twiddleImag, int32_t rotated[]){
+	rotated[REAL] = ((value[REAL] * twiddleReal) - (value[IMAGINARY] * twiddleImag)) >> Q15_SHIFT;
+	rotated[IMAGINARY] = ((value[REAL] * twiddleImag) + (value[IMAGINARY] * twiddleReal)) >> Q15_SHIFT;
+}
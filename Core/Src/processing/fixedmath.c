@@ -0,0 +1,59 @@
+/**
+ * @file fixedmath.c
+ * @brief Implement the integer maths shared by the processing modules
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The square root is computed bit by bit (two bits of the value per iteration), with no division nor multiplication.
+ * It starts from the highest bit set in the value, so a 32-bits value takes 16 iterations at most
+ * whatever the width of the argument.
+ */
+#include "fixedmath.h"
+#include <stm32f1xx.h>
+
+//definitions
+#define WORD_BITS		32U		///< Number of bits in a 32-bits word
+#define HIGHEST_BIT		31U		///< Position of the highest bit in a 32-bits word
+#define EVEN_MASK		0xFEU	///< Mask rounding a bit position down to an even one (a power of four)
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Compute the integer square root of a value
+ *
+ * @param value Value of which compute the square root
+ * @return Square root, rounded down
+ */
+uint32_t fixedmathSquareRoot(uint64_t value){
+	const uint32_t upper = (uint32_t)(value >> WORD_BITS);
+	uint64_t root = 0;
+	uint64_t bit;
+	uint8_t highestBit;
+
+	if(!value)
+		return (0);
+
+	//get the highest power of four lower than the value
+	if(upper)
+		highestBit = (uint8_t)((WORD_BITS + HIGHEST_BIT) - __CLZ(upper));
+	else
+		highestBit = (uint8_t)(HIGHEST_BIT - __CLZ((uint32_t)value));
+	bit = 1ULL << (highestBit & EVEN_MASK);
+
+	//compute the root bit by bit
+	while(bit){
+		if(value >= root + bit){
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		}
+		else
+			root >>= 1;
+		bit >>= 2;
+	}
+
+	return ((uint32_t)root);
+}
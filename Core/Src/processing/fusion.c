@@ -0,0 +1,281 @@
+/**
+ * @file fusion.c
+ * @brief Implement the fusion of the gyroscope rates with the accelerometer angles (complementary filter, Mahony style)
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The angles are the ones displayed in level mode : atan(X / Z) and atan(Y / Z).
+ * The gyroscope axes must be aligned with the accelerometer ones, so that :
+ * - the X axis angle turns at minus the Y axis rate
+ * - the Y axis angle turns at the X axis rate
+ *
+ * At each gyroscope sample, each angle is integrated with the rate, then pulled towards the accelerometer angle
+ * by a proportional-integral correction :
+ * - the proportional term (1/2^KP_SHIFT per sample) sets the time constant under which the gyroscope is trusted
+ * 	 (256 samples, 1.35 s at 190 Hz) : above it, the accelerometer wins and the gyroscope drift is cancelled,
+ * 	 under it, the gyroscope wins and the linear accelerations are filtered out
+ * - the integral term converges to the opposite of the gyroscope zero-rate level (up to 10 dps on the L3GD20),
+ * 	 which would otherwise offset the angles by bias * time constant
+ * For the first FUSION_SETTLE_SAMPLES, both gains are raised so that the bias is estimated within seconds,
+ * the device being still. As soon as it turns (rates above STILL_DPS), the settling is over : raised gains
+ * would follow the linear accelerations and wind the bias estimation up.
+ *
+ * The accelerometer angles are averaged over a block, and reach the fusion up to two blocks late (more than 300 ms
+ * in precise averaging). Comparing them with the current angles would pull the estimation towards the past whenever
+ * the device turns : they are instead compared with the current angles minus the rotation integrated since the block
+ * was measured, the cumulated rotation being kept over the last FUSION_HISTORY_SIZE samples.
+ * The corrections applied since then are thus accounted for, and the loop keeps its stability whatever the delay.
+ *
+ * When the accelerometer measures far from 1 g, it is not only measuring gravity : the correction is suspended,
+ * and the gyroscope alone (bias cancelled) carries the angles.
+ *
+ * The angles are kept in Q16 degrees and the bias estimation in Q24 degrees per sample, all in integers.
+ * The accelerometer reference and the gyroscope samples are given by different tasks, which run to completion.
+ */
+#include "fusion.h"
+#include <math.h>
+
+//definitions
+#define ANGLE_SHIFT			16U		///< Number of fractional bits of the angles (in degrees)
+#define INTEGRAL_SHIFT		24U		///< Number of fractional bits of the bias estimation (in degrees per sample)
+#define STEP_SHIFT			16U		///< Number of fractional bits of the integration step
+#define KP_SHIFT			8U		///< Shift giving the proportional gain (time constant of 256 samples)
+#define KI_SHIFT			16U		///< Shift giving the integral gain (damping of 0.5)
+#define KP_SETTLE_SHIFT		4U		///< Shift giving the proportional gain while settling
+#define KI_SETTLE_SHIFT		9U		///< Shift giving the integral gain while settling (damping of 0.7)
+#define FUSION_SETTLE_SAMPLES	380U	///< Number of samples fused with the settling gains (2 s at 190 Hz)
+#define STILL_DPS			20U		///< Rate above which the device is considered turning, which ends the settling (in dps)
+#define MAX_BIAS_Q24		((int32_t)1 << 22)	///< Highest bias estimation (0.25 degree per sample, 47 dps at 190 Hz)
+#define GATE_PERCENT		20		///< Deviation of the squared acceleration from 1 g above which the accelerometer is ignored (about 10 % of 1 g)
+#define PERCENT				100		///< 100 %
+#define UDPS_PER_DPS		1000000ULL	///< Number of micro-degrees per second in a degree per second
+#define US_PER_S			1000000ULL	///< Number of microseconds in a second
+#define DEGREES_180			180.0f	///< Value representing a flat angle
+#define FUSION_HISTORY_SIZE	64U		///< Number of past cumulated rotations kept to date the late accelerometer angles (337 ms at 190 Hz)
+
+/**
+ * @brief Enumeration of the function IDs of the fusion
+ */
+typedef enum _fusionFunctionCodes_e{
+	INIT = 0,	///< fusionInitialise()
+}fusionFunctionCodes_e;
+
+/**
+ * @brief Enumeration of the vector components
+ */
+typedef enum{
+	X = 0,	///< X component
+	Y,		///< Y component
+	Z,		///< Z component
+}component_e;
+
+//tool functions
+static inline int32_t toAngleQ16(int32_t direction, int32_t axisZ);
+static inline uint8_t isStill(const int32_t rate[FUSION_NB_ANGLES]);
+
+//state variables
+static int64_t	_step = 0;						///< Angle increment per rate LSB and per sample (in Q16 degrees, Q16)
+static uint32_t	_samplePeriod_us = 1;			///< Gyroscope sample period (in us)
+static int32_t	_stillRate = 0;					///< Rate above which the device is considered turning (in LSB)
+static int32_t	_angles[FUSION_NB_ANGLES];		///< Estimated angles (in Q16 degrees)
+static int32_t	_reference[FUSION_NB_ANGLES];	///< Last accelerometer angles (in Q16 degrees)
+static int32_t	_integral[FUSION_NB_ANGLES];	///< Bias estimations (in Q24 degrees per sample)
+static uint8_t	_referenceValid = 0;			///< Flag indicating the last accelerometer vector measured gravity only
+static uint8_t	_referenceAge = 0;				///< Number of samples fused since the last accelerometer vector was measured
+static uint32_t	_rotation[FUSION_NB_ANGLES];	///< Rotation integrated since the reset, bias included (in Q16 degrees, modulo 2^32)
+static uint32_t	_history[FUSION_HISTORY_SIZE][FUSION_NB_ANGLES];	///< Rotation integrated at the last samples (in Q16 degrees, modulo 2^32)
+static uint8_t	_historyHead = 0;				///< Index of the rotation integrated at the last sample
+static uint8_t	_initialised = 0;				///< Flag indicating the angles have been set from a first reference
+static uint16_t	_nbFused = 0;					///< Number of samples fused since the reset (saturates at FUSION_SETTLE_SAMPLES)
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Set the gyroscope scale and sample period, and reset the estimation
+ *
+ * @param rateScale_udps Scale of the rates (in micro-degrees per second per LSB)
+ * @param samplePeriod_us Gyroscope sample period (in us)
+ * @retval 0 Success
+ * @retval 1 Null scale or sample period
+ */
+errorCode_u fusionInitialise(uint32_t rateScale_udps, uint32_t samplePeriod_us){
+	if(!rateScale_udps || !samplePeriod_us)
+		return (createErrorCode(INIT, 1, ERR_WARNING));
+
+	//angle step per LSB = scale (udps) * period (us) / 10^12, in Q16 degrees, itself in Q16
+	_step = (int64_t)((((uint64_t)rateScale_udps * samplePeriod_us) << (ANGLE_SHIFT + STEP_SHIFT)) / (UDPS_PER_DPS * US_PER_S));
+	_samplePeriod_us = samplePeriod_us;
+	_stillRate = (int32_t)((STILL_DPS * UDPS_PER_DPS) / rateScale_udps);
+	fusionReset();
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Restart the estimation from the next accelerometer angles, with the settling gains
+ */
+void fusionReset(){
+	for(uint8_t angle = 0 ; angle < FUSION_NB_ANGLES ; angle++){
+		_angles[angle] = 0;
+		_rotation[angle] = 0;
+		_reference[angle] = 0;
+		_integral[angle] = 0;
+	}
+
+	_referenceValid = 0;
+	_referenceAge = 0;
+	_initialised = 0;
+	_nbFused = 0;
+}
+
+/**
+ * @brief Give the last accelerometer vector, used as the reference the angles are pulled towards
+ * @details The vector is discarded if its squared norm deviates from 1 g by more than GATE_PERCENT
+ *
+ * @param vector Accelerometer vector (any fixed-point format)
+ * @param oneG Norm of 1 g in the vector format
+ * @param age_us Time elapsed since the vector was measured (middle of its averaging window, in us)
+ */
+void fusionSetReference(const int32_t vector[FUSION_NB_AXIS], int32_t oneG, uint32_t age_us){
+	uint32_t age = age_us / _samplePeriod_us;
+
+	int64_t norm2 = 0;
+	int64_t oneG2 = (int64_t)oneG * oneG;
+	int64_t deviation;
+
+	for(uint8_t axis = 0 ; axis < FUSION_NB_AXIS ; axis++)
+		norm2 += (int64_t)vector[axis] * vector[axis];
+
+	deviation = norm2 - oneG2;
+	if(deviation < 0)
+		deviation = -deviation;
+
+	_referenceValid = ((deviation * PERCENT) <= (oneG2 * GATE_PERCENT));
+	if(!_referenceValid)
+		return;
+
+	_reference[X] = toAngleQ16(vector[X], vector[Z]);
+	_reference[Y] = toAngleQ16(vector[Y], vector[Z]);
+	_referenceAge = (uint8_t)((age < FUSION_HISTORY_SIZE) ? age : (FUSION_HISTORY_SIZE - 1U));
+
+	//start from the first valid reference
+	if(!_initialised){
+		_angles[X] = _reference[X];
+		_angles[Y] = _reference[Y];
+		for(uint8_t sample = 0 ; sample < FUSION_HISTORY_SIZE ; sample++){
+			_history[sample][X] = _rotation[X];
+			_history[sample][Y] = _rotation[Y];
+		}
+		_initialised = 1;
+	}
+}
+
+/**
+ * @brief Fuse gyroscope samples : integrate the rates, and correct the angles towards the accelerometer reference
+ *
+ * @param rates Rates of each sample (X, Y, Z, in LSB)
+ * @param nbSamples Number of samples
+ */
+void fusionAddRates(const int16_t rates[][FUSION_NB_AXIS], uint8_t nbSamples){
+	uint8_t kpShift, kiShift, past;
+
+	//without a first reference, the rates can not be integrated from anywhere
+	if(!_initialised)
+		return;
+
+	for(uint8_t sample = 0 ; sample < nbSamples ; sample++){
+		//angle rates : X axis angle at minus the Y rate, Y axis angle at the X rate
+		int32_t rate[FUSION_NB_ANGLES] = {-(int32_t)rates[sample][Y], (int32_t)rates[sample][X]};
+
+		kpShift = KP_SHIFT;
+		kiShift = KI_SHIFT;
+		if(_nbFused < FUSION_SETTLE_SAMPLES){
+			if(isStill(rate)){
+				kpShift = KP_SETTLE_SHIFT;
+				kiShift = KI_SETTLE_SHIFT;
+				_nbFused++;
+			}
+			else
+				_nbFused = FUSION_SETTLE_SAMPLES;
+		}
+
+		//rotation integrated when the accelerometer vector was measured
+		past = (uint8_t)((_historyHead + FUSION_HISTORY_SIZE - _referenceAge) % FUSION_HISTORY_SIZE);
+		if(_referenceAge < (FUSION_HISTORY_SIZE - 1U))
+			_referenceAge++;
+		_historyHead = (uint8_t)((_historyHead + 1U) % FUSION_HISTORY_SIZE);
+
+		for(uint8_t angle = 0 ; angle < FUSION_NB_ANGLES ; angle++){
+			int32_t error = 0;
+			int32_t increment;
+
+			//proportional and integral terms (only when the accelerometer measures gravity)
+			if(_referenceValid){
+				error = _reference[angle] - (_angles[angle] - (int32_t)(_rotation[angle] - _history[past][angle]));
+				_integral[angle] += error >> (kiShift - (INTEGRAL_SHIFT - ANGLE_SHIFT));
+				if(_integral[angle] > MAX_BIAS_Q24)
+					_integral[angle] = MAX_BIAS_Q24;
+				else if(_integral[angle] < -MAX_BIAS_Q24)
+					_integral[angle] = -MAX_BIAS_Q24;
+			}
+
+			increment = (int32_t)((rate[angle] * _step) >> STEP_SHIFT) + (_integral[angle] >> (INTEGRAL_SHIFT - ANGLE_SHIFT));
+			_angles[angle] += increment + (error >> kpShift);
+			_rotation[angle] += (uint32_t)increment;
+			_history[_historyHead][angle] = _rotation[angle];
+		}
+	}
+}
+
+/**
+ * @brief Check if the bias estimation has settled
+ *
+ * @retval 0 Still settling (or no reference yet)
+ * @retval 1 Settled
+ */
+uint8_t fusionIsSettled(){
+	return (_initialised && (_nbFused >= FUSION_SETTLE_SAMPLES));
+}
+
+/**
+ * @brief Get the estimated angles
+ *
+ * @param[out] angles X and Y axis angles (in degrees)
+ */
+void fusionGetAngles(float angles[FUSION_NB_ANGLES]){
+	for(uint8_t angle = 0 ; angle < FUSION_NB_ANGLES ; angle++)
+		angles[angle] = (float)_angles[angle] / (float)((int32_t)1 << ANGLE_SHIFT);
+}
+
+/**
+ * @brief Compute the angle (in Q16 degrees) between a component and the Z component
+ *
+ * @param direction Component in the direction of the angle
+ * @param axisZ Z component
+ * @return Angle (in Q16 degrees)
+ */
+static inline int32_t toAngleQ16(int32_t direction, int32_t axisZ){
+	if(!axisZ)
+		return (0);
+
+	return ((int32_t)((atanf((float)direction / (float)axisZ) * DEGREES_180 * (float)((int32_t)1 << ANGLE_SHIFT)) / (float)M_PI));
+}
+
+/**
+ * @brief Check if the device is still enough to use the settling gains
+ *
+ * @param rate Angle rates (in LSB)
+ * @retval 0 Device turning
+ * @retval 1 Device still
+ */
+static inline uint8_t isStill(const int32_t rate[FUSION_NB_ANGLES]){
+	for(uint8_t angle = 0 ; angle < FUSION_NB_ANGLES ; angle++){
+		if((rate[angle] > _stillRate) || (rate[angle] < -_stillRate))
+			return (0);
+	}
+
+	return (1);
+}
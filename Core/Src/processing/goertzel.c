@@ -0,0 +1,332 @@
+/**
+ * @file goertzel.c
+ * @brief Implement a bank of integer-only Goertzel filters, each detecting a single frequency over a sliding window
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Each filter runs the recurrence s(n) = x(n) + 2.cos(w).s(n-1) - s(n-2) on every sample,
+ * with its coefficient in Q14 and its states in 32 bits (products computed on 64 bits).
+ *
+ * The samples are cut in segments of GOERTZEL_SEGMENT samples. At the end of a segment, its complex DFT term
+ * y = s1 - exp(-jw).s2 is rotated by the phase of its last sample, which aligns all the segments on the same time origin,
+ * and stored in a ring of GOERTZEL_NB_SEGMENTS segments. The DFT of the sliding window is then the sum of the ring
+ * and of the segment in progress (extracted from its states without disturbing them), so results are published
+ * at the end of every block, whatever its size, once the window spans GOERTZEL_LENGTH samples.
+ *
+ * The DC component (gravity on the Z axis) is tracked with a low-pass filter on the blocks means,
+ * and removed from the samples before filtering, so it does not leak into the target frequencies.
+ *
+ * Coefficients are recomputed at the start of every segment from the current sample period,
+ * so they follow the accelerometer clock drift. Changing a frequency restarts the window.
+ */
+#include "goertzel.h"
+#include "fixedmath.h"
+#include "fft.h"
+#include <stm32f1xx.h>
+
+//definitions
+#define COEFF_SHIFT		14U				///< Number of fractional bits in a filter coefficient
+#define Q15_SHIFT		15U				///< Number of fractional bits in a sine or cosine
+#define PHASE_SHIFT		24U				///< Number of bits of the phase step computation (in 1/2^24th of a wave)
+#define STEP_SHIFT		8U				///< Shift converting a phase step into a phase (in 1/2^32th of a wave)
+#define TABLE_SHIFT		22U				///< Shift converting a phase into a sine table angle (FFT_MAX_SIZE angles per wave)
+#define FRACTION_SHIFT	8U				///< Number of bits of the phase fraction used to interpolate between two table angles
+#define DHZ_NS_PER_WAVE	10000000000ULL	///< Product of a frequency (in dHz) and a period (in ns) making a full wave
+#define DC_SHIFT		4U				///< Number of fractional bits of the DC estimation
+#define DC_FILTER_SHIFT	3U				///< Shift giving the weight of a new block mean in the DC estimation (1/8th)
+#define LAST_FILTER		(GOERTZEL_NB_FILTERS - 1U)	///< Index of the last filter in the bank
+
+#if (GOERTZEL_NB_SEGMENTS * GOERTZEL_SEGMENT) != GOERTZEL_LENGTH
+#error GOERTZEL_LENGTH must be made of GOERTZEL_NB_SEGMENTS segments of GOERTZEL_SEGMENT samples
+#endif
+
+/**
+ * @brief Enumeration of the function IDs of the Goertzel bank
+ */
+typedef enum _goertzelFunctionCodes_e{
+	SET_FREQUENCY = 0,	///< goertzelSetFrequency()
+}goertzelFunctionCodes_e;
+
+/**
+ * @brief Structure holding a complex value
+ */
+typedef struct{
+	int32_t		real;		///< Real part
+	int32_t		imaginary;	///< Imaginary part
+}complex_t;
+
+/**
+ * @brief Structure holding the state of a filter
+ */
+typedef struct{
+	uint16_t	frequency_dHz;	///< Target frequency (in dHz), 0 if disabled
+	int16_t		coefficient;	///< 2.cos(w), in Q14
+	int16_t		cosine;			///< cos(w), in Q15
+	int16_t		sine;			///< sin(w), in Q15
+	uint32_t	phaseStep;		///< Phase step between two samples (in 1/2^32th of a wave)
+	uint32_t	phase;			///< Phase of the next sample to filter (in 1/2^32th of a wave)
+	int32_t		state1;			///< s(n-1)
+	int32_t		state2;			///< s(n-2)
+	complex_t	segments[GOERTZEL_NB_SEGMENTS];	///< DFT terms of the last complete segments, aligned on the same time origin
+	uint16_t	amplitude;		///< Amplitude found in the last window (in input units)
+}goertzelFilter_t;
+
+//tool functions
+static void startSegment(uint32_t samplePeriod_ns);
+static void finishSegment();
+static complex_t segmentTerm(const goertzelFilter_t* filter);
+static void publishResults();
+static void phaseToCosine(uint32_t phase, int32_t* cosine, int32_t* sine);
+
+//state variables
+static goertzelFilter_t	_filters[GOERTZEL_NB_FILTERS];	///< Filters bank
+static uint8_t			_nbSamples = 0;					///< Number of samples filtered in the current segment
+static uint8_t			_nbSegments = 0;				///< Number of complete segments in the rings
+static uint8_t			_nextSegment = 0;				///< Index of the ring slot the next complete segment goes to
+static int32_t			_dc = 0;						///< DC component estimation (with DC_SHIFT fractional bits)
+static uint8_t			_dcValid = 0;					///< Flag indicating the DC component has been estimated
+static uint8_t			_newResults = 0;				///< Flag indicating new results have been published
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Set the frequency detected by a filter, and restart the window
+ *
+ * @param filter Index of the filter
+ * @param frequency_dHz Target frequency (in dHz), 0 to disable the filter
+ * @retval 0 Success
+ * @retval 1 Filter index out of range
+ */
+errorCode_u goertzelSetFrequency(uint8_t filter, uint16_t frequency_dHz){
+	if(filter > LAST_FILTER)
+		return (createErrorCode(SET_FREQUENCY, 1, ERR_WARNING));
+
+	_filters[filter].frequency_dHz = frequency_dHz;
+	goertzelReset();
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Discard the window and the DC estimation (e.g. after samples have been lost)
+ */
+void goertzelReset(){
+	_nbSamples = 0;
+	_nbSegments = 0;
+	_nextSegment = 0;
+	_dcValid = 0;
+}
+
+/**
+ * @brief Run all the filters on a block of samples, and publish the amplitudes of the window ending with it
+ *
+ * @param samples Samples to filter
+ * @param nbSamples Number of samples to filter
+ * @param samplePeriod_ns Period between two samples (in ns)
+ */
+void goertzelAddSamples(const int16_t samples[], uint8_t nbSamples, uint32_t samplePeriod_ns){
+	int32_t sum = 0;
+	int32_t dc;
+	uint8_t chunk;
+
+	if(!nbSamples)
+		return;
+
+	//update the DC estimation with the block mean, then round it to remove it from the samples
+	for(uint8_t i = 0 ; i < nbSamples ; i++)
+		sum += samples[i];
+	sum = (sum * (1 << DC_SHIFT)) / nbSamples;
+	if(_dcValid)
+		_dc += (sum - _dc) / (1 << DC_FILTER_SHIFT);
+	else
+		_dc = sum;
+	_dcValid = 1;
+	dc = (_dc + (1 << (DC_SHIFT - 1U))) >> DC_SHIFT;
+
+	while(nbSamples){
+		//if new segment, compute the coefficients and clear the states
+		if(!_nbSamples)
+			startSegment(samplePeriod_ns);
+
+		//process as many samples as possible in the current segment
+		chunk = (uint8_t)(GOERTZEL_SEGMENT - _nbSamples);
+		if(chunk > nbSamples)
+			chunk = nbSamples;
+
+		for(goertzelFilter_t* filter = _filters ; filter <= &_filters[LAST_FILTER] ; filter++){
+			int32_t state1 = filter->state1;
+			int32_t state2 = filter->state2;
+			int32_t state0;
+
+			if(!filter->frequency_dHz)
+				continue;
+
+			for(uint8_t i = 0 ; i < chunk ; i++){
+				state0 = (samples[i] - dc) + (int32_t)(((int64_t)filter->coefficient * state1) >> COEFF_SHIFT) - state2;
+				state2 = state1;
+				state1 = state0;
+			}
+
+			filter->state1 = state1;
+			filter->state2 = state2;
+			filter->phase += filter->phaseStep * chunk;
+		}
+
+		samples += chunk;
+		nbSamples = (uint8_t)(nbSamples - chunk);
+		_nbSamples = (uint8_t)(_nbSamples + chunk);
+
+		//if segment complete, store it in the rings
+		if(_nbSamples >= GOERTZEL_SEGMENT)
+			finishSegment();
+	}
+
+	//publish once the window is complete
+	if(_nbSegments >= GOERTZEL_NB_SEGMENTS)
+		publishResults();
+}
+
+/**
+ * @brief Check if new results have been published since the last call
+ *
+ * @retval 0 No new results
+ * @retval 1 New results available
+ */
+uint8_t goertzelHasNewResults(){
+	uint8_t tmp = _newResults;
+	_newResults = 0;
+
+	return (tmp);
+}
+
+/**
+ * @brief Get the amplitude found by a filter in the last window
+ *
+ * @param filter Index of the filter
+ * @return Peak amplitude of the target frequency (in input units), 0 if index out of range
+ */
+uint16_t goertzelGetAmplitude(uint8_t filter){
+	if(filter > LAST_FILTER)
+		return (0);
+
+	return (_filters[filter].amplitude);
+}
+
+/**
+ * @brief Compute the filters coefficients and clear their states
+ *
+ * @param samplePeriod_ns Period between two samples (in ns)
+ */
+static void startSegment(uint32_t samplePeriod_ns){
+	int32_t cosine, sine;
+
+	for(goertzelFilter_t* filter = _filters ; filter <= &_filters[LAST_FILTER] ; filter++){
+		//get the phase step of the target frequency (in 1/2^32th of a wave)
+		filter->phaseStep = (uint32_t)((((uint64_t)filter->frequency_dHz * samplePeriod_ns) << PHASE_SHIFT) / DHZ_NS_PER_WAVE) << STEP_SHIFT;
+
+		//cos(w) in Q15 is 2.cos(w) in Q14
+		phaseToCosine(filter->phaseStep, &cosine, &sine);
+		filter->coefficient = (int16_t)cosine;
+		filter->cosine = (int16_t)cosine;
+		filter->sine = (int16_t)sine;
+
+		filter->state1 = 0;
+		filter->state2 = 0;
+	}
+}
+
+/**
+ * @brief Store the DFT term of the segment of all the filters in their ring
+ */
+static void finishSegment(){
+	for(goertzelFilter_t* filter = _filters ; filter <= &_filters[LAST_FILTER] ; filter++){
+		if(filter->frequency_dHz)
+			filter->segments[_nextSegment] = segmentTerm(filter);
+	}
+
+	_nextSegment = (uint8_t)((_nextSegment + 1U) % GOERTZEL_NB_SEGMENTS);
+	if(_nbSegments < GOERTZEL_NB_SEGMENTS)
+		_nbSegments++;
+	_nbSamples = 0;
+}
+
+/**
+ * @brief Get the DFT term of the samples filtered since the segment start, aligned on the time origin
+ * @details y = s1 - exp(-jw).s2 is the DFT term relative to the last sample filtered, so it is rotated by minus its phase.
+ *
+ * @param filter Filter of which get the term
+ * @return DFT term of the segment
+ */
+static complex_t segmentTerm(const goertzelFilter_t* filter){
+	int32_t cosine, sine;
+	int64_t real, imaginary;
+	complex_t term;
+
+	//y = (s1 - cos(w).s2) + j.sin(w).s2
+	real = filter->state1 - (((int64_t)filter->cosine * filter->state2) >> Q15_SHIFT);
+	imaginary = ((int64_t)filter->sine * filter->state2) >> Q15_SHIFT;
+
+	//term = y.exp(-j.phase)
+	phaseToCosine(filter->phase - filter->phaseStep, &cosine, &sine);
+	term.real = (int32_t)(((real * cosine) + (imaginary * sine)) >> Q15_SHIFT);
+	term.imaginary = (int32_t)(((imaginary * cosine) - (real * sine)) >> Q15_SHIFT);
+
+	return (term);
+}
+
+/**
+ * @brief Sum the rings and the segment in progress, and publish the amplitude of all the filters
+ */
+static void publishResults(){
+	const uint16_t windowLength = (uint16_t)(GOERTZEL_LENGTH + _nbSamples);
+	int64_t real, imaginary;
+	complex_t term;
+
+	for(goertzelFilter_t* filter = _filters ; filter <= &_filters[LAST_FILTER] ; filter++){
+		if(!filter->frequency_dHz){
+			filter->amplitude = 0;
+			continue;
+		}
+
+		real = 0;
+		imaginary = 0;
+		for(uint8_t i = 0 ; i < GOERTZEL_NB_SEGMENTS ; i++){
+			real += filter->segments[i].real;
+			imaginary += filter->segments[i].imaginary;
+		}
+		if(_nbSamples){
+			term = segmentTerm(filter);
+			real += term.real;
+			imaginary += term.imaginary;
+		}
+
+		//amplitude = 2.|X| / N, rounded
+		filter->amplitude = (uint16_t)(((fixedmathSquareRoot((uint64_t)((real * real) + (imaginary * imaginary))) << 1) + (windowLength >> 1)) / windowLength);
+	}
+
+	_newResults = 1;
+}
+
+/**
+ * @brief Get the cosine and sine of a phase, interpolated between two sine table angles
+ *
+ * @param phase Phase (in 1/2^32th of a wave)
+ * @param[out] cosine Cosine of the phase (in Q15)
+ * @param[out] sine Sine of the phase (in Q15)
+ */
+static void phaseToCosine(uint32_t phase, int32_t* cosine, int32_t* sine){
+	const uint16_t angle = (uint16_t)(phase >> TABLE_SHIFT);
+	const int32_t fraction = (int32_t)((phase >> (TABLE_SHIFT - FRACTION_SHIFT)) & ((1U << FRACTION_SHIFT) - 1U));
+	int32_t lower, upper;
+
+	lower = cosineQ15(angle);
+	upper = cosineQ15((uint16_t)(angle + 1U));
+	*cosine = lower + (((upper - lower) * fraction) >> FRACTION_SHIFT);
+
+	lower = sineQ15(angle);
+	upper = sineQ15((uint16_t)(angle + 1U));
+	*sine = lower + (((upper - lower) * fraction) >> FRACTION_SHIFT);
+}
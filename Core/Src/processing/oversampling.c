@@ -0,0 +1,76 @@
+/**
+ * @file oversampling.c
+ * @brief Implement the sliding window averaging the fine accelerometer measurements over several blocks
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Each FIFO block is already decimated by the accelerometer driver (32 samples at 200 Hz averaged into one),
+ * its average keeping 8 fractional bits. Averaging N samples of a white noise divides it by sqrt(N),
+ * so another decimation stage is needed to reach hundredths of a degree (1/256 LSB is about 0.0002 degree at 1 g) :
+ * the window sums the last OVERSAMPLING_NB_BLOCKS block averages (1024 samples, 5.12 s, in precise averaging).
+ *
+ * The sums are kept as-is, without dividing them by the number of blocks :
+ * the angles only depend on the ratio between the axis, so the extra bits of the sum are all kept.
+ * With |average| < 2^23 (Q8), the sums stay under 2^28.
+ * While the window fills (after a reset), the sums cover fewer blocks, but still give the right angles.
+ */
+#include "oversampling.h"
+
+//definitions
+#define WINDOW_MASK	(OVERSAMPLING_NB_BLOCKS - 1U)	///< Mask wrapping the window indexes
+
+//state variables
+static int32_t	_window[OVERSAMPLING_NB_BLOCKS][OVERSAMPLING_NB_AXIS];	///< Last block averages received
+static int32_t	_sums[OVERSAMPLING_NB_AXIS];		///< Sums of the block averages in the window, per axis
+static uint8_t	_index = 0;							///< Index of the oldest block average in the window
+static uint8_t	_nbBlocks = 0;						///< Number of block averages in the window
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Empty the window (e.g. after the device has been moved)
+ */
+void oversamplingReset(){
+	for(uint8_t block = 0 ; block < OVERSAMPLING_NB_BLOCKS ; block++){
+		for(uint8_t axis = 0 ; axis < OVERSAMPLING_NB_AXIS ; axis++)
+			_window[block][axis] = 0;
+	}
+	for(uint8_t axis = 0 ; axis < OVERSAMPLING_NB_AXIS ; axis++)
+		_sums[axis] = 0;
+
+	_index = 0;
+	_nbBlocks = 0;
+}
+
+/**
+ * @brief Add a block average to the window, replacing the oldest one once full
+ *
+ * @param vector Block average, per axis (fine measurements)
+ * @return Number of block averages in the window
+ */
+uint8_t oversamplingAddVector(const int32_t vector[OVERSAMPLING_NB_AXIS]){
+	for(uint8_t axis = 0 ; axis < OVERSAMPLING_NB_AXIS ; axis++){
+		_sums[axis] += vector[axis] - _window[_index][axis];
+		_window[_index][axis] = vector[axis];
+	}
+
+	_index = (uint8_t)((_index + 1U) & WINDOW_MASK);
+	if(_nbBlocks < OVERSAMPLING_NB_BLOCKS)
+		_nbBlocks++;
+
+	return (_nbBlocks);
+}
+
+/**
+ * @brief Get the sums of the block averages in the window
+ *
+ * @param[out] sums Sums of the block averages, per axis (same fixed-point format as the vectors added)
+ */
+void oversamplingGetSums(int32_t sums[OVERSAMPLING_NB_AXIS]){
+	for(uint8_t axis = 0 ; axis < OVERSAMPLING_NB_AXIS ; axis++)
+		sums[axis] = _sums[axis];
+}
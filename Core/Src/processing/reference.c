@@ -0,0 +1,187 @@
+/**
+ * @file reference.c
+ * @brief Implement the expression of measurements relative to a captured reference orientation
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * When captured, the reference gravity vector r becomes the Z axis of a new orthonormal frame :
+ * - uz = r / |r|
+ * - ux = sensor X axis with its uz component removed, normalised
+ *   (sensor Y axis used instead if r is almost aligned with X)
+ * - uy = uz x ux
+ *
+ * Each measurement is then projected on this frame with three dot products,
+ * so the angles computed from the result are the rotation relative to the reference,
+ * and not a difference of angles relative to gravity (which is wrong as soon as both axis are tilted).
+ *
+ * The frame vectors are kept in Q14, and all the maths is integer only.
+ * The reference vector is stored in the settings, so it survives resets.
+ */
+#include "reference.h"
+#include "settings.h"
+#include "fixedmath.h"
+
+//definitions
+#define FRAME_SHIFT			14U					///< Number of fractional bits in the frame vectors
+#define FRAME_ONE			((int32_t)1 << FRAME_SHIFT)	///< 1.0 in Q14
+#define ALIGNED_THRESHOLD	14746				///< 0.9 in Q14, above which the reference is considered aligned with X
+#define ROUNDING_Q14		((int32_t)1 << (FRAME_SHIFT - 1U))	///< 0.5 in Q14, used to round products
+
+/**
+ * @brief Enumeration of the function IDs of the reference
+ */
+typedef enum _referenceFunctionCodes_e{
+	INIT = 0,	///< referenceInitialise()
+	CAPTURE,	///< referenceCapture()
+}referenceFunctionCodes_e;
+
+/**
+ * @brief Enumeration of the vector components
+ */
+typedef enum{
+	X = 0,	///< X component
+	Y,		///< Y component
+	Z,		///< Z component
+}component_e;
+
+//tool functions
+static uint8_t buildFrame(const int16_t reference[REFERENCE_NB_AXIS]);
+static int16_t dotProduct(const int16_t vector[REFERENCE_NB_AXIS], const int16_t unit[REFERENCE_NB_AXIS]);
+
+//state variables
+static int16_t	_frame[REFERENCE_NB_AXIS][REFERENCE_NB_AXIS];	///< Unit vectors of the reference frame (ux, uy, uz), in Q14
+static uint8_t	_frameValid = 0;								///< Flag indicating a reference frame is available
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Rebuild the reference frame from the reference vector stored in the settings
+ *
+ * @retval 0 Success
+ * @retval 1 No reference stored
+ * @retval 2 Stored reference is null
+ */
+errorCode_u referenceInitialise(){
+	const settings_t* settings = settingsGet();
+
+	_frameValid = 0;
+	if(!settings->referenceSet)
+		return (createErrorCode(INIT, 1, ERR_INFO));
+
+	if(!buildFrame(settings->reference))
+		return (createErrorCode(INIT, 2, ERR_WARNING));
+
+	_frameValid = 1;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Capture a new reference vector, and save it in the settings
+ *
+ * @param vector Measured vector to use as reference
+ * @retval 0 Success
+ * @retval 1 Vector is null
+ * @retval 2 Error while saving the settings
+ */
+errorCode_u referenceCapture(const int16_t vector[REFERENCE_NB_AXIS]){
+	settings_t* settings = settingsGet();
+	errorCode_u result;
+
+	if(!buildFrame(vector))
+		return (createErrorCode(CAPTURE, 1, ERR_WARNING));
+	_frameValid = 1;
+
+	//store the reference
+	for(uint8_t i = 0 ; i < REFERENCE_NB_AXIS ; i++)
+		settings->reference[i] = vector[i];
+	settings->referenceSet = 1;
+
+	result = settingsSave();
+	if(IS_ERROR(result))
+		return (pushErrorCode(result, CAPTURE, 2));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Check if a reference is available
+ *
+ * @retval 0 No reference available
+ * @retval 1 Reference available
+ */
+uint8_t referenceIsSet(){
+	return (_frameValid);
+}
+
+/**
+ * @brief Express a vector in the reference frame
+ * @note If no reference is available, the vector is copied as-is
+ *
+ * @param vector Vector measured in the sensor frame
+ * @param[out] relative Vector in the reference frame
+ */
+void referenceApply(const int16_t vector[REFERENCE_NB_AXIS], int16_t relative[REFERENCE_NB_AXIS]){
+	for(uint8_t i = 0 ; i < REFERENCE_NB_AXIS ; i++)
+		relative[i] = (_frameValid ? dotProduct(vector, _frame[i]) : vector[i]);
+}
+
+/**
+ * @brief Build the orthonormal reference frame around a reference vector
+ *
+ * @param reference Reference vector
+ * @retval 0 Reference vector is null
+ * @retval 1 Success
+ */
+static uint8_t buildFrame(const int16_t reference[REFERENCE_NB_AXIS]){
+	int16_t* unitX = _frame[X];
+	int16_t* unitY = _frame[Y];
+	int16_t* unitZ = _frame[Z];
+	int32_t projection[REFERENCE_NB_AXIS] = {0};
+	int32_t dot;
+	uint32_t norm;
+
+	//uz = r / |r|
+	norm = fixedmathSquareRoot((uint32_t)(reference[X] * reference[X]) + (uint32_t)(reference[Y] * reference[Y]) + (uint32_t)(reference[Z] * reference[Z]));
+	if(!norm)
+		return (0);
+	for(uint8_t i = 0 ; i < REFERENCE_NB_AXIS ; i++)
+		unitZ[i] = (int16_t)(((int32_t)reference[i] * FRAME_ONE) / (int32_t)norm);
+
+	//pick the sensor axis the least aligned with uz, then remove its uz component
+	component_e seed = ((unitZ[X] > ALIGNED_THRESHOLD) || (unitZ[X] < -ALIGNED_THRESHOLD)) ? Y : X;
+	dot = unitZ[seed];
+	for(uint8_t i = 0 ; i < REFERENCE_NB_AXIS ; i++)
+		projection[i] = ((i == seed) ? FRAME_ONE : 0) - ((dot * unitZ[i] + ROUNDING_Q14) >> FRAME_SHIFT);
+
+	//ux = normalised projection
+	norm = fixedmathSquareRoot((uint32_t)(projection[X] * projection[X]) + (uint32_t)(projection[Y] * projection[Y]) + (uint32_t)(projection[Z] * projection[Z]));
+	for(uint8_t i = 0 ; i < REFERENCE_NB_AXIS ; i++)
+		unitX[i] = (int16_t)((projection[i] * FRAME_ONE) / (int32_t)norm);
+
+	//uy = uz x ux
+	unitY[X] = (int16_t)((unitZ[Y] * unitX[Z] - unitZ[Z] * unitX[Y] + ROUNDING_Q14) >> FRAME_SHIFT);
+	unitY[Y] = (int16_t)((unitZ[Z] * unitX[X] - unitZ[X] * unitX[Z] + ROUNDING_Q14) >> FRAME_SHIFT);
+	unitY[Z] = (int16_t)((unitZ[X] * unitX[Y] - unitZ[Y] * unitX[X] + ROUNDING_Q14) >> FRAME_SHIFT);
+
+	return (1);
+}
+
+/**
+ * @brief Compute the projection of a vector on a Q14 unit vector
+ *
+ * @param vector Vector to project
+ * @param unit Unit vector, in Q14
+ * @return Projection, in the vector units
+ */
+static int16_t dotProduct(const int16_t vector[REFERENCE_NB_AXIS], const int16_t unit[REFERENCE_NB_AXIS]){
+	int32_t sum = 0;
+
+	for(uint8_t i = 0 ; i < REFERENCE_NB_AXIS ; i++)
+		sum += (int32_t)vector[i] * unit[i];
+
+	return ((int16_t)((sum + ROUNDING_Q14) >> FRAME_SHIFT));
+}
@@ -0,0 +1,127 @@
+/**
+ * @file spectrum.c
+ * @brief Implement the detection of the dominant component in a window of samples
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Samples are accumulated in the real parts of a single complex buffer, which is then
+ * transformed in place. With FFT_SIZE at 256, the whole module uses 1 KB of RAM.
+ *
+ * The window mean is removed to get rid of gravity, then samples are amplified to use
+ * the Q15 headroom before the Hann window and the transform are applied.
+ */
+#include "spectrum.h"
+#include "fixedmath.h"
+#include <stm32f1xx.h>
+
+//definitions
+#define INPUT_SHIFT		3U			///< Number of bits samples are amplified by before the transform
+#define HANN_FFT_SHIFT	2U			///< Shift compensating the Hann coherent gain (1/2) and the one-sided spectrum (1/2)
+#define INTERP_SHIFT	8U			///< Number of fractional bits used in the peak interpolation
+#define NS_PER_S		1000000000U	///< Number of nanoseconds in a second
+#define INT16_BITS		16U			///< Number of bits in a 16-bits integer
+#define REAL			0U			///< Offset of the real part of a complex value
+#define IMAGINARY		1U			///< Offset of the imaginary part of a complex value
+
+//tool functions
+static uint32_t binMagnitude(uint16_t bin);
+
+//state variables
+static int16_t	_buffer[FFT_SIZE << 1];	///< Complex buffer in which the transform is computed
+static uint16_t	_nbSamples = 0;			///< Number of samples accumulated in the window
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Discard all the samples accumulated
+ */
+void spectrumReset(){
+	_nbSamples = 0;
+}
+
+/**
+ * @brief Add samples to the window
+ * @note Samples in excess are dropped
+ *
+ * @param samples Samples to add
+ * @param nbSamples Number of samples to add
+ * @retval 0 Window not full yet
+ * @retval 1 Window full, ready to be computed
+ */
+uint8_t spectrumAddSamples(const int16_t samples[], uint8_t nbSamples){
+	while(nbSamples-- && (_nbSamples < FFT_SIZE)){
+		_buffer[(_nbSamples << 1) + REAL] = *(samples++);
+		_buffer[(_nbSamples << 1) + IMAGINARY] = 0;
+		_nbSamples++;
+	}
+
+	return (_nbSamples >= FFT_SIZE);
+}
+
+/**
+ * @brief Compute the spectrum of the window and find its dominant component
+ * @note The window is reset afterwards
+ *
+ * @param samplePeriod_ns Period between two samples (in ns)
+ * @param[out] peak Dominant component
+ */
+void spectrumCompute(uint32_t samplePeriod_ns, spectrumPeak_t* peak){
+	int32_t mean = 0;
+	uint32_t magnitude;
+	uint32_t maxMagnitude = 0;
+	uint16_t maxBin = 1;
+	int32_t previous, next, curvature;
+	int32_t offset = 0;
+
+	//compute the mean of the window
+	for(uint16_t i = 0 ; i < FFT_SIZE ; i++)
+		mean += _buffer[i << 1];
+	mean /= (int32_t)FFT_SIZE;
+
+	//remove the mean and amplify the samples
+	for(uint16_t i = 0 ; i < FFT_SIZE ; i++)
+		_buffer[i << 1] = (int16_t)__SSAT((_buffer[i << 1] - mean) * (1 << INPUT_SHIFT), INT16_BITS);
+
+	//apply the window and transform
+	fftQ15ApplyHann(_buffer);
+	fftQ15Transform(_buffer);
+
+	//find the highest bin (DC and Nyquist excluded)
+	for(uint16_t bin = 1 ; bin < (FFT_SIZE >> 1) ; bin++){
+		magnitude = binMagnitude(bin);
+		if(magnitude > maxMagnitude){
+			maxMagnitude = magnitude;
+			maxBin = bin;
+		}
+	}
+
+	//interpolate the peak position between its neighbours (parabolic fit, in 1/256th of a bin)
+	previous = (int32_t)binMagnitude(maxBin - 1);
+	next = (int32_t)binMagnitude(maxBin + 1);
+	curvature = previous - (2 * (int32_t)maxMagnitude) + next;
+	if(curvature)
+		offset = ((previous - next) * (1 << (INTERP_SHIFT - 1))) / curvature;
+
+	//convert the peak to a frequency and an amplitude
+	peak->frequency_Hz = (uint16_t)(((uint64_t)(((int32_t)maxBin << INTERP_SHIFT) + offset) * NS_PER_S) / ((uint64_t)FFT_SIZE * samplePeriod_ns << INTERP_SHIFT));
+	peak->amplitude = (uint16_t)((maxMagnitude << HANN_FFT_SHIFT) >> INPUT_SHIFT);
+
+	_nbSamples = 0;
+}
+
+/**
+ * @brief Compute the magnitude of a transformed bin
+ *
+ * @param bin Bin number
+ * @return Magnitude of the bin
+ */
+static uint32_t binMagnitude(uint16_t bin){
+	int32_t real = _buffer[(bin << 1) + REAL];
+	int32_t imaginary = _buffer[(bin << 1) + IMAGINARY];
+
+	return (fixedmathSquareRoot((uint32_t)(real * real) + (uint32_t)(imaginary * imaginary)));
+}
@@ -0,0 +1,206 @@
+/**
+ * @file scheduler.c
+ * @brief Implement a run-to-completion cooperative scheduler with priorities
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Each task owns a priority (the higher the number, the higher the priority),
+ * which is also its bit in the ready bitmap. A task becomes ready :
+ * - periodically, released by schedulerTick() in the SysTick interrupt
+ * - on events, signalled with schedulerSignal() (from interrupts or other tasks)
+ *
+ * The highest-priority ready task is picked in constant time by counting the leading zeros of the bitmap.
+ * Tasks are never preempted by other tasks, only by interrupts.
+ *
+ * When no task is ready, the CPU sleeps until the next interrupt.
+ * Interrupts are masked between the last check and the WFI instruction, so a signal
+ * raised in between still wakes the CPU up (pending interrupts end WFI even when masked).
+ *
+ * Each run is timed : execution time, and latency from the moment the task became ready.
+ * A run ending after its deadline (relative to the moment the task became ready) is counted as a miss.
+ */
+#include "scheduler.h"
+#include "concurrency.h"
+#include "timestamp.h"
+#include <stm32f1xx.h>
+
+//definitions
+#define HIGHEST_BIT		31U		///< Index of the highest bit in the ready bitmap
+
+/**
+ * @brief Enumeration of the function IDs of the scheduler
+ */
+typedef enum _schedulerFunctionCodes_e{
+	ADD_TASK = 0,	///< schedulerAddTask()
+	GET_STATS,		///< schedulerGetStats()
+}schedulerFunctionCodes_e;
+
+/**
+ * @brief Structure holding a task control block
+ */
+typedef struct{
+	task_t				function;		///< Function run by the task (NULL if no task at this priority)
+	uint16_t			period_ms;		///< Release period (in ms), 0 if only triggered by events
+	volatile uint16_t	countdown_ms;	///< Time left before the next periodic release (in ms)
+	uint32_t			deadline_us;	///< Deadline relative to the moment the task becomes ready (in us), 0 if none
+	volatile uint32_t	readyTime_us;	///< Moment the task became ready (in us)
+	taskStats_t			stats;			///< Execution statistics
+}taskControl_t;
+
+//state variables
+static taskControl_t	_tasks[SCHEDULER_NB_PRIORITIES];	///< Task control blocks, indexed by priority
+static eventFlags_t		_ready = 0;							///< Ready bitmap (bit n set if task with priority n ready)
+static uint32_t			_periodicTasks = 0;					///< Bitmap of the tasks released periodically
+static uint32_t			_idleTime_us = 0;					///< Cumulated time spent sleeping (in us)
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Register a task
+ *
+ * @param priority Task priority (unique, the higher the number, the higher the priority)
+ * @param task Function run by the task
+ * @param period_ms Release period (in ms), 0 if only triggered by events
+ * @param deadline_us Deadline relative to the moment the task becomes ready (in us), 0 if none
+ * @retval 0 Success
+ * @retval 1 Priority out of range
+ * @retval 2 Priority already used
+ * @retval 3 No function provided
+ */
+errorCode_u schedulerAddTask(uint8_t priority, task_t task, uint16_t period_ms, uint32_t deadline_us){
+	taskControl_t* control;
+
+	if(priority >= SCHEDULER_NB_PRIORITIES)
+		return (createErrorCode(ADD_TASK, 1, ERR_WARNING));
+
+	control = &_tasks[priority];
+	if(control->function)
+		return (createErrorCode(ADD_TASK, 2, ERR_WARNING));
+	if(!task)
+		return (createErrorCode(ADD_TASK, 3, ERR_WARNING)); 	// @suppress("Avoid magic numbers")
+
+	control->function = task;
+	control->period_ms = period_ms;
+	control->countdown_ms = period_ms;
+	control->deadline_us = deadline_us;
+	control->stats = (taskStats_t){0};
+
+	//publish the task as periodic once fully configured
+	if(period_ms)
+		eventSet(&_periodicTasks, 1U << priority);
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Make a task ready (can be called from interrupts)
+ *
+ * @param priority Priority of the task to make ready
+ */
+void schedulerSignal(uint8_t priority){
+	uint32_t bit = 1U << priority;
+
+	//stamp the moment the task became ready, unless already pending
+	if(!(_ready & bit))
+		_tasks[priority].readyTime_us = timestampGet_us();
+
+	eventSet(&_ready, bit);
+}
+
+/**
+ * @brief Release the periodic tasks whose period elapsed
+ * @note Must be called every millisecond, from the SysTick interrupt
+ */
+void schedulerTick(){
+	uint32_t periodic = _periodicTasks;
+
+	while(periodic){
+		uint8_t priority = (uint8_t)(HIGHEST_BIT - __CLZ(periodic));
+		taskControl_t* control = &_tasks[priority];
+
+		periodic &= ~(1U << priority);
+		if(--control->countdown_ms)
+			continue;
+
+		control->countdown_ms = control->period_ms;
+		schedulerSignal(priority);
+	}
+}
+
+/**
+ * @brief Run the highest-priority ready task, or sleep until the next interrupt if none is ready
+ */
+void schedulerRunNext(){
+	taskControl_t* control;
+	errorCode_u result;
+	uint32_t start_us, end_us, latency_us;
+	uint8_t priority;
+
+	//if no task ready, sleep (interrupts masked to avoid missing a signal raised before WFI)
+	__disable_irq();
+	if(!_ready){
+		start_us = timestampGet_us();
+		__WFI();
+		__enable_irq();
+		_idleTime_us += timestampGet_us() - start_us;
+		return;
+	}
+	__enable_irq();
+
+	//pick the highest-priority ready task, and clear its ready bit before running it
+	priority = (uint8_t)(HIGHEST_BIT - __CLZ(_ready));
+	eventTestAndClear(&_ready, 1U << priority);
+	control = &_tasks[priority];
+	if(!control->function)
+		return;
+
+	//run the task and time it
+	start_us = timestampGet_us();
+	result = (*control->function)();
+	end_us = timestampGet_us();
+
+	//update the statistics
+	control->stats.nbRuns++;
+	control->stats.lastDuration_us = end_us - start_us;
+	control->stats.totalDuration_us += control->stats.lastDuration_us;
+	if(control->stats.lastDuration_us > control->stats.maxDuration_us)
+		control->stats.maxDuration_us = control->stats.lastDuration_us;
+
+	latency_us = end_us - control->readyTime_us;
+	if(latency_us > control->stats.maxLatency_us)
+		control->stats.maxLatency_us = latency_us;
+	if(control->deadline_us && (latency_us > control->deadline_us))
+		control->stats.deadlineMisses++;
+
+	if(IS_ERROR(result))
+		control->stats.lastError = result;
+}
+
+/**
+ * @brief Get the execution statistics of a task
+ *
+ * @param priority Priority of the task
+ * @param[out] stats Execution statistics
+ * @retval 0 Success
+ * @retval 1 No task at this priority
+ */
+errorCode_u schedulerGetStats(uint8_t priority, taskStats_t* stats){
+	if((priority >= SCHEDULER_NB_PRIORITIES) || !_tasks[priority].function)
+		return (createErrorCode(GET_STATS, 1, ERR_WARNING));
+
+	*stats = _tasks[priority].stats;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Get the cumulated time spent sleeping
+ *
+ * @return Idle time (in us)
+ */
+uint32_t schedulerGetIdleTime_us(){
+	return (_idleTime_us);
+}
@@ -0,0 +1,276 @@
+/**
+ * @file scheduler_freertos.c
+ * @brief Implement the scheduler API on top of FreeRTOS (built with USE_FREERTOS)
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Each registered task becomes a FreeRTOS task, which blocks on its task notification
+ * instead of being polled :
+ * - schedulerSignal() gives the notification (from interrupts or other tasks)
+ * - the periodic release is the notification wait timeout
+ *
+ * The tasks registered without a period (the drivers and the processing) block until signalled,
+ * so the kernel only switches tasks on the interrupts, the drivers timers expiry and the periodic releases.
+ *
+ * The kernel is configured as cooperative, so the tasks keep the run-to-completion contract
+ * of the bare-metal scheduler and share the application data without locks.
+ *
+ * Statistics are gathered exactly as with the bare-metal scheduler, and the idle time
+ * is measured in the idle hook, so both builds can be compared with the same figures.
+ *
+ * Memory reserved : STACK_WORDS words of stack and one task control block per task,
+ * plus the idle task stack (configMINIMAL_STACK_SIZE words).
+ */
+//TODO measure the comparison with the bare-metal scheduler on target (tools/tracer/scheduler_compare.gdb) : .bss/.data, idle time and TRACE_TOTAL of each build
+#include "scheduler.h"
+#include "concurrency.h"
+#include "timestamp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include <stm32f1xx.h>
+
+//definitions
+#define STACK_WORDS		256U	///< Stack size of each task (in 32-bit words)
+#define MAX_TASKS		6U		///< Maximum number of tasks registered (determines the stacks memory reserved)
+
+/**
+ * @brief Enumeration of the function IDs of the scheduler
+ */
+typedef enum _schedulerFunctionCodes_e{
+	ADD_TASK = 0,	///< schedulerAddTask()
+	GET_STATS,		///< schedulerGetStats()
+}schedulerFunctionCodes_e;
+
+/**
+ * @brief Structure holding a task control block
+ */
+typedef struct{
+	task_t				function;		///< Function run by the task (NULL if no task at this priority)
+	uint8_t				priority;		///< Task priority
+	uint16_t			period_ms;		///< Release period (in ms), 0 if only triggered by events
+	uint32_t			deadline_us;	///< Deadline relative to the moment the task becomes ready (in us), 0 if none
+	volatile uint32_t	readyTime_us;	///< Moment the task became ready (in us)
+	TaskHandle_t		handle;			///< FreeRTOS task handle
+	taskStats_t			stats;			///< Execution statistics
+}taskControl_t;
+
+extern void xPortSysTickHandler(void);
+
+//tool functions
+static void taskEntry(void* parameter);
+static void runTask(taskControl_t* control);
+
+//state variables
+static taskControl_t	_tasks[SCHEDULER_NB_PRIORITIES];	///< Task control blocks, indexed by priority
+static StaticTask_t		_taskBuffers[MAX_TASKS];			///< FreeRTOS task control blocks
+static StackType_t		_stacks[MAX_TASKS][STACK_WORDS];	///< Tasks stacks
+static StaticTask_t		_idleBuffer;						///< FreeRTOS idle task control block
+static StackType_t		_idleStack[configMINIMAL_STACK_SIZE];	///< Idle task stack
+static uint8_t			_nbTasks = 0;						///< Number of tasks registered
+static eventFlags_t		_ready = 0;							///< Ready bitmap (bit n set if task with priority n signalled)
+static uint32_t			_idleTime_us = 0;					///< Cumulated time spent sleeping (in us)
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Register a task
+ *
+ * @param priority Task priority (unique, the higher the number, the higher the priority)
+ * @param task Function run by the task
+ * @param period_ms Release period (in ms), 0 if only triggered by events
+ * @param deadline_us Deadline relative to the moment the task becomes ready (in us), 0 if none
+ * @retval 0 Success
+ * @retval 1 Priority out of range (the FreeRTOS idle task takes the lowest priority)
+ * @retval 2 Priority already used
+ * @retval 3 No function provided
+ * @retval 4 No more task memory available
+ */
+errorCode_u schedulerAddTask(uint8_t priority, task_t task, uint16_t period_ms, uint32_t deadline_us){
+	taskControl_t* control;
+
+	if(priority >= (configMAX_PRIORITIES - 1))
+		return (createErrorCode(ADD_TASK, 1, ERR_WARNING));
+
+	control = &_tasks[priority];
+	if(control->function)
+		return (createErrorCode(ADD_TASK, 2, ERR_WARNING));
+	if(!task)
+		return (createErrorCode(ADD_TASK, 3, ERR_WARNING)); 	// @suppress("Avoid magic numbers")
+	if(_nbTasks >= MAX_TASKS)
+		return (createErrorCode(ADD_TASK, 4, ERR_WARNING)); 	// @suppress("Avoid magic numbers")
+
+	control->function = task;
+	control->priority = priority;
+	control->period_ms = period_ms;
+	control->deadline_us = deadline_us;
+	control->stats = (taskStats_t){0};
+
+	//create the task one priority above the idle task
+	control->handle = xTaskCreateStatic(taskEntry, "task", STACK_WORDS, control, (UBaseType_t)priority + 1U, _stacks[_nbTasks], &_taskBuffers[_nbTasks]);
+	_nbTasks++;
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Make a task ready (can be called from interrupts)
+ * @note The interrupts calling this function must have a priority numerically
+ * 		 higher or equal to configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY
+ *
+ * @param priority Priority of the task to make ready
+ */
+void schedulerSignal(uint8_t priority){
+	taskControl_t* control = &_tasks[priority];
+	uint32_t bit = 1U << priority;
+
+	if(!control->handle)
+		return;
+
+	//stamp the moment the task became ready, unless already pending
+	if(!(_ready & bit))
+		control->readyTime_us = timestampGet_us();
+	eventSet(&_ready, bit);
+
+	//notify the task (no yield requested, the current task runs to completion)
+	if(__get_IPSR())
+		vTaskNotifyGiveFromISR(control->handle, NULL);
+	else
+		xTaskNotifyGive(control->handle);
+}
+
+/**
+ * @brief Forward the SysTick interrupt to the kernel once started
+ * @note Must be called every millisecond, from the SysTick interrupt
+ */
+void schedulerTick(){
+	if(xTaskGetSchedulerState() != taskSCHEDULER_NOT_STARTED)
+		xPortSysTickHandler();
+}
+
+/**
+ * @brief Start the kernel
+ * @note Never returns
+ */
+void schedulerRunNext(){
+	vTaskStartScheduler();
+}
+
+/**
+ * @brief Get the execution statistics of a task
+ *
+ * @param priority Priority of the task
+ * @param[out] stats Execution statistics
+ * @retval 0 Success
+ * @retval 1 No task at this priority
+ */
+errorCode_u schedulerGetStats(uint8_t priority, taskStats_t* stats){
+	if((priority >= SCHEDULER_NB_PRIORITIES) || !_tasks[priority].function)
+		return (createErrorCode(GET_STATS, 1, ERR_WARNING));
+
+	*stats = _tasks[priority].stats;
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Get the cumulated time spent sleeping
+ *
+ * @return Idle time (in us)
+ */
+uint32_t schedulerGetIdleTime_us(){
+	return (_idleTime_us);
+}
+
+/**
+ * @brief FreeRTOS task body : wait for a signal or the next periodic release, then run the task function
+ *
+ * @param parameter Task control block
+ */
+static void taskEntry(void* parameter){
+	taskControl_t* control = (taskControl_t*)parameter;
+	TickType_t nextRelease = xTaskGetTickCount() + control->period_ms;
+	TickType_t timeout;
+	int32_t remaining;
+
+	for(;;){
+		//compute the time left before the next periodic release
+		timeout = portMAX_DELAY;
+		if(control->period_ms){
+			remaining = (int32_t)(nextRelease - xTaskGetTickCount());
+			timeout = (remaining > 0) ? (TickType_t)remaining : 0;
+		}
+
+		//block until signalled, or release periodically on timeout
+		if(!ulTaskNotifyTake(pdTRUE, timeout)){
+			control->readyTime_us = timestampGet_us();
+			nextRelease += control->period_ms;
+		}
+
+		eventTestAndClear(&_ready, 1U << control->priority);
+		runTask(control);
+	}
+}
+
+/**
+ * @brief Run a task function, time it and update its statistics
+ *
+ * @param control Task control block
+ */
+static void runTask(taskControl_t* control){
+	errorCode_u result;
+	uint32_t start_us, end_us, latency_us;
+
+	start_us = timestampGet_us();
+	result = (*control->function)();
+	end_us = timestampGet_us();
+
+	control->stats.nbRuns++;
+	control->stats.lastDuration_us = end_us - start_us;
+	control->stats.totalDuration_us += control->stats.lastDuration_us;
+	if(control->stats.lastDuration_us > control->stats.maxDuration_us)
+		control->stats.maxDuration_us = control->stats.lastDuration_us;
+
+	latency_us = end_us - control->readyTime_us;
+	if(latency_us > control->stats.maxLatency_us)
+		control->stats.maxLatency_us = latency_us;
+	if(control->deadline_us && (latency_us > control->deadline_us))
+		control->stats.deadlineMisses++;
+
+	if(IS_ERROR(result))
+		control->stats.lastError = result;
+}
+
+/**
+ * @brief FreeRTOS idle hook : sleep until the next interrupt and accumulate the idle time
+ */
+void vApplicationIdleHook(void){
+	uint32_t start_us;
+
+	//interrupts masked to avoid missing a signal raised before WFI
+	__disable_irq();
+	if(_ready){
+		__enable_irq();
+		return;
+	}
+
+	start_us = timestampGet_us();
+	__WFI();
+	__enable_irq();
+	_idleTime_us += timestampGet_us() - start_us;
+}
+
+/**
+ * @brief Provide the FreeRTOS idle task memory (static allocation)
+ *
+ * @param[out] taskBuffer Idle task control block
+ * @param[out] stack Idle task stack
+ * @param[out] stackSize Idle task stack size (in words)
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t** taskBuffer, StackType_t** stack, uint32_t* stackSize){
+	*taskBuffer = &_idleBuffer;
+	*stack = _idleStack;
+	*stackSize = configMINIMAL_STACK_SIZE;
+}
@@ -23,7 +23,9 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "ADXL345.h"
-#include "SSD1306.h"
+#include "display.h"
+#include "timestamp.h"
+#include "scheduler.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -57,6 +59,7 @@
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern DMA_HandleTypeDef hdma_adc1;
 extern DMA_HandleTypeDef hdma_spi2_tx;
 /* USER CODE BEGIN EV */
 
@@ -140,19 +143,6 @@ void UsageFault_Handler(void)
   }
 }
 
-/**
-  * @brief This function handles System service call via SWI instruction.
-  */
-void SVC_Handler(void)
-{
-  /* USER CODE BEGIN SVCall_IRQn 0 */
-
-  /* USER CODE END SVCall_IRQn 0 */
-  /* USER CODE BEGIN SVCall_IRQn 1 */
-
-  /* USER CODE END SVCall_IRQn 1 */
-}
-
 /**
   * @brief This function handles Debug monitor.
   */
@@ -166,33 +156,28 @@ void DebugMon_Handler(void)
   /* USER CODE END DebugMonitor_IRQn 1 */
 }
 
-/**
-  * @brief This function handles Pendable request for system service.
-  */
-void PendSV_Handler(void)
-{
-  /* USER CODE BEGIN PendSV_IRQn 0 */
-
-  /* USER CODE END PendSV_IRQn 0 */
-  /* USER CODE BEGIN PendSV_IRQn 1 */
-
-  /* USER CODE END PendSV_IRQn 1 */
-}
-
 /**
   * @brief This function handles System tick timer.
   */
 void SysTick_Handler(void)
 {
   /* USER CODE BEGIN SysTick_IRQn 0 */
-	if(adxlTimer_ms)
+	//count the state machines timers down, and run the machines once expired
+	if(adxlTimer_ms){
 		adxlTimer_ms = adxlTimer_ms - 1;
+		if(!adxlTimer_ms)
+			schedulerSignal(TASK_ACCELEROMETER);
+	}
 
-	if(screenTimer_ms)
+	if(screenTimer_ms){
 		screenTimer_ms = screenTimer_ms - 1;
+		if(!screenTimer_ms)
+			schedulerSignal(TASK_SCREEN);
+	}
   /* USER CODE END SysTick_IRQn 0 */
   HAL_IncTick();
   /* USER CODE BEGIN SysTick_IRQn 1 */
+	schedulerTick();
 
   /* USER CODE END SysTick_IRQn 1 */
 }
@@ -210,7 +195,9 @@ void SysTick_Handler(void)
 void EXTI0_IRQHandler(void)
 {
   /* USER CODE BEGIN EXTI0_IRQn 0 */
-	adxlINT1occurred = 1;
+	spscPush(&adxlINT1edges, timestampGet_us());
+	eventSet(&adxlEvents, ADXL_EVENT_INT1);
+	schedulerSignal(TASK_ACCELEROMETER);
   /* USER CODE END EXTI0_IRQn 0 */
   HAL_GPIO_EXTI_IRQHandler(ADXL_INT1_Pin);
   /* USER CODE BEGIN EXTI0_IRQn 1 */
@@ -218,6 +205,20 @@ void EXTI0_IRQHandler(void)
   /* USER CODE END EXTI0_IRQn 1 */
 }
 
+/**
+  * @brief This function handles DMA1 channel1 global interrupt.
+  */
+void DMA1_Channel1_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel1_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel1_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_adc1);
+  /* USER CODE BEGIN DMA1_Channel1_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel1_IRQn 1 */
+}
+
 /**
   * @brief This function handles DMA1 channel5 global interrupt.
   */
@@ -228,10 +229,28 @@ void DMA1_Channel5_IRQHandler(void)
   /* USER CODE END DMA1_Channel5_IRQn 0 */
   HAL_DMA_IRQHandler(&hdma_spi2_tx);
   /* USER CODE BEGIN DMA1_Channel5_IRQn 1 */
+	schedulerSignal(TASK_SCREEN);
 
   /* USER CODE END DMA1_Channel5_IRQn 1 */
 }
 
 /* USER CODE BEGIN 1 */
+#ifndef USE_FREERTOS
+//SVCall and PendSV handlers are not generated (.ioc) : the FreeRTOS port provides them in USE_FREERTOS builds (see FreeRTOSConfig.h)
+
+/**
+  * @brief This function handles System service call via SWI instruction.
+  */
+void SVC_Handler(void)
+{
+}
+
+/**
+  * @brief This function handles Pendable request for system service.
+  */
+void PendSV_Handler(void)
+{
+}
+#endif
 
 /* USER CODE END 1 */
@@ -0,0 +1,126 @@
+/**
+ * @file settings.c
+ * @brief Implement the storage of the settings kept across resets, in the last flash page
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The linker script reserves the last flash page (1 KB) and exports its address as _ssettings.
+ * Settings are loaded in RAM at initialisation, modified there, and written back on demand.
+ * A magic number and a checksum guard against erased or outdated pages, in which case defaults are used.
+ *
+ * @note Erasing a page stalls the CPU for about 20 ms, so saving must only happen on user actions.
+ */
+#include "settings.h"
+#include "main.h"
+
+//definitions
+#define SETTINGS_MAGIC		0x4C564C32U		///< Magic number of the current settings layout ("LVL2")
+#define HALFWORD_SIZE		2U				///< Number of bytes in a half-word
+
+/**
+ * @brief Enumeration of the function IDs of the settings
+ */
+typedef enum _settingsFunctionCodes_e{
+	INIT = 0,	///< settingsInitialise()
+	SAVE,		///< settingsSave()
+}settingsFunctionCodes_e;
+
+//tool functions
+static uint32_t computeChecksum(const settings_t* settings);
+
+//linker symbols
+extern const settings_t _ssettings;		///< Flash page holding the settings
+
+//state variables
+static settings_t _settings;	///< RAM copy of the settings
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Load the settings from flash, or defaults if none valid found
+ *
+ * @retval 0 Success
+ * @retval 1 No valid settings found, defaults loaded
+ */
+errorCode_u settingsInitialise(){
+	//if settings in flash valid, load them
+	if((_ssettings.magic == SETTINGS_MAGIC) && (_ssettings.checksum == computeChecksum(&_ssettings))){
+		_settings = _ssettings;
+		return (ERR_SUCCESS);
+	}
+
+	//load defaults
+	_settings = (settings_t){0};
+	_settings.magic = SETTINGS_MAGIC;
+	return (createErrorCode(INIT, 1, ERR_INFO));
+}
+
+/**
+ * @brief Get the RAM copy of the settings
+ *
+ * @return Settings
+ */
+settings_t* settingsGet(){
+	return (&_settings);
+}
+
+/**
+ * @brief Write the RAM copy of the settings in flash
+ *
+ * @retval 0 Success
+ * @retval 1 Error while unlocking the flash
+ * @retval 2 Error while erasing the settings page
+ * @retval 3 Error while programming the settings
+ */
+errorCode_u settingsSave(){
+	FLASH_EraseInitTypeDef erase = {.TypeErase = FLASH_TYPEERASE_PAGES, .PageAddress = (uint32_t)&_ssettings, .NbPages = 1};
+	const uint16_t* source = (const uint16_t*)&_settings;
+	HAL_StatusTypeDef HALresult;
+	uint32_t pageError;
+
+	_settings.magic = SETTINGS_MAGIC;
+	_settings.checksum = computeChecksum(&_settings);
+
+	HALresult = HAL_FLASH_Unlock();
+	if(HALresult != HAL_OK)
+		return (createErrorCodeLayer1(SAVE, 1, HALresult, ERR_ERROR));
+
+	//erase the page
+	HALresult = HAL_FLASHEx_Erase(&erase, &pageError);
+	if(HALresult != HAL_OK){
+		HAL_FLASH_Lock();
+		return (createErrorCodeLayer1(SAVE, 2, HALresult, ERR_ERROR));
+	}
+
+	//program the settings half-word by half-word
+	for(uint32_t offset = 0 ; offset < sizeof(settings_t) ; offset += HALFWORD_SIZE){
+		HALresult = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, (uint32_t)&_ssettings + offset, *(source++));
+		if(HALresult != HAL_OK){
+			HAL_FLASH_Lock();
+			return (createErrorCodeLayer1(SAVE, 3, HALresult, ERR_ERROR)); 	// @suppress("Avoid magic numbers")
+		}
+	}
+
+	HAL_FLASH_Lock();
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Compute the checksum of settings (sum of all the half-words before the checksum, complemented)
+ *
+ * @param settings Settings of which compute the checksum
+ * @return Checksum
+ */
+static uint32_t computeChecksum(const settings_t* settings){
+	const uint16_t* iterator = (const uint16_t*)settings;
+	uint32_t sum = 0;
+
+	while(iterator < (const uint16_t*)&settings->checksum)
+		sum += *(iterator++);
+
+	return (~sum);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file timestamp.c
+ * @brief Implement a microsecond-resolution timestamp based on the free-running SysTick counter
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The HAL tick provides the milliseconds, and the SysTick current value register provides
+ * the sub-millisecond part. Timestamps wrap around every 71 minutes, so only differences
+ * between two timestamps must be used.
+ *
+ * The function is safe to call from interrupts with a higher priority than SysTick :
+ * if the counter reloaded but its interrupt is still pending, the missing millisecond is added.
+ */
+#include "timestamp.h"
+#include "main.h"
+
+//definitions
+#define US_PER_MS	1000U		///< Number of microseconds in a millisecond
+#define HZ_PER_MHZ	1000000U	///< Number of Hz in a MHz
+
+/**
+ * @brief Get the current timestamp
+ *
+ * @return Timestamp (in us)
+ */
+uint32_t timestampGet_us(){
+	uint32_t tick;
+	uint32_t milliseconds;
+	uint32_t counter;
+
+	//read the tick and the counter until no tick interrupt occurs in between
+	do{
+		tick = HAL_GetTick();
+		milliseconds = tick;
+		counter = SysTick->VAL;
+
+		//if counter reloaded but the tick interrupt is still pending (caller has a higher priority), add the missing tick
+		if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk){
+			counter = SysTick->VAL;
+			milliseconds++;
+		}
+	}while(tick != HAL_GetTick());
+
+	//SysTick counts down from its reload value
+	return ((milliseconds * US_PER_MS) + ((SysTick->LOAD - counter) / (HAL_RCC_GetHCLKFreq() / HZ_PER_MHZ)));
+}
@@ -0,0 +1,163 @@
+/**
+ * @file tracer.c
+ * @brief Implement the end-to-end latency tracing, from the accelerometer watermark edge to the pixels on screen
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Each block is tagged with a sequence number when its watermark edge is serviced.
+ * Each trace point keeps the latest trace which reached it : marking a point copies the trace
+ * from the previous point, timestamps it, and consumes the previous one. This way, the tag of the freshest
+ * data follows the pipeline, and a block is only measured once even if its values are printed several times.
+ * Blocks which are never displayed are simply overwritten by fresher ones.
+ *
+ * Once a trace reaches the last point (screen DMA transfer complete, marked from the interrupt),
+ * the duration of each stage is added to a power-of-two histogram.
+ *
+ * The histograms are kept in tracerSnapshot, published under a sequence lock.
+ * They can be exported to the host by dumping it with the debugger, e.g. with GDB :
+ * @code
+ * dump binary value trace.bin tracerSnapshot
+ * @endcode
+ * then decoded with tools/tracer/tracer_decode.py.
+ *
+ * @note All the points except the last one must be marked from the main loop.
+ */
+#include "tracer.h"
+#include "concurrency.h"
+#include "timestamp.h"
+#include <stm32f1xx.h>
+
+//definitions
+#define HIGHEST_BIT		32U		///< Number of bits in a duration
+
+/**
+ * @brief Enumeration of the function IDs of the tracer
+ */
+typedef enum _tracerFunctionCodes_e{
+	GET_HISTOGRAM = 0,	///< tracerGetHistogram()
+}tracerFunctionCodes_e;
+
+/**
+ * @brief Structure holding the trace of a block
+ */
+typedef struct{
+	uint32_t	tag;							///< Block sequence number
+	uint32_t	stamps_us[TRACE_NB_POINTS];		///< Timestamp of each point reached (in us)
+	uint8_t		valid;							///< Flag indicating the trace has not been consumed by the next point yet
+}trace_t;
+
+//tool functions
+static void addDuration(traceHistogram_t* histogram, uint32_t duration_us);
+
+//global variables
+traceSnapshot_t tracerSnapshot = {.magic = TRACE_MAGIC, .version = TRACE_VERSION, .nbStages = TRACE_NB_STAGES};	///< Histograms exported to the host
+
+//state variables
+static trace_t		_traces[TRACE_NB_POINTS];	///< Latest trace which reached each point
+static uint32_t		_nextTag = 1;				///< Tag given to the next block
+static seqlock_t	_snapshotLock;				///< Sequence lock protecting the snapshot (written by the DMA interrupt)
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Tag a new block, starting its trace
+ *
+ * @param edgeTimestamp_us Timestamp of the watermark edge of the block (in us)
+ */
+void tracerTag(uint32_t edgeTimestamp_us){
+	trace_t* trace = &_traces[TRACE_EDGE];
+
+	trace->tag = _nextTag++;
+	trace->stamps_us[TRACE_EDGE] = edgeTimestamp_us;
+	trace->valid = 1;
+}
+
+/**
+ * @brief Move the latest trace from the previous point to this one
+ * @details Once the last point is reached, the stage durations are added to the histograms
+ *
+ * @param point Point reached
+ */
+void tracerMark(tracePoint_e point){
+	trace_t* previous;
+	trace_t* trace;
+	uint32_t* stamps;
+
+	if((point == TRACE_EDGE) || (point >= TRACE_NB_POINTS))
+		return;
+
+	//if no new trace reached the previous point, nothing to follow
+	previous = &_traces[point - 1];
+	if(!previous->valid)
+		return;
+
+	//propagate the trace and consume the previous one
+	trace = &_traces[point];
+	*trace = *previous;
+	previous->valid = 0;
+	trace->stamps_us[point] = timestampGet_us();
+	if(point != TRACE_DISPLAYED)
+		return;
+
+	//last point reached, record the durations
+	trace->valid = 0;
+	stamps = trace->stamps_us;
+
+	seqlockWriteBegin(&_snapshotLock);
+	addDuration(&tracerSnapshot.histograms[TRACE_ACQUISITION], stamps[TRACE_INTEGRATED] - stamps[TRACE_EDGE]);
+	addDuration(&tracerSnapshot.histograms[TRACE_QUEUEING], stamps[TRACE_COMPUTED] - stamps[TRACE_INTEGRATED]);
+	addDuration(&tracerSnapshot.histograms[TRACE_COMPUTE], stamps[TRACE_PRINTED] - stamps[TRACE_COMPUTED]);
+	addDuration(&tracerSnapshot.histograms[TRACE_TRANSFER], stamps[TRACE_DISPLAYED] - stamps[TRACE_PRINTED]);
+	addDuration(&tracerSnapshot.histograms[TRACE_TOTAL], stamps[TRACE_DISPLAYED] - stamps[TRACE_EDGE]);
+	tracerSnapshot.nbTraces++;
+	tracerSnapshot.lastTag = trace->tag;
+	seqlockWriteEnd(&_snapshotLock);
+}
+
+/**
+ * @brief Get a consistent copy of the histogram of a stage
+ *
+ * @param stage Stage of which get the histogram
+ * @param[out] histogram Histogram copy
+ * @retval 0 Success
+ * @retval 1 Stage out of range
+ */
+errorCode_u tracerGetHistogram(traceStage_e stage, traceHistogram_t* histogram){
+	uint32_t sequence;
+
+	if(stage >= TRACE_NB_STAGES)
+		return (createErrorCode(GET_HISTOGRAM, 1, ERR_WARNING));
+
+	//copy the histogram, and retry if the interrupt updated it in the meantime
+	do{
+		sequence = seqlockReadBegin(&_snapshotLock);
+		*histogram = tracerSnapshot.histograms[stage];
+	}while(seqlockReadRetry(&_snapshotLock, sequence));
+
+	return (ERR_SUCCESS);
+}
+
+/**
+ * @brief Add a duration to a histogram
+ *
+ * @param histogram Histogram to update
+ * @param duration_us Duration to add (in us)
+ */
+static void addDuration(traceHistogram_t* histogram, uint32_t duration_us){
+	uint32_t bin = 0;
+
+	//bin n holds [2^(n-1), 2^n[, which is the number of significant bits
+	if(duration_us)
+		bin = HIGHEST_BIT - __CLZ(duration_us);
+	if(bin >= TRACE_NB_BINS)
+		bin = TRACE_NB_BINS - 1U;
+
+	histogram->bins[bin]++;
+	histogram->total_us += duration_us;
+	if(duration_us > histogram->max_us)
+		histogram->max_us = duration_us;
+}
@@ -0,0 +1,47 @@
+#ifndef BENCHMARK_INC_BENCHMARK_H_
+#define BENCHMARK_INC_BENCHMARK_H_
+#include <stdint.h>
+
+//definitions
+#define BENCHMARK_MAX_KERNELS	16U		///< Maximum number of kernels benchmarked
+#define BENCHMARK_BATCH			32U		///< Number of kernel calls timed together (amortises the counter reads)
+#define BENCHMARK_ITERATIONS	4096U	///< Default number of calls per kernel
+#define BENCHMARK_VERSION		1U		///< Version of the results layout (bumped if the fields change)
+
+/**
+ * @brief Kernel prototype
+ *
+ * @param iteration Iteration number, used to vary the inputs
+ */
+typedef void (*benchmarkKernel_t)(uint32_t iteration);
+
+/**
+ * @brief Structure describing a benchmarked kernel
+ */
+typedef struct{
+	const char*			name;	///< Kernel name, as reported
+	void				(*setup)(void);	///< Function preparing the kernel (NULL if none)
+	benchmarkKernel_t	run;	///< Kernel
+}benchmarkEntry_t;
+
+/**
+ * @brief Structure holding the measurements of a kernel
+ */
+typedef struct{
+	const char*	name;			///< Kernel name
+	uint32_t	iterations;		///< Number of calls measured
+	uint32_t	batchMin;		///< Cycles of the fastest batch, minus the harness overhead
+	uint32_t	batchMax;		///< Cycles of the slowest batch, minus the harness overhead
+	uint64_t	totalCycles;	///< Cycles of all the batches, minus the harness overhead
+	uint64_t	totalNs;		///< Time of all the batches (in ns)
+}benchmarkResult_t;
+
+extern const benchmarkEntry_t	benchmarkKernels[];
+extern const uint8_t			benchmarkNbKernels;
+extern benchmarkResult_t		benchmarkResults[BENCHMARK_MAX_KERNELS];
+extern uint8_t					benchmarkNbResults;
+
+void	benchmarkRunAll(uint32_t iterations, const char* filter);
+void	benchmarkDone(void);
+
+#endif /* BENCHMARK_INC_BENCHMARK_H_ */
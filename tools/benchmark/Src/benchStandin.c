@@ -0,0 +1,139 @@
+/**
+ * @file benchStandin.c
+ * @brief Implement the STM32F1 HAL functions used by the kernels, on the host
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Unlike the simulator, nothing is timed nor modelled : the transfers complete instantly,
+ * so that the host figures only cover the kernels computations.
+ * - SPI receptions return the same accelerometer sample (flat, 1 g on Z), whatever the registers read
+ * - SPI DMA transmissions are complete as soon as started : the half-transfer and transfer-complete callbacks
+ * 	 are called right away, as many times as the circular mode is kept
+ * - the core clock is the target one (72 MHz)
+ */
+#include "stm32f1xx_hal.h"
+
+//definitions
+#define HCLK_HZ		72000000U	///< Core clock frequency (in Hz)
+#define PCLK1_HZ	36000000U	///< APB1 clock frequency (in Hz)
+
+//global variables
+SPI_TypeDef			simSPI1, simSPI2;
+GPIO_TypeDef		simGPIOA, simGPIOB;
+DMA_Channel_TypeDef	simDMA1channel1, simDMA1channel5;
+ADC_TypeDef			simADC1;
+DWT_Type			simDWT;
+CoreDebug_Type		simCoreDebug;
+SCB_Type			simSCB;
+SysTick_Type		simSysTick;
+volatile uint32_t	uwTick = 0;		///< Milliseconds elapsed since the start
+
+//state variables
+static const uint8_t _sample[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x01};	///< Sample returned by the SPI receptions (X, Y, Z little-endian)
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+uint32_t HAL_GetTick(void){
+	return (uwTick);
+}
+
+uint32_t HAL_RCC_GetHCLKFreq(void){
+	return (HCLK_HZ);
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void){
+	return (PCLK1_HZ);
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void){
+	return (HCLK_HZ);
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState){
+	(void)GPIOx;
+	(void)GPIO_Pin;
+	(void)PinState;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin){
+	(void)GPIOx;
+	(void)GPIO_Pin;
+	return (GPIO_PIN_SET);
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi){
+	(void)hspi;
+	return (HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout){
+	(void)hspi;
+	(void)pData;
+	(void)Size;
+	(void)Timeout;
+	return (HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout){
+	(void)hspi;
+	(void)Timeout;
+
+	for(uint16_t i = 0 ; i < Size ; i++)
+		pData[i] = _sample[i % sizeof(_sample)];
+	return (HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size){
+	uint32_t circular;
+
+	(void)pData;
+	(void)Size;
+
+	do{
+		HAL_SPI_TxHalfCpltCallback(hspi);
+		circular = READ_BIT(hspi->hdmatx->Instance->CCR, DMA_CCR_CIRC);
+		HAL_SPI_TxCpltCallback(hspi);
+	}while(circular);
+
+	return (HAL_OK);
+}
+
+__attribute__((weak)) void HAL_SPI_TxHalfCpltCallback(SPI_HandleTypeDef* hspi){
+	(void)hspi;
+}
+
+__attribute__((weak)) void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi){
+	(void)hspi;
+}
+
+HAL_StatusTypeDef HAL_SPI_DMAStop(SPI_HandleTypeDef* hspi){
+	(void)hspi;
+	return (HAL_OK);
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef* hspi){
+	(void)hspi;
+	return (HAL_SPI_STATE_READY);
+}
+
+void __WFI(void){}
+
+void __disable_irq(void){}
+
+void __enable_irq(void){}
+
+uint32_t __get_PRIMASK(void){
+	return (0);
+}
+
+void __set_PRIMASK(uint32_t priMask){
+	(void)priMask;
+}
+
+uint32_t __get_IPSR(void){
+	return (0);
+}
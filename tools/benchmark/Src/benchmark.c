@@ -0,0 +1,184 @@
+/**
+ * @file benchmark.c
+ * @brief Implement the micro-benchmarks harness, on the target and on the host
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Each kernel is called a number of times, by batches of BENCHMARK_BATCH calls timed together.
+ * The fastest, slowest and cumulated batches are kept, minus the harness overhead
+ * (an empty kernel measured first, reported as "overhead").
+ *
+ * Cycles come from the DWT cycles counter on the target, and from the time stamp counter on x86 hosts
+ * (0 on other hosts). Times come from the cycles and the core clock on the target, and from CLOCK_MONOTONIC on the host.
+ *
+ * The results stay in benchmarkResults[] : the host runner prints them, and benchmark.gdb reads them
+ * from the target once benchmarkDone() is reached. Both print the same JSON lines.
+ */
+#include "benchmark.h"
+#include <string.h>
+#if defined(__arm__)
+#include "main.h"
+#else
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define READ_CYCLES()	((uint32_t)__rdtsc())
+#else
+#define READ_CYCLES()	0U
+#endif
+#endif
+
+//definitions
+#define NS_PER_S		1000000000ULL	///< Number of nanoseconds in a second
+#define NS_PER_US		1000U			///< Number of nanoseconds in a microsecond
+#define HZ_PER_MHZ		1000000U		///< Number of Hz in a MHz
+
+/**
+ * @brief Structure holding a point in time
+ */
+typedef struct{
+	uint32_t	cycles;		///< Cycles counter
+	uint64_t	time_ns;	///< Monotonic time (in ns, 0 on the target)
+}benchmarkClock_t;
+
+//tool functions
+static void measure(const benchmarkEntry_t* kernel, uint32_t nbBatches, benchmarkResult_t* result);
+static void emptyKernel(uint32_t iteration);
+static inline benchmarkClock_t clockNow();
+
+//global variables
+benchmarkResult_t	benchmarkResults[BENCHMARK_MAX_KERNELS];	///< Results of the kernels run, the overhead first
+uint8_t				benchmarkNbResults = 0;						///< Number of results
+
+//state variables
+static uint32_t				_overheadCycles = 0;	///< Cycles of an empty batch
+static uint64_t				_overheadNs = 0;		///< Time of an empty batch (in ns)
+static volatile uint8_t		_done = 0;				///< Set once all the kernels have been run (keeps benchmarkDone() from being optimised out)
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Run all the kernels (or the ones whose name contains the filter), then call benchmarkDone()
+ *
+ * @param iterations Number of calls per kernel (rounded up to a multiple of BENCHMARK_BATCH)
+ * @param filter Text the kernel names must contain (NULL to run all the kernels)
+ */
+void benchmarkRunAll(uint32_t iterations, const char* filter){
+	static const benchmarkEntry_t overhead = {"overhead", NULL, emptyKernel};
+	uint32_t nbBatches = (iterations + BENCHMARK_BATCH - 1U) / BENCHMARK_BATCH;
+
+#if defined(__arm__)
+	//make sure the cycles counter runs
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+	//measure the harness overhead first, with nothing to subtract
+	benchmarkNbResults = 0;
+	_overheadCycles = 0;
+	_overheadNs = 0;
+	measure(&overhead, nbBatches, &benchmarkResults[benchmarkNbResults]);
+	_overheadCycles = benchmarkResults[benchmarkNbResults].batchMin;
+	_overheadNs = benchmarkResults[benchmarkNbResults].totalNs / nbBatches;
+	benchmarkNbResults++;
+
+	for(uint8_t i = 0 ; (i < benchmarkNbKernels) && (benchmarkNbResults < BENCHMARK_MAX_KERNELS) ; i++){
+		if(filter && !strstr(benchmarkKernels[i].name, filter))
+			continue;
+
+		if(benchmarkKernels[i].setup)
+			(*benchmarkKernels[i].setup)();
+		measure(&benchmarkKernels[i], nbBatches, &benchmarkResults[benchmarkNbResults++]);
+	}
+
+	benchmarkDone();
+}
+
+/**
+ * @brief Function called once all the kernels have been run (breakpoint used by benchmark.gdb)
+ */
+void benchmarkDone(void){
+	_done = 1;
+}
+
+/**
+ * @brief Measure a kernel
+ *
+ * @param kernel Kernel to measure
+ * @param nbBatches Number of batches of BENCHMARK_BATCH calls
+ * @param[out] result Measurements
+ */
+static void measure(const benchmarkEntry_t* kernel, uint32_t nbBatches, benchmarkResult_t* result){
+	uint32_t iteration = 0;
+
+	*result = (benchmarkResult_t){.name = kernel->name, .iterations = nbBatches * BENCHMARK_BATCH, .batchMin = UINT32_MAX};
+
+	//warm the caches (host) and the flash prefetch buffer (target) up with an untimed batch
+	for(uint32_t call = 0 ; call < BENCHMARK_BATCH ; call++)
+		(*kernel->run)(iteration++);
+	iteration = 0;
+
+	for(uint32_t batch = 0 ; batch < nbBatches ; batch++){
+		benchmarkClock_t start, end;
+		uint32_t cycles;
+		uint64_t time_ns;
+
+		start = clockNow();
+		for(uint32_t call = 0 ; call < BENCHMARK_BATCH ; call++)
+			(*kernel->run)(iteration++);
+		end = clockNow();
+
+		//subtract the overhead (clamped, a batch can be faster than the overhead by noise)
+		cycles = end.cycles - start.cycles;
+		cycles = (cycles > _overheadCycles) ? (cycles - _overheadCycles) : 0;
+		time_ns = end.time_ns - start.time_ns;
+		time_ns = (time_ns > _overheadNs) ? (time_ns - _overheadNs) : 0;
+
+		if(cycles < result->batchMin)
+			result->batchMin = cycles;
+		if(cycles > result->batchMax)
+			result->batchMax = cycles;
+		result->totalCycles += cycles;
+		result->totalNs += time_ns;
+	}
+
+#if defined(__arm__)
+	//on the target, the time is deduced from the cycles
+	result->totalNs = (result->totalCycles * NS_PER_US) / (HAL_RCC_GetHCLKFreq() / HZ_PER_MHZ);
+#endif
+}
+
+/**
+ * @brief Kernel doing nothing, used to measure the harness overhead
+ *
+ * @param iteration Unused
+ */
+static void emptyKernel(uint32_t iteration){
+	(void)iteration;
+}
+
+/**
+ * @brief Read the cycles counter and the monotonic time
+ *
+ * @return Current point in time
+ */
+static inline benchmarkClock_t clockNow(){
+	benchmarkClock_t now;
+
+#if defined(__arm__)
+	now.cycles = DWT->CYCCNT;
+	now.time_ns = 0;
+#else
+	struct timespec time;
+
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	now.cycles = READ_CYCLES();
+	now.time_ns = ((uint64_t)time.tv_sec * NS_PER_S) + (uint64_t)time.tv_nsec;
+#endif
+
+	return (now);
+}
@@ -0,0 +1,290 @@
+/**
+ * @file kernels.c
+ * @brief Declare the kernels measured by the micro-benchmarks
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The ADXL345 driver is included rather than linked, so that its private kernels
+ * (integrateFIFO(), decodeBlock(), average(), fineAverage(), atanDegrees()) can be measured without being exported.
+ * The benchmark build must then not link the adxl345 library.
+ *
+ * Each kernel varies its inputs with the iteration number, and feeds its outputs to a volatile sink
+ * so that the compiler can not drop the calls.
+ * The drivers must have been initialised (SPI handles set) before the kernels are run.
+ */
+#include "benchmark.h"
+#include "ADXL345.c"
+#include "screen.h"
+#include "screenImages.h"
+#include "errorstack.h"
+#include "goertzel.h"
+#include "spectrum.h"
+
+//definitions
+#define ANGLE_RANGE_DD		1800U	///< Range of the angles printed (in tenths of degrees)
+#define ANGLE_OFFSET_DEG	90.0f	///< Offset bringing the printed angles into [-90, 90]
+#define DEGREES_DD			10.0f	///< Number of tenths of degrees in a degree
+#define ONE_G_LSB			256		///< 1 g measured in full resolution (3.9 mg/LSB)
+#define DIRECTION_RANGE		512U	///< Range of the directions given to atanDegrees()
+#define BLOCK_SIZE			32U		///< Number of samples given to the processing kernels per call
+#define SAMPLE_PERIOD_NS	5000000U	///< Sample period of the processing kernels (200 Hz, in ns)
+#define SINE_AMPLITUDE		100		///< Amplitude of the synthetic vibration samples (in LSB)
+#define NB_ERROR_LAYERS		4U		///< Number of codes the error stack can hold
+#define NB_IMAGES			6U		///< Number of mode screens decoded in turn
+#define FRAME_SIZE			1024U	///< Number of bytes in a decoded mode screen (128 columns, 8 pages)
+
+//tool functions
+static void setupScreen(void);
+static void setupProcessing(void);
+static void setupDecode(void);
+static void setupAverageShift(void);
+static void setupAverageReciprocal(void);
+static void runIntegrateFIFO(uint32_t iteration);
+static void runDecodeBlock(uint32_t iteration);
+static void runAverage(uint32_t iteration);
+static void runFineAverage(uint32_t iteration);
+static void runAtanDegrees(uint32_t iteration);
+static void runPrintAngle(uint32_t iteration);
+static void runRleDecode(uint32_t iteration);
+static void runDrawImage(uint32_t iteration);
+static uint32_t streamScreen(void);
+static void runPushErrorCode(uint32_t iteration);
+static void runStateDispatch(uint32_t iteration);
+static void runGoertzel(uint32_t iteration);
+static void runSpectrum(uint32_t iteration);
+
+//global variables
+const benchmarkEntry_t benchmarkKernels[] = {
+	{"integrateFIFO",		NULL,				runIntegrateFIFO},
+	{"decodeBlock",			setupDecode,		runDecodeBlock},
+	{"averageShift",		setupAverageShift,	runAverage},
+	{"averageReciprocal",	setupAverageReciprocal,	runAverage},
+	{"fineAverageDivision",	setupAverageReciprocal,	runFineAverage},
+	{"atanDegrees",			NULL,				runAtanDegrees},
+	{"screenPrintAngle",	setupScreen,		runPrintAngle},
+	{"rleDecode",			NULL,				runRleDecode},
+	{"screenDrawImage",		setupScreen,		runDrawImage},
+	{"pushErrorCode",		NULL,				runPushErrorCode},
+	{"stateDispatch",		setupScreen,		runStateDispatch},
+	{"goertzelAddSamples",	setupProcessing,	runGoertzel},
+	{"spectrumCompute",		setupProcessing,	runSpectrum},
+};
+const uint8_t benchmarkNbKernels = (uint8_t)(sizeof(benchmarkKernels) / sizeof(benchmarkKernels[0]));
+
+//state variables
+static volatile int32_t	_sink;					///< Sink of the kernels outputs
+static int16_t			_samples[BLOCK_SIZE];	///< Synthetic vibration samples given to the processing kernels
+static uint8_t			_frame[FRAME_SIZE];		///< Mode screen decoded by the RLE kernel
+static const rleImage_t* const _images[NB_IMAGES] = {	///< Mode screens decoded in turn
+	&imageModeLevel,
+	&imageModePrecision,
+	&imageModeRelative,
+	&imageModeSpectrum,
+	&imageModeCalibration,
+	&imageModeAveraging,
+};
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Wait for the screen to be idle, so that the kernels start from the same state
+ */
+static void setupScreen(void){
+	while(!isScreenReady())
+		screenUpdate();
+}
+
+/**
+ * @brief Fill the FIFO block with samples of all magnitudes and signs
+ */
+static void setupDecode(void){
+	for(uint8_t i = 0 ; i < FIFO_WORDS ; i++)
+		_fifoWords[i] = (uint32_t)i * 0x9E3779B9U;		// @suppress("Avoid magic numbers")
+}
+
+/**
+ * @brief Average the blocks over a power of two depth
+ */
+static void setupAverageShift(void){
+	setDepth(ADXL_AVERAGING_PRECISE);
+}
+
+/**
+ * @brief Average the blocks over a depth which is not a power of two
+ */
+static void setupAverageReciprocal(void){
+	setDepth(ADXL_AVERAGING_FAST);
+}
+
+/**
+ * @brief Configure the filters bank and prepare a block of vibration samples (one period every 8 samples)
+ */
+static void setupProcessing(void){
+	static const uint16_t frequencies_dHz[GOERTZEL_NB_FILTERS] = {100, 250, 500, 1000};	// @suppress("Avoid magic numbers")
+
+	for(uint8_t i = 0 ; i < GOERTZEL_NB_FILTERS ; i++)
+		goertzelSetFrequency(i, frequencies_dHz[i]);
+	goertzelReset();
+	spectrumReset();
+
+	for(uint8_t i = 0 ; i < BLOCK_SIZE ; i++)
+		_samples[i] = (int16_t)((sineQ15((uint16_t)(i * (FFT_MAX_SIZE >> 3))) * SINE_AMPLITUDE) >> 15);	// @suppress("Avoid magic numbers")
+}
+
+/**
+ * @brief Read and average a FIFO block
+ *
+ * @param iteration Unused
+ */
+static void runIntegrateFIFO(uint32_t iteration){
+	int16_t x, y, z;
+
+	(void)iteration;
+	integrateFIFO(&x, &y, &z);
+	_sink = x + y + z;
+}
+
+/**
+ * @brief Decode and sum a FIFO block already read
+ *
+ * @param iteration Unused
+ */
+static void runDecodeBlock(uint32_t iteration){
+	int32_t sums[NB_AXIS];
+
+	(void)iteration;
+	decodeBlock(_fifoWords, ADXL_MAX_AVERAGING, _block, sums);
+	_sink = sums[X_AXIS] + sums[Y_AXIS] + sums[Z_AXIS];
+}
+
+/**
+ * @brief Average the sums of a block, with sums of both signs
+ *
+ * @param iteration Iteration number
+ */
+static void runAverage(uint32_t iteration){
+	int32_t sum = (int32_t)(iteration * 0x9E3779B9U) >> 12;		// @suppress("Avoid magic numbers")
+
+	_sink = average(sum) + average(-sum) + average(sum >> 1);
+}
+
+/**
+ * @brief Average the sums of a block keeping the fractional bits, with sums of both signs
+ *
+ * @param iteration Iteration number
+ */
+static void runFineAverage(uint32_t iteration){
+	int32_t sum = (int32_t)(iteration * 0x9E3779B9U) >> 12;		// @suppress("Avoid magic numbers")
+
+	_sink = fineAverage(sum) + fineAverage(-sum) + fineAverage(sum >> 1);
+}
+
+/**
+ * @brief Compute an angle, with directions sweeping both signs
+ *
+ * @param iteration Iteration number
+ */
+static void runAtanDegrees(uint32_t iteration){
+	int16_t direction = (int16_t)((int32_t)(iteration % DIRECTION_RANGE) - (int32_t)(DIRECTION_RANGE >> 1));
+
+	_sink = (int32_t)atanDegrees(direction, ONE_G_LSB);
+}
+
+/**
+ * @brief Print an angle, sweeping [-90.0, 89.9] degrees, and stream it (rendered page by page by the DMA callbacks)
+ *
+ * @param iteration Iteration number
+ */
+static void runPrintAngle(uint32_t iteration){
+	float angle = ((float)(iteration % ANGLE_RANGE_DD) / DEGREES_DD) - ANGLE_OFFSET_DEG;
+
+	_sink = (int32_t)(screenPrintAngle(angle, 0, 0).dword + streamScreen());
+}
+
+/**
+ * @brief Decode a full mode screen, cycling through the images
+ *
+ * @param iteration Iteration number
+ */
+static void runRleDecode(uint32_t iteration){
+	rleDecoder_t decoder;
+
+	rleStart(&decoder, _images[iteration % NB_IMAGES]);
+	_sink = rleDecode(&decoder, _frame, FRAME_SIZE) + _frame[iteration % FRAME_SIZE];
+}
+
+/**
+ * @brief Draw a full mode screen, expanded page by page as it is streamed, cycling through the images
+ *
+ * @param iteration Iteration number
+ */
+static void runDrawImage(uint32_t iteration){
+	_sink = (int32_t)(screenDrawImage(_images[iteration % NB_IMAGES], 0, 0).dword + streamScreen());
+}
+
+/**
+ * @brief Run the screen state machine until the region queued is streamed
+ *
+ * @return Error codes of the state machine, combined
+ */
+static uint32_t streamScreen(void){
+	uint32_t codes = 0;
+
+	while(!isScreenReady())
+		codes |= screenUpdate().dword;
+	return (codes);
+}
+
+/**
+ * @brief Push an error code through all the layers of the stack
+ *
+ * @param iteration Iteration number
+ */
+static void runPushErrorCode(uint32_t iteration){
+	errorCode_u code = createErrorCode((uint8_t)iteration, 1, ERR_WARNING);
+
+	for(uint8_t layer = 1 ; layer < NB_ERROR_LAYERS ; layer++)
+		code = pushErrorCode(code, layer, layer);
+	_sink = (int32_t)code.dword;
+}
+
+/**
+ * @brief Run the screen state machine while it is idle (cost of a state dispatch)
+ *
+ * @param iteration Unused
+ */
+static void runStateDispatch(uint32_t iteration){
+	(void)iteration;
+	_sink = (int32_t)screenUpdate().dword;
+}
+
+/**
+ * @brief Run the filters bank on a block of samples
+ *
+ * @param iteration Unused
+ */
+static void runGoertzel(uint32_t iteration){
+	(void)iteration;
+	goertzelAddSamples(_samples, BLOCK_SIZE, SAMPLE_PERIOD_NS);
+	_sink = goertzelGetAmplitude(0);
+}
+
+/**
+ * @brief Add a block of samples to the spectrum window, and compute the spectrum once it is full
+ * @note One call in FFT_SIZE / BLOCK_SIZE computes the transform, the mean covers both
+ *
+ * @param iteration Unused
+ */
+static void runSpectrum(uint32_t iteration){
+	spectrumPeak_t peak;
+
+	(void)iteration;
+	if(spectrumAddSamples(_samples, BLOCK_SIZE)){
+		spectrumCompute(SAMPLE_PERIOD_NS, &peak);
+		_sink = peak.amplitude;
+	}
+}
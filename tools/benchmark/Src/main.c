@@ -0,0 +1,109 @@
+/**
+ * @file main.c
+ * @brief Run the micro-benchmarks on the host
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The kernels are compiled unmodified against the HAL stand-in (benchStandin.c),
+ * the drivers are initialised as in the firmware, then all the kernels (or the ones selected with -k) are run.
+ *
+ * The results are printed as JSON lines (stdout, or -o), one per kernel, the same as benchmark.gdb prints on the target :
+ * {"version":1,"platform":"host","kernel":"atanDegrees","iterations":4096,"cycles_min":...,"cycles_mean":...,"cycles_max":...,"ns_mean":...}
+ * The cycles and times are per call, minus the harness overhead. On the host, the cycles are time stamp counter ticks.
+ *
+ * Two results files are compared with bench_compare.py.
+ */
+#include "benchmark.h"
+#include "ADXL345.h"
+#include "screen.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+//tool functions
+static void usage(const char* program);
+static void printResult(FILE* output, const benchmarkResult_t* result);
+
+//state variables
+static SPI_HandleTypeDef	_spiADXL = {.Instance = SPI1};		///< Stand-in accelerometer SPI handle
+static DMA_HandleTypeDef	_dmaScreen = {.Instance = DMA1_Channel5};	///< Stand-in screen SPI DMA handle
+static SPI_HandleTypeDef	_spiScreen = {.Instance = SPI2, .hdmatx = &_dmaScreen};	///< Stand-in screen SPI handle
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+int main(int argc, char* argv[]){
+	uint32_t iterations = BENCHMARK_ITERATIONS;
+	const char* filter = NULL;
+	FILE* output = stdout;
+	int option;
+
+	while((option = getopt(argc, argv, "n:k:o:h")) != -1){
+		switch(option){
+			case 'n':
+				iterations = (uint32_t)strtoul(optarg, NULL, 0);
+				break;
+
+			case 'k':
+				filter = optarg;
+				break;
+
+			case 'o':
+				output = fopen(optarg, "w");
+				if(!output){
+					perror(optarg);
+					return (EXIT_FAILURE);
+				}
+				break;
+
+			case 'h':
+			default:
+				usage(argv[0]);
+				return (EXIT_FAILURE);
+		}
+	}
+	if(!iterations || (optind != argc)){
+		usage(argv[0]);
+		return (EXIT_FAILURE);
+	}
+
+	//initialise the drivers as the firmware does
+	ADXL345initialise(&_spiADXL);
+	screenInitialise(&_spiScreen);
+
+	benchmarkRunAll(iterations, filter);
+	for(uint8_t i = 0 ; i < benchmarkNbResults ; i++)
+		printResult(output, &benchmarkResults[i]);
+
+	if(output != stdout)
+		fclose(output);
+	return (EXIT_SUCCESS);
+}
+
+/**
+ * @brief Print the command line usage
+ *
+ * @param program Program name
+ */
+static void usage(const char* program){
+	fprintf(stderr, "usage: %s [-n iterations] [-k kernel_filter] [-o results.jsonl]\n", program);
+}
+
+/**
+ * @brief Print the measurements of a kernel as a JSON line (per call figures)
+ *
+ * @param output Output stream
+ * @param result Measurements
+ */
+static void printResult(FILE* output, const benchmarkResult_t* result){
+	fprintf(output, "{\"version\":%u,\"platform\":\"host\",\"kernel\":\"%s\",\"iterations\":%u,"
+					"\"cycles_min\":%.2f,\"cycles_mean\":%.2f,\"cycles_max\":%.2f,\"ns_mean\":%.2f}\n",
+					BENCHMARK_VERSION, result->name, result->iterations,
+					(double)result->batchMin / BENCHMARK_BATCH,
+					(double)result->totalCycles / result->iterations,
+					(double)result->batchMax / BENCHMARK_BATCH,
+					(double)result->totalNs / result->iterations);
+}
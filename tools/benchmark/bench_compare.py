@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""
+Compare two micro-benchmarks results files (JSON lines from the host runner or benchmark.gdb).
+
+The cycles per call of the fastest batch of each kernel found in both files are compared
+(the mean times when no cycles are available) : the fastest batch is the least disturbed
+by interrupts and, on the host, by the scheduler. A kernel slower by more than the threshold is a regression.
+The target figures repeat within a few cycles. The host figures are noisier :
+use more iterations (-n 65536) and a wider threshold (-t 15) there.
+
+usage: bench_compare.py [-t percent] before.jsonl after.jsonl
+
+return: 0 if no kernel regressed, 1 otherwise
+"""
+import argparse
+import json
+import sys
+
+VERSION = 1
+DEFAULT_THRESHOLD = 5.0
+
+
+def load(path):
+    results = {}
+    with open(path) as lines:
+        for line in lines:
+            if not line.strip():
+                continue
+            result = json.loads(line)
+            if result.get("version") != VERSION:
+                sys.exit(f"{path}: unsupported results version")
+            results[result["kernel"]] = result
+    return results
+
+
+def cost(result):
+    if result["cycles_min"] > 0:
+        return result["cycles_min"], "cycles"
+    return result["ns_mean"], "ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-t", "--threshold", type=float, default=DEFAULT_THRESHOLD,
+                        help=f"slowdown tolerated, in percent (default {DEFAULT_THRESHOLD})")
+    parser.add_argument("before")
+    parser.add_argument("after")
+    arguments = parser.parse_args()
+
+    before = load(arguments.before)
+    after = load(arguments.after)
+    regressions = 0
+
+    print(f"{'kernel':<24} {'before':>12} {'after':>12} {'change':>9}")
+    for kernel, result in after.items():
+        if kernel == "overhead" or kernel not in before:
+            continue
+
+        old, unit = cost(before[kernel])
+        new, _ = cost(result)
+        change = ((new - old) * 100.0 / old) if old else 0.0
+        mark = ""
+        if change > arguments.threshold:
+            mark = "  REGRESSION"
+            regressions += 1
+        print(f"{kernel:<24} {old:>9.2f} {unit:<2} {new:>9.2f} {unit:<2} {change:>+8.1f}%{mark}")
+
+    for kernel in before.keys() - after.keys():
+        print(f"{kernel:<24} missing from {arguments.after}")
+
+    if regressions:
+        print(f"\n{regressions} kernel(s) slower by more than {arguments.threshold}%")
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,172 @@
+#!/usr/bin/env python3
+"""
+Compress PBM images into run-length-encoded screen images (C source and header), at build time.
+
+Each image is converted to the panels native format (pages of 8 rows, one byte per column, LSB on top),
+then encoded as a stream of tokens decoded by rle.c :
+  - control byte 0x00-0x7F : literal, the next (control + 1) bytes are copied
+  - control byte 0x80-0xFF : run, the next byte is repeated ((control & 0x7F) + 3) times
+The image symbols are named after the files (mode_level.pbm gives imageModeLevel).
+
+usage: image_pack.py [-s] -o output_base image.pbm [image.pbm ...]
+
+return: 0 on success, 1 if an image can not be read or converted
+"""
+import argparse
+import os
+import re
+import sys
+
+PAGE_ROWS = 8
+MAX_WIDTH = 255
+MAX_PAGES = 255
+MAX_LITERAL = 128
+MIN_RUN = 3
+MAX_RUN = 127 + MIN_RUN
+RUN_FLAG = 0x80
+BYTES_PER_LINE = 16
+
+
+def read_pbm(path):
+    with open(path, "rb") as image:
+        data = image.read()
+
+    #split the header tokens (magic, width, height), skipping the comments
+    tokens = []
+    offset = 0
+    while len(tokens) < 3:
+        match = re.compile(rb"\s*(#[^\n]*\n\s*)*([^\s#]+)").match(data, offset)
+        if not match:
+            sys.exit(f"{path}: truncated PBM header")
+        tokens.append(match.group(2))
+        offset = match.end()
+    magic, width, height = tokens[0], int(tokens[1]), int(tokens[2])
+
+    if magic == b"P1":
+        bits = [int(bit) for bit in re.sub(rb"#[^\n]*\n|\s", b"", data[offset:]).decode()]
+        pixels = [bits[row * width:(row + 1) * width] for row in range(height)]
+    elif magic == b"P4":
+        raw = data[offset + 1:]
+        stride = (width + 7) // 8
+        pixels = [[(raw[row * stride + column // 8] >> (7 - column % 8)) & 1 for column in range(width)]
+                  for row in range(height)]
+    else:
+        sys.exit(f"{path}: not a PBM image (P1 or P4)")
+
+    if len(pixels) != height or any(len(row) != width for row in pixels):
+        sys.exit(f"{path}: truncated PBM data")
+    if (height % PAGE_ROWS) or (width > MAX_WIDTH) or (height // PAGE_ROWS > MAX_PAGES):
+        sys.exit(f"{path}: {width} x {height} can not be stored in pages")
+    return width, height, pixels
+
+
+def to_pages(width, height, pixels):
+    pages = bytearray()
+    for page in range(height // PAGE_ROWS):
+        for column in range(width):
+            byte = 0
+            for bit in range(PAGE_ROWS):
+                byte |= pixels[(page * PAGE_ROWS) + bit][column] << bit
+            pages.append(byte)
+    return pages
+
+
+def encode(raw):
+    encoded = bytearray()
+    literal = bytearray()
+    index = 0
+
+    def flush_literal():
+        encoded.append(len(literal) - 1)
+        encoded.extend(literal)
+        literal.clear()
+
+    while index < len(raw):
+        run = 1
+        while (index + run < len(raw)) and (raw[index + run] == raw[index]) and (run < MAX_RUN):
+            run += 1
+
+        if run >= MIN_RUN:
+            if literal:
+                flush_literal()
+            encoded.extend((RUN_FLAG | (run - MIN_RUN), raw[index]))
+            index += run
+            continue
+
+        literal.append(raw[index])
+        index += 1
+        if len(literal) == MAX_LITERAL:
+            flush_literal()
+
+    if literal:
+        flush_literal()
+    return encoded
+
+
+def decode(encoded):
+    raw = bytearray()
+    index = 0
+    while index < len(encoded):
+        control = encoded[index]
+        if control & RUN_FLAG:
+            raw.extend([encoded[index + 1]] * ((control & ~RUN_FLAG) + MIN_RUN))
+            index += 2
+        else:
+            raw.extend(encoded[index + 1:index + control + 2])
+            index += control + 2
+    return raw
+
+
+def symbol_name(path):
+    words = re.split(r"[^0-9A-Za-z]+", os.path.splitext(os.path.basename(path))[0])
+    return "image" + "".join(word[:1].upper() + word[1:] for word in words if word)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("-o", "--output", required=True, help="output path, without the .c/.h extension")
+    parser.add_argument("-s", "--stats", action="store_true", help="print the compression ratio of each image")
+    parser.add_argument("images", nargs="+")
+    arguments = parser.parse_args()
+
+    base = os.path.basename(arguments.output)
+    guard = "GENERATED_" + re.sub(r"[^0-9A-Za-z]", "_", base).upper() + "_H_"
+    header = [f"#ifndef {guard}", f"#define {guard}", '#include "rle.h"', "",
+              "//generated by tools/imagepack/image_pack.py, do not edit", ""]
+    source = [f'#include "{base}.h"', "", "//generated by tools/imagepack/image_pack.py, do not edit", ""]
+    total_raw = total_encoded = 0
+
+    for path in arguments.images:
+        width, height, pixels = read_pbm(path)
+        raw = to_pages(width, height, pixels)
+        encoded = encode(raw)
+        if decode(encoded) != raw:
+            sys.exit(f"{path}: the encoded stream does not decode back to the image")
+
+        name = symbol_name(path)
+        header.append(f"extern const rleImage_t\t{name};\t///< {os.path.basename(path)} ({len(encoded)} bytes)")
+        source.append(f"static const uint8_t {name}Data[{len(encoded)}] = {{")
+        for start in range(0, len(encoded), BYTES_PER_LINE):
+            source.append("\t" + ", ".join(f"0x{byte:02X}" for byte in encoded[start:start + BYTES_PER_LINE]) + ",")
+        source.append("};")
+        source.append(f"const rleImage_t {name} = {{{name}Data, {len(encoded)}U, {width}U, {height // PAGE_ROWS}U}};")
+        source.append("")
+
+        total_raw += len(raw)
+        total_encoded += len(encoded)
+        if arguments.stats:
+            print(f"{os.path.basename(path):<24} {len(raw):>6} -> {len(encoded):>5} bytes ({100.0 * len(encoded) / len(raw):5.1f} %)")
+
+    if arguments.stats:
+        print(f"{'total':<24} {total_raw:>6} -> {total_encoded:>5} bytes ({100.0 * total_encoded / total_raw:5.1f} %)")
+
+    header.extend(["", f"#endif /* {guard} */", ""])
+    with open(arguments.output + ".h", "w") as output:
+        output.write("\n".join(header))
+    with open(arguments.output + ".c", "w") as output:
+        output.write("\n".join(source))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
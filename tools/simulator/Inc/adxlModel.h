@@ -0,0 +1,36 @@
+#ifndef SIMULATOR_INC_ADXLMODEL_H_
+#define SIMULATOR_INC_ADXLMODEL_H_
+#include <stdint.h>
+#include "simulator.h"
+#include "ADXL345.h"
+
+/**
+ * @brief Acceleration source prototype
+ *
+ * @param context Source context
+ * @param time_ns Simulated time of the sample (in ns)
+ * @param[out] acceleration_ug Acceleration on each axis (in ug)
+ */
+typedef void (*adxlSource_t)(void* context, uint64_t time_ns, int32_t acceleration_ug[NB_AXIS]);
+
+/**
+ * @brief Structure holding the statistics of the ADXL345 model
+ */
+typedef struct{
+	uint32_t	nbSamples;		///< Number of samples converted
+	uint32_t	nbPopped;		///< Number of FIFO entries read
+	uint32_t	nbOverruns;		///< Number of samples lost (FIFO full or data registers not read)
+	uint32_t	nbSingleTaps;	///< Number of single taps detected
+	uint32_t	nbDoubleTaps;	///< Number of double taps detected
+	uint32_t	nbActivities;	///< Number of samples detected as activity
+	uint32_t	nbInactivities;	///< Number of inactivity periods detected
+	uint32_t	nbFreeFalls;	///< Number of free-falls detected
+	uint32_t	nbTriggers;		///< Number of trigger events in trigger mode
+}adxlModelStats_t;
+
+extern const simSPIdevice_t adxlModelDevice;
+
+void adxlModelInitialise(GPIO_TypeDef* int1Port, uint16_t int1Pin, adxlSource_t source, void* context);
+void adxlModelGetStats(adxlModelStats_t* stats);
+
+#endif /* SIMULATOR_INC_ADXLMODEL_H_ */
@@ -0,0 +1,20 @@
+#ifndef SIMULATOR_INC_CAPTURE_H_
+#define SIMULATOR_INC_CAPTURE_H_
+#include <stdint.h>
+#include "ADXL345.h"
+
+/**
+ * @brief Structure holding a captured samples stream
+ */
+typedef struct{
+	int16_t		(*samples)[NB_AXIS];	///< Samples, in full resolution LSB
+	uint32_t	nbSamples;				///< Number of samples
+	uint32_t	odr_Hz;					///< Output data rate at which the samples were captured (in Hz)
+}capture_t;
+
+int			captureLoad(capture_t* capture, const char* path);
+void		captureFree(capture_t* capture);
+uint64_t	captureGetDuration_ns(const capture_t* capture);
+void		captureReplay(void* context, uint64_t time_ns, int32_t acceleration_ug[NB_AXIS]);
+
+#endif /* SIMULATOR_INC_CAPTURE_H_ */
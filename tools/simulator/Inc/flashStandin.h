@@ -0,0 +1,6 @@
+#ifndef SIMULATOR_INC_FLASHSTANDIN_H_
+#define SIMULATOR_INC_FLASHSTANDIN_H_
+
+void flashStandinErase();
+
+#endif /* SIMULATOR_INC_FLASHSTANDIN_H_ */
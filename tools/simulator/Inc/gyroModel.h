@@ -0,0 +1,30 @@
+#ifndef SIMULATOR_INC_GYROMODEL_H_
+#define SIMULATOR_INC_GYROMODEL_H_
+#include <stdint.h>
+#include "simulator.h"
+#include "L3GD20.h"
+
+/**
+ * @brief Angular rate source prototype
+ *
+ * @param context Source context
+ * @param time_ns Simulated time of the sample (in ns)
+ * @param[out] rate_mdps Angular rate around each axis (in milli-degrees per second)
+ */
+typedef void (*gyroSource_t)(void* context, uint64_t time_ns, int32_t rate_mdps[L3GD_NB_AXIS]);
+
+/**
+ * @brief Structure holding the statistics of the L3GD20 model
+ */
+typedef struct{
+	uint32_t	nbSamples;		///< Number of samples converted
+	uint32_t	nbPopped;		///< Number of FIFO entries read
+	uint32_t	nbOverruns;		///< Number of samples lost (oldest FIFO entry overwritten)
+}gyroModelStats_t;
+
+extern const simSPIdevice_t gyroModelDevice;
+
+void gyroModelInitialise(gyroSource_t source, void* context);
+void gyroModelGetStats(gyroModelStats_t* stats);
+
+#endif /* SIMULATOR_INC_GYROMODEL_H_ */
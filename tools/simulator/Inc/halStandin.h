@@ -0,0 +1,7 @@
+#ifndef SIMULATOR_INC_HALSTANDIN_H_
+#define SIMULATOR_INC_HALSTANDIN_H_
+#include <stdint.h>
+
+void halStandinSetAnalog(uint16_t supply_mV, uint16_t battery_mV, int16_t temperature_dC);
+
+#endif /* SIMULATOR_INC_HALSTANDIN_H_ */
@@ -0,0 +1,20 @@
+#ifndef SIMULATOR_INC_IMAGE_H_
+#define SIMULATOR_INC_IMAGE_H_
+#include <stdint.h>
+
+//definitions
+#define IMAGE_WIDTH			128U					///< Width of the images (in pixels)
+#define IMAGE_HEIGHT		64U						///< Height of the images (in pixels)
+#define IMAGE_ROW_BYTES		(IMAGE_WIDTH / 8U)		///< Number of bytes in an image row
+
+/**
+ * @brief Monochrome image, one bit per pixel, rows from the top, leftmost pixel in the MSB (1 when lit)
+ */
+typedef struct{
+	uint8_t	rows[IMAGE_HEIGHT][IMAGE_ROW_BYTES];	///< Pixels of each row
+}image_t;
+
+int			imageWrite(const image_t* image, const char* path);
+uint32_t	imageCRC32(const image_t* image);
+
+#endif /* SIMULATOR_INC_IMAGE_H_ */
@@ -0,0 +1,45 @@
+#ifndef SIMULATOR_INC_PROFILE_H_
+#define SIMULATOR_INC_PROFILE_H_
+#include <stdint.h>
+#include "capture.h"
+
+//definitions
+#define PROFILE_NB_PARAMETERS	3U	///< Highest number of parameters of a profile
+#define PROFILE_NB_ANGLES		2U	///< Number of true angles given (X and Y axis angles, as in level mode)
+
+/**
+ * @brief Enumeration of the acceleration profiles
+ */
+typedef enum{
+	PROFILE_CAPTURE = 0,	///< Replay of a capture
+	PROFILE_STILL,			///< Constant acceleration (x, y, z in mg)
+	PROFILE_TILT,			///< Constant tilt (roll, pitch in degrees)
+	PROFILE_SWEEP,			///< Sinusoidal rocking around the X axis (period in s, amplitude in degrees)
+	PROFILE_VIBRATION,		///< Flat, with a sinusoidal vibration on Z (frequency in Hz, amplitude in mg)
+	PROFILE_TAPS,			///< Flat, with periodic taps on Z (period in s, taps per burst, tap width in ms)
+	PROFILE_BOOM,			///< Swinging at the end of an arm (period in s, amplitude in degrees, arm length in m)
+	NB_PROFILES
+}profileType_e;
+
+/**
+ * @brief Structure describing an acceleration profile, with the sensor imperfections added to it
+ */
+typedef struct{
+	profileType_e		type;									///< Profile type
+	double				parameters[PROFILE_NB_PARAMETERS];		///< Profile parameters
+	const capture_t*	capture;								///< Capture replayed (PROFILE_CAPTURE only)
+	double				noise_mg;								///< Standard deviation of the white noise added on each axis (in mg)
+	double				drift_mg_per_h;							///< Offset drift added on each axis (in mg per hour)
+	double				rateBias_dps;							///< Zero-rate level added to each gyroscope axis (in dps)
+	double				rateNoise_dps;							///< Standard deviation of the white noise added to each gyroscope axis (in dps)
+	uint64_t			random;									///< Noise generator state
+	uint64_t			rateRandom;								///< Gyroscope noise generator state
+}profile_t;
+
+int		profileParse(profile_t* profile, const char* specification);
+void	profileSetCapture(profile_t* profile, const capture_t* capture);
+void	profileSource(void* context, uint64_t time_ns, int32_t acceleration_ug[NB_AXIS]);
+void	profileRateSource(void* context, uint64_t time_ns, int32_t rate_mdps[NB_AXIS]);
+int		profileGetAngles(const profile_t* profile, uint64_t time_ns, double angles[PROFILE_NB_ANGLES]);
+
+#endif /* SIMULATOR_INC_PROFILE_H_ */
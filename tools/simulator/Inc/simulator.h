@@ -0,0 +1,63 @@
+#ifndef SIMULATOR_INC_SIMULATOR_H_
+#define SIMULATOR_INC_SIMULATOR_H_
+#include <stdint.h>
+#include <stm32f1xx.h>
+
+//definitions
+#define SIM_HCLK_HZ		72000000U	///< Simulated core clock frequency (in Hz)
+#define SIM_PCLK1_HZ	36000000U	///< Simulated APB1 clock frequency (in Hz)
+#define SIM_PCLK2_HZ	72000000U	///< Simulated APB2 clock frequency (in Hz)
+#define SIM_CYCLES_PER_US	(SIM_HCLK_HZ / 1000000U)	///< Number of core cycles per microsecond
+#define SIM_NS_PER_US	1000U		///< Number of nanoseconds in a microsecond
+#define SIM_NS_PER_MS	1000000U	///< Number of nanoseconds in a millisecond
+#define SIM_NS_PER_S	1000000000ULL	///< Number of nanoseconds in a second
+
+/**
+ * @brief Enumeration of the simulated interrupts, by dispatch priority (lowest number first)
+ */
+typedef enum{
+	SIM_IRQ_EXTI0 = 0,		///< Accelerometer INT1 falling edge
+	SIM_IRQ_DMA1_CH1,		///< ADC DMA half/full transfer
+	SIM_IRQ_DMA1_CH5,		///< Screen SPI DMA transfer complete
+	SIM_IRQ_SYSTICK,		///< 1 ms system tick
+	SIM_NB_IRQ
+}simIRQ_e;
+
+typedef void (*simCallback_t)(void* context);							///< Timer expiry callback
+typedef void (*simPinCallback_t)(void* context, GPIO_PinState level);	///< Output pin change callback
+
+/**
+ * @brief Structure holding a one-shot simulated timer
+ */
+typedef struct{
+	uint64_t		due_ns;		///< Simulated time at which the timer expires (in ns)
+	simCallback_t	callback;	///< Function called on expiry
+	void*			context;	///< Context given to the callback
+	uint8_t			armed;		///< 1 if the timer is waiting for its expiry
+}simTimer_t;
+
+/**
+ * @brief Structure describing a device attached to a SPI bus
+ */
+typedef struct{
+	void	(*select)(void* context, uint8_t selected);		///< Called when the chip select changes (1 when selected)
+	uint8_t	(*exchange)(void* context, uint8_t mosi);		///< Called for each byte clocked, returns the MISO byte
+	void*	context;										///< Context given to the callbacks
+}simSPIdevice_t;
+
+void		simInitialise(uint64_t end_ns, simCallback_t onEnd);
+uint64_t	simNow_ns();
+void		simAdvance_ns(uint64_t duration_ns);
+void		simTimerArm(simTimer_t* timer, uint64_t due_ns);
+void		simTimerCancel(simTimer_t* timer);
+void		simRaiseIRQ(simIRQ_e irq);
+void		simEnableIRQ(simIRQ_e irq);
+void		simPinDrive(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState level);
+GPIO_PinState simPinRead(const GPIO_TypeDef* port, uint16_t pin);
+void		simPinWatch(GPIO_TypeDef* port, uint16_t pin, simPinCallback_t callback, void* context);
+void		simPinSetEXTI(GPIO_TypeDef* port, uint16_t pin);
+void		simSPIattach(const SPI_TypeDef* bus, GPIO_TypeDef* csPort, uint16_t csPin, const simSPIdevice_t* device);
+uint8_t		simSPIexchange(const SPI_TypeDef* bus, uint8_t mosi);
+uint32_t	simSPIgetBytes(const SPI_TypeDef* bus);
+
+#endif /* SIMULATOR_INC_SIMULATOR_H_ */
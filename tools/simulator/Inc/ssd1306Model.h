@@ -0,0 +1,52 @@
+#ifndef SIMULATOR_INC_SSD1306MODEL_H_
+#define SIMULATOR_INC_SSD1306MODEL_H_
+#include <stdint.h>
+#include "simulator.h"
+#include "image.h"
+
+/**
+ * @brief Enumeration of the controllers the model can behave as
+ */
+typedef enum{
+	MODEL_SSD1306 = 0,	///< SSD1306 : 128 columns, horizontal/vertical/page addressing modes
+	MODEL_SH1106		///< SH1106 : 132 columns (128 visible from column 2), page addressing mode only
+}ssd1306Controller_e;
+
+/**
+ * @brief Structure holding the statistics of the SSD1306 model
+ */
+typedef struct{
+	uint32_t	commandBytes;		///< Number of command bytes received
+	uint32_t	dataBytes;			///< Number of data bytes received
+	uint32_t	nbTransfers;		///< Number of data transfers (chip select windows with data)
+	uint32_t	nbFrames;			///< Number of frames (data transfers, or commands changing the display)
+	uint32_t	maxFrameBytes;		///< Maximum number of bytes (commands and data) received for a frame
+	uint32_t	unknownCommands;	///< Number of command bytes not listed in the datasheet
+}ssd1306ModelStats_t;
+
+/**
+ * @brief Structure describing a frame, ended by the chip select release
+ */
+typedef struct{
+	uint32_t	index;			///< Frame number (from 0)
+	uint64_t	time_ns;		///< Simulated time at which the frame ended (in ns)
+	uint32_t	commandBytes;	///< Number of command bytes received since the previous frame
+	uint32_t	dataBytes;		///< Number of data bytes received since the previous frame
+}ssd1306Frame_t;
+
+/**
+ * @brief Frame handler prototype
+ *
+ * @param context Handler context
+ * @param frame Frame which just ended (the panel can be rendered with ssd1306ModelRender())
+ */
+typedef void (*ssd1306FrameHandler_t)(void* context, const ssd1306Frame_t* frame);
+
+extern const simSPIdevice_t ssd1306ModelDevice;
+
+void ssd1306ModelInitialise(ssd1306Controller_e controller, GPIO_TypeDef* dcPort, uint16_t dcPin, GPIO_TypeDef* resetPort, uint16_t resetPin);
+void ssd1306ModelSetFrameHandler(ssd1306FrameHandler_t handler, void* context);
+void ssd1306ModelRender(image_t* image);
+void ssd1306ModelGetStats(ssd1306ModelStats_t* stats);
+
+#endif /* SIMULATOR_INC_SSD1306MODEL_H_ */
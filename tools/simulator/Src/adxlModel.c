@@ -0,0 +1,692 @@
+/**
+ * @file adxlModel.c
+ * @brief Implement a behavioural model of the ADXL345, attached to the simulated SPI bus
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The model keeps a register file, and converts a sample at each output data rate period
+ * once in measurement mode. Samples are converted with the data format at conversion time
+ * (range, resolution, justification, self-test deflection and offsets), then either stored
+ * in the data registers (bypass mode) or pushed in the 32 entries FIFO.
+ *
+ * Reading the data registers latches the oldest sample at the first data byte, and pops it
+ * from the FIFO when the chip select is released, as on the device.
+ *
+ * Each sample also runs the event detections, on the acceleration with its offsets and self-test deflection :
+ * - single and double taps (threshold, duration, latency, window and the double tap suppression)
+ * - activity and inactivity (DC or AC coupled, on the axes enabled), free-fall
+ * The events are latched in INT_SOURCE until it is read, and the axes involved are reported in ACT_TAP_STATUS.
+ *
+ * In trigger mode, the FIFO streams until an event enabled on the trigger pin occurs,
+ * then keeps the number of samples set in FIFO_CTL and collects until full, as in FIFO mode,
+ * until the device is set back to bypass mode.
+ * The sleep bit lowers the sample rate to the wake-up rate ; the auto-sleep (link) is not modelled.
+ *
+ * INT1 follows the interrupt sources enabled and not mapped to INT2, with the polarity set in DATA_FORMAT.
+ *
+ * @note Datasheet : https://www.analog.com/media/en/technical-documentation/data-sheets/ADXL345.pdf
+ */
+#include "adxlModel.h"
+#include "ADXL345registers.h"
+
+//definitions
+#define FIFO_DEPTH			32U			///< Number of samples the FIFO can hold
+#define ADDRESS_MASK		0x3FU		///< Register address bits of the command byte
+#define FIFO_MODE_MASK		0xC0U		///< FIFO mode bits of FIFO_CONTROL
+#define FIFO_SAMPLES_MASK	0x1FU		///< Watermark bits of FIFO_CONTROL
+#define RATE_MASK			0x0FU		///< Rate bits of BANDWIDTH_POWERMODE
+#define RANGE_MASK			0x03U		///< Range bits of DATA_FORMAT
+#define RATE_MAX_CODE		0x0FU		///< Rate code of the highest output data rate
+#define ODR_MAX_HZ			3200U		///< Highest output data rate (in Hz)
+#define RESOLUTION_BITS		10U			///< Resolution of the measurements when not in full resolution
+#define REGISTER_BITS		16U			///< Width of a data register pair
+#define OFFSET_UG_PER_LSB	15600		///< Scale of the offset registers (in ug per LSB)
+#define BYTE_SHIFT			8U			///< Number of bits in a byte
+#define ST_DEFLECTION_X_UG	 1500000	///< Self-test deflection on the X axis (in ug)
+#define ST_DEFLECTION_Y_UG	-1500000	///< Self-test deflection on the Y axis (in ug)
+#define ST_DEFLECTION_Z_UG	 2300000	///< Self-test deflection on the Z axis (in ug)
+#define THRESHOLD_UG_PER_LSB	62500	///< Scale of the tap, activity and free-fall thresholds (in ug per LSB)
+#define TAP_DURATION_NS_PER_LSB	625000U	///< Scale of the tap duration (in ns per LSB)
+#define TAP_LATENCY_NS_PER_LSB	1250000U	///< Scale of the tap latency and window (in ns per LSB)
+#define INACTIVITY_NS_PER_LSB	1000000000ULL	///< Scale of the inactivity time (in ns per LSB)
+#define FREEFALL_NS_PER_LSB		5000000U	///< Scale of the free-fall time (in ns per LSB)
+#define FIFO_TRIGGERED		0x80U		///< FIFO_STATUS bit set once a trigger event occurred
+#define TRIGGER_INT2		0x20U		///< FIFO_CONTROL bit linking the trigger event to INT2
+#define SLEEP_BIT			0x04U		///< Sleep bit of POWER_CONTROL
+#define WAKEUP_MASK			0x03U		///< Wake-up rate bits of POWER_CONTROL
+#define WAKEUP_MAX_HZ		8U			///< Highest wake-up rate (in Hz)
+#define ACTIVITY_AC			0x80U		///< ACTIVITY_CONTROL bit selecting the AC coupled activity detection
+#define ACTIVITY_SHIFT		4U			///< Position of the activity axes in ACTIVITY_CONTROL
+#define INACTIVITY_AC		0x08U		///< ACTIVITY_CONTROL bit selecting the AC coupled inactivity detection
+#define AXES_MASK			0x07U		///< Axes enable bits (X, Y, Z from the MSB) of ACTIVITY_CONTROL and TAP_AXES
+#define STATUS_ASLEEP		0x08U		///< ACT_TAP_STATUS bit set while asleep
+#define STATUS_ACT_SHIFT	4U			///< Position of the activity axes in ACT_TAP_STATUS
+#define EVENTS_MASK			(ADXL_INT_SINGLETAP | ADXL_INT_DOUBLETAP | ADXL_INT_ACTIVITY | ADXL_INT_INACTIVITY | ADXL_INT_FREEFALL)	///< Latched events
+
+/**
+ * @brief Enumeration of the tap detection phases
+ */
+typedef enum{
+	PHASE_IDLE = 0,		///< Waiting for a first tap
+	PHASE_LATENCY,		///< First tap detected, waiting for the latency to elapse
+	PHASE_WINDOW,		///< Waiting for a second tap to start
+	PHASE_SECOND,		///< Second tap started in the window, waiting for it to end
+}tapPhase_e;
+
+/**
+ * @brief Structure holding a converted sample, as read in the data registers
+ */
+typedef struct{
+	int16_t	axes[NB_AXIS];	///< Value of each axis
+}sample_t;
+
+//SPI device callbacks
+static void selectChanged(void* context, uint8_t selected);
+static uint8_t exchangeByte(void* context, uint8_t mosi);
+
+//tool functions
+static void sampleElapsed(void* context);
+static void measure(const int32_t acceleration_ug[NB_AXIS], int32_t measured_ug[NB_AXIS]);
+static sample_t convert(const int32_t measured_ug[NB_AXIS]);
+static uint8_t detectEvents(const int32_t measured_ug[NB_AXIS], uint64_t time_ns);
+static uint8_t detectTaps(const int32_t measured_ug[NB_AXIS], uint64_t time_ns);
+static uint8_t axesAbove(const int32_t measured_ug[NB_AXIS], const int32_t reference_ug[NB_AXIS], uint8_t axes, uint8_t threshold);
+static void trigger();
+static uint8_t readRegister(uint8_t address);
+static void writeRegister(uint8_t address, uint8_t value);
+static uint8_t interruptSources();
+static void updateINT1();
+static void startSampling();
+static uint64_t samplePeriod_ns();
+
+//global variables
+const simSPIdevice_t adxlModelDevice = {selectChanged, exchangeByte, NULL};	///< SPI device callbacks of the model
+
+//state variables
+static uint8_t			_registers[ADXL_NB_REGISTERS];	///< Register file
+static sample_t			_fifo[FIFO_DEPTH];				///< FIFO entries
+static uint8_t			_fifoHead = 0;					///< Index of the oldest FIFO entry
+static uint8_t			_fifoCount = 0;					///< Number of FIFO entries
+static sample_t			_output;						///< Data registers content when no FIFO entry is available
+static sample_t			_latched;						///< Sample latched by the current data registers read
+static uint8_t			_latchedValid = 0;				///< 1 if a sample has been latched during the current transaction
+static uint8_t			_dataReady = 0;					///< 1 if a sample has not been read yet
+static uint8_t			_overrun = 0;					///< 1 if a sample has been lost since the last read
+static uint8_t			_address = 0;					///< Register address of the current transaction
+static uint8_t			_command = 0;					///< Command byte of the current transaction (0 if not received yet)
+static uint8_t			_commandReceived = 0;			///< 1 once the command byte of the current transaction is received
+static uint8_t			_events = 0;					///< Events latched until INT_SOURCE is read
+static uint8_t			_triggered = 0;					///< 1 once a trigger event occurred in trigger mode
+static tapPhase_e		_tapPhase = PHASE_IDLE;			///< Tap detection phase
+static uint8_t			_tapAbove = 0;					///< 1 while the acceleration is above the tap threshold
+static uint64_t			_tapStart_ns = 0;				///< Time at which the acceleration got above the tap threshold
+static uint64_t			_tapLatencyEnd_ns = 0;			///< End of the latency following the first tap
+static uint64_t			_tapWindowEnd_ns = 0;			///< End of the window for a second tap
+static int32_t			_activityReference[NB_AXIS];	///< Reference acceleration of the AC coupled activity detection (in ug)
+static int32_t			_inactivityReference[NB_AXIS];	///< Reference acceleration of the AC coupled inactivity detection (in ug)
+static uint8_t			_tapAxes = 0;					///< Axes above the tap threshold during the current tap
+static uint64_t			_stillSince_ns = 0;				///< Time since which no inactivity threshold is exceeded
+static uint8_t			_still = 0;						///< 1 while no inactivity threshold is exceeded
+static uint8_t			_inactivityReported = 0;		///< 1 once the inactivity of the current still period is reported
+static uint64_t			_fallingSince_ns = 0;			///< Time since which all axes are below the free-fall threshold
+static uint8_t			_falling = 0;					///< 1 while all axes are below the free-fall threshold
+static uint8_t			_freeFallReported = 0;			///< 1 once the current fall is reported
+static uint8_t			_referencesValid = 0;			///< 0 if the AC coupled references must be taken at the next sample
+static simTimer_t		_sampleTimer;					///< Timer expiring at the next sample conversion
+static GPIO_TypeDef*	_int1Port = NULL;				///< Port of the INT1 pin
+static uint16_t			_int1Pin = 0;					///< INT1 pin
+static adxlSource_t		_source = NULL;					///< Acceleration source
+static void*			_sourceContext = NULL;			///< Acceleration source context
+static adxlModelStats_t	_stats;							///< Model statistics
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Initialise the model at its power-up state
+ *
+ * @param int1Port Port of the pin connected to INT1
+ * @param int1Pin Pin connected to INT1
+ * @param source Acceleration source
+ * @param context Acceleration source context
+ */
+void adxlModelInitialise(GPIO_TypeDef* int1Port, uint16_t int1Pin, adxlSource_t source, void* context){
+	_int1Port = int1Port;
+	_int1Pin = int1Pin;
+	_source = source;
+	_sourceContext = context;
+
+	_registers[DEVICE_ID] = ADXL_DEVICE_ID;
+	_registers[BANDWIDTH_POWERMODE] = ADXL_RATE_100HZ;
+	_sampleTimer.callback = sampleElapsed;
+	updateINT1();
+}
+
+/**
+ * @brief Get the statistics of the model
+ *
+ * @param[out] stats Statistics
+ */
+void adxlModelGetStats(adxlModelStats_t* stats){
+	*stats = _stats;
+}
+
+/**
+ * @brief Chip select change : start or end a transaction
+ * @details At the end of a transaction which read the data registers, the latched FIFO entry is popped
+ *
+ * @param context Unused
+ * @param selected 1 if the chip select has been asserted
+ */
+static void selectChanged(void* context, uint8_t selected){
+	(void)context;
+
+	if(selected){
+		_commandReceived = 0;
+		_latchedValid = 0;
+		return;
+	}
+
+	if(_latchedValid && ((_registers[FIFO_CONTROL] & FIFO_MODE_MASK) != ADXL_MODE_BYPASS) && _fifoCount){
+		_fifoHead = (uint8_t)((_fifoHead + 1U) % FIFO_DEPTH);
+		_fifoCount--;
+		_stats.nbPopped++;
+	}
+
+	_latchedValid = 0;
+	updateINT1();
+}
+
+/**
+ * @brief Exchange a byte : the first one of a transaction is the command, the next ones are register accesses
+ *
+ * @param context Unused
+ * @param mosi Byte received
+ * @return Byte sent back
+ */
+static uint8_t exchangeByte(void* context, uint8_t mosi){
+	uint8_t miso = 0;
+
+	(void)context;
+
+	if(!_commandReceived){
+		_commandReceived = 1;
+		_command = mosi;
+		_address = mosi & ADDRESS_MASK;
+		return (0);
+	}
+
+	if(_command & ADXL_READ)
+		miso = readRegister(_address);
+	else
+		writeRegister(_address, mosi);
+
+	if(_command & ADXL_MULTIPLE)
+		_address++;
+
+	return (miso);
+}
+
+/**
+ * @brief Convert a sample, and store it according to the FIFO mode
+ *
+ * @param context Unused
+ */
+static void sampleElapsed(void* context){
+	int32_t acceleration_ug[NB_AXIS] = {0};
+	int32_t measured_ug[NB_AXIS];
+	uint64_t now_ns = simNow_ns();
+	uint8_t newEvents;
+	uint8_t mode;
+	sample_t sample;
+
+	(void)context;
+
+	simTimerArm(&_sampleTimer, _sampleTimer.due_ns + samplePeriod_ns());
+
+	if(_source)
+		(*_source)(_sourceContext, now_ns, acceleration_ug);
+	measure(acceleration_ug, measured_ug);
+	sample = convert(measured_ug);
+	newEvents = detectEvents(measured_ug, now_ns);
+	_stats.nbSamples++;
+
+	//trigger mode streams until triggered, then collects as in FIFO mode
+	mode = _registers[FIFO_CONTROL] & FIFO_MODE_MASK;
+	if(mode == ADXL_MODE_TRIGGER)
+		mode = (_triggered ? ADXL_MODE_FIFO : ADXL_MODE_STREAM);
+
+	switch(mode){
+		//FIFO : collection stops once full
+		case ADXL_MODE_FIFO:
+			if(_fifoCount >= FIFO_DEPTH){
+				_overrun = 1;
+				_stats.nbOverruns++;
+				break;
+			}
+			_fifo[(_fifoHead + _fifoCount) % FIFO_DEPTH] = sample;
+			_fifoCount++;
+			break;
+
+		//stream : the oldest entry is dropped once full
+		case ADXL_MODE_STREAM:
+			if(_fifoCount >= FIFO_DEPTH){
+				_fifoHead = (uint8_t)((_fifoHead + 1U) % FIFO_DEPTH);
+				_fifoCount--;
+				_overrun = 1;
+				_stats.nbOverruns++;
+			}
+			_fifo[(_fifoHead + _fifoCount) % FIFO_DEPTH] = sample;
+			_fifoCount++;
+			break;
+
+		//bypass : the data registers are overwritten
+		case ADXL_MODE_BYPASS:
+		default:
+			if(_dataReady){
+				_overrun = 1;
+				_stats.nbOverruns++;
+			}
+			_output = sample;
+			break;
+	}
+
+	//in trigger mode, an event enabled on the trigger pin freezes the samples preceding it
+	if(((_registers[FIFO_CONTROL] & FIFO_MODE_MASK) == ADXL_MODE_TRIGGER) && !_triggered){
+		uint8_t enabled = newEvents & _registers[INTERRUPT_ENABLE];
+		uint8_t onINT2 = (_registers[FIFO_CONTROL] & TRIGGER_INT2) != 0;
+
+		if(enabled & (onINT2 ? _registers[INTERRUPT_MAPPING] : (uint8_t)~_registers[INTERRUPT_MAPPING]))
+			trigger();
+	}
+
+	_dataReady = 1;
+	updateINT1();
+}
+
+/**
+ * @brief Compute the acceleration measured, with the offsets and the self-test deflection
+ *
+ * @param acceleration_ug Acceleration applied on each axis (in ug)
+ * @param[out] measured_ug Acceleration measured on each axis (in ug)
+ */
+static void measure(const int32_t acceleration_ug[NB_AXIS], int32_t measured_ug[NB_AXIS]){
+	static const int32_t deflection_ug[NB_AXIS] = {ST_DEFLECTION_X_UG, ST_DEFLECTION_Y_UG, ST_DEFLECTION_Z_UG};
+
+	for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++){
+		measured_ug[axis] = acceleration_ug[axis] + ((int8_t)_registers[OFFSET_X + axis] * OFFSET_UG_PER_LSB);
+		if(_registers[DATA_FORMAT] & ADXL_SELF_TEST)
+			measured_ug[axis] += deflection_ug[axis];
+	}
+}
+
+/**
+ * @brief Convert an acceleration with the current data format
+ *
+ * @param measured_ug Acceleration measured on each axis (in ug)
+ * @return Sample as read in the data registers
+ */
+static sample_t convert(const int32_t measured_ug[NB_AXIS]){
+	uint8_t format = _registers[DATA_FORMAT];
+	uint8_t range = format & RANGE_MASK;
+	uint8_t bits = (format & ADXL_FULL_RESOL) ? (uint8_t)(RESOLUTION_BITS + range) : (uint8_t)RESOLUTION_BITS;
+	int32_t scale_ug = (format & ADXL_FULL_RESOL) ? (int32_t)ADXL_SCALE_UG_PER_LSB : (int32_t)(ADXL_SCALE_UG_PER_LSB << range);
+	int32_t maximum = (1 << (bits - 1U)) - 1;
+	sample_t sample;
+
+	for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++){
+		int32_t value_ug = measured_ug[axis];
+		int32_t value;
+
+		//round to the nearest LSB and saturate
+		value = (value_ug + ((value_ug < 0) ? -(scale_ug / 2) : (scale_ug / 2))) / scale_ug;
+		if(value > maximum)
+			value = maximum;
+		if(value < -maximum - 1)
+			value = -maximum - 1;
+
+		if(format & ADXL_LEFT_JUSTIFY)
+			value *= (1 << (REGISTER_BITS - bits));
+
+		sample.axes[axis] = (int16_t)value;
+	}
+
+	return (sample);
+}
+
+/**
+ * @brief Run the event detections on a sample
+ *
+ * @param measured_ug Acceleration measured on each axis (in ug)
+ * @param time_ns Time of the sample (in ns)
+ * @return Events which occurred with this sample
+ */
+static uint8_t detectEvents(const int32_t measured_ug[NB_AXIS], uint64_t time_ns){
+	static const int32_t zero[NB_AXIS] = {0};
+	uint8_t control = _registers[ACTIVITY_CONTROL];
+	uint8_t events;
+	uint8_t axes;
+
+	//the AC coupled detections compare to the acceleration when they get enabled
+	if(!_referencesValid){
+		for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++){
+			_activityReference[axis] = measured_ug[axis];
+			_inactivityReference[axis] = measured_ug[axis];
+		}
+		_referencesValid = 1;
+	}
+
+	events = detectTaps(measured_ug, time_ns);
+
+	//activity : any axis enabled above the threshold
+	axes = axesAbove(measured_ug, ((control & ACTIVITY_AC) ? _activityReference : zero), (control >> ACTIVITY_SHIFT) & AXES_MASK, _registers[ACTIVITY_THRESHOLD]);
+	if(axes){
+		events |= ADXL_INT_ACTIVITY;
+		_registers[TAP_ACTIVITY_SOURCE] = (uint8_t)((_registers[TAP_ACTIVITY_SOURCE] & ~(AXES_MASK << STATUS_ACT_SHIFT) & ~STATUS_ASLEEP) | (axes << STATUS_ACT_SHIFT));
+		_stats.nbActivities++;
+	}
+
+	//inactivity : all axes enabled below the threshold for the inactivity time (reported once, the AC reference then follows)
+	if((control & AXES_MASK) && _registers[INACTIVITY_THRESHOLD]){
+		if(axesAbove(measured_ug, ((control & INACTIVITY_AC) ? _inactivityReference : zero), control & AXES_MASK, _registers[INACTIVITY_THRESHOLD])){
+			_still = 0;
+			_inactivityReported = 0;
+		}
+		else if(!_still){
+			_still = 1;
+			_stillSince_ns = time_ns;
+		}
+		if(_still && !_inactivityReported && ((time_ns - _stillSince_ns) >= (_registers[INACTIVITY_TIME] * INACTIVITY_NS_PER_LSB))){
+			_inactivityReported = 1;
+			events |= ADXL_INT_INACTIVITY;
+			_registers[TAP_ACTIVITY_SOURCE] |= STATUS_ASLEEP;
+			for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++)
+				_activityReference[axis] = measured_ug[axis];
+			_stats.nbInactivities++;
+		}
+	}
+
+	//free-fall : all axes below the threshold for the free-fall time (reported once per fall)
+	if(_registers[FREEFALL_THRESHOLD]){
+		if(axesAbove(measured_ug, zero, AXES_MASK, _registers[FREEFALL_THRESHOLD])){
+			_falling = 0;
+			_freeFallReported = 0;
+		}
+		else if(!_falling){
+			_falling = 1;
+			_fallingSince_ns = time_ns;
+		}
+		if(_falling && !_freeFallReported && ((time_ns - _fallingSince_ns) >= ((uint64_t)_registers[FREEFALL_TIME] * FREEFALL_NS_PER_LSB))){
+			_freeFallReported = 1;
+			events |= ADXL_INT_FREEFALL;
+			_stats.nbFreeFalls++;
+		}
+	}
+
+	_events |= events;
+	return (events);
+}
+
+/**
+ * @brief Run the tap detection on a sample
+ * @details A tap is an acceleration above the threshold for at most the tap duration.
+ * 			A second tap starting after the latency and within the window is a double tap,
+ * 			unless the suppression is set and the acceleration is above the threshold during the latency.
+ *
+ * @param measured_ug Acceleration measured on each axis (in ug)
+ * @param time_ns Time of the sample (in ns)
+ * @return Tap events which occurred with this sample
+ */
+static uint8_t detectTaps(const int32_t measured_ug[NB_AXIS], uint64_t time_ns){
+	static const int32_t zero[NB_AXIS] = {0};
+	uint8_t axes = axesAbove(measured_ug, zero, _registers[TAP_AXES] & AXES_MASK, _registers[TAP_THRESHOLD]);
+	uint8_t doubleEnabled = _registers[TAP_LATENCY] && _registers[TAP_WINDOW];
+	uint8_t events = 0;
+	uint8_t isTap;
+
+	//latency and window expiries
+	if((_tapPhase == PHASE_LATENCY) && (time_ns >= _tapLatencyEnd_ns))
+		_tapPhase = PHASE_WINDOW;
+	if((_tapPhase == PHASE_WINDOW) && (time_ns > _tapWindowEnd_ns))
+		_tapPhase = PHASE_IDLE;
+
+	//acceleration getting above the threshold
+	if(axes && !_tapAbove){
+		_tapAbove = 1;
+		_tapStart_ns = time_ns;
+		_tapAxes = axes;
+
+		if(_tapPhase == PHASE_WINDOW)
+			_tapPhase = PHASE_SECOND;
+		else if((_tapPhase == PHASE_LATENCY) && (_registers[TAP_AXES] & ADXL_TAP_SUPPRESS))
+			_tapPhase = PHASE_IDLE;
+		return (0);
+	}
+	if(axes || !_tapAbove){
+		_tapAxes |= axes;
+		return (0);
+	}
+
+	//acceleration getting back below the threshold : tap if short enough
+	_tapAbove = 0;
+	isTap = (time_ns - _tapStart_ns) <= ((uint64_t)_registers[TAP_DURATION] * TAP_DURATION_NS_PER_LSB);
+
+	if(_tapPhase == PHASE_SECOND){
+		_tapPhase = PHASE_IDLE;
+		if(isTap){
+			events = ADXL_INT_DOUBLETAP;
+			_stats.nbDoubleTaps++;
+		}
+	}
+	else if(isTap && (_tapPhase == PHASE_IDLE)){
+		events = ADXL_INT_SINGLETAP;
+		_stats.nbSingleTaps++;
+		if(doubleEnabled){
+			_tapPhase = PHASE_LATENCY;
+			_tapLatencyEnd_ns = time_ns + (_registers[TAP_LATENCY] * TAP_LATENCY_NS_PER_LSB);
+			_tapWindowEnd_ns = _tapLatencyEnd_ns + (_registers[TAP_WINDOW] * TAP_LATENCY_NS_PER_LSB);
+		}
+	}
+
+	//report the axes involved in the tap
+	if(events)
+		_registers[TAP_ACTIVITY_SOURCE] = (uint8_t)((_registers[TAP_ACTIVITY_SOURCE] & ~AXES_MASK) | _tapAxes);
+	return (events);
+}
+
+/**
+ * @brief Get the axes on which the acceleration differs from a reference by more than a threshold
+ *
+ * @param measured_ug Acceleration measured on each axis (in ug)
+ * @param reference_ug Reference acceleration on each axis (in ug)
+ * @param axes Axes checked (X, Y, Z from the MSB, as in ACTIVITY_CONTROL and TAP_AXES)
+ * @param threshold Threshold (62.5 mg per LSB, 0 disables the detection)
+ * @return Axes above the threshold (same bits as the axes checked)
+ */
+static uint8_t axesAbove(const int32_t measured_ug[NB_AXIS], const int32_t reference_ug[NB_AXIS], uint8_t axes, uint8_t threshold){
+	int32_t threshold_ug = threshold * THRESHOLD_UG_PER_LSB;
+	uint8_t above = 0;
+
+	if(!threshold)
+		return (0);
+
+	for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++){
+		uint8_t bit = (uint8_t)(0x04U >> axis);											// @suppress("Avoid magic numbers")
+		int32_t difference = measured_ug[axis] - reference_ug[axis];
+
+		if((axes & bit) && ((difference > threshold_ug) || (difference < -threshold_ug)))
+			above |= bit;
+	}
+
+	return (above);
+}
+
+/**
+ * @brief Trigger event in trigger mode : keep the samples set in FIFO_CTL, then collect as in FIFO mode
+ */
+static void trigger(){
+	uint8_t kept = _registers[FIFO_CONTROL] & FIFO_SAMPLES_MASK;
+
+	while(_fifoCount > kept){
+		_fifoHead = (uint8_t)((_fifoHead + 1U) % FIFO_DEPTH);
+		_fifoCount--;
+	}
+
+	_triggered = 1;
+	_stats.nbTriggers++;
+}
+
+/**
+ * @brief Read a register, with its side effects
+ *
+ * @param address Register address
+ * @return Register value
+ */
+static uint8_t readRegister(uint8_t address){
+	const sample_t* sample;
+	uint8_t index;
+	uint16_t value;
+
+	if(address >= ADXL_NB_REGISTERS)
+		return (0);
+
+	switch(address){
+		//reading the sources clears the events latched
+		case INTERRUPT_SOURCE:
+			value = interruptSources();
+			_events = 0;
+			return ((uint8_t)value);
+
+		case FIFO_STATUS:
+			return (_triggered ? (uint8_t)(_fifoCount | FIFO_TRIGGERED) : _fifoCount);
+
+		case DATA_X0:
+		case DATA_X1:
+		case DATA_Y0:
+		case DATA_Y1:
+		case DATA_Z0:
+		case DATA_Z1:
+			//latch the oldest sample at the first data byte of the transaction
+			if(!_latchedValid){
+				sample = (((_registers[FIFO_CONTROL] & FIFO_MODE_MASK) != ADXL_MODE_BYPASS) && _fifoCount) ? &_fifo[_fifoHead] : &_output;
+				_latched = *sample;
+				_output = *sample;
+				_latchedValid = 1;
+				_dataReady = 0;
+				_overrun = 0;
+			}
+			index = (uint8_t)(address - DATA_X0);
+			value = (uint16_t)_latched.axes[index >> 1];
+			return ((index & 1U) ? (uint8_t)(value >> BYTE_SHIFT) : (uint8_t)value);
+
+		default:
+			return (_registers[address]);
+	}
+}
+
+/**
+ * @brief Write a register, with its side effects
+ *
+ * @param address Register address
+ * @param value Value to write
+ */
+static void writeRegister(uint8_t address, uint8_t value){
+	uint8_t previous;
+
+	//read-only and reserved registers
+	if((address >= ADXL_NB_REGISTERS) || (address < TAP_THRESHOLD) || (address == INTERRUPT_SOURCE) || (address == TAP_ACTIVITY_SOURCE)
+		|| (address == FIFO_STATUS) || ((address >= DATA_X0) && (address <= DATA_Z1)))
+		return;
+
+	previous = _registers[address];
+	_registers[address] = value;
+
+	switch(address){
+		case POWER_CONTROL:
+			if((value & ADXL_MEASURE_MODE) && (!(previous & ADXL_MEASURE_MODE) || ((value ^ previous) & (SLEEP_BIT | WAKEUP_MASK))))
+				startSampling();
+			else if(!(value & ADXL_MEASURE_MODE))
+				simTimerCancel(&_sampleTimer);
+			break;
+
+		case BANDWIDTH_POWERMODE:
+			if(_registers[POWER_CONTROL] & ADXL_MEASURE_MODE)
+				startSampling();
+			break;
+
+		//bypass mode clears the FIFO and resets the trigger
+		case FIFO_CONTROL:
+			if((value & FIFO_MODE_MASK) == ADXL_MODE_BYPASS){
+				_fifoHead = 0;
+				_fifoCount = 0;
+				_triggered = 0;
+			}
+			break;
+
+		//the AC coupled detections take their reference at the next sample
+		case ACTIVITY_CONTROL:
+			_referencesValid = 0;
+			break;
+
+		default:
+			break;
+	}
+
+	updateINT1();
+}
+
+/**
+ * @brief Compute the interrupt sources
+ *
+ * @return INTERRUPT_SOURCE value
+ */
+static uint8_t interruptSources(){
+	uint8_t sources = _events;
+	uint8_t mode = _registers[FIFO_CONTROL] & FIFO_MODE_MASK;
+
+	if(_dataReady)
+		sources |= ADXL_INT_DATARDY;
+	if(_overrun)
+		sources |= ADXL_INT_OVERRUN;
+	if((mode != ADXL_MODE_BYPASS) && (_fifoCount >= (_registers[FIFO_CONTROL] & FIFO_SAMPLES_MASK)))
+		sources |= ADXL_INT_WATERMARK;
+
+	return (sources);
+}
+
+/**
+ * @brief Drive the INT1 pin according to the interrupt sources enabled and mapped on it
+ */
+static void updateINT1(){
+	uint8_t asserted = (interruptSources() & _registers[INTERRUPT_ENABLE] & (uint8_t)~_registers[INTERRUPT_MAPPING]) != 0;
+	uint8_t activeLow = (_registers[DATA_FORMAT] & ADXL_INT_ACTIV_LOW) != 0;
+
+	if(_int1Port)
+		simPinDrive(_int1Port, _int1Pin, (asserted != activeLow) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+/**
+ * @brief (Re)start the conversions, the first sample coming one period later
+ */
+static void startSampling(){
+	simTimerArm(&_sampleTimer, simNow_ns() + samplePeriod_ns());
+}
+
+/**
+ * @brief Compute the sample period from the rate code
+ * @details The output data rate halves with each rate code below the highest one.
+ * 			In sleep mode, the samples come at the wake-up rate (8 Hz halved with each code).
+ *
+ * @return Sample period (in ns)
+ */
+static uint64_t samplePeriod_ns(){
+	uint8_t code = _registers[BANDWIDTH_POWERMODE] & RATE_MASK;
+
+	if(_registers[POWER_CONTROL] & SLEEP_BIT)
+		return ((SIM_NS_PER_S << (_registers[POWER_CONTROL] & WAKEUP_MASK)) / WAKEUP_MAX_HZ);
+
+	return ((SIM_NS_PER_S << (RATE_MAX_CODE - code)) / ODR_MAX_HZ);
+}
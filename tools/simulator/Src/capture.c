@@ -0,0 +1,150 @@
+/**
+ * @file capture.c
+ * @brief Implement the loading and the replay of samples streams captured on the device
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * A capture is a text file with one sample per line, as three integers in full resolution LSB (3.9 mg/LSB) :
+ * @code
+ * # odr_hz=200
+ * 12 -4 251
+ * 13 -3 250
+ * @endcode
+ * Lines starting with '#' are comments, except the optional odr_hz one (200 Hz if absent).
+ * tools/simulator/capture.gdb logs the FIFO blocks in this format from the target.
+ *
+ * The replay holds each sample for its capture period, so a capture can be replayed at any simulated output data rate.
+ */
+#include "capture.h"
+#include "simulator.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//definitions
+#define LINE_SIZE		128U	///< Maximum length of a capture line
+#define DEFAULT_ODR_HZ	200U	///< Output data rate assumed if the capture does not give it (in Hz)
+#define INITIAL_SIZE	1024U	///< Number of samples allocated at first
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Load a capture file
+ *
+ * @param[out] capture Capture loaded
+ * @param path Path of the capture file
+ * @retval 0 Success
+ * @retval -1 Error while opening, reading or parsing the file
+ */
+int captureLoad(capture_t* capture, const char* path){
+	char line[LINE_SIZE];
+	uint32_t capacity = INITIAL_SIZE;
+	uint32_t lineNumber = 0;
+	unsigned int odr;
+	int x, y, z;
+	FILE* file;
+
+	*capture = (capture_t){NULL, 0, DEFAULT_ODR_HZ};
+
+	file = fopen(path, "r");
+	if(!file){
+		perror(path);
+		return (-1);
+	}
+
+	capture->samples = malloc(capacity * sizeof(*capture->samples));
+	if(!capture->samples){
+		fclose(file);
+		return (-1);
+	}
+
+	while(fgets(line, sizeof(line), file)){
+		lineNumber++;
+
+		//header and comments
+		if(line[0] == '#'){
+			if(sscanf(line, "# odr_hz=%u", &odr) == 1)
+				capture->odr_Hz = odr;
+			continue;
+		}
+		if(strspn(line, " \t\r\n") == strlen(line))
+			continue;
+
+		if(sscanf(line, "%d %d %d", &x, &y, &z) != NB_AXIS){
+			fprintf(stderr, "%s:%u : expected three integers\n", path, lineNumber);
+			fclose(file);
+			captureFree(capture);
+			return (-1);
+		}
+
+		//grow the samples array when full
+		if(capture->nbSamples >= capacity){
+			int16_t (*grown)[NB_AXIS] = realloc(capture->samples, 2U * capacity * sizeof(*capture->samples));
+
+			if(!grown){
+				fclose(file);
+				captureFree(capture);
+				return (-1);
+			}
+			capture->samples = grown;
+			capacity *= 2U;
+		}
+
+		capture->samples[capture->nbSamples][X_AXIS] = (int16_t)x;
+		capture->samples[capture->nbSamples][Y_AXIS] = (int16_t)y;
+		capture->samples[capture->nbSamples][Z_AXIS] = (int16_t)z;
+		capture->nbSamples++;
+	}
+
+	fclose(file);
+	if(!capture->nbSamples || !capture->odr_Hz){
+		fprintf(stderr, "%s : no samples, or invalid output data rate\n", path);
+		captureFree(capture);
+		return (-1);
+	}
+
+	return (0);
+}
+
+/**
+ * @brief Free the samples of a capture
+ *
+ * @param capture Capture to free
+ */
+void captureFree(capture_t* capture){
+	free(capture->samples);
+	capture->samples = NULL;
+	capture->nbSamples = 0;
+}
+
+/**
+ * @brief Get the duration of a capture
+ *
+ * @param capture Capture
+ * @return Duration (in ns)
+ */
+uint64_t captureGetDuration_ns(const capture_t* capture){
+	return (((uint64_t)capture->nbSamples * SIM_NS_PER_S) / capture->odr_Hz);
+}
+
+/**
+ * @brief Acceleration source replaying a capture (the last sample is held past its end)
+ *
+ * @param context Capture to replay
+ * @param time_ns Simulated time of the sample (in ns)
+ * @param[out] acceleration_ug Acceleration on each axis (in ug)
+ */
+void captureReplay(void* context, uint64_t time_ns, int32_t acceleration_ug[NB_AXIS]){
+	const capture_t* capture = (const capture_t*)context;
+	uint64_t index = (time_ns * capture->odr_Hz) / SIM_NS_PER_S;
+
+	if(index >= capture->nbSamples)
+		index = capture->nbSamples - 1U;
+
+	for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++)
+		acceleration_ug[axis] = capture->samples[index][axis] * (int32_t)ADXL_SCALE_UG_PER_LSB;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file flashStandin.c
+ * @brief Implement the STM32F1 HAL flash functions used by the settings, on top of a RAM page
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The settings flash page (exported as _ssettings by the linker script on the target) is a RAM array.
+ * Only the operations the settings module performs are accepted :
+ * - erasing the settings page, and only it
+ * - programming half-words inside of it
+ *
+ * It is shared by the simulator and the host tests saving settings.
+ */
+#include "flashStandin.h"
+#include "stm32f1xx_hal.h"
+#include <string.h>
+
+//definitions
+#define FLASH_PAGE_SIZE		1024U		///< Size of a flash page (in bytes)
+
+//global variables
+uint8_t _ssettings[FLASH_PAGE_SIZE] __attribute__((aligned(8)));	///< Settings flash page stand-in
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Blank the settings page stand-in, as a freshly erased flash page
+ */
+void flashStandinErase(){
+	memset(_ssettings, 0xFF, sizeof(_ssettings));	// @suppress("Avoid magic numbers")
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void){
+	return (HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void){
+	return (HAL_OK);
+}
+
+/**
+ * @brief Program a half-word in the settings page stand-in
+ * @note The firmware truncates the page address to 32 bits, hence the offset computed on truncated addresses
+ */
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data){
+	uint32_t offset = Address - (uint32_t)(uintptr_t)_ssettings;
+	uint16_t halfWord = (uint16_t)Data;
+
+	if((TypeProgram != FLASH_TYPEPROGRAM_HALFWORD) || (offset > (sizeof(_ssettings) - sizeof(halfWord))))
+		return (HAL_ERROR);
+
+	memcpy(&_ssettings[offset], &halfWord, sizeof(halfWord));
+	return (HAL_OK);
+}
+
+/**
+ * @brief Erase the settings page stand-in
+ */
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef* pEraseInit, uint32_t* PageError){
+	if((pEraseInit->PageAddress != (uint32_t)(uintptr_t)_ssettings) || (pEraseInit->NbPages != 1U)){
+		*PageError = pEraseInit->PageAddress;
+		return (HAL_ERROR);
+	}
+
+	flashStandinErase();
+	*PageError = 0xFFFFFFFFU;	// @suppress("Avoid magic numbers")
+	return (HAL_OK);
+}
@@ -0,0 +1,332 @@
+/**
+ * @file gyroModel.c
+ * @brief Implement a behavioural model of the L3GD20, attached to the simulated SPI bus
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The model keeps a register file, and converts a sample at each output data rate period
+ * once in normal mode. Samples are converted with the full scale at conversion time,
+ * then either stored in the data registers (bypass mode, or FIFO disabled) or pushed in the 32 entries FIFO.
+ *
+ * Reading the data registers latches the oldest sample at the first data byte, and pops it
+ * from the FIFO when the chip select is released.
+ *
+ * FIFO_SRC_REG reports the number of entries stored, the FIFO being empty, and the FIFO being full (OVRN).
+ * Only the bypass and stream modes are modelled, the other ones behaving as the stream mode.
+ *
+ * @note Datasheet : https://www.st.com/resource/en/datasheet/l3gd20.pdf
+ */
+#include "gyroModel.h"
+#include "L3GD20registers.h"
+#include <math.h>
+
+//definitions
+#define FIFO_DEPTH			32U			///< Number of samples the FIFO can hold
+#define ADDRESS_MASK		0x3FU		///< Register address bits of the command byte
+#define FIFO_MODE_MASK		0xE0U		///< FIFO mode bits of FIFO_CTRL_REG
+#define ODR_MASK			0xC0U		///< Output data rate bits of CTRL_REG1
+#define ODR_SHIFT			6U			///< Position of the output data rate bits in CTRL_REG1
+#define ODR_MIN_HZ			95U			///< Lowest output data rate (in Hz)
+#define RANGE_MASK			0x30U		///< Full scale bits of CTRL_REG4
+#define SCALE_250_MDPS		8.75		///< Scale at 250 dps full scale (in mdps per LSB)
+#define SCALE_500_MDPS		17.50		///< Scale at 500 dps full scale (in mdps per LSB)
+#define SCALE_2000_MDPS		70.0		///< Scale at 2000 dps full scale (in mdps per LSB)
+#define BYTE_SHIFT			8U			///< Number of bits in a byte
+
+/**
+ * @brief Structure holding a converted sample, as read in the data registers
+ */
+typedef struct{
+	int16_t	axes[L3GD_NB_AXIS];	///< Value of each axis
+}sample_t;
+
+//SPI device callbacks
+static void selectChanged(void* context, uint8_t selected);
+static uint8_t exchangeByte(void* context, uint8_t mosi);
+
+//tool functions
+static void sampleElapsed(void* context);
+static sample_t convert(const int32_t rate_mdps[L3GD_NB_AXIS]);
+static uint8_t readRegister(uint8_t address);
+static void writeRegister(uint8_t address, uint8_t value);
+static uint8_t isFIFOenabled();
+static uint64_t samplePeriod_ns();
+
+//global variables
+const simSPIdevice_t gyroModelDevice = {selectChanged, exchangeByte, NULL};	///< SPI device callbacks of the model
+
+//state variables
+static uint8_t			_registers[L3GD_NB_REGISTERS];	///< Register file
+static sample_t			_fifo[FIFO_DEPTH];				///< FIFO entries
+static uint8_t			_fifoHead = 0;					///< Index of the oldest FIFO entry
+static uint8_t			_fifoCount = 0;					///< Number of FIFO entries
+static sample_t			_output;						///< Data registers content when the FIFO is not used
+static sample_t			_latched;						///< Sample latched by the current data registers read
+static uint8_t			_latchedValid = 0;				///< 1 if a sample has been latched during the current transaction
+static uint8_t			_address = 0;					///< Register address of the current transaction
+static uint8_t			_command = 0;					///< Command byte of the current transaction
+static uint8_t			_commandReceived = 0;			///< 1 once the command byte of the current transaction is received
+static simTimer_t		_sampleTimer;					///< Timer expiring at the next sample conversion
+static gyroSource_t		_source = NULL;					///< Angular rate source
+static void*			_sourceContext = NULL;			///< Angular rate source context
+static gyroModelStats_t	_stats;							///< Model statistics
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Initialise the model at its power-up state (power-down mode)
+ *
+ * @param source Angular rate source
+ * @param context Angular rate source context
+ */
+void gyroModelInitialise(gyroSource_t source, void* context){
+	_source = source;
+	_sourceContext = context;
+
+	_registers[WHO_AM_I] = L3GD_DEVICE_ID;
+	_registers[CTRL_REG1] = L3GD_AXES_ENABLED;
+	_sampleTimer.callback = sampleElapsed;
+}
+
+/**
+ * @brief Get the statistics of the model
+ *
+ * @param[out] stats Statistics
+ */
+void gyroModelGetStats(gyroModelStats_t* stats){
+	*stats = _stats;
+}
+
+/**
+ * @brief Chip select change : start or end a transaction
+ * @details At the end of a transaction which read the data registers, the latched FIFO entry is popped
+ *
+ * @param context Unused
+ * @param selected 1 if the chip select has been asserted
+ */
+static void selectChanged(void* context, uint8_t selected){
+	(void)context;
+
+	if(selected){
+		_commandReceived = 0;
+		_latchedValid = 0;
+		return;
+	}
+
+	if(_latchedValid && isFIFOenabled() && _fifoCount){
+		_fifoHead = (uint8_t)((_fifoHead + 1U) % FIFO_DEPTH);
+		_fifoCount--;
+		_stats.nbPopped++;
+	}
+
+	_latchedValid = 0;
+}
+
+/**
+ * @brief Exchange a byte : the first one of a transaction is the command, the next ones are register accesses
+ *
+ * @param context Unused
+ * @param mosi Byte received
+ * @return Byte sent back
+ */
+static uint8_t exchangeByte(void* context, uint8_t mosi){
+	uint8_t miso = 0;
+
+	(void)context;
+
+	if(!_commandReceived){
+		_commandReceived = 1;
+		_command = mosi;
+		_address = mosi & ADDRESS_MASK;
+		return (0);
+	}
+
+	if(_command & L3GD_READ)
+		miso = readRegister(_address);
+	else
+		writeRegister(_address, mosi);
+
+	if(_command & L3GD_MULTIPLE)
+		_address++;
+
+	return (miso);
+}
+
+/**
+ * @brief Convert a sample, and store it according to the FIFO mode
+ *
+ * @param context Unused
+ */
+static void sampleElapsed(void* context){
+	int32_t rate_mdps[L3GD_NB_AXIS] = {0};
+	sample_t sample;
+
+	(void)context;
+
+	simTimerArm(&_sampleTimer, _sampleTimer.due_ns + samplePeriod_ns());
+
+	if(_source)
+		(*_source)(_sourceContext, simNow_ns(), rate_mdps);
+	sample = convert(rate_mdps);
+	_stats.nbSamples++;
+
+	if(!isFIFOenabled()){
+		_output = sample;
+		return;
+	}
+
+	//stream : the oldest entry is overwritten once full
+	if(_fifoCount >= FIFO_DEPTH){
+		_fifoHead = (uint8_t)((_fifoHead + 1U) % FIFO_DEPTH);
+		_fifoCount--;
+		_stats.nbOverruns++;
+	}
+	_fifo[(_fifoHead + _fifoCount) % FIFO_DEPTH] = sample;
+	_fifoCount++;
+}
+
+/**
+ * @brief Convert an angular rate with the current full scale
+ *
+ * @param rate_mdps Angular rate around each axis (in mdps)
+ * @return Sample as read in the data registers
+ */
+static sample_t convert(const int32_t rate_mdps[L3GD_NB_AXIS]){
+	double scale_mdps;
+	sample_t sample;
+
+	switch(_registers[CTRL_REG4] & RANGE_MASK){
+		case L3GD_RANGE_250DPS:
+			scale_mdps = SCALE_250_MDPS;
+			break;
+
+		case L3GD_RANGE_500DPS:
+			scale_mdps = SCALE_500_MDPS;
+			break;
+
+		default:
+			scale_mdps = SCALE_2000_MDPS;
+			break;
+	}
+
+	//round to the nearest LSB and saturate
+	for(uint8_t axis = 0 ; axis < L3GD_NB_AXIS ; axis++){
+		double value = round((double)rate_mdps[axis] / scale_mdps);
+
+		if(value > INT16_MAX)
+			value = INT16_MAX;
+		if(value < INT16_MIN)
+			value = INT16_MIN;
+		sample.axes[axis] = (int16_t)value;
+	}
+
+	return (sample);
+}
+
+/**
+ * @brief Read a register, with its side effects
+ *
+ * @param address Register address
+ * @return Register value
+ */
+static uint8_t readRegister(uint8_t address){
+	uint8_t index;
+	uint16_t value;
+
+	if(address >= L3GD_NB_REGISTERS)
+		return (0);
+
+	switch(address){
+		case FIFO_SRC_REG:
+			if(!isFIFOenabled())
+				return (L3GD_FIFO_EMPTY);
+			if(!_fifoCount)
+				return (L3GD_FIFO_EMPTY);
+			if(_fifoCount >= FIFO_DEPTH)
+				return (L3GD_FIFO_OVERRUN | L3GD_FIFO_LEVEL);
+			return (_fifoCount);
+
+		case OUT_X_L:
+		case OUT_X_H:
+		case OUT_Y_L:
+		case OUT_Y_H:
+		case OUT_Z_L:
+		case OUT_Z_H:
+			//latch the oldest sample at the first data byte of the transaction
+			if(!_latchedValid){
+				_latched = (isFIFOenabled() && _fifoCount) ? _fifo[_fifoHead] : _output;
+				_latchedValid = 1;
+			}
+			index = (uint8_t)(address - OUT_X_L);
+			value = (uint16_t)_latched.axes[index >> 1];
+			return ((index & 1U) ? (uint8_t)(value >> BYTE_SHIFT) : (uint8_t)value);
+
+		default:
+			return (_registers[address]);
+	}
+}
+
+/**
+ * @brief Write a register, with its side effects
+ *
+ * @param address Register address
+ * @param value Value to write
+ */
+static void writeRegister(uint8_t address, uint8_t value){
+	uint8_t previous;
+
+	//read-only and reserved registers
+	if((address >= L3GD_NB_REGISTERS) || (address < CTRL_REG1) || (address == OUT_TEMP) || (address == STATUS_REG)
+		|| ((address >= OUT_X_L) && (address <= OUT_Z_H)) || (address == FIFO_SRC_REG))
+		return;
+
+	previous = _registers[address];
+	_registers[address] = value;
+
+	switch(address){
+		//normal mode starts the conversions, the first sample coming one period later
+		case CTRL_REG1:
+			if((value & L3GD_POWER_NORMAL) && (!(previous & L3GD_POWER_NORMAL) || ((value ^ previous) & ODR_MASK)))
+				simTimerArm(&_sampleTimer, simNow_ns() + samplePeriod_ns());
+			else if(!(value & L3GD_POWER_NORMAL))
+				simTimerCancel(&_sampleTimer);
+			break;
+
+		//disabling the FIFO or setting it in bypass mode clears it
+		case CTRL_REG5:
+		case FIFO_CTRL_REG:
+			if(!isFIFOenabled()){
+				_fifoHead = 0;
+				_fifoCount = 0;
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+/**
+ * @brief Check if the samples are pushed in the FIFO
+ *
+ * @retval 0 FIFO disabled or in bypass mode
+ * @retval 1 FIFO enabled, in a storing mode
+ */
+static uint8_t isFIFOenabled(){
+	return ((_registers[CTRL_REG5] & L3GD_FIFO_ENABLE) && ((_registers[FIFO_CTRL_REG] & FIFO_MODE_MASK) != L3GD_MODE_BYPASS));
+}
+
+/**
+ * @brief Compute the sample period from the output data rate bits (95 Hz doubled with each code)
+ *
+ * @return Sample period (in ns)
+ */
+static uint64_t samplePeriod_ns(){
+	uint8_t code = (uint8_t)((_registers[CTRL_REG1] & ODR_MASK) >> ODR_SHIFT);
+
+	return (SIM_NS_PER_S / ((uint64_t)ODR_MIN_HZ << code));
+}
@@ -0,0 +1,433 @@
+/**
+ * @file halStandin.c
+ * @brief Implement the STM32F1 HAL functions used by the firmware, on top of the simulator core
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * - SPI transfers clock the bytes through the devices attached to the bus,
+ * 	 and take the simulated time given by the bus prescaler and clock
+ * - SPI DMA transfers raise the DMA interrupt after half of the bytes, then at the end.
+ * 	 Each half is handed to the device when the DMA starts reading it, and a transfer in circular mode
+ * 	 (checked at its end, as the firmware may drop it on the fly) starts over with the first half
+ * - the ADC fills its circular DMA buffer with the raw values of the simulated analog levels,
+ * 	 at the pace of the scan sequence conversion time
+ * - the settings flash page is a RAM array (see flashStandin.c)
+ */
+#include "halStandin.h"
+#include "simulator.h"
+#include "flashStandin.h"
+#include <string.h>
+
+//definitions
+#define BITS_PER_BYTE			8U			///< Number of bits clocked per byte
+#define PRESCALER_SHIFT			3U			///< Position of the baud rate prescaler in SPI_CR1
+#define SPI_CALL_OVERHEAD_NS	1000U		///< Time spent by a blocking HAL SPI call besides clocking the bytes (in ns)
+#define ADC_CLOCK_HZ			12000000U	///< ADC clock frequency (PCLK2 / 6)
+#define ADC_CONVERSION_CYCLES	252U		///< ADC cycles per conversion (239.5 sampling + 12.5 conversion)
+#define ADC_FULL_SCALE			4095U		///< Raw value of a full-scale conversion
+#define VREFINT_MV				1200U		///< Internal reference voltage (in mV)
+#define V25_UV					1430000		///< Temperature sensor voltage at 25 degrees (in uV)
+#define SLOPE_UV_PER_DC			430			///< Temperature sensor average slope (in uV per tenth of degree)
+#define TEMPERATURE_25_DC		250			///< 25 degrees, in tenths of degrees
+#define BATTERY_DIVIDER			2U			///< Ratio of the battery voltage divider
+#define UV_PER_MV				1000		///< Number of uV in a mV
+#define NB_ADC_CHANNELS			3U			///< Number of channels in the scan sequence (VREFINT, temperature, battery)
+
+/**
+ * @brief Enumeration of the DMA events signalled by a channel interrupt
+ */
+typedef enum{
+	DMA_TRANSFER_COMPLETE = 0,	///< Whole transfer done
+	DMA_HALF_TRANSFER,			///< First half of a circular transfer done
+}dmaEvent_e;
+
+/**
+ * @brief Structure holding the state of a simulated DMA channel
+ */
+typedef struct{
+	simTimer_t			timer;		///< Timer expiring at the end of the current transfer
+	DMA_HandleTypeDef*	handle;		///< DMA handle using the channel
+	simIRQ_e			irq;		///< Interrupt raised by the channel
+	dmaEvent_e			event;		///< Event signalled by the next interrupt
+}dmaChannel_t;
+
+/**
+ * @brief Structure holding the state of the simulated screen SPI DMA transfer
+ */
+typedef struct{
+	SPI_HandleTypeDef*	hspi;		///< SPI handle transmitting
+	const uint8_t*		buffer;		///< Buffer transmitted
+	uint16_t			length;		///< Number of bytes in the buffer
+	uint16_t			half;		///< Number of bytes in the first half of the buffer
+}spiTransfer_t;
+
+/**
+ * @brief Structure holding the state of the simulated ADC
+ */
+typedef struct{
+	uint16_t*	buffer;			///< Circular DMA buffer
+	uint32_t	length;			///< Number of conversions in the buffer
+	uint64_t	halfPeriod_ns;	///< Time taken to fill half of the buffer (in ns)
+	uint16_t	raw[NB_ADC_CHANNELS];	///< Raw value of each channel of the sequence
+}adcState_t;
+
+//tool functions
+static uint64_t spiTransferTime_ns(const SPI_HandleTypeDef* hspi, uint32_t nbBytes);
+static void dmaTransferElapsed(void* context);
+static void fillADCHalf(uint8_t half);
+static void sendSPIbytes(uint16_t first, uint16_t last);
+
+//global variables
+volatile uint32_t uwTick = 0;								///< Milliseconds elapsed since the start
+
+//state variables
+static dmaChannel_t	_dmaADC = {.irq = SIM_IRQ_DMA1_CH1};		///< ADC DMA channel
+static dmaChannel_t	_dmaScreen = {.irq = SIM_IRQ_DMA1_CH5};		///< Screen SPI DMA channel
+static adcState_t	_adc;										///< ADC state
+static spiTransfer_t	_spiTransfer;							///< Screen SPI DMA transfer
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Set the analog levels converted by the ADC
+ *
+ * @param supply_mV Supply voltage (in mV)
+ * @param battery_mV Battery voltage, before the divider (in mV)
+ * @param temperature_dC Die temperature (in tenths of degrees)
+ */
+void halStandinSetAnalog(uint16_t supply_mV, uint16_t battery_mV, int16_t temperature_dC){
+	int32_t sensor_uV = V25_UV - ((temperature_dC - TEMPERATURE_25_DC) * SLOPE_UV_PER_DC);
+
+	_adc.raw[0] = (uint16_t)((VREFINT_MV * ADC_FULL_SCALE) / supply_mV);
+	_adc.raw[1] = (uint16_t)(((uint32_t)sensor_uV * ADC_FULL_SCALE) / ((uint32_t)supply_mV * UV_PER_MV));
+	_adc.raw[2] = (uint16_t)(((uint32_t)battery_mV * ADC_FULL_SCALE) / (supply_mV * BATTERY_DIVIDER));
+}
+
+HAL_StatusTypeDef HAL_Init(void){
+	flashStandinErase();
+	HAL_MspInit();
+	return (HAL_OK);
+}
+
+uint32_t HAL_GetTick(void){
+	return (uwTick);
+}
+
+void HAL_IncTick(void){
+	uwTick++;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority){
+	(void)IRQn;
+	(void)PreemptPriority;
+	(void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn){
+	switch(IRQn){
+		case EXTI0_IRQn:
+			simEnableIRQ(SIM_IRQ_EXTI0);
+			break;
+
+		case DMA1_Channel1_IRQn:
+			simEnableIRQ(SIM_IRQ_DMA1_CH1);
+			break;
+
+		case DMA1_Channel5_IRQn:
+			simEnableIRQ(SIM_IRQ_DMA1_CH5);
+			break;
+
+		default:
+			break;
+	}
+}
+
+HAL_StatusTypeDef HAL_RCC_OscConfig(RCC_OscInitTypeDef* RCC_OscInitStruct){
+	(void)RCC_OscInitStruct;
+	return (HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_RCC_ClockConfig(RCC_ClkInitTypeDef* RCC_ClkInitStruct, uint32_t FLatency){
+	(void)RCC_ClkInitStruct;
+	(void)FLatency;
+	return (HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef* PeriphClkInit){
+	(void)PeriphClkInit;
+	return (HAL_OK);
+}
+
+uint32_t HAL_RCC_GetHCLKFreq(void){
+	return (SIM_HCLK_HZ);
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void){
+	return (SIM_PCLK1_HZ);
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void){
+	return (SIM_PCLK2_HZ);
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init){
+	if(GPIO_Init->Mode == GPIO_MODE_IT_FALLING)
+		simPinSetEXTI(GPIOx, (uint16_t)GPIO_Init->Pin);
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef* GPIOx, uint32_t GPIO_Pin){
+	(void)GPIOx;
+	(void)GPIO_Pin;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin){
+	return (simPinRead(GPIOx, GPIO_Pin));
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState){
+	simPinDrive(GPIOx, GPIO_Pin, PinState);
+}
+
+void HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin){
+	(void)GPIO_Pin;
+}
+
+HAL_StatusTypeDef HAL_DMA_Init(DMA_HandleTypeDef* hdma){
+	MODIFY_REG(hdma->Instance->CCR, DMA_CCR_CIRC, hdma->Init.Mode);
+
+	if(hdma->Instance == DMA1_Channel1)
+		_dmaADC.handle = hdma;
+	else if(hdma->Instance == DMA1_Channel5)
+		_dmaScreen.handle = hdma;
+
+	return (HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_DMA_DeInit(DMA_HandleTypeDef* hdma){
+	(void)hdma;
+	return (HAL_OK);
+}
+
+/**
+ * @brief Handle a DMA channel interrupt, calling back the peripheral linked to it
+ *
+ * @param hdma DMA handle
+ */
+void HAL_DMA_IRQHandler(DMA_HandleTypeDef* hdma){
+	if(hdma->Instance == DMA1_Channel5){
+		SPI_HandleTypeDef* hspi = (SPI_HandleTypeDef*)hdma->Parent;
+
+		if(_dmaScreen.event == DMA_HALF_TRANSFER){
+			HAL_SPI_TxHalfCpltCallback(hspi);
+			return;
+		}
+
+		if(!READ_BIT(hdma->Instance->CCR, DMA_CCR_CIRC))
+			hspi->State = HAL_SPI_STATE_READY;
+		HAL_SPI_TxCpltCallback(hspi);
+		return;
+	}
+
+	if(hdma->Instance == DMA1_Channel1){
+		if(_dmaADC.event == DMA_HALF_TRANSFER)
+			HAL_ADC_ConvHalfCpltCallback((ADC_HandleTypeDef*)hdma->Parent);
+		else
+			HAL_ADC_ConvCpltCallback((ADC_HandleTypeDef*)hdma->Parent);
+	}
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi){
+	if(hspi->State == HAL_SPI_STATE_RESET)
+		HAL_SPI_MspInit(hspi);
+
+	MODIFY_REG(hspi->Instance->CR1, SPI_CR1_BR, hspi->Init.BaudRatePrescaler);
+	hspi->State = HAL_SPI_STATE_READY;
+	return (HAL_OK);
+}
+
+/**
+ * @brief Clock bytes out on a SPI bus, blocking for the transfer time
+ */
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout){
+	(void)Timeout;
+
+	if(hspi->State != HAL_SPI_STATE_READY)
+		return (HAL_BUSY);
+
+	for(uint16_t i = 0 ; i < Size ; i++)
+		simSPIexchange(hspi->Instance, pData[i]);
+
+	simAdvance_ns(spiTransferTime_ns(hspi, Size) + SPI_CALL_OVERHEAD_NS);
+	return (HAL_OK);
+}
+
+/**
+ * @brief Clock bytes in from a SPI bus, blocking for the transfer time
+ */
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout){
+	(void)Timeout;
+
+	if(hspi->State != HAL_SPI_STATE_READY)
+		return (HAL_BUSY);
+
+	for(uint16_t i = 0 ; i < Size ; i++)
+		pData[i] = simSPIexchange(hspi->Instance, 0x00U);
+
+	simAdvance_ns(spiTransferTime_ns(hspi, Size) + SPI_CALL_OVERHEAD_NS);
+	return (HAL_OK);
+}
+
+/**
+ * @brief Start a SPI DMA transfer, the DMA interrupt firing after each half of the transfer time
+ * @note The bytes of a half are handed to the device as soon as the DMA starts reading it
+ */
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size){
+	if(hspi->State != HAL_SPI_STATE_READY)
+		return (HAL_BUSY);
+	if(!hspi->hdmatx || (hspi->hdmatx != _dmaScreen.handle))
+		return (HAL_ERROR);
+
+	hspi->State = HAL_SPI_STATE_BUSY_TX;
+	_spiTransfer.hspi = hspi;
+	_spiTransfer.buffer = pData;
+	_spiTransfer.length = Size;
+	_spiTransfer.half = Size >> 1;
+	sendSPIbytes(0, _spiTransfer.half);
+
+	_dmaScreen.event = DMA_TRANSFER_COMPLETE;
+	_dmaScreen.timer.callback = dmaTransferElapsed;
+	_dmaScreen.timer.context = &_dmaScreen;
+	simTimerArm(&_dmaScreen.timer, simNow_ns() + spiTransferTime_ns(hspi, _spiTransfer.half));
+	return (HAL_OK);
+}
+
+/**
+ * @brief Default SPI DMA callbacks, overridden by the display backend
+ */
+__attribute__((weak)) void HAL_SPI_TxHalfCpltCallback(SPI_HandleTypeDef* hspi){
+	(void)hspi;
+}
+
+__attribute__((weak)) void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi){
+	(void)hspi;
+}
+
+HAL_StatusTypeDef HAL_SPI_DMAStop(SPI_HandleTypeDef* hspi){
+	simTimerCancel(&_dmaScreen.timer);
+	hspi->State = HAL_SPI_STATE_READY;
+	return (HAL_OK);
+}
+
+HAL_SPI_StateTypeDef HAL_SPI_GetState(SPI_HandleTypeDef* hspi){
+	return (hspi->State);
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef* hadc){
+	if(!hadc->State)
+		HAL_ADC_MspInit(hadc);
+
+	hadc->State = 1;
+	return (HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef* hadc, ADC_ChannelConfTypeDef* sConfig){
+	(void)hadc;
+	(void)sConfig;
+	return (HAL_OK);
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc){
+	(void)hadc;
+	return (HAL_OK);
+}
+
+/**
+ * @brief Start the continuous conversions, the DMA interrupt firing each time half of the buffer is filled
+ */
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length){
+	if(hadc->DMA_Handle != _dmaADC.handle)
+		return (HAL_ERROR);
+
+	_adc.buffer = (uint16_t*)pData;
+	_adc.length = Length;
+	_adc.halfPeriod_ns = ((uint64_t)(Length >> 1) * ADC_CONVERSION_CYCLES * SIM_NS_PER_S) / ADC_CLOCK_HZ;
+
+	_dmaADC.event = DMA_TRANSFER_COMPLETE;
+	_dmaADC.timer.callback = dmaTransferElapsed;
+	_dmaADC.timer.context = &_dmaADC;
+	simTimerArm(&_dmaADC.timer, simNow_ns() + _adc.halfPeriod_ns);
+	return (HAL_OK);
+}
+
+/**
+ * @brief Compute the time taken to clock bytes on a SPI bus
+ *
+ * @param hspi SPI handle
+ * @param nbBytes Number of bytes
+ * @return Transfer time (in ns)
+ */
+static uint64_t spiTransferTime_ns(const SPI_HandleTypeDef* hspi, uint32_t nbBytes){
+	uint32_t clock_Hz = (hspi->Instance == SPI1) ? SIM_PCLK2_HZ : SIM_PCLK1_HZ;
+	uint32_t prescaler = 2U << ((hspi->Instance->CR1 & SPI_CR1_BR) >> PRESCALER_SHIFT);
+
+	return (((uint64_t)nbBytes * BITS_PER_BYTE * prescaler * SIM_NS_PER_S) / clock_Hz);
+}
+
+/**
+ * @brief End of a DMA transfer (or half of a circular one) : raise the channel interrupt
+ *
+ * @param context DMA channel
+ */
+static void dmaTransferElapsed(void* context){
+	dmaChannel_t* channel = (dmaChannel_t*)context;
+
+	//the ADC DMA is circular : fill the next half and re-arm
+	if(channel == &_dmaADC){
+		channel->event = (channel->event == DMA_HALF_TRANSFER) ? DMA_TRANSFER_COMPLETE : DMA_HALF_TRANSFER;
+		fillADCHalf(channel->event == DMA_TRANSFER_COMPLETE);
+		simTimerArm(&channel->timer, channel->timer.due_ns + _adc.halfPeriod_ns);
+	}
+
+	//the screen DMA sends its second half, then starts over if still circular
+	if(channel == &_dmaScreen){
+		channel->event = (channel->event == DMA_HALF_TRANSFER) ? DMA_TRANSFER_COMPLETE : DMA_HALF_TRANSFER;
+		if(channel->event == DMA_HALF_TRANSFER){
+			sendSPIbytes(_spiTransfer.half, _spiTransfer.length);
+			simTimerArm(&channel->timer, channel->timer.due_ns + spiTransferTime_ns(_spiTransfer.hspi, _spiTransfer.length - _spiTransfer.half));
+		}
+		else if(READ_BIT(channel->handle->Instance->CCR, DMA_CCR_CIRC)){
+			sendSPIbytes(0, _spiTransfer.half);
+			simTimerArm(&channel->timer, channel->timer.due_ns + spiTransferTime_ns(_spiTransfer.hspi, _spiTransfer.half));
+		}
+	}
+
+	simRaiseIRQ(channel->irq);
+}
+
+/**
+ * @brief Fill half of the ADC buffer with the raw values of the simulated analog levels
+ *
+ * @param half Half to fill (0 for the first one)
+ */
+static void fillADCHalf(uint8_t half){
+	uint32_t halfLength = _adc.length >> 1;
+	uint16_t* destination = &_adc.buffer[half * halfLength];
+
+	for(uint32_t i = 0 ; i < halfLength ; i++)
+		destination[i] = _adc.raw[i % NB_ADC_CHANNELS];
+}
+
+/**
+ * @brief Hand bytes of the screen DMA buffer to the device
+ *
+ * @param first First byte to send
+ * @param last Byte following the last one to send
+ */
+static void sendSPIbytes(uint16_t first, uint16_t last){
+	for(uint16_t i = first ; i < last ; i++)
+		simSPIexchange(_spiTransfer.hspi->Instance, _spiTransfer.buffer[i]);
+}
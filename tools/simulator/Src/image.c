@@ -0,0 +1,218 @@
+/**
+ * @file image.c
+ * @brief Implement the dump of monochrome screen images as PBM or PNG files
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Both formats show the lit pixels in white on black, as on the OLED panel.
+ * The PNG files are written without any library : 1-bit greyscale, and a zlib stream made of a single stored (uncompressed) block.
+ */
+#include "image.h"
+#include <stdio.h>
+#include <string.h>
+
+//definitions
+#define PNG_RAW_SIZE		(IMAGE_HEIGHT * (IMAGE_ROW_BYTES + 1U))	///< Size of the PNG raw data (filter byte + pixels, for each row)
+#define PNG_IHDR_SIZE		13U			///< Size of the PNG header chunk data
+#define PNG_ZLIB_SIZE		(2U + 5U + PNG_RAW_SIZE + 4U)			///< Size of the zlib stream (header, stored block header, data, Adler-32)
+#define PNG_BIT_DEPTH		1U			///< Number of bits per pixel
+#define PNG_GREYSCALE		0U			///< PNG colour type of the greyscale images
+#define PNG_FILTER_NONE		0U			///< PNG row filter "none"
+#define ZLIB_CMF			0x78U		///< zlib compression method (deflate, 32K window)
+#define ZLIB_FLG			0x01U		///< zlib flags (fastest level, makes CMF.FLG a multiple of 31)
+#define DEFLATE_FINAL_STORED	0x01U	///< Deflate block header : last block, stored
+#define CRC32_POLYNOMIAL	0xEDB88320U	///< CRC-32 reversed polynomial (PNG, zlib)
+#define ADLER_MODULO		65521U		///< Adler-32 modulo
+
+//image functions
+static int writePBM(const image_t* image, FILE* file);
+static int writePNG(const image_t* image, FILE* file);
+static void writeChunk(FILE* file, const char type[4], const uint8_t data[], uint32_t size);
+static uint8_t* storeBigEndian(uint8_t* destination, uint32_t value);
+static uint32_t crc32Update(uint32_t crc, const uint8_t data[], uint32_t size);
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Write an image, as PNG if the path ends with ".png", as PBM otherwise
+ *
+ * @param image Image to write
+ * @param path Path of the file
+ * @retval 0 Success
+ * @retval -1 Error while writing the file
+ */
+int imageWrite(const image_t* image, const char* path){
+	size_t length = strlen(path);
+	FILE* file;
+	int result;
+
+	file = fopen(path, "wb");
+	if(!file){
+		perror(path);
+		return (-1);
+	}
+
+	if((length > 4U) && !strcmp(&path[length - 4U], ".png"))	// @suppress("Avoid magic numbers")
+		result = writePNG(image, file);
+	else
+		result = writePBM(image, file);
+
+	if(fclose(file))
+		result = -1;
+	if(result)
+		perror(path);
+
+	return (result);
+}
+
+/**
+ * @brief Compute the CRC-32 of the pixels of an image, to compare images without dumping them
+ *
+ * @param image Image
+ * @return CRC-32 of the pixels
+ */
+uint32_t imageCRC32(const image_t* image){
+	return (crc32Update(0, &image->rows[0][0], sizeof(image->rows)));
+}
+
+/**
+ * @brief Write an image as a binary PBM (P4) file
+ * @note PBM pixels are 1 when black, so the lit pixels are inverted
+ *
+ * @param image Image to write
+ * @param file File to write to
+ * @retval 0 Success
+ * @retval -1 Error while writing
+ */
+static int writePBM(const image_t* image, FILE* file){
+	uint8_t row[IMAGE_ROW_BYTES];
+
+	fprintf(file, "P4\n%u %u\n", IMAGE_WIDTH, IMAGE_HEIGHT);
+	for(uint8_t y = 0 ; y < IMAGE_HEIGHT ; y++){
+		for(uint8_t i = 0 ; i < IMAGE_ROW_BYTES ; i++)
+			row[i] = (uint8_t)~image->rows[y][i];
+
+		if(fwrite(row, sizeof(row), 1, file) != 1U)
+			return (-1);
+	}
+
+	return (ferror(file) ? -1 : 0);
+}
+
+/**
+ * @brief Write an image as a 1-bit greyscale PNG file
+ *
+ * @param image Image to write
+ * @param file File to write to
+ * @retval 0 Success
+ * @retval -1 Error while writing
+ */
+static int writePNG(const image_t* image, FILE* file){
+	static const uint8_t signature[8] = {0x89U, 'P', 'N', 'G', '\r', '\n', 0x1AU, '\n'};
+	uint8_t header[PNG_IHDR_SIZE];
+	uint8_t stream[PNG_ZLIB_SIZE];
+	uint8_t* iterator;
+	uint32_t adlerA = 1U;
+	uint32_t adlerB = 0;
+
+	fwrite(signature, sizeof(signature), 1, file);
+
+	//header : size, bit depth, colour type, compression, filter and interlace methods
+	iterator = storeBigEndian(header, IMAGE_WIDTH);
+	iterator = storeBigEndian(iterator, IMAGE_HEIGHT);
+	*(iterator++) = PNG_BIT_DEPTH;
+	*(iterator++) = PNG_GREYSCALE;
+	*(iterator++) = 0;
+	*(iterator++) = 0;
+	*iterator = 0;
+	writeChunk(file, "IHDR", header, sizeof(header));
+
+	//zlib stream with a single stored block (length, then its one's complement, little endian)
+	iterator = stream;
+	*(iterator++) = ZLIB_CMF;
+	*(iterator++) = ZLIB_FLG;
+	*(iterator++) = DEFLATE_FINAL_STORED;
+	*(iterator++) = (uint8_t)(PNG_RAW_SIZE & 0xFFU);							// @suppress("Avoid magic numbers")
+	*(iterator++) = (uint8_t)(PNG_RAW_SIZE >> 8U);								// @suppress("Avoid magic numbers")
+	*(iterator++) = (uint8_t)(~PNG_RAW_SIZE & 0xFFU);							// @suppress("Avoid magic numbers")
+	*(iterator++) = (uint8_t)((~PNG_RAW_SIZE >> 8U) & 0xFFU);					// @suppress("Avoid magic numbers")
+
+	//raw rows, each preceded by its filter type, with the Adler-32 computed along
+	for(uint8_t y = 0 ; y < IMAGE_HEIGHT ; y++){
+		*iterator = PNG_FILTER_NONE;
+		memcpy(iterator + 1, image->rows[y], IMAGE_ROW_BYTES);
+
+		for(uint8_t i = 0 ; i <= IMAGE_ROW_BYTES ; i++){
+			adlerA = (adlerA + iterator[i]) % ADLER_MODULO;
+			adlerB = (adlerB + adlerA) % ADLER_MODULO;
+		}
+		iterator += IMAGE_ROW_BYTES + 1U;
+	}
+	storeBigEndian(iterator, (adlerB << 16U) | adlerA);						// @suppress("Avoid magic numbers")
+	writeChunk(file, "IDAT", stream, sizeof(stream));
+
+	writeChunk(file, "IEND", NULL, 0);
+	return (ferror(file) ? -1 : 0);
+}
+
+/**
+ * @brief Write a PNG chunk (size, type, data and CRC)
+ *
+ * @param file File to write to
+ * @param type Chunk type
+ * @param data Chunk data
+ * @param size Size of the data
+ */
+static void writeChunk(FILE* file, const char type[4], const uint8_t data[], uint32_t size){
+	uint8_t field[4];
+	uint32_t crc;
+
+	storeBigEndian(field, size);
+	fwrite(field, sizeof(field), 1, file);
+	fwrite(type, 4U, 1, file);														// @suppress("Avoid magic numbers")
+	if(size)
+		fwrite(data, size, 1, file);
+
+	crc = crc32Update(0, (const uint8_t*)type, 4U);									// @suppress("Avoid magic numbers")
+	crc = crc32Update(crc, data, size);
+	storeBigEndian(field, crc);
+	fwrite(field, sizeof(field), 1, file);
+}
+
+/**
+ * @brief Store a 32-bit value in big endian
+ *
+ * @param destination Bytes to write to
+ * @param value Value to store
+ * @return Byte following the value stored
+ */
+static uint8_t* storeBigEndian(uint8_t* destination, uint32_t value){
+	*(destination++) = (uint8_t)(value >> 24U);										// @suppress("Avoid magic numbers")
+	*(destination++) = (uint8_t)(value >> 16U);										// @suppress("Avoid magic numbers")
+	*(destination++) = (uint8_t)(value >> 8U);										// @suppress("Avoid magic numbers")
+	*(destination++) = (uint8_t)value;
+	return (destination);
+}
+
+/**
+ * @brief Continue a CRC-32 computation (bitwise, the images are small)
+ *
+ * @param crc CRC computed so far (0 to start)
+ * @param data Data to add
+ * @param size Size of the data
+ * @return CRC updated
+ */
+static uint32_t crc32Update(uint32_t crc, const uint8_t data[], uint32_t size){
+	crc = ~crc;
+	for(uint32_t i = 0 ; i < size ; i++){
+		crc ^= data[i];
+		for(uint8_t bit = 0 ; bit < 8U ; bit++)										// @suppress("Avoid magic numbers")
+			crc = (crc >> 1U) ^ ((crc & 1U) ? CRC32_POLYNOMIAL : 0);
+	}
+
+	return (~crc);
+}
@@ -0,0 +1,654 @@
+/**
+ * @file main.c
+ * @brief Run the firmware on the host, replaying a samples stream captured on the device
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The firmware sources are compiled unmodified against the HAL stand-in, its main() renamed firmwareMain().
+ * The simulated devices are wired as on the board, then the firmware runs until the end of the capture
+ * (plus a short tail to let the last blocks reach the screen).
+ * Instead of a capture, a synthetic profile can drive the accelerometer for a given time (-g and -d, see profile.c),
+ * and noise (-n) and drift (-D) can be added to either, for soak and throughput runs.
+ *
+ * In USE_GYRO builds, a L3GD20 model shares SPI1 on GYRO_CS, turning as the profile does, with a zero-rate level (-B)
+ * and noise (-N). The angles from the accelerometer alone and the fused ones are then sampled every 10 ms
+ * (after the fusion settling time), and their errors against the true angles of the profile are added to the summary.
+ *
+ * Outputs :
+ * - the angles printed on screen, with their simulated timestamps (CSV, -a)
+ * - the panel images, each time they change (PNG or PBM files, -f), with the bytes received for each frame (frames.csv)
+ * - the last panel image (-p, PNG if its name ends with .png, PBM otherwise)
+ * - a summary (key = value lines, -s or stdout) : SPI bytes, tap gestures reported to the application, latency stages from the tracer (simulated time),
+ * 	 tasks statistics, and the host time spent in each stage function (measured around the real calls)
+ *
+ * Two builds can be compared on the same capture with ab_compare.sh, pixel-exactly with the last panel image.
+ */
+#include "simulator.h"
+#include "halStandin.h"
+#include "adxlModel.h"
+#include "ssd1306Model.h"
+#include "capture.h"
+#include "image.h"
+#include "profile.h"
+#ifdef USE_GYRO
+#include "gyroModel.h"
+#include "fusion.h"
+#endif
+#include "main.h"
+#include "scheduler.h"
+#include "tracer.h"
+#include "screen.h"
+#include "goertzel.h"
+#include "spectrum.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <math.h>
+#include <sys/stat.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define READ_CYCLES()	__rdtsc()
+#else
+#define READ_CYCLES()	0ULL
+#endif
+
+//definitions
+#define TAIL_NS				(500ULL * SIM_NS_PER_MS)	///< Time simulated after the end of the capture (in ns)
+#ifdef SCREEN_SH1106
+#define SCREEN_CONTROLLER	MODEL_SH1106				///< Controller of the panel simulated
+#else
+#define SCREEN_CONTROLLER	MODEL_SSD1306				///< Controller of the panel simulated
+#endif
+#define SUPPLY_MV			3300U	///< Simulated supply voltage (in mV)
+#define BATTERY_MV			3900U	///< Simulated battery voltage (in mV)
+#define TEMPERATURE_DC		250		///< Simulated die temperature (in tenths of degrees)
+#define PATH_SIZE			512U	///< Maximum length of a frame image path
+#define DEFAULT_DURATION_S	60.0	///< Time simulated with a synthetic profile, if not given (in s)
+#define ERROR_PERIOD_NS		(10ULL * SIM_NS_PER_MS)		///< Period at which the angle errors are sampled (in ns)
+#define ERROR_START_NS		(3ULL * SIM_NS_PER_S)		///< Time after which the angle errors are sampled (in ns)
+
+/**
+ * @brief Enumeration of the firmware stage functions timed on the host
+ */
+typedef enum{
+	HOST_ACQUISITION = 0,	///< ADXL345update()
+	HOST_FILTERS,			///< goertzelAddSamples()
+	HOST_SPECTRUM,			///< spectrumCompute()
+	HOST_RENDERING,			///< screenPrintAngle() and screenPrintPreciseAngle()
+	HOST_SCREEN,			///< screenUpdate()
+	NB_HOST_STAGES
+}hostStage_e;
+
+/**
+ * @brief Structure holding the host time spent in a stage function
+ */
+typedef struct{
+	uint64_t	nbCalls;	///< Number of calls
+	uint64_t	time_ns;	///< Cumulated wall-clock time (in ns)
+	uint64_t	cycles;		///< Cumulated time stamp counter cycles (0 if not available)
+}hostStage_t;
+
+/**
+ * @brief Structure holding the errors of an angle estimation against the true angles
+ */
+typedef struct{
+	double		squares;	///< Sum of the squared errors (in squared degrees)
+	double		max;		///< Highest absolute error (in degrees)
+}angleErrors_t;
+
+/**
+ * @brief Structure holding a measurement in progress
+ */
+typedef struct{
+	struct timespec	start;	///< Wall-clock time at the start
+	uint64_t		cycles;	///< Time stamp counter at the start
+}hostProbe_t;
+
+//wrapped firmware functions
+extern int			firmwareMain(void);
+errorCode_u			__real_ADXL345update();
+sensorGesture_e		__real_ADXL345getGesture();
+void				__real_goertzelAddSamples(const int16_t samples[], uint8_t nbSamples, uint32_t samplePeriod_ns);
+void				__real_spectrumCompute(uint32_t samplePeriod_ns, spectrumPeak_t* peak);
+errorCode_u			__real_screenPrintAngle(float angle, uint8_t page, uint8_t column);
+errorCode_u			__real_screenPrintPreciseAngle(float angle, uint8_t page, uint8_t column);
+errorCode_u			__real_screenUpdate();
+
+//tool functions
+static void usage(const char* program);
+static void finish(void* context);
+static void printSummary(FILE* output);
+static hostProbe_t probeStart();
+static void probeStop(hostStage_e stage, hostProbe_t probe);
+static uint64_t elapsed_ns(const struct timespec* start, const struct timespec* end);
+static int openFrames(const char* directory);
+static void frameEnded(void* context, const ssd1306Frame_t* frame);
+#ifdef USE_GYRO
+static void sampleErrors(void* context);
+static void addError(angleErrors_t* errors, double error);
+#endif
+
+//names used in the summary
+static const char* const _stageNames[TRACE_NB_STAGES] = {"acquisition", "queueing", "compute", "transfer", "total"};
+static const char* const _hostNames[NB_HOST_STAGES] = {"acquisition", "filters", "spectrum", "rendering", "screen"};
+static const char* const _taskNames[] = {"analog", "interface", "processing", "screen", "gyroscope", "accelerometer"};
+
+//state variables
+static capture_t		_capture;					///< Capture replayed (no samples with a synthetic profile)
+static profile_t		_profile;					///< Acceleration profile driving the accelerometer
+static const char*		_sourceName = NULL;			///< Path of the capture replayed, or synthetic profile specification
+static FILE*			_angles = NULL;				///< Angles CSV output (NULL if not requested)
+static FILE*			_summary = NULL;			///< Summary output
+static struct timespec	_hostStart;					///< Wall-clock time at the start of the simulation
+static hostStage_t		_host[NB_HOST_STAGES];		///< Host time spent in each stage function
+static uint32_t			_nbAngles = 0;				///< Number of angles printed
+static uint32_t			_nbGestures[SENSOR_DOUBLE_TAP + 1] = {0};	///< Number of tap gestures reported to the application, per gesture
+static const char*		_framesDirectory = NULL;	///< Directory in which the frames images are dumped (NULL if not requested)
+static const char*		_framesExtension = "png";	///< Extension (and format) of the frames images
+static const char*		_lastImagePath = NULL;		///< Path of the last panel image (NULL if not requested)
+static FILE*			_frames = NULL;				///< Frames CSV output (NULL if not requested)
+static uint32_t			_lastCRC = 0;				///< CRC-32 of the last frame image dumped
+static uint32_t			_nbImages = 0;				///< Number of frame images dumped
+#ifdef USE_GYRO
+static simTimer_t		_errorTimer;				///< Timer expiring at the next angle errors sample
+static angleErrors_t	_staticErrors;				///< Errors of the angles computed from the accelerometer alone
+static angleErrors_t	_fusedErrors;				///< Errors of the angles fused with the gyroscope
+static uint32_t			_nbErrors = 0;				///< Number of angle errors sampled (per estimation, both angles)
+#endif
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+int main(int argc, char* argv[]){
+	const char* anglesPath = NULL;
+	const char* summaryPath = NULL;
+	double duration_s = DEFAULT_DURATION_S;
+	double noise_mg = 0.0;
+	double drift_mg_per_h = 0.0;
+	double rateBias_dps = 0.0;
+	double rateNoise_dps = 0.0;
+	uint64_t duration_ns;
+	int option;
+
+	while((option = getopt(argc, argv, "a:s:f:F:p:g:d:n:D:B:N:h")) != -1){
+		switch(option){
+			case 'a':
+				anglesPath = optarg;
+				break;
+
+			case 'g':
+				_sourceName = optarg;
+				break;
+
+			case 'd':
+				duration_s = atof(optarg);
+				break;
+
+			case 'n':
+				noise_mg = atof(optarg);
+				break;
+
+			case 'D':
+				drift_mg_per_h = atof(optarg);
+				break;
+
+			case 'B':
+				rateBias_dps = atof(optarg);
+				break;
+
+			case 'N':
+				rateNoise_dps = atof(optarg);
+				break;
+
+			case 'f':
+				_framesDirectory = optarg;
+				break;
+
+			case 'F':
+				if(strcmp(optarg, "png") && strcmp(optarg, "pbm")){
+					usage(argv[0]);
+					return (EXIT_FAILURE);
+				}
+				_framesExtension = optarg;
+				break;
+
+			case 'p':
+				_lastImagePath = optarg;
+				break;
+
+			case 's':
+				summaryPath = optarg;
+				break;
+
+			default:
+				usage(argv[0]);
+				return (EXIT_FAILURE);
+		}
+	}
+
+	//acceleration source : either a synthetic profile, or a capture
+	if(_sourceName){
+		if((optind != argc) || (duration_s <= 0.0)){
+			usage(argv[0]);
+			return (EXIT_FAILURE);
+		}
+		if(profileParse(&_profile, _sourceName))
+			return (EXIT_FAILURE);
+		duration_ns = (uint64_t)(duration_s * (double)SIM_NS_PER_S);
+	}
+	else{
+		if(optind != (argc - 1)){
+			usage(argv[0]);
+			return (EXIT_FAILURE);
+		}
+		_sourceName = argv[optind];
+		if(captureLoad(&_capture, _sourceName))
+			return (EXIT_FAILURE);
+		profileSetCapture(&_profile, &_capture);
+		duration_ns = captureGetDuration_ns(&_capture);
+	}
+	_profile.noise_mg = noise_mg;
+	_profile.drift_mg_per_h = drift_mg_per_h;
+	_profile.rateBias_dps = rateBias_dps;
+	_profile.rateNoise_dps = rateNoise_dps;
+
+	//open the outputs
+	_summary = summaryPath ? fopen(summaryPath, "w") : stdout;
+	if(!_summary){
+		perror(summaryPath);
+		return (EXIT_FAILURE);
+	}
+	if(anglesPath){
+		_angles = fopen(anglesPath, "w");
+		if(!_angles){
+			perror(anglesPath);
+			return (EXIT_FAILURE);
+		}
+		fprintf(_angles, "time_ms,page,angle\n");
+	}
+	if(_framesDirectory && openFrames(_framesDirectory))
+		return (EXIT_FAILURE);
+
+	//wire the devices as on the board
+	simInitialise(duration_ns + TAIL_NS, finish);
+	halStandinSetAnalog(SUPPLY_MV, BATTERY_MV, TEMPERATURE_DC);
+	adxlModelInitialise(ADXL_INT1_GPIO_Port, ADXL_INT1_Pin, profileSource, &_profile);
+	simSPIattach(SPI1, ADXL_CS_GPIO_Port, ADXL_CS_Pin, &adxlModelDevice);
+#ifdef USE_GYRO
+	gyroModelInitialise(profileRateSource, &_profile);
+	simSPIattach(SPI1, GYRO_CS_GPIO_Port, GYRO_CS_Pin, &gyroModelDevice);
+	_errorTimer.callback = sampleErrors;
+	simTimerArm(&_errorTimer, ERROR_START_NS);
+#endif
+	ssd1306ModelInitialise(SCREEN_CONTROLLER, SSD1306_DC_GPIO_Port, SSD1306_DC_Pin, SSD1306_RST_GPIO_Port, SSD1306_RST_Pin);
+	ssd1306ModelSetFrameHandler(frameEnded, NULL);
+	simSPIattach(SPI2, SSD1306_CS_GPIO_Port, SSD1306_CS_Pin, &ssd1306ModelDevice);
+
+	//run the firmware (never returns, finish() ends the simulation)
+	clock_gettime(CLOCK_MONOTONIC, &_hostStart);
+	firmwareMain();
+	return (EXIT_FAILURE);
+}
+
+errorCode_u __wrap_ADXL345update(){
+	hostProbe_t probe = probeStart();
+	errorCode_u result = __real_ADXL345update();
+
+	probeStop(HOST_ACQUISITION, probe);
+	return (result);
+}
+
+/**
+ * @brief Count the tap gestures reported to the application
+ */
+sensorGesture_e __wrap_ADXL345getGesture(){
+	sensorGesture_e gesture = __real_ADXL345getGesture();
+
+	_nbGestures[gesture]++;
+	return (gesture);
+}
+
+void __wrap_goertzelAddSamples(const int16_t samples[], uint8_t nbSamples, uint32_t samplePeriod_ns){
+	hostProbe_t probe = probeStart();
+
+	__real_goertzelAddSamples(samples, nbSamples, samplePeriod_ns);
+	probeStop(HOST_FILTERS, probe);
+}
+
+void __wrap_spectrumCompute(uint32_t samplePeriod_ns, spectrumPeak_t* peak){
+	hostProbe_t probe = probeStart();
+
+	__real_spectrumCompute(samplePeriod_ns, peak);
+	probeStop(HOST_SPECTRUM, probe);
+}
+
+/**
+ * @brief Log the angle printed, then print it
+ */
+errorCode_u __wrap_screenPrintAngle(float angle, uint8_t page, uint8_t column){
+	hostProbe_t probe;
+	errorCode_u result;
+
+	if(_angles)
+		fprintf(_angles, "%.3f,%u,%.4f\n", (double)simNow_ns() / SIM_NS_PER_MS, page, (double)angle);
+	_nbAngles++;
+
+	probe = probeStart();
+	result = __real_screenPrintAngle(angle, page, column);
+	probeStop(HOST_RENDERING, probe);
+	return (result);
+}
+
+/**
+ * @brief Log the precise angle printed, then print it
+ */
+errorCode_u __wrap_screenPrintPreciseAngle(float angle, uint8_t page, uint8_t column){
+	hostProbe_t probe;
+	errorCode_u result;
+
+	if(_angles)
+		fprintf(_angles, "%.3f,%u,%.4f\n", (double)simNow_ns() / SIM_NS_PER_MS, page, (double)angle);
+	_nbAngles++;
+
+	probe = probeStart();
+	result = __real_screenPrintPreciseAngle(angle, page, column);
+	probeStop(HOST_RENDERING, probe);
+	return (result);
+}
+
+errorCode_u __wrap_screenUpdate(){
+	hostProbe_t probe = probeStart();
+	errorCode_u result = __real_screenUpdate();
+
+	probeStop(HOST_SCREEN, probe);
+	return (result);
+}
+
+/**
+ * @brief Print the command line usage
+ *
+ * @param program Program name
+ */
+static void usage(const char* program){
+	fprintf(stderr, "usage: %s [-a angles.csv] [-s summary.txt] [-f frames_dir [-F png|pbm]] [-p last.png|last.pbm]\n"
+					"          [-n noise_mg] [-D drift_mg_per_hour] [-B gyro_bias_dps] [-N gyro_noise_dps]\n"
+					"          {capture.txt | -g profile[:parameters] [-d seconds]}\n", program);
+}
+
+/**
+ * @brief End of the simulation : write the summary and exit
+ *
+ * @param context Unused
+ */
+static void finish(void* context){
+	image_t image;
+	int result = EXIT_SUCCESS;
+	(void)context;
+
+	if(_lastImagePath){
+		ssd1306ModelRender(&image);
+		if(imageWrite(&image, _lastImagePath))
+			result = EXIT_FAILURE;
+	}
+
+	printSummary(_summary);
+	if(_angles)
+		fclose(_angles);
+	if(_frames)
+		fclose(_frames);
+	if(_summary != stdout)
+		fclose(_summary);
+	captureFree(&_capture);
+
+	exit(result);
+}
+
+/**
+ * @brief Print the summary of the simulation
+ *
+ * @param output Summary output
+ */
+static void printSummary(FILE* output){
+	struct timespec hostEnd;
+	adxlModelStats_t adxl;
+#ifdef USE_GYRO
+	gyroModelStats_t gyro;
+	uint32_t nbErrors = _nbErrors ? _nbErrors : 1U;
+#endif
+	ssd1306ModelStats_t screen;
+	image_t image;
+	traceHistogram_t histogram;
+	taskStats_t task;
+	uint64_t hostTime_ns;
+	double simulated_s;
+
+	clock_gettime(CLOCK_MONOTONIC, &hostEnd);
+	hostTime_ns = elapsed_ns(&_hostStart, &hostEnd);
+	simulated_s = (double)simNow_ns() / (double)SIM_NS_PER_S;
+	adxlModelGetStats(&adxl);
+	ssd1306ModelGetStats(&screen);
+	ssd1306ModelRender(&image);
+
+	fprintf(output, "source = %s\n", _sourceName);
+	if(_capture.nbSamples){
+		fprintf(output, "capture.samples = %u\n", _capture.nbSamples);
+		fprintf(output, "capture.odr_hz = %u\n", _capture.odr_Hz);
+	}
+	fprintf(output, "source.noise_mg = %.2f\n", _profile.noise_mg);
+	fprintf(output, "source.drift_mg_per_h = %.2f\n", _profile.drift_mg_per_h);
+	fprintf(output, "simulated_s = %.3f\n", simulated_s);
+	fprintf(output, "host_s = %.3f\n", (double)hostTime_ns / (double)SIM_NS_PER_S);
+	fprintf(output, "speedup = %.1f\n", (simulated_s * (double)SIM_NS_PER_S) / (double)(hostTime_ns ? hostTime_ns : 1U));
+	fprintf(output, "angles.printed = %u\n", _nbAngles);
+
+	//buses and devices
+	fprintf(output, "adxl.samples = %u\n", adxl.nbSamples);
+	fprintf(output, "adxl.popped = %u\n", adxl.nbPopped);
+	fprintf(output, "adxl.overruns = %u\n", adxl.nbOverruns);
+	fprintf(output, "adxl.single_taps = %u\n", adxl.nbSingleTaps);
+	fprintf(output, "adxl.double_taps = %u\n", adxl.nbDoubleTaps);
+	fprintf(output, "gestures.single_taps = %u\n", _nbGestures[SENSOR_SINGLE_TAP]);
+	fprintf(output, "gestures.double_taps = %u\n", _nbGestures[SENSOR_DOUBLE_TAP]);
+	fprintf(output, "adxl.activity_samples = %u\n", adxl.nbActivities);
+	fprintf(output, "adxl.inactivities = %u\n", adxl.nbInactivities);
+	fprintf(output, "adxl.free_falls = %u\n", adxl.nbFreeFalls);
+	fprintf(output, "adxl.triggers = %u\n", adxl.nbTriggers);
+#ifdef USE_GYRO
+	gyroModelGetStats(&gyro);
+	fprintf(output, "gyro.bias_dps = %.3f\n", _profile.rateBias_dps);
+	fprintf(output, "gyro.noise_dps = %.3f\n", _profile.rateNoise_dps);
+	fprintf(output, "gyro.samples = %u\n", gyro.nbSamples);
+	fprintf(output, "gyro.popped = %u\n", gyro.nbPopped);
+	fprintf(output, "gyro.overruns = %u\n", gyro.nbOverruns);
+	fprintf(output, "fusion.error_samples = %u\n", _nbErrors);
+	fprintf(output, "fusion.static_rms_deg = %.4f\n", sqrt(_staticErrors.squares / nbErrors));
+	fprintf(output, "fusion.static_max_deg = %.4f\n", _staticErrors.max);
+	fprintf(output, "fusion.fused_rms_deg = %.4f\n", sqrt(_fusedErrors.squares / nbErrors));
+	fprintf(output, "fusion.fused_max_deg = %.4f\n", _fusedErrors.max);
+#endif
+	fprintf(output, "spi1.bytes = %u\n", simSPIgetBytes(SPI1));
+	fprintf(output, "spi2.bytes = %u\n", simSPIgetBytes(SPI2));
+	fprintf(output, "screen.command_bytes = %u\n", screen.commandBytes);
+	fprintf(output, "screen.data_bytes = %u\n", screen.dataBytes);
+	fprintf(output, "screen.transfers = %u\n", screen.nbTransfers);
+	fprintf(output, "screen.frames = %u\n", screen.nbFrames);
+	fprintf(output, "screen.frame_bytes.mean = %u\n", screen.nbFrames ? ((screen.commandBytes + screen.dataBytes) / screen.nbFrames) : 0);
+	fprintf(output, "screen.frame_bytes.max = %u\n", screen.maxFrameBytes);
+	fprintf(output, "screen.unknown_commands = %u\n", screen.unknownCommands);
+	fprintf(output, "screen.images_dumped = %u\n", _nbImages);
+	fprintf(output, "screen.last_crc32 = %08x\n", imageCRC32(&image));
+
+	//latency stages, in simulated time (the firmware code itself takes none, so these are I/O and queueing times)
+	fprintf(output, "trace.blocks = %u\n", tracerSnapshot.nbTraces);
+	fprintf(output, "trace.never_displayed = %u\n", tracerSnapshot.lastTag - tracerSnapshot.nbTraces);
+	for(uint8_t stage = 0 ; stage < TRACE_NB_STAGES ; stage++){
+		uint32_t mean_us;
+
+		tracerGetHistogram((traceStage_e)stage, &histogram);
+		mean_us = tracerSnapshot.nbTraces ? (histogram.total_us / tracerSnapshot.nbTraces) : 0;
+		fprintf(output, "trace.%s.mean_us = %u\n", _stageNames[stage], mean_us);
+		fprintf(output, "trace.%s.max_us = %u\n", _stageNames[stage], histogram.max_us);
+		fprintf(output, "trace.%s.mean_cycles = %u\n", _stageNames[stage], mean_us * SIM_CYCLES_PER_US);
+	}
+
+	//tasks
+	for(uint8_t priority = 0 ; priority < (sizeof(_taskNames) / sizeof(_taskNames[0])) ; priority++){
+		if(IS_ERROR(schedulerGetStats(priority, &task)))
+			continue;
+
+		fprintf(output, "task.%s.runs = %u\n", _taskNames[priority], task.nbRuns);
+		fprintf(output, "task.%s.max_latency_us = %u\n", _taskNames[priority], task.maxLatency_us);
+		fprintf(output, "task.%s.deadline_misses = %u\n", _taskNames[priority], task.deadlineMisses);
+	}
+
+	//host time spent in the stage functions
+	for(uint8_t stage = 0 ; stage < NB_HOST_STAGES ; stage++){
+		const hostStage_t* host = &_host[stage];
+		uint64_t calls = host->nbCalls ? host->nbCalls : 1U;
+
+		fprintf(output, "host.%s.calls = %llu\n", _hostNames[stage], (unsigned long long)host->nbCalls);
+		fprintf(output, "host.%s.mean_ns = %llu\n", _hostNames[stage], (unsigned long long)(host->time_ns / calls));
+		fprintf(output, "host.%s.mean_cycles = %llu\n", _hostNames[stage], (unsigned long long)(host->cycles / calls));
+	}
+}
+
+/**
+ * @brief Start measuring the host time spent in a function
+ *
+ * @return Measurement in progress
+ */
+static hostProbe_t probeStart(){
+	hostProbe_t probe;
+
+	clock_gettime(CLOCK_MONOTONIC, &probe.start);
+	probe.cycles = READ_CYCLES();
+	return (probe);
+}
+
+/**
+ * @brief Stop measuring the host time spent in a function, and add it to its stage
+ *
+ * @param stage Stage of the function
+ * @param probe Measurement in progress
+ */
+static void probeStop(hostStage_e stage, hostProbe_t probe){
+	uint64_t cycles = READ_CYCLES();
+	struct timespec end;
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	_host[stage].nbCalls++;
+	_host[stage].time_ns += elapsed_ns(&probe.start, &end);
+	_host[stage].cycles += cycles - probe.cycles;
+}
+
+/**
+ * @brief Compute the time elapsed between two wall-clock times
+ *
+ * @param start Start time
+ * @param end End time
+ * @return Time elapsed (in ns)
+ */
+static uint64_t elapsed_ns(const struct timespec* start, const struct timespec* end){
+	return ((uint64_t)(end->tv_sec - start->tv_sec) * SIM_NS_PER_S + (uint64_t)end->tv_nsec - (uint64_t)start->tv_nsec);
+}
+
+/**
+ * @brief Create the frames directory (if needed) and open its frames CSV
+ *
+ * @param directory Frames directory
+ * @retval 0 Success
+ * @retval -1 Error while creating the directory or the CSV file
+ */
+static int openFrames(const char* directory){
+	char path[PATH_SIZE];
+
+	if(mkdir(directory, 0755) && (errno != EEXIST)){								// @suppress("Avoid magic numbers")
+		perror(directory);
+		return (-1);
+	}
+
+	snprintf(path, sizeof(path), "%s/frames.csv", directory);
+	_frames = fopen(path, "w");
+	if(!_frames){
+		perror(path);
+		return (-1);
+	}
+
+	fprintf(_frames, "frame,time_ms,command_bytes,data_bytes,crc32,image\n");
+	return (0);
+}
+
+/**
+ * @brief Frame handler : log the frame, and dump its image if it changed
+ *
+ * @param context Unused
+ * @param frame Frame which just ended
+ */
+static void frameEnded(void* context, const ssd1306Frame_t* frame){
+	char path[PATH_SIZE] = "";
+	image_t image;
+	uint32_t crc;
+	(void)context;
+
+	if(!_frames)
+		return;
+
+	ssd1306ModelRender(&image);
+	crc = imageCRC32(&image);
+	if(!_nbImages || (crc != _lastCRC)){
+		snprintf(path, sizeof(path), "%s/frame_%06u.%s", _framesDirectory, frame->index, _framesExtension);
+		imageWrite(&image, path);
+		_lastCRC = crc;
+		_nbImages++;
+	}
+
+	fprintf(_frames, "%u,%.3f,%u,%u,%08x,%s\n", frame->index, (double)frame->time_ns / SIM_NS_PER_MS,
+			frame->commandBytes, frame->dataBytes, crc, (path[0] ? strrchr(path, '/') + 1 : ""));
+}
+
+#ifdef USE_GYRO
+/**
+ * @brief Sample the errors of the accelerometer angles and of the fused angles against the true angles
+ * @details The accelerometer angles are the ones of the last block published, as the fusion reference
+ *
+ * @param context Unused
+ */
+static void sampleErrors(void* context){
+	double truth[PROFILE_NB_ANGLES];
+	float fused[FUSION_NB_ANGLES];
+	int32_t fine[NB_AXIS];
+	float measured;
+	(void)context;
+
+	simTimerArm(&_errorTimer, _errorTimer.due_ns + ERROR_PERIOD_NS);
+	if(profileGetAngles(&_profile, simNow_ns(), truth))
+		return;
+
+	ADXL345getFineVector(fine);
+	fusionGetAngles(fused);
+	for(uint8_t angle = 0 ; angle < FUSION_NB_ANGLES ; angle++){
+		measured = vectorToAngleDegrees(fine[angle], fine[Z_AXIS]);
+		addError(&_staticErrors, (double)measured - truth[angle]);
+		addError(&_fusedErrors, (double)fused[angle] - truth[angle]);
+	}
+	_nbErrors += FUSION_NB_ANGLES;
+}
+
+/**
+ * @brief Add an error to the statistics of an estimation
+ *
+ * @param errors Statistics of the estimation
+ * @param error Error (in degrees)
+ */
+static void addError(angleErrors_t* errors, double error){
+	errors->squares += error * error;
+	if(fabs(error) > errors->max)
+		errors->max = fabs(error);
+}
+#endif
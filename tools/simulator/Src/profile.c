@@ -0,0 +1,339 @@
+/**
+ * @file profile.c
+ * @brief Implement the acceleration profiles driving the ADXL345 model
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * A profile is either the replay of a capture, or a synthetic motion given as "name[:parameter,...]" :
+ * - still[:x_mg,y_mg,z_mg]						constant acceleration (default flat, 0,0,1000)
+ * - tilt:roll_deg[,pitch_deg]					constant tilt
+ * - sweep[:period_s,amplitude_deg]				sinusoidal rocking around the X axis (default 20 s, 45 degrees)
+ * - vibration[:frequency_hz,amplitude_mg]		flat, with a sinusoidal vibration on Z (default 10 Hz, 100 mg)
+ * - taps[:period_s,count,width_ms]				flat, with bursts of 4 g taps on Z, 150 ms apart (default 2 s, 1 tap, 10 ms)
+ * - boom[:period_s,amplitude_deg,length_m]		sinusoidal swing around the Y axis, at the end of an arm hanging from the pivot
+ * 												(default 2 s, 20 degrees, 1 m) : the tangential and centripetal accelerations
+ * 												add up to gravity, so that the accelerometer alone misreads the tilt
+ *
+ * A white gaussian noise and a linear offset drift can be added on each axis, whatever the profile.
+ * The noise generator is seeded identically at each run, so that two runs see the same samples.
+ *
+ * The profiles also give the angular rates seen by a gyroscope aligned with the accelerometer
+ * (the X axis angle turning at minus the Y axis rate), with a zero-rate level and a white noise,
+ * and the true angles of gravity, against which the angles estimated are compared.
+ * A capture has no known rates nor angles : the gyroscope then only measures its zero-rate level and noise.
+ */
+#include "profile.h"
+#include "simulator.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//definitions
+#define ONE_G_MG			1000.0		///< 1 g (in mg)
+#define UG_PER_MG			1000.0		///< Number of ug in a mg
+#define S_PER_H				3600.0		///< Number of seconds in an hour
+#define TAP_MG				4000.0		///< Acceleration of a tap (in mg)
+#define TAP_SPACING_S		0.150		///< Time between the taps of a burst (in s)
+#define MS_PER_S			1000.0		///< Number of ms in a second
+#define MDPS_PER_DPS		1000.0		///< Number of mdps in a dps
+#define GRAVITY_MS2			9.80665		///< Standard gravity (in m/s^2)
+#define RANDOM_SEED			0x9E3779B97F4A7C15ULL	///< Initial state of the noise generator
+#define RANDOM_MULTIPLIER	0x2545F4914F6CDD1DULL	///< xorshift64* output multiplier
+#define RANDOM_MANTISSA		11U			///< Number of bits dropped to get a 53 bits mantissa
+#define RANDOM_SCALE		(1.0 / 9007199254740992.0)	///< Scale of a 53 bits integer to [0, 1)
+
+/**
+ * @brief Structure describing a synthetic profile syntax
+ */
+typedef struct{
+	const char*	name;									///< Name given in the specification
+	uint8_t		nbRequired;								///< Number of parameters which must be given
+	double		defaults[PROFILE_NB_PARAMETERS];		///< Values of the parameters not given
+}profileSyntax_t;
+
+//tool functions
+static double randomGaussian(uint64_t* state);
+static double degreesToRadians(double degrees);
+static void swingAngles(const profile_t* profile, double time_s, double* angle, double* rate, double* acceleration);
+
+static const profileSyntax_t _syntaxes[NB_PROFILES] = {
+	[PROFILE_CAPTURE]	= {NULL,		0, {0}},
+	[PROFILE_STILL]		= {"still",		0, {0.0, 0.0, ONE_G_MG}},
+	[PROFILE_TILT]		= {"tilt",		1, {0.0, 0.0, 0.0}},
+	[PROFILE_SWEEP]		= {"sweep",		0, {20.0, 45.0, 0.0}},		// @suppress("Avoid magic numbers")
+	[PROFILE_VIBRATION]	= {"vibration",	0, {10.0, 100.0, 0.0}},		// @suppress("Avoid magic numbers")
+	[PROFILE_TAPS]		= {"taps",		0, {2.0, 1.0, 10.0}},		// @suppress("Avoid magic numbers")
+	[PROFILE_BOOM]		= {"boom",		0, {2.0, 20.0, 1.0}},		// @suppress("Avoid magic numbers")
+};
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Parse a synthetic profile specification
+ *
+ * @param[out] profile Profile (noise and drift disabled)
+ * @param specification Profile specification ("name[:parameter,...]")
+ * @retval 0 Success
+ * @retval -1 Unknown profile or invalid parameters
+ */
+int profileParse(profile_t* profile, const char* specification){
+	const char* parameters = strchr(specification, ':');
+	size_t nameLength = parameters ? (size_t)(parameters - specification) : strlen(specification);
+	uint8_t nbParameters = 0;
+
+	*profile = (profile_t){.random = RANDOM_SEED, .rateRandom = RANDOM_SEED};
+
+	for(uint8_t type = PROFILE_STILL ; type < NB_PROFILES ; type++){
+		if((strlen(_syntaxes[type].name) == nameLength) && !strncmp(specification, _syntaxes[type].name, nameLength))
+			profile->type = (profileType_e)type;
+	}
+	if(profile->type == PROFILE_CAPTURE){
+		fprintf(stderr, "%s : unknown profile\n", specification);
+		return (-1);
+	}
+	memcpy(profile->parameters, _syntaxes[profile->type].defaults, sizeof(profile->parameters));
+
+	//parameters, separated with commas
+	while(parameters && (nbParameters < PROFILE_NB_PARAMETERS)){
+		char* end;
+
+		profile->parameters[nbParameters++] = strtod(parameters + 1, &end);
+		if((end == parameters + 1) || ((*end != ',') && (*end != '\0'))){
+			fprintf(stderr, "%s : invalid parameter %u\n", specification, nbParameters);
+			return (-1);
+		}
+		parameters = (*end == ',') ? end : NULL;
+	}
+
+	if(parameters || (nbParameters < _syntaxes[profile->type].nbRequired)){
+		fprintf(stderr, "%s : wrong number of parameters\n", specification);
+		return (-1);
+	}
+	if(((profile->type == PROFILE_SWEEP) || (profile->type == PROFILE_TAPS) || (profile->type == PROFILE_BOOM)) && (profile->parameters[0] <= 0.0)){
+		fprintf(stderr, "%s : the period must be positive\n", specification);
+		return (-1);
+	}
+
+	return (0);
+}
+
+/**
+ * @brief Set a profile to replay a capture (noise and drift disabled)
+ *
+ * @param[out] profile Profile
+ * @param capture Capture to replay
+ */
+void profileSetCapture(profile_t* profile, const capture_t* capture){
+	*profile = (profile_t){.type = PROFILE_CAPTURE, .capture = capture, .random = RANDOM_SEED, .rateRandom = RANDOM_SEED};
+}
+
+/**
+ * @brief Acceleration source following a profile
+ *
+ * @param context Profile followed
+ * @param time_ns Simulated time of the sample (in ns)
+ * @param[out] acceleration_ug Acceleration on each axis (in ug)
+ */
+void profileSource(void* context, uint64_t time_ns, int32_t acceleration_ug[NB_AXIS]){
+	profile_t* profile = (profile_t*)context;
+	const double* parameters = profile->parameters;
+	double time_s = (double)time_ns / (double)SIM_NS_PER_S;
+	double acceleration_mg[NB_AXIS] = {0.0, 0.0, ONE_G_MG};
+	double roll, pitch, phase, angle, rate, angular;
+
+	switch(profile->type){
+		case PROFILE_CAPTURE:
+			captureReplay((void*)profile->capture, time_ns, acceleration_ug);
+			for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++)
+				acceleration_mg[axis] = acceleration_ug[axis] / UG_PER_MG;
+			break;
+
+		case PROFILE_STILL:
+			memcpy(acceleration_mg, parameters, sizeof(acceleration_mg));
+			break;
+
+		case PROFILE_TILT:
+		case PROFILE_SWEEP:
+			if(profile->type == PROFILE_TILT){
+				roll = degreesToRadians(parameters[0]);
+				pitch = degreesToRadians(parameters[1]);
+			}
+			else{
+				swingAngles(profile, time_s, &roll, NULL, NULL);
+				pitch = 0.0;
+			}
+			acceleration_mg[X_AXIS] = ONE_G_MG * sin(roll);
+			acceleration_mg[Y_AXIS] = ONE_G_MG * cos(roll) * sin(pitch);
+			acceleration_mg[Z_AXIS] = ONE_G_MG * cos(roll) * cos(pitch);
+			break;
+
+		case PROFILE_VIBRATION:
+			acceleration_mg[Z_AXIS] += parameters[1] * sin(2.0 * M_PI * parameters[0] * time_s);
+			break;
+
+		//taps in bursts starting at each period
+		case PROFILE_TAPS:
+			phase = fmod(time_s, parameters[0]);
+			for(uint32_t tap = 0 ; tap < (uint32_t)parameters[1] ; tap++){
+				double start_s = tap * TAP_SPACING_S;
+
+				if((phase >= start_s) && (phase < (start_s + (parameters[2] / MS_PER_S))))
+					acceleration_mg[Z_AXIS] = TAP_MG;
+			}
+			break;
+
+		//gravity, plus the tangential (X) and centripetal (Z) accelerations of the arm end
+		case PROFILE_BOOM:
+			swingAngles(profile, time_s, &angle, &rate, &angular);
+			acceleration_mg[X_AXIS] = ONE_G_MG * (sin(angle) + ((parameters[2] * angular) / GRAVITY_MS2));
+			acceleration_mg[Y_AXIS] = 0.0;
+			acceleration_mg[Z_AXIS] = ONE_G_MG * (cos(angle) + ((parameters[2] * rate * rate) / GRAVITY_MS2));
+			break;
+
+		case NB_PROFILES:
+		default:
+			break;
+	}
+
+	//sensor imperfections
+	for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++){
+		acceleration_mg[axis] += profile->drift_mg_per_h * (time_s / S_PER_H);
+		if(profile->noise_mg > 0.0)
+			acceleration_mg[axis] += profile->noise_mg * randomGaussian(&profile->random);
+
+		acceleration_ug[axis] = (int32_t)lround(acceleration_mg[axis] * UG_PER_MG);
+	}
+}
+
+/**
+ * @brief Angular rate source following a profile
+ * @details The profiles swinging around the Y axis turn at minus the X axis angle rate, the other ones do not turn
+ *
+ * @param context Profile followed
+ * @param time_ns Simulated time of the sample (in ns)
+ * @param[out] rate_mdps Angular rate around each axis (in mdps)
+ */
+void profileRateSource(void* context, uint64_t time_ns, int32_t rate_mdps[NB_AXIS]){
+	profile_t* profile = (profile_t*)context;
+	double time_s = (double)time_ns / (double)SIM_NS_PER_S;
+	double rate_dps[NB_AXIS] = {0.0, 0.0, 0.0};
+	double rate;
+
+	if((profile->type == PROFILE_SWEEP) || (profile->type == PROFILE_BOOM)){
+		swingAngles(profile, time_s, NULL, &rate, NULL);
+		rate_dps[Y_AXIS] = -(rate * 180.0) / M_PI;									// @suppress("Avoid magic numbers")
+	}
+
+	//sensor imperfections
+	for(uint8_t axis = 0 ; axis < NB_AXIS ; axis++){
+		rate_dps[axis] += profile->rateBias_dps;
+		if(profile->rateNoise_dps > 0.0)
+			rate_dps[axis] += profile->rateNoise_dps * randomGaussian(&profile->rateRandom);
+
+		rate_mdps[axis] = (int32_t)lround(rate_dps[axis] * MDPS_PER_DPS);
+	}
+}
+
+/**
+ * @brief Get the true angles of gravity, as computed in level mode (atan(X / Z) and atan(Y / Z))
+ *
+ * @param profile Profile followed
+ * @param time_ns Simulated time (in ns)
+ * @param[out] angles X and Y axis angles (in degrees)
+ * @retval 0 Success
+ * @retval -1 Angles unknown (capture replayed)
+ */
+int profileGetAngles(const profile_t* profile, uint64_t time_ns, double angles[PROFILE_NB_ANGLES]){
+	const double* parameters = profile->parameters;
+	double gravity[NB_AXIS] = {0.0, 0.0, 1.0};
+	double roll, pitch;
+
+	switch(profile->type){
+		case PROFILE_CAPTURE:
+			return (-1);
+
+		case PROFILE_STILL:
+			memcpy(gravity, parameters, sizeof(gravity));
+			break;
+
+		case PROFILE_TILT:
+			roll = degreesToRadians(parameters[0]);
+			pitch = degreesToRadians(parameters[1]);
+			gravity[X_AXIS] = sin(roll);
+			gravity[Y_AXIS] = cos(roll) * sin(pitch);
+			gravity[Z_AXIS] = cos(roll) * cos(pitch);
+			break;
+
+		case PROFILE_SWEEP:
+		case PROFILE_BOOM:
+			swingAngles(profile, (double)time_ns / (double)SIM_NS_PER_S, &roll, NULL, NULL);
+			gravity[X_AXIS] = sin(roll);
+			gravity[Z_AXIS] = cos(roll);
+			break;
+
+		case PROFILE_VIBRATION:
+		case PROFILE_TAPS:
+		case NB_PROFILES:
+		default:
+			break;
+	}
+
+	angles[0] = (atan(gravity[X_AXIS] / gravity[Z_AXIS]) * 180.0) / M_PI;			// @suppress("Avoid magic numbers")
+	angles[1] = (atan(gravity[Y_AXIS] / gravity[Z_AXIS]) * 180.0) / M_PI;			// @suppress("Avoid magic numbers")
+	return (0);
+}
+
+/**
+ * @brief Compute the angle of a swinging profile (period and amplitude as its first parameters), and its derivatives
+ *
+ * @param profile Profile followed
+ * @param time_s Simulated time (in s)
+ * @param[out] angle Angle (in radians, NULL if not needed)
+ * @param[out] rate Angle rate (in radians per second, NULL if not needed)
+ * @param[out] acceleration Angle acceleration (in radians per second squared, NULL if not needed)
+ */
+static void swingAngles(const profile_t* profile, double time_s, double* angle, double* rate, double* acceleration){
+	double pulsation = (2.0 * M_PI) / profile->parameters[0];
+	double amplitude = degreesToRadians(profile->parameters[1]);
+
+	if(angle)
+		*angle = amplitude * sin(pulsation * time_s);
+	if(rate)
+		*rate = amplitude * pulsation * cos(pulsation * time_s);
+	if(acceleration)
+		*acceleration = -amplitude * pulsation * pulsation * sin(pulsation * time_s);
+}
+
+/**
+ * @brief Draw a normally distributed number (Box-Muller transform on a xorshift64* generator)
+ *
+ * @param state Generator state
+ * @return Random number (mean 0, standard deviation 1)
+ */
+static double randomGaussian(uint64_t* state){
+	double uniform[2];
+
+	for(uint8_t i = 0 ; i < 2U ; i++){
+		*state ^= *state >> 12U;													// @suppress("Avoid magic numbers")
+		*state ^= *state << 25U;													// @suppress("Avoid magic numbers")
+		*state ^= *state >> 27U;													// @suppress("Avoid magic numbers")
+		uniform[i] = (double)((*state * RANDOM_MULTIPLIER) >> RANDOM_MANTISSA) * RANDOM_SCALE;
+	}
+
+	return (sqrt(-2.0 * log(1.0 - uniform[0])) * cos(2.0 * M_PI * uniform[1]));
+}
+
+/**
+ * @brief Convert an angle in degrees to radians
+ *
+ * @param degrees Angle (in degrees)
+ * @return Angle (in radians)
+ */
+static double degreesToRadians(double degrees){
+	return ((degrees * M_PI) / 180.0);												// @suppress("Avoid magic numbers")
+}
@@ -0,0 +1,495 @@
+/**
+ * @file simulator.c
+ * @brief Implement the simulator core : virtual clock, timers, interrupts, GPIO levels and SPI buses
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The firmware runs unmodified on the host, with a virtual clock which only advances when
+ * the firmware waits : SPI transfers advance it by their duration, and __WFI() jumps
+ * straight to the next timer expiry. The firmware code itself takes no simulated time,
+ * which is why a simulation runs much faster than real time.
+ *
+ * Interrupts are dispatched to the real handlers of stm32f1xx_it.c whenever they are pending,
+ * enabled and not masked by PRIMASK. They do not nest.
+ */
+#include "simulator.h"
+#include "stm32f1xx_it.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+//definitions
+#define MAX_TIMERS		16U		///< Maximum number of timers which can be armed at the same time
+#define MAX_WATCHES		8U		///< Maximum number of output pins watched
+#define MAX_DEVICES		4U		///< Maximum number of SPI devices attached
+#define NB_PORTS		2U		///< Number of GPIO ports simulated (A and B)
+#define EXTI_LINE0		0x0001U	///< Pin mask of the only EXTI line simulated
+
+/**
+ * @brief Structure holding a watch on an output pin
+ */
+typedef struct{
+	GPIO_TypeDef*		port;		///< Port of the pin watched
+	uint16_t			pin;		///< Pin watched
+	simPinCallback_t	callback;	///< Function called on a level change
+	void*				context;	///< Context given to the callback
+}pinWatch_t;
+
+/**
+ * @brief Structure holding a device attached to a SPI bus
+ */
+typedef struct{
+	const SPI_TypeDef*		bus;		///< SPI bus
+	GPIO_TypeDef*			csPort;		///< Port of the chip select pin
+	uint16_t				csPin;		///< Chip select pin
+	const simSPIdevice_t*	device;		///< Device callbacks
+	uint32_t				bytes;		///< Number of bytes exchanged with the device
+}spiSlot_t;
+
+//tool functions
+static void sysTickElapsed(void* context);
+static void chipSelectChanged(void* context, GPIO_PinState level);
+static void setTime(uint64_t time_ns);
+static void runTimers(uint64_t until_ns);
+static simTimer_t* nextTimer();
+static void dispatchIRQs();
+static uint16_t* portLevels(const GPIO_TypeDef* port);
+
+//peripherals registers
+SPI_TypeDef			simSPI1, simSPI2;
+GPIO_TypeDef		simGPIOA, simGPIOB;
+DMA_Channel_TypeDef	simDMA1channel1, simDMA1channel5;
+ADC_TypeDef			simADC1;
+DWT_Type			simDWT;
+CoreDebug_Type		simCoreDebug;
+SCB_Type			simSCB;
+SysTick_Type		simSysTick;
+
+//interrupts handlers, by simulated IRQ
+static void (* const _handlers[SIM_NB_IRQ])(void) = {
+	[SIM_IRQ_EXTI0] = EXTI0_IRQHandler,
+	[SIM_IRQ_DMA1_CH1] = DMA1_Channel1_IRQHandler,
+	[SIM_IRQ_DMA1_CH5] = DMA1_Channel5_IRQHandler,
+	[SIM_IRQ_SYSTICK] = SysTick_Handler,
+};
+
+//state variables
+static uint64_t		_now_ns = 0;					///< Simulated time (in ns)
+static uint64_t		_end_ns = UINT64_MAX;			///< Simulated time at which the simulation ends (in ns)
+static simCallback_t _onEnd = NULL;					///< Function called when the simulation ends
+static simTimer_t*	_timers[MAX_TIMERS];			///< Timers registered
+static uint8_t		_nbTimers = 0;					///< Number of timers registered
+static simTimer_t	_sysTick;						///< 1 ms system tick timer
+static uint32_t		_pending = 0;					///< Pending interrupts (bit n for simIRQ_e n)
+static uint32_t		_enabled = 1U << SIM_IRQ_SYSTICK;	///< Enabled interrupts (SysTick always enabled)
+static uint32_t		_primask = 0;					///< Interrupts masked if 1
+static uint32_t		_activeIRQ = 0;					///< Interrupt being serviced (simIRQ_e + 1), 0 in thread mode
+static uint16_t		_levels[NB_PORTS];				///< Pins levels, per port
+static uint16_t		_extiPins[NB_PORTS];			///< Pins configured as falling edge interrupts, per port
+static pinWatch_t	_watches[MAX_WATCHES];			///< Output pins watched
+static uint8_t		_nbWatches = 0;					///< Number of pins watched
+static spiSlot_t	_devices[MAX_DEVICES];			///< SPI devices attached
+static uint8_t		_nbDevices = 0;					///< Number of SPI devices attached
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Initialise the simulator core and start the system tick
+ *
+ * @param end_ns Simulated time at which the simulation ends (in ns)
+ * @param onEnd Function called when the simulation ends (must not return)
+ */
+void simInitialise(uint64_t end_ns, simCallback_t onEnd){
+	_end_ns = end_ns;
+	_onEnd = onEnd;
+
+	simSysTick.LOAD = (SIM_HCLK_HZ / 1000U) - 1U;	// @suppress("Avoid magic numbers")
+	simSysTick.VAL = simSysTick.LOAD;
+	_sysTick.callback = sysTickElapsed;
+	simTimerArm(&_sysTick, SIM_NS_PER_MS);
+}
+
+/**
+ * @brief Get the simulated time
+ *
+ * @return Simulated time (in ns)
+ */
+uint64_t simNow_ns(){
+	return (_now_ns);
+}
+
+/**
+ * @brief Let the simulated time flow while the firmware is busy (e.g. blocking SPI transfer)
+ * @note Interrupts raised in the meantime are serviced, as they would be on the target
+ *
+ * @param duration_ns Duration to let flow (in ns)
+ */
+void simAdvance_ns(uint64_t duration_ns){
+	uint64_t target_ns = _now_ns + duration_ns;
+
+	runTimers(target_ns);
+	setTime(target_ns);
+}
+
+/**
+ * @brief Arm a timer (registering it on its first use)
+ *
+ * @param timer Timer to arm
+ * @param due_ns Simulated time at which the timer expires (in ns)
+ */
+void simTimerArm(simTimer_t* timer, uint64_t due_ns){
+	uint8_t i;
+
+	for(i = 0 ; (i < _nbTimers) && (_timers[i] != timer) ; i++);
+	if(i == _nbTimers){
+		if(_nbTimers >= MAX_TIMERS){
+			fprintf(stderr, "simulator : too many timers\n");
+			exit(EXIT_FAILURE);
+		}
+		_timers[_nbTimers++] = timer;
+	}
+
+	timer->due_ns = due_ns;
+	timer->armed = 1;
+}
+
+/**
+ * @brief Cancel a timer
+ *
+ * @param timer Timer to cancel
+ */
+void simTimerCancel(simTimer_t* timer){
+	timer->armed = 0;
+}
+
+/**
+ * @brief Raise an interrupt, and service it right away if possible
+ *
+ * @param irq Interrupt to raise
+ */
+void simRaiseIRQ(simIRQ_e irq){
+	_pending |= 1U << irq;
+	if(irq == SIM_IRQ_SYSTICK)
+		simSCB.ICSR |= SCB_ICSR_PENDSTSET_Msk;
+	dispatchIRQs();
+}
+
+/**
+ * @brief Enable an interrupt in the NVIC
+ *
+ * @param irq Interrupt to enable
+ */
+void simEnableIRQ(simIRQ_e irq){
+	_enabled |= 1U << irq;
+}
+
+/**
+ * @brief Drive a pin (from the firmware or from a device), notifying the watchers and the EXTI
+ *
+ * @param port Port of the pin
+ * @param pin Pin to drive
+ * @param level Level driven
+ */
+void simPinDrive(GPIO_TypeDef* port, uint16_t pin, GPIO_PinState level){
+	uint16_t* levels = portLevels(port);
+	uint16_t previous;
+
+	if(!levels)
+		return;
+
+	previous = *levels;
+	if(level == GPIO_PIN_SET)
+		*levels |= pin;
+	else
+		*levels &= (uint16_t)~pin;
+	port->IDR = *levels;
+	port->ODR = *levels;
+
+	if(previous == *levels)
+		return;
+
+	for(uint8_t i = 0 ; i < _nbWatches ; i++){
+		if((_watches[i].port == port) && (_watches[i].pin & pin))
+			(*_watches[i].callback)(_watches[i].context, level);
+	}
+
+	//falling edge on an EXTI pin
+	if((level == GPIO_PIN_RESET) && (pin & EXTI_LINE0) && (_extiPins[port == GPIOB] & pin))
+		simRaiseIRQ(SIM_IRQ_EXTI0);
+}
+
+/**
+ * @brief Read the level of a pin
+ *
+ * @param port Port of the pin
+ * @param pin Pin to read
+ * @return Level of the pin
+ */
+GPIO_PinState simPinRead(const GPIO_TypeDef* port, uint16_t pin){
+	const uint16_t* levels = portLevels(port);
+
+	return ((levels && (*levels & pin)) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+/**
+ * @brief Watch the changes of a pin level
+ *
+ * @param port Port of the pin
+ * @param pin Pin to watch
+ * @param callback Function called on a level change
+ * @param context Context given to the callback
+ */
+void simPinWatch(GPIO_TypeDef* port, uint16_t pin, simPinCallback_t callback, void* context){
+	if(_nbWatches >= MAX_WATCHES){
+		fprintf(stderr, "simulator : too many pins watched\n");
+		exit(EXIT_FAILURE);
+	}
+
+	_watches[_nbWatches++] = (pinWatch_t){port, pin, callback, context};
+}
+
+/**
+ * @brief Configure a pin as a falling edge interrupt
+ *
+ * @param port Port of the pin
+ * @param pin Pin to configure
+ */
+void simPinSetEXTI(GPIO_TypeDef* port, uint16_t pin){
+	if(portLevels(port))
+		_extiPins[port == GPIOB] |= pin;
+}
+
+/**
+ * @brief Attach a device to a SPI bus
+ *
+ * @param bus SPI bus
+ * @param csPort Port of the device chip select pin
+ * @param csPin Device chip select pin (active low)
+ * @param device Device callbacks
+ */
+void simSPIattach(const SPI_TypeDef* bus, GPIO_TypeDef* csPort, uint16_t csPin, const simSPIdevice_t* device){
+	spiSlot_t* slot;
+
+	if(_nbDevices >= MAX_DEVICES){
+		fprintf(stderr, "simulator : too many SPI devices\n");
+		exit(EXIT_FAILURE);
+	}
+
+	slot = &_devices[_nbDevices++];
+	*slot = (spiSlot_t){bus, csPort, csPin, device, 0};
+	simPinWatch(csPort, csPin, chipSelectChanged, slot);
+}
+
+/**
+ * @brief Clock a byte on a SPI bus, with the device currently selected
+ *
+ * @param bus SPI bus
+ * @param mosi Byte sent by the MCU
+ * @return Byte sent by the device (0xFF if none selected)
+ */
+uint8_t simSPIexchange(const SPI_TypeDef* bus, uint8_t mosi){
+	for(uint8_t i = 0 ; i < _nbDevices ; i++){
+		spiSlot_t* slot = &_devices[i];
+
+		if((slot->bus == bus) && (simPinRead(slot->csPort, slot->csPin) == GPIO_PIN_RESET)){
+			slot->bytes++;
+			return ((*slot->device->exchange)(slot->device->context, mosi));
+		}
+	}
+
+	return (0xFFU);	// @suppress("Avoid magic numbers")
+}
+
+/**
+ * @brief Get the number of bytes exchanged with the devices of a SPI bus
+ *
+ * @param bus SPI bus
+ * @return Number of bytes
+ */
+uint32_t simSPIgetBytes(const SPI_TypeDef* bus){
+	uint32_t bytes = 0;
+
+	for(uint8_t i = 0 ; i < _nbDevices ; i++){
+		if(_devices[i].bus == bus)
+			bytes += _devices[i].bytes;
+	}
+
+	return (bytes);
+}
+
+/**
+ * @brief Sleep until an interrupt is pending
+ * @note As on the target, a pending interrupt wakes the core up even if masked
+ */
+void __WFI(void){
+	simTimer_t* timer;
+
+	while(!(_pending & _enabled)){
+		timer = nextTimer();
+		if(!timer){
+			fprintf(stderr, "simulator : sleeping with nothing left to wake up\n");
+			(*_onEnd)(NULL);
+		}
+		runTimers(timer->due_ns);
+	}
+}
+
+/**
+ * @brief Mask the interrupts
+ */
+void __disable_irq(void){
+	_primask = 1;
+}
+
+/**
+ * @brief Unmask the interrupts, servicing the pending ones
+ */
+void __enable_irq(void){
+	_primask = 0;
+	dispatchIRQs();
+}
+
+/**
+ * @brief Get the interrupts mask
+ *
+ * @return 1 if the interrupts are masked
+ */
+uint32_t __get_PRIMASK(void){
+	return (_primask);
+}
+
+/**
+ * @brief Set the interrupts mask
+ *
+ * @param priMask 1 to mask the interrupts
+ */
+void __set_PRIMASK(uint32_t priMask){
+	_primask = priMask & 1U;
+	dispatchIRQs();
+}
+
+/**
+ * @brief Get the interrupt being serviced
+ *
+ * @return 0 in thread mode, non-zero in an interrupt handler
+ */
+uint32_t __get_IPSR(void){
+	return (_activeIRQ);
+}
+
+/**
+ * @brief Raise the system tick interrupt and re-arm its timer
+ *
+ * @param context Unused
+ */
+static void sysTickElapsed(void* context){
+	(void)context;
+
+	simTimerArm(&_sysTick, _sysTick.due_ns + SIM_NS_PER_MS);
+	simRaiseIRQ(SIM_IRQ_SYSTICK);
+}
+
+/**
+ * @brief Forward a chip select change to the device attached
+ *
+ * @param context SPI slot of the device
+ * @param level New chip select level
+ */
+static void chipSelectChanged(void* context, GPIO_PinState level){
+	const spiSlot_t* slot = (const spiSlot_t*)context;
+
+	if(slot->device->select)
+		(*slot->device->select)(slot->device->context, (level == GPIO_PIN_RESET));
+}
+
+/**
+ * @brief Move the simulated time forward, update the timing registers and end the simulation if over
+ *
+ * @param time_ns New simulated time (in ns)
+ */
+static void setTime(uint64_t time_ns){
+	uint64_t cycles;
+
+	if(time_ns < _now_ns)
+		return;
+	_now_ns = time_ns;
+
+	//core cycles counter and system tick down-counter
+	cycles = (_now_ns * SIM_CYCLES_PER_US) / SIM_NS_PER_US;
+	simDWT.CYCCNT = (uint32_t)cycles;
+	simSysTick.VAL = simSysTick.LOAD - (uint32_t)(cycles % (simSysTick.LOAD + 1U));
+
+	if((_now_ns >= _end_ns) && _onEnd)
+		(*_onEnd)(NULL);
+}
+
+/**
+ * @brief Expire all the timers due until a simulated time, in chronological order
+ *
+ * @param until_ns Simulated time until which expire the timers (in ns)
+ */
+static void runTimers(uint64_t until_ns){
+	simTimer_t* timer;
+
+	while((timer = nextTimer()) && (timer->due_ns <= until_ns)){
+		setTime(timer->due_ns);
+		timer->armed = 0;
+		(*timer->callback)(timer->context);
+		dispatchIRQs();
+	}
+}
+
+/**
+ * @brief Find the timer expiring first
+ *
+ * @return Timer expiring first (NULL if none armed)
+ */
+static simTimer_t* nextTimer(){
+	simTimer_t* first = NULL;
+
+	for(uint8_t i = 0 ; i < _nbTimers ; i++){
+		if(_timers[i]->armed && (!first || (_timers[i]->due_ns < first->due_ns)))
+			first = _timers[i];
+	}
+
+	return (first);
+}
+
+/**
+ * @brief Service the pending interrupts, by priority, unless masked or already in an interrupt
+ */
+static void dispatchIRQs(){
+	uint32_t serviceable;
+	uint32_t irq;
+
+	if(_primask || _activeIRQ)
+		return;
+
+	while((serviceable = _pending & _enabled)){
+		irq = (uint32_t)__builtin_ctz(serviceable);
+		_pending &= ~(1U << irq);
+		if(irq == SIM_IRQ_SYSTICK)
+			simSCB.ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+
+		_activeIRQ = irq + 1U;
+		(*_handlers[irq])();
+		_activeIRQ = 0;
+	}
+}
+
+/**
+ * @brief Get the levels of the pins of a port
+ *
+ * @param port GPIO port
+ * @return Pins levels (NULL if port not simulated)
+ */
+static uint16_t* portLevels(const GPIO_TypeDef* port){
+	if(port == GPIOA)
+		return (&_levels[0]);
+	if(port == GPIOB)
+		return (&_levels[1]);
+	return (NULL);
+}
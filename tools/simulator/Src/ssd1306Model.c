@@ -0,0 +1,525 @@
+/**
+ * @file ssd1306Model.c
+ * @brief Implement a model of the SSD1306 screen and its GDDRAM, attached to the simulated SPI bus
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * The D/C pin level tells the command bytes from the data bytes.
+ * Commands are decoded with their parameters (as listed in the datasheet command table),
+ * and data bytes are written in the 128 x 64 GDDRAM following the addressing mode
+ * (horizontal, vertical or page) and the column/page windows.
+ * As on the device, the segment remap only affects the data written after it,
+ * while the scan direction, start line, offset, inversion and display on/off apply to the whole panel.
+ *
+ * A frame ends when the chip select is released after data bytes, or after a command changing the display.
+ * Each frame is reported to the frame handler with the bytes received since the previous one.
+ *
+ * The panel is rendered as seen on the usual modules, which are wired so that the orientation set
+ * by the driver (segment remap to 127, scan from COM63) shows the column 0 of page 0 at the top left.
+ * The COM pins hardware configuration and the scrolling are not modelled.
+ *
+ * The model can also behave as an SH1106, which shares most of the commands but has 132 columns
+ * (the 128 visible ones starting at column 2), no horizontal or vertical addressing mode,
+ * and a DC-DC control command instead of the charge pump one.
+ *
+ * @note Datasheet : https://cdn-shop.adafruit.com/datasheets/SSD1306.pdf
+ * @note Datasheet : https://www.velleman.eu/downloads/29/infosheets/sh1106_datasheet.pdf
+ */
+#include "ssd1306Model.h"
+#include "SSD1306_registers.h"
+#include <string.h>
+
+//definitions
+#define NB_PAGES			8U			///< Number of GDDRAM pages
+#define NB_COLUMNS			128U		///< Number of GDDRAM columns (segments)
+#define SH_NB_COLUMNS		132U		///< Number of SH1106 display RAM columns
+#define SH_FIRST_VISIBLE	2U			///< First SH1106 segment wired to the panel
+#define SH_DC_DC_CONTROL	0xADU		///< SH1106 DC-DC control command (one parameter)
+#define NB_ROWS				64U			///< Number of GDDRAM rows (COM lines)
+#define PAGE_ROWS			8U			///< Number of rows in a page
+#define MAX_PARAMETERS		6U			///< Highest number of parameters of a command
+#define COLUMN_MASK			0x7FU		///< Column address bits
+#define PAGE_MASK			0x07U		///< Page address bits
+#define ROW_MASK			0x3FU		///< Row address bits (start line, offset, multiplex ratio)
+#define NIBBLE_MASK			0x0FU		///< Column nibble bits of the page addressing mode commands
+#define NIBBLE_SHIFT		4U			///< Shift of the high column nibble
+#define ADDR_MODE_MASK		0x03U		///< Addressing mode bits
+#define ADDR_MODE_INVALID	0x03U		///< Invalid addressing mode value
+#define BYTE_BITS			8U			///< Number of bits in a byte
+
+//SPI device callbacks
+static void selectChanged(void* context, uint8_t selected);
+static uint8_t exchangeByte(void* context, uint8_t mosi);
+
+//tool functions
+static void resetChanged(void* context, GPIO_PinState level);
+static void resetRegisters();
+static void receiveCommand(uint8_t byte);
+static uint8_t nbParameters(uint8_t command);
+static uint8_t isSSD1306only(uint8_t command);
+static void executeCommand();
+static void writeData(uint8_t byte);
+static uint8_t isPixelLit(uint8_t x, uint8_t y);
+
+//global variables
+const simSPIdevice_t ssd1306ModelDevice = {selectChanged, exchangeByte, NULL};	///< SPI device callbacks of the model
+
+//state variables
+static GPIO_TypeDef*			_dcPort = NULL;					///< Port of the D/C pin
+static uint16_t					_dcPin = 0;						///< D/C pin (low for commands, high for data)
+static ssd1306Controller_e		_controller = MODEL_SSD1306;	///< Controller modelled
+static uint8_t					_nbColumns = NB_COLUMNS;		///< Number of RAM columns of the controller
+static uint8_t					_firstVisible = 0;				///< First segment wired to the panel
+static uint8_t					_ram[NB_PAGES][SH_NB_COLUMNS];	///< GDDRAM, indexed by page then segment
+static uint8_t					_addressingMode;				///< Memory addressing mode
+static uint8_t					_columnStart;					///< First column of the window (horizontal and vertical modes)
+static uint8_t					_columnEnd;						///< Last column of the window (horizontal and vertical modes)
+static uint8_t					_pageStart;						///< First page of the window (horizontal and vertical modes)
+static uint8_t					_pageEnd;						///< Last page of the window (horizontal and vertical modes)
+static uint8_t					_column;						///< Column address pointer
+static uint8_t					_page;							///< Page address pointer
+static uint8_t					_segmentRemap;					///< 1 if the column 127 is mapped to SEG0
+static uint8_t					_scanReversed;					///< 1 if the COM lines are scanned from COM[N-1] to COM0
+static uint8_t					_startLine;						///< Display start line
+static uint8_t					_offset;						///< Display offset
+static uint8_t					_multiplexRatio;				///< Multiplex ratio (number of COM lines - 1)
+static uint8_t					_inverted;						///< 1 if the display is inverted
+static uint8_t					_allOn;							///< 1 if the display ignores the RAM content
+static uint8_t					_displayOn;						///< 1 if the display is on
+static uint8_t					_command = 0;					///< Command waiting for its parameters
+static uint8_t					_parameters[MAX_PARAMETERS];	///< Parameters of the command received so far
+static uint8_t					_nbExpected = 0;				///< Number of parameters still expected by the command
+static uint8_t					_nbReceived = 0;				///< Number of parameters received for the command
+static uint8_t					_dataReceived = 0;				///< 1 if data bytes have been received since the chip select was asserted
+static uint8_t					_displayChanged = 0;			///< 1 if a command has changed the display since the last frame
+static ssd1306Frame_t			_frame;							///< Frame in progress
+static ssd1306FrameHandler_t	_handler = NULL;				///< Frame handler (NULL if none)
+static void*					_handlerContext = NULL;			///< Frame handler context
+static ssd1306ModelStats_t		_stats;							///< Model statistics
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Initialise the model at its reset state
+ *
+ * @param controller Controller to behave as
+ * @param dcPort Port of the pin connected to D/C
+ * @param dcPin Pin connected to D/C
+ * @param resetPort Port of the pin connected to RES#
+ * @param resetPin Pin connected to RES#
+ */
+void ssd1306ModelInitialise(ssd1306Controller_e controller, GPIO_TypeDef* dcPort, uint16_t dcPin, GPIO_TypeDef* resetPort, uint16_t resetPin){
+	_dcPort = dcPort;
+	_dcPin = dcPin;
+	_controller = controller;
+	_nbColumns = ((controller == MODEL_SH1106) ? SH_NB_COLUMNS : NB_COLUMNS);
+	_firstVisible = ((controller == MODEL_SH1106) ? SH_FIRST_VISIBLE : 0);
+
+	resetRegisters();
+	simPinWatch(resetPort, resetPin, resetChanged, NULL);
+}
+
+/**
+ * @brief Set the function called at the end of each frame
+ *
+ * @param handler Frame handler (NULL to disable)
+ * @param context Frame handler context
+ */
+void ssd1306ModelSetFrameHandler(ssd1306FrameHandler_t handler, void* context){
+	_handler = handler;
+	_handlerContext = context;
+}
+
+/**
+ * @brief Render the panel as currently displayed
+ *
+ * @param[out] image Panel image
+ */
+void ssd1306ModelRender(image_t* image){
+	memset(image, 0, sizeof(*image));
+
+	for(uint8_t y = 0 ; y < IMAGE_HEIGHT ; y++){
+		for(uint8_t x = 0 ; x < IMAGE_WIDTH ; x++){
+			if(isPixelLit(x, y))
+				image->rows[y][x / BYTE_BITS] |= (uint8_t)(0x80U >> (x % BYTE_BITS));	// @suppress("Avoid magic numbers")
+		}
+	}
+}
+
+/**
+ * @brief Get the statistics of the model
+ *
+ * @param[out] stats Statistics
+ */
+void ssd1306ModelGetStats(ssd1306ModelStats_t* stats){
+	*stats = _stats;
+}
+
+/**
+ * @brief Chip select change : end the frame if data has been received or the display changed
+ *
+ * @param context Unused
+ * @param selected 1 if the chip select has been asserted
+ */
+static void selectChanged(void* context, uint8_t selected){
+	uint32_t frameBytes;
+	(void)context;
+
+	if(selected || (!_dataReceived && !_displayChanged))
+		return;
+
+	if(_dataReceived)
+		_stats.nbTransfers++;
+	_dataReceived = 0;
+	_displayChanged = 0;
+
+	//report the frame, then start the next one
+	frameBytes = _frame.commandBytes + _frame.dataBytes;
+	if(frameBytes > _stats.maxFrameBytes)
+		_stats.maxFrameBytes = frameBytes;
+	_stats.nbFrames++;
+
+	_frame.time_ns = simNow_ns();
+	if(_handler)
+		(*_handler)(_handlerContext, &_frame);
+
+	_frame = (ssd1306Frame_t){.index = _frame.index + 1U};
+}
+
+/**
+ * @brief Receive a byte, as a command or as data depending on the D/C pin
+ *
+ * @param context Unused
+ * @param mosi Byte received
+ * @return 0 (the screen does not send anything back)
+ */
+static uint8_t exchangeByte(void* context, uint8_t mosi){
+	(void)context;
+
+	if(simPinRead(_dcPort, _dcPin) == GPIO_PIN_SET){
+		_stats.dataBytes++;
+		_frame.dataBytes++;
+		_dataReceived = 1;
+		writeData(mosi);
+	}
+	else{
+		_stats.commandBytes++;
+		_frame.commandBytes++;
+		receiveCommand(mosi);
+	}
+
+	return (0);
+}
+
+/**
+ * @brief RES# pin change : reset the registers while low (the GDDRAM content is kept)
+ *
+ * @param context Unused
+ * @param level RES# level
+ */
+static void resetChanged(void* context, GPIO_PinState level){
+	(void)context;
+
+	if(level == GPIO_PIN_RESET)
+		resetRegisters();
+}
+
+/**
+ * @brief Set the registers to their reset values
+ */
+static void resetRegisters(){
+	_addressingMode = SSD_PAGE_ADDR;
+	_columnStart = 0;
+	_columnEnd = NB_COLUMNS - 1U;
+	_pageStart = 0;
+	_pageEnd = NB_PAGES - 1U;
+	_column = 0;
+	_page = 0;
+	_segmentRemap = 0;
+	_scanReversed = 0;
+	_startLine = SSD_START_LINE_0;
+	_offset = SSD_OFFSET_0;
+	_multiplexRatio = SSD_MUX_RATIO_64;
+	_inverted = 0;
+	_allOn = 0;
+	_displayOn = 0;
+	_nbExpected = 0;
+	_displayChanged = 1;
+}
+
+/**
+ * @brief Receive a command byte, either a new command or one of its parameters
+ *
+ * @param byte Byte received
+ */
+static void receiveCommand(uint8_t byte){
+	//parameter of the command in progress
+	if(_nbExpected){
+		_parameters[_nbReceived++] = byte;
+		if(!--_nbExpected)
+			executeCommand();
+		return;
+	}
+
+	//new command
+	_command = byte;
+	_nbReceived = 0;
+	_nbExpected = nbParameters(byte);
+	if(!_nbExpected)
+		executeCommand();
+}
+
+/**
+ * @brief Get the number of parameters following a command
+ *
+ * @param command Command byte
+ * @return Number of parameters
+ */
+static uint8_t nbParameters(uint8_t command){
+	//the SH1106 adds the DC-DC control, and lacks the commands listed in isSSD1306only()
+	if(_controller == MODEL_SH1106){
+		if(command == SH_DC_DC_CONTROL)
+			return (1);
+		if(isSSD1306only(command))
+			return (0);
+	}
+
+	switch(command){
+		case MEMORY_ADDR_MODE:
+		case CONTRAST_CONTROL:
+		case CHG_PUMP_REGULATOR:
+		case MUX_RATIO:
+		case DISPLAY_OFFSET:
+		case CLOCK_DIVIDE_RATIO:
+		case PRECHARGE_PERIOD:
+		case HARDWARE_CONFIG:
+		case VCOMH_DESELECT_LVL:
+			return (1);
+
+		case COLUMN_ADDRESS:
+		case PAGE_ADDRESS:
+		case SCROLL_VER_AREA:
+			return (2);																// @suppress("Avoid magic numbers")
+
+		case SCROLL_BOTH_RIGHT:
+		case SCROLL_BOTH_LEFT:
+			return (5);																// @suppress("Avoid magic numbers")
+
+		case SCROLL_HOR_RIGHT:
+		case SCROLL_HOR_LEFT:
+			return (6);																// @suppress("Avoid magic numbers")
+
+		default:
+			return (0);
+	}
+}
+
+/**
+ * @brief Check whether a command only exists on the SSD1306 (addressing windows, charge pump, scrolling)
+ *
+ * @param command Command byte
+ * @return 1 if the SH1106 does not have the command
+ */
+static uint8_t isSSD1306only(uint8_t command){
+	switch(command){
+		case MEMORY_ADDR_MODE:
+		case COLUMN_ADDRESS:
+		case PAGE_ADDRESS:
+		case CHG_PUMP_REGULATOR:
+		case SCROLL_HOR_RIGHT:
+		case SCROLL_HOR_LEFT:
+		case SCROLL_BOTH_RIGHT:
+		case SCROLL_BOTH_LEFT:
+		case SCROLL_DISABLE:
+		case SCROLL_ENABLE:
+		case SCROLL_VER_AREA:
+			return (1);
+
+		default:
+			return (0);
+	}
+}
+
+/**
+ * @brief Execute the command received, with its parameters
+ */
+static void executeCommand(){
+	//commands carrying their value in the command byte
+	if(_command < HIGH_COL_START_ADDR){
+		_column = (uint8_t)((_column & ~NIBBLE_MASK) | (_command & NIBBLE_MASK));
+		return;
+	}
+	if(_command < MEMORY_ADDR_MODE){
+		_column = (uint8_t)(((_command & NIBBLE_MASK) << NIBBLE_SHIFT) | (_column & NIBBLE_MASK));
+		return;
+	}
+
+	//controller specific commands
+	if(_controller == MODEL_SH1106){
+		if(_command == SH_DC_DC_CONTROL)
+			return;
+		if(isSSD1306only(_command)){
+			_stats.unknownCommands++;
+			return;
+		}
+	}
+	if((_command >= DISPLAY_START_LINE) && (_command < CONTRAST_CONTROL)){
+		_startLine = _command & ROW_MASK;
+		_displayChanged = 1;
+		return;
+	}
+	if((_command >= ADDR_MODE_PAGESTART) && (_command <= (ADDR_MODE_PAGESTART | PAGE_MASK))){
+		_page = _command & PAGE_MASK;
+		return;
+	}
+
+	switch(_command){
+		case MEMORY_ADDR_MODE:
+			if((_parameters[0] & ADDR_MODE_MASK) != ADDR_MODE_INVALID)
+				_addressingMode = _parameters[0] & ADDR_MODE_MASK;
+			break;
+
+		case COLUMN_ADDRESS:
+			_columnStart = _parameters[0] & COLUMN_MASK;
+			_columnEnd = _parameters[1] & COLUMN_MASK;
+			_column = _columnStart;
+			break;
+
+		case PAGE_ADDRESS:
+			_pageStart = _parameters[0] & PAGE_MASK;
+			_pageEnd = _parameters[1] & PAGE_MASK;
+			_page = _pageStart;
+			break;
+
+		case SEGMENT_REMAP_0:
+		case SEGMENT_REMAP_127:
+			_segmentRemap = (_command == SEGMENT_REMAP_127);
+			break;
+
+		case SCAN_DIRECTION_0_N1:
+		case SCAN_DIRECTION_N1_0:
+			_scanReversed = (_command == SCAN_DIRECTION_N1_0);
+			_displayChanged = 1;
+			break;
+
+		case DISPLAY_OFFSET:
+			_offset = _parameters[0] & ROW_MASK;
+			_displayChanged = 1;
+			break;
+
+		case MUX_RATIO:
+			_multiplexRatio = _parameters[0] & ROW_MASK;
+			_displayChanged = 1;
+			break;
+
+		case DISPLAY_FOLLOW_RAM:
+		case DISPLAY_ALL_ON:
+			_allOn = (_command == DISPLAY_ALL_ON);
+			_displayChanged = 1;
+			break;
+
+		case DISPLAY_NORMAL:
+		case DISPLAY_INVERSE:
+			_inverted = (_command == DISPLAY_INVERSE);
+			_displayChanged = 1;
+			break;
+
+		case DISPLAY_OFF:
+		case DISPLAY_ON:
+			_displayOn = (_command == DISPLAY_ON);
+			_displayChanged = 1;
+			break;
+
+		//commands without effect on the image
+		case CONTRAST_CONTROL:
+		case CHG_PUMP_REGULATOR:
+		case CLOCK_DIVIDE_RATIO:
+		case PRECHARGE_PERIOD:
+		case HARDWARE_CONFIG:
+		case VCOMH_DESELECT_LVL:
+		case SCROLL_HOR_RIGHT:
+		case SCROLL_HOR_LEFT:
+		case SCROLL_BOTH_RIGHT:
+		case SCROLL_BOTH_LEFT:
+		case SCROLL_DISABLE:
+		case SCROLL_ENABLE:
+		case SCROLL_VER_AREA:
+		case NOP:
+			break;
+
+		default:
+			_stats.unknownCommands++;
+			break;
+	}
+}
+
+/**
+ * @brief Write a data byte in the GDDRAM and move the address pointers
+ *
+ * @param byte Data byte (8 vertical pixels, LSB on top)
+ */
+static void writeData(uint8_t byte){
+	uint8_t segment;
+
+	//the nibbles are latched separately, the column address is only bound once both are set
+	_column = (uint8_t)(_column % _nbColumns);
+	segment = (_segmentRemap ? (uint8_t)(_nbColumns - 1U - _column) : _column);
+
+	_ram[_page][segment] = byte;
+
+	switch(_addressingMode){
+		case SSD_HORIZONTAL_ADDR:
+			if(_column < _columnEnd){
+				_column++;
+				break;
+			}
+			_column = _columnStart;
+			_page = ((_page < _pageEnd) ? (uint8_t)(_page + 1U) : _pageStart);
+			break;
+
+		case SSD_VERTICAL_ADDR:
+			if(_page < _pageEnd){
+				_page++;
+				break;
+			}
+			_page = _pageStart;
+			_column = ((_column < _columnEnd) ? (uint8_t)(_column + 1U) : _columnStart);
+			break;
+
+		//page addressing mode : the column pointer wraps within the page
+		default:
+			_column = (uint8_t)((_column + 1U) % _nbColumns);
+			break;
+	}
+}
+
+/**
+ * @brief Check whether a pixel of the panel is lit
+ *
+ * @param x Pixel column, from the left
+ * @param y Pixel row, from the top
+ * @return 1 if lit
+ */
+static uint8_t isPixelLit(uint8_t x, uint8_t y){
+	uint8_t segment = (uint8_t)(_firstVisible + COLUMN_MASK - x);
+	uint8_t com = (uint8_t)(ROW_MASK - y);
+	uint8_t scanned;
+	uint8_t row;
+
+	if(!_displayOn)
+		return (0);
+	if(_allOn)
+		return (1);
+
+	//COM line driven at this position, then GDDRAM row shown on it
+	scanned = (_scanReversed ? (uint8_t)(_multiplexRatio - com) : com);
+	if(com > _multiplexRatio)
+		return (0);
+
+	row = (uint8_t)(scanned + _startLine + _offset) & ROW_MASK;
+	return ((uint8_t)(((_ram[row / PAGE_ROWS][segment] >> (row % PAGE_ROWS)) & 1U) ^ _inverted));
+}
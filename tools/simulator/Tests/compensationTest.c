@@ -0,0 +1,185 @@
+/**
+ * @file compensationTest.c
+ * @brief Check the offsets temperature compensation against synthetic drift data
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Each axis offset drifts with the temperature following a known law (linear or quadratic).
+ * The calibration procedure is replayed as on the device : at each calibration temperature,
+ * the compensation is updated, the flat measurement is compensated with the offsets applied
+ * (noise and rounding included), and the result is calibrated against the flat orientation.
+ * The temperature is then swept, and the offsets interpolated are compared to the true drift :
+ * - inside the calibrated range, the error must stay within the interpolation bound of the law
+ * - outside of it, the closest calibrated entry must be applied as-is
+ *
+ * The settings flash page is replaced by the RAM page of flashStandin.c, so the table saved can be reloaded and compared.
+ */
+#include "hostTest.h"
+#include "flashStandin.h"
+#include "compensation.h"
+#include "settings.h"
+#include "sensor.h"
+#include "main.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+//definitions
+#define ONE_G_LSB			256			///< Gravity measured on Z (in LSB)
+#define NB_CALIBRATIONS		5U			///< Number of temperatures calibrated
+#define SWEEP_FIRST_DC		(-150)		///< First temperature of the sweep (in tenths of degrees)
+#define SWEEP_LAST_DC		450			///< Last temperature of the sweep (in tenths of degrees)
+#define SWEEP_STEP_DC		5			///< Temperature step of the sweep (in tenths of degrees)
+#define NOISE_LSB			0.5			///< Peak noise left on the averaged calibration measurement (in LSB)
+#define MAX_LINEAR_ERROR	1.5			///< Highest error accepted on a linear drift (noise and two roundings, in LSB)
+#define MAX_QUADRATIC_ERROR	3.5			///< Highest error accepted on a quadratic drift (interpolation bound of 1.9 LSB, plus the linear one)
+
+/**
+ * @brief Structure describing the offset drift law of an axis (offset = base + slope * T + curvature * T²)
+ */
+typedef struct{
+	double	base;		///< Offset at 0 degrees (in LSB)
+	double	slope;		///< Linear drift (in LSB per degree)
+	double	curvature;	///< Quadratic drift (in LSB per squared degree)
+}drift_t;
+
+//tool functions
+static double trueOffset(const drift_t* drift, int16_t temperature_dC);
+static void calibrate(const drift_t drifts[COMPENSATION_NB_AXIS]);
+static void checkSweep(const char* law, const drift_t drifts[COMPENSATION_NB_AXIS], double maxError);
+
+/**
+ * @brief Temperatures at which the calibration is replayed (in tenths of degrees, not centred on the table entries)
+ */
+static const int16_t calibrationTemperatures_dC[NB_CALIBRATIONS] = {-80, 30, 120, 240, 370};
+
+/**
+ * @brief Linear drift laws, per axis (about 0.8 mg per degree on X, at 3.9 mg per LSB)
+ */
+static const drift_t linearDrifts[COMPENSATION_NB_AXIS] = {
+	{  3.0,	 0.20,	0.0},
+	{ -5.0,	-0.12,	0.0},
+	{  8.0,	 0.35,	0.0},
+};
+
+/**
+ * @brief Quadratic drift laws, per axis (interpolation error between entries 13 degrees apart up to 1.9 LSB)
+ */
+static const drift_t quadraticDrifts[COMPENSATION_NB_AXIS] = {
+	{ -2.0,	 0.10,	 0.040},
+	{  4.0,	-0.30,	-0.030},
+	{  0.0,	 0.25,	 0.045},
+};
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+int main(){
+	int16_t offsets[COMPENSATION_NB_AXIS];
+	int16_t saved[COMPENSATION_NB_AXIS];
+
+	//without any calibration, no offset is applied
+	flashStandinErase();
+	settingsInitialise();
+	compensationUpdate(250, offsets);	// @suppress("Avoid magic numbers")
+	testCheckInteger("uncalibrated.calibrated", compensationGetNbCalibrated(), 0);
+	testCheckInteger("uncalibrated.offset_z", offsets[Z_AXIS], 0);
+
+	//linear drift
+	calibrate(linearDrifts);
+	testCheckInteger("linear.calibrated", compensationGetNbCalibrated(), NB_CALIBRATIONS);
+	checkSweep("linear", linearDrifts, MAX_LINEAR_ERROR);
+
+	//the table saved in flash gives the same offsets once reloaded
+	compensationUpdate(180, saved);		// @suppress("Avoid magic numbers")
+	memset(settingsGet(), 0, sizeof(settings_t));
+	testCheckInteger("linear.reloaded.success", IS_SUCCESS(settingsInitialise()), 1);
+	compensationUpdate(180, offsets);	// @suppress("Avoid magic numbers")
+	for(uint8_t axis = 0 ; axis < COMPENSATION_NB_AXIS ; axis++)
+		testCheckInteger("linear.reloaded.offset", offsets[axis], saved[axis]);
+
+	//quadratic drift, calibrated over the linear one (same entries overwritten)
+	calibrate(quadraticDrifts);
+	testCheckInteger("quadratic.calibrated", compensationGetNbCalibrated(), NB_CALIBRATIONS);
+	checkSweep("quadratic", quadraticDrifts, MAX_QUADRATIC_ERROR);
+
+	return (testResult());
+}
+
+/**
+ * @brief Compute the true offset of an axis at a temperature
+ *
+ * @param drift Drift law of the axis
+ * @param temperature_dC Temperature (in tenths of degrees)
+ * @return Offset (in LSB)
+ */
+static double trueOffset(const drift_t* drift, int16_t temperature_dC){
+	double temperature = temperature_dC / 10.0;
+
+	return (drift->base + (drift->slope * temperature) + (drift->curvature * temperature * temperature));
+}
+
+/**
+ * @brief Replay the calibration procedure at each calibration temperature, the device lying flat
+ *
+ * @param drifts Drift law of each axis
+ */
+static void calibrate(const drift_t drifts[COMPENSATION_NB_AXIS]){
+	const int16_t flat[COMPENSATION_NB_AXIS] = {0, 0, ONE_G_LSB};
+	int16_t offsets[COMPENSATION_NB_AXIS];
+	int16_t measured[COMPENSATION_NB_AXIS];
+
+	for(uint8_t c = 0 ; c < NB_CALIBRATIONS ; c++){
+		compensationUpdate(calibrationTemperatures_dC[c], offsets);
+
+		//averaged flat measurement, with the offsets currently applied subtracted (alternating noise sign)
+		for(uint8_t axis = 0 ; axis < COMPENSATION_NB_AXIS ; axis++){
+			double noise = ((c + axis) & 1U) ? NOISE_LSB : -NOISE_LSB;
+			measured[axis] = (int16_t)lround(flat[axis] + trueOffset(&drifts[axis], calibrationTemperatures_dC[c]) + noise) - offsets[axis];
+		}
+
+		testCheckInteger("calibration.success", IS_SUCCESS(compensationCalibrate(measured, flat)), 1);
+	}
+}
+
+/**
+ * @brief Sweep the temperature and compare the offsets applied to the true drift
+ *
+ * @param law Name of the drift law
+ * @param drifts Drift law of each axis
+ * @param maxError Highest error accepted inside the calibrated range (in LSB)
+ */
+static void checkSweep(const char* law, const drift_t drifts[COMPENSATION_NB_AXIS], double maxError){
+	const int16_t first_dC = calibrationTemperatures_dC[0];
+	const int16_t last_dC = calibrationTemperatures_dC[NB_CALIBRATIONS - 1];
+	int16_t offsets[COMPENSATION_NB_AXIS];
+	int16_t bound[COMPENSATION_NB_AXIS];
+	double error, maxInside = 0.0;
+	uint32_t clampMismatches = 0;
+	char name[64];
+
+	for(int16_t temperature_dC = SWEEP_FIRST_DC ; temperature_dC <= SWEEP_LAST_DC ; temperature_dC += SWEEP_STEP_DC){
+		compensationUpdate(temperature_dC, offsets);
+
+		//inside the calibrated range, compare to the true drift
+		if((temperature_dC >= first_dC) && (temperature_dC <= last_dC)){
+			for(uint8_t axis = 0 ; axis < COMPENSATION_NB_AXIS ; axis++){
+				error = fabs(offsets[axis] - trueOffset(&drifts[axis], temperature_dC));
+				maxInside = fmax(maxInside, error);
+			}
+			continue;
+		}
+
+		//outside of it, the closest calibrated entry applies as-is
+		compensationUpdate((temperature_dC < first_dC) ? first_dC : last_dC, bound);
+		clampMismatches += (uint32_t)(memcmp(offsets, bound, sizeof(offsets)) != 0);
+	}
+
+	snprintf(name, sizeof(name), "%s.error_lsb.max", law);
+	testCheck(name, maxInside, 0.0, maxError);
+	snprintf(name, sizeof(name), "%s.out_of_range.mismatches", law);
+	testCheckInteger(name, clampMismatches, 0);
+}
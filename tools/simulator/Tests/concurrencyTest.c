@@ -0,0 +1,280 @@
+/**
+ * @file concurrencyTest.c
+ * @brief Stress the concurrency primitives from several host threads
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * On the device, the primitives share data between interrupts and the main loop.
+ * Here, POSIX threads play those roles, preempted at any instruction by the host scheduler
+ * (and running truly in parallel on multi-core hosts), with the host atomic builtins :
+ * - event flags : several producers each raise their own flag again once the consumer cleared it,
+ *   the consumer counts the flags it tested and cleared. A lost set or a lost clear shows up in the counts.
+ * - sequence lock : a writer keeps updating a snapshot whose fields are derived from a counter,
+ *   several readers copy it and check the fields match. Any torn snapshot accepted is counted.
+ * - SPSC ring : a producer pushes a sequence of values through a small ring (full and wrapping often),
+ *   the consumer checks it pops them all, in order.
+ */
+#include "hostTest.h"
+#include "concurrency.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <math.h>
+
+//definitions
+#define NB_PRODUCERS		4U			///< Number of threads raising event flags
+#define NB_EVENTS			20000U		///< Number of events raised by each producer
+#define NB_READERS			3U			///< Number of threads reading the snapshot
+#define NB_WRITES			200000U		///< Number of snapshot updates
+#define SNAPSHOT_WORDS		4U			///< Number of words in the snapshot
+#define RING_CAPACITY		8U			///< Capacity of the SPSC ring (small to make it full and wrap often)
+#define NB_VALUES			500000U		///< Number of values pushed through the ring
+
+/**
+ * @brief Structure holding the snapshot protected by the sequence lock
+ */
+typedef struct{
+	volatile uint32_t	words[SNAPSHOT_WORDS];	///< Fields, all derived from the same counter
+}snapshot_t;
+
+/**
+ * @brief Structure holding the results of a snapshot reader
+ */
+typedef struct{
+	uint32_t	nbReads;	///< Number of consistent snapshots read
+	uint32_t	nbRetries;	///< Number of snapshots read again because written in the meantime
+	uint32_t	nbTorn;		///< Number of snapshots accepted with mismatching fields
+	uint32_t	nbBackward;	///< Number of snapshots older than the previous one read
+}readerResults_t;
+
+//tool functions
+static void* eventProducer(void* context);
+static void* snapshotWriter(void* context);
+static void* snapshotReader(void* context);
+static void* ringProducer(void* context);
+static void checkEvents();
+static void checkSeqlock();
+static void checkRing();
+
+//state variables
+static eventFlags_t		_events = 0;			///< Event flags raised by the producers
+static volatile uint8_t	_stopEvents = 0;		///< 1 once the consumer gave up waiting for the events
+static seqlock_t		_lock = {0};			///< Sequence lock protecting the snapshot
+static snapshot_t		_snapshot;				///< Snapshot updated by the writer
+static volatile uint8_t	_writing = 0;			///< 1 while the writer is updating the snapshot
+static spscRing_t		_ring;					///< Ring between the producer and the consumer
+static uint32_t			_ringBuffer[RING_CAPACITY];	///< Storage of the ring
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+int main(){
+	uint32_t buffer[RING_CAPACITY - 1U];
+	spscRing_t ring;
+
+	testCheckInteger("spsc.init.not_power_of_two", IS_ERROR(spscInitialise(&ring, buffer, RING_CAPACITY - 1U)), 1);
+
+	checkEvents();
+	checkSeqlock();
+	checkRing();
+
+	return (testResult());
+}
+
+/**
+ * @brief Raise the flag of a producer again each time the consumer cleared it
+ *
+ * @param context Flag of the producer
+ * @return NULL
+ */
+static void* eventProducer(void* context){
+	const uint32_t flag = (uint32_t)(uintptr_t)context;
+
+	for(uint32_t event = 0 ; event < NB_EVENTS ; event++){
+		while((_events & flag) && !_stopEvents)
+			sched_yield();
+		eventSet(&_events, flag);
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Run the event producers, and count the flags tested and cleared until they all ended
+ */
+static void checkEvents(){
+	pthread_t producers[NB_PRODUCERS];
+	uint32_t counts[NB_PRODUCERS] = {0};
+	uint32_t flags, total = 0;
+	uint8_t running = 1;
+	char name[64];
+
+	for(uint32_t p = 0 ; p < NB_PRODUCERS ; p++)
+		pthread_create(&producers[p], NULL, eventProducer, (void*)(uintptr_t)(1U << p));
+
+	//count until all the events have been consumed (a lost one blocks its producer, hence the iterations limit)
+	for(uint32_t iteration = 0 ; running && (iteration < (NB_PRODUCERS * NB_EVENTS * 100U)) ; iteration++){
+		flags = eventTestAndClear(&_events, (1U << NB_PRODUCERS) - 1U);
+		for(uint32_t p = 0 ; p < NB_PRODUCERS ; p++)
+			counts[p] += ((flags >> p) & 1U);
+
+		total = 0;
+		for(uint32_t p = 0 ; p < NB_PRODUCERS ; p++)
+			total += counts[p];
+		running = (total < (NB_PRODUCERS * NB_EVENTS));
+		if(!flags)
+			sched_yield();
+	}
+
+	//release any producer still waiting, then join them
+	_stopEvents = 1;
+	for(uint32_t p = 0 ; p < NB_PRODUCERS ; p++)
+		pthread_join(producers[p], NULL);
+
+	for(uint32_t p = 0 ; p < NB_PRODUCERS ; p++){
+		snprintf(name, sizeof(name), "events.producer_%u.consumed", p);
+		testCheckInteger(name, counts[p], NB_EVENTS);
+	}
+}
+
+/**
+ * @brief Update the snapshot NB_WRITES times
+ *
+ * @param context Unused
+ * @return NULL
+ */
+static void* snapshotWriter(void* context){
+	(void)context;
+
+	for(uint32_t counter = 1 ; counter <= NB_WRITES ; counter++){
+		seqlockWriteBegin(&_lock);
+		for(uint8_t word = 0 ; word < SNAPSHOT_WORDS ; word++){
+			_snapshot.words[word] = counter * (word + 1U);
+
+			//let the readers run in the middle of the update from time to time
+			if(!(counter & 0xFFU) && (word == 1U))		// @suppress("Avoid magic numbers")
+				sched_yield();
+		}
+		seqlockWriteEnd(&_lock);
+	}
+
+	_writing = 0;
+	return (NULL);
+}
+
+/**
+ * @brief Read the snapshot until the writer ended, and check the consistency of each copy accepted
+ *
+ * @param context Reader results
+ * @return NULL
+ */
+static void* snapshotReader(void* context){
+	readerResults_t* results = (readerResults_t*)context;
+	uint32_t copy[SNAPSHOT_WORDS];
+	uint32_t previous = 0;
+	uint32_t start;
+
+	while(_writing){
+		//copy the snapshot, and let the writer end its update if it was written in the meantime
+		for(;;){
+			start = seqlockReadBegin(&_lock);
+			for(uint8_t word = 0 ; word < SNAPSHOT_WORDS ; word++)
+				copy[word] = _snapshot.words[word];
+			if(!seqlockReadRetry(&_lock, start))
+				break;
+
+			results->nbRetries++;
+			sched_yield();
+		}
+
+		for(uint8_t word = 1 ; word < SNAPSHOT_WORDS ; word++){
+			if(copy[word] != (copy[0] * (word + 1U))){
+				results->nbTorn++;
+				break;
+			}
+		}
+		results->nbBackward += (copy[0] < previous);
+		previous = copy[0];
+		results->nbReads++;
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Run the snapshot writer against several readers
+ */
+static void checkSeqlock(){
+	pthread_t writer, readers[NB_READERS];
+	readerResults_t results[NB_READERS] = {0};
+	uint32_t nbReads = 0, nbRetries = 0, nbTorn = 0, nbBackward = 0;
+
+	_writing = 1;
+	for(uint32_t r = 0 ; r < NB_READERS ; r++)
+		pthread_create(&readers[r], NULL, snapshotReader, &results[r]);
+	pthread_create(&writer, NULL, snapshotWriter, NULL);
+
+	pthread_join(writer, NULL);
+	for(uint32_t r = 0 ; r < NB_READERS ; r++){
+		pthread_join(readers[r], NULL);
+		nbReads += results[r].nbReads;
+		nbRetries += results[r].nbRetries;
+		nbTorn += results[r].nbTorn;
+		nbBackward += results[r].nbBackward;
+	}
+
+	testCheck("seqlock.reads", nbReads, 1.0, INFINITY);
+	testCheck("seqlock.retries", nbRetries, 1.0, INFINITY);
+	testCheckInteger("seqlock.torn", nbTorn, 0);
+	testCheckInteger("seqlock.backward", nbBackward, 0);
+	testCheckInteger("seqlock.sequence", _lock.sequence, 2U * NB_WRITES);
+}
+
+/**
+ * @brief Push the values 0 to NB_VALUES - 1 in the ring, waiting while it is full
+ *
+ * @param context Number of times the ring was found full
+ * @return NULL
+ */
+static void* ringProducer(void* context){
+	uint32_t* nbFull = (uint32_t*)context;
+
+	for(uint32_t value = 0 ; value < NB_VALUES ; value++){
+		while(!spscPush(&_ring, value)){
+			(*nbFull)++;
+			sched_yield();
+		}
+	}
+
+	return (NULL);
+}
+
+/**
+ * @brief Run the ring producer, and check the values popped come in order, none missing
+ */
+static void checkRing(){
+	pthread_t producer;
+	uint32_t nbFull = 0, nbPopped = 0, nbOutOfOrder = 0;
+	uint32_t value;
+
+	testCheckInteger("spsc.init.success", IS_SUCCESS(spscInitialise(&_ring, _ringBuffer, RING_CAPACITY)), 1);
+	pthread_create(&producer, NULL, ringProducer, &nbFull);
+
+	while(nbPopped < NB_VALUES){
+		if(!spscPop(&_ring, &value)){
+			sched_yield();
+			continue;
+		}
+		nbOutOfOrder += (value != nbPopped);
+		nbPopped++;
+	}
+	pthread_join(producer, NULL);
+
+	testCheckInteger("spsc.popped", nbPopped, NB_VALUES);
+	testCheckInteger("spsc.out_of_order", nbOutOfOrder, 0);
+	testCheckInteger("spsc.left", spscPop(&_ring, &value), 0);
+	testCheck("spsc.full", nbFull, 1.0, INFINITY);
+}
@@ -0,0 +1,160 @@
+/**
+ * @file goertzelTest.c
+ * @brief Compare the Goertzel filters bank to a floating-point reference
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Tones on gravity (as the Z axis sees them) are fed to the bank block by block, at the level and spectrum mode rates,
+ * with the fast and precise averaging depths. After each block, the amplitudes published are compared to a
+ * double precision DFT of the same window, gravity excluded :
+ * - a result must be published at each block once the window is complete
+ * - the amplitude of the target frequency must match the reference
+ * - the amplitude of a filter away from the tone (its leakage) must match the reference too
+ * - gravity alone must give 0 on all the filters
+ *
+ * The host cycles spent per sample (all filters) are printed for information (time stamp counter, x86 only).
+ */
+#include "hostTest.h"
+#include "goertzel.h"
+#include <math.h>
+#include <stdio.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define READ_CYCLES()	__rdtsc()
+#else
+#define READ_CYCLES()	0ULL
+#endif
+
+//definitions
+#define GRAVITY_LSB			256.0		///< Gravity seen on Z (in LSB)
+#define NB_BLOCKS			60U			///< Number of blocks fed per case
+#define MAX_SAMPLES			(NB_BLOCKS * 32U)	///< Highest number of samples fed per case
+#define MAX_ERROR_LSB		1.5			///< Highest amplitude error accepted against the reference (in LSB)
+#define MAX_ERROR_RATIO		0.02		///< Highest relative amplitude error accepted against the reference
+#define NB_CASES			5U			///< Number of cases run
+
+/**
+ * @brief Structure describing a case fed to the bank
+ */
+typedef struct{
+	const char*	name;				///< Name of the case
+	uint32_t	samplePeriod_ns;	///< Sample period (in ns)
+	uint8_t		blockSize;			///< Number of samples per block
+	double		frequency_Hz;		///< Frequency of the tone (in Hz)
+	double		amplitude;			///< Peak amplitude of the tone (in LSB), 0 for gravity only
+	uint16_t	target_dHz;			///< Frequency of the filter on the tone (in dHz)
+	uint16_t	away_dHz;			///< Frequency of the filter away from the tone (in dHz)
+}goertzelCase_t;
+
+//tool functions
+static void runCase(const goertzelCase_t* test);
+static double referenceAmplitude(const int16_t samples[], uint32_t end, uint32_t length, uint16_t frequency_dHz, double sampleRate_Hz);
+
+/**
+ * @brief Cases fed to the bank
+ */
+static const goertzelCase_t cases[NB_CASES] = {
+	{"level_fast",		5000000U,	10U,	25.0,	 40.0,	 250U,	 500U},
+	{"level_precise",	5000000U,	32U,	49.7,	100.0,	 497U,	 250U},
+	{"level_gravity",	5000000U,	10U,	 0.0,	  0.0,	 250U,	 500U},
+	{"spectrum_fast",	312500U,	10U,	500.0,	300.0,	5000U,	2500U},
+	{"spectrum_precise",312500U,	32U,	 87.3,	  8.0,	 873U,	1200U},
+};
+
+//state variables
+static uint64_t	_cycles = 0;		///< Host cycles spent in the bank
+static uint64_t	_nbSamples = 0;		///< Number of samples fed to the bank
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+int main(){
+	for(uint8_t i = 0 ; i < NB_CASES ; i++)
+		runCase(&cases[i]);
+
+	if(_nbSamples)
+		printf("goertzel.host_cycles_per_sample = %.1f\n", (double)_cycles / (double)_nbSamples);
+
+	return (testResult());
+}
+
+/**
+ * @brief Feed a case to the bank, and compare the results published after each block to the reference
+ *
+ * @param test Case to feed
+ */
+static void runCase(const goertzelCase_t* test){
+	const double sampleRate_Hz = 1e9 / test->samplePeriod_ns;
+	int16_t samples[MAX_SAMPLES];
+	uint32_t nbSamples = 0;
+	uint32_t published = 0, expected = 0;
+	double reference, error, maxError = 0.0, maxAwayError = 0.0;
+	uint64_t start;
+	char name[96];
+
+	goertzelSetFrequency(0, test->target_dHz);
+	goertzelSetFrequency(1, test->away_dHz);
+	goertzelSetFrequency(2, 0);
+	goertzelSetFrequency(3, 0);
+
+	for(uint32_t block = 0 ; block < NB_BLOCKS ; block++){
+		for(uint8_t i = 0 ; i < test->blockSize ; i++, nbSamples++)
+			samples[nbSamples] = (int16_t)lround(GRAVITY_LSB + (test->amplitude * sin(2.0 * M_PI * test->frequency_Hz * nbSamples / sampleRate_Hz)));
+
+		start = READ_CYCLES();
+		goertzelAddSamples(&samples[nbSamples - test->blockSize], test->blockSize, test->samplePeriod_ns);
+		_cycles += READ_CYCLES() - start;
+		_nbSamples += test->blockSize;
+
+		//the window spans all the complete segments, plus the one in progress
+		if(nbSamples < GOERTZEL_LENGTH)
+			continue;
+		expected++;
+		if(!goertzelHasNewResults())
+			continue;
+		published++;
+
+		reference = referenceAmplitude(samples, nbSamples, GOERTZEL_LENGTH + (nbSamples % GOERTZEL_SEGMENT), test->target_dHz, sampleRate_Hz);
+		error = fabs(goertzelGetAmplitude(0) - reference);
+		maxError = fmax(maxError, error);
+
+		reference = referenceAmplitude(samples, nbSamples, GOERTZEL_LENGTH + (nbSamples % GOERTZEL_SEGMENT), test->away_dHz, sampleRate_Hz);
+		error = fabs(goertzelGetAmplitude(1) - reference);
+		maxAwayError = fmax(maxAwayError, error);
+	}
+
+	snprintf(name, sizeof(name), "goertzel.%s.results_published", test->name);
+	testCheckInteger(name, published, expected);
+	snprintf(name, sizeof(name), "goertzel.%s.amplitude", test->name);
+	testCheck(name, goertzelGetAmplitude(0), test->amplitude - MAX_ERROR_LSB - (MAX_ERROR_RATIO * test->amplitude) - 1.0,
+											 test->amplitude + MAX_ERROR_LSB + (MAX_ERROR_RATIO * test->amplitude) + 1.0);
+	snprintf(name, sizeof(name), "goertzel.%s.error_lsb.max", test->name);
+	testCheck(name, maxError, 0.0, MAX_ERROR_LSB + (MAX_ERROR_RATIO * test->amplitude));
+	snprintf(name, sizeof(name), "goertzel.%s.away.error_lsb.max", test->name);
+	testCheck(name, maxAwayError, 0.0, MAX_ERROR_LSB + (MAX_ERROR_RATIO * test->amplitude));
+}
+
+/**
+ * @brief Compute the amplitude of a frequency over a window with a double precision DFT, gravity excluded
+ *
+ * @param samples Samples fed to the bank
+ * @param end Number of samples fed (the window ends with the last one)
+ * @param length Number of samples in the window
+ * @param frequency_dHz Frequency of which compute the amplitude (in dHz)
+ * @param sampleRate_Hz Sample rate (in Hz)
+ * @return Peak amplitude (in LSB)
+ */
+static double referenceAmplitude(const int16_t samples[], uint32_t end, uint32_t length, uint16_t frequency_dHz, double sampleRate_Hz){
+	const double frequency_Hz = frequency_dHz / 10.0;
+	double real = 0.0, imaginary = 0.0;
+
+	for(uint32_t n = end - length ; n < end ; n++){
+		real += (samples[n] - GRAVITY_LSB) * cos(2.0 * M_PI * frequency_Hz * n / sampleRate_Hz);
+		imaginary -= (samples[n] - GRAVITY_LSB) * sin(2.0 * M_PI * frequency_Hz * n / sampleRate_Hz);
+	}
+
+	return ((2.0 * sqrt((real * real) + (imaginary * imaginary))) / length);
+}
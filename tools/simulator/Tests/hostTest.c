@@ -0,0 +1,67 @@
+/**
+ * @file hostTest.c
+ * @brief Implement the checks shared by the host tests
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Each check prints a "name = value" line (as the simulator summary does), followed by FAILED if out of its bounds,
+ * so a test prints all its figures even when one of them fails. The test exit code is then given by testResult().
+ */
+#include "hostTest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+
+//state variables
+static uint32_t	_nbChecks = 0;		///< Number of checks run
+static uint32_t	_nbFailures = 0;	///< Number of checks out of their bounds
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+/**
+ * @brief Check a measured figure is within its bounds
+ *
+ * @param name Name of the figure
+ * @param value Value measured
+ * @param min Lowest value accepted
+ * @param max Highest value accepted
+ */
+void testCheck(const char* name, double value, double min, double max){
+	const uint8_t failed = ((value < min) || (value > max));
+
+	printf("%s = %.3f%s\n", name, value, (failed ? "\tFAILED" : ""));
+	_nbChecks++;
+	_nbFailures += failed;
+}
+
+/**
+ * @brief Check an integer value is the one expected
+ *
+ * @param name Name of the value
+ * @param value Value obtained
+ * @param expected Value expected
+ */
+void testCheckInteger(const char* name, int64_t value, int64_t expected){
+	const uint8_t failed = (value != expected);
+
+	if(failed)
+		printf("%s = %" PRId64 "\tFAILED (expected %" PRId64 ")\n", name, value, expected);
+	else
+		printf("%s = %" PRId64 "\n", name, value);
+	_nbChecks++;
+	_nbFailures += failed;
+}
+
+/**
+ * @brief Print the number of checks failed, and get the test exit code
+ *
+ * @return EXIT_SUCCESS if all checks passed, EXIT_FAILURE otherwise
+ */
+int testResult(){
+	printf("checks = %" PRIu32 "\nfailures = %" PRIu32 "\n", _nbChecks, _nbFailures);
+	return ((_nbFailures || !_nbChecks) ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,9 @@
+#ifndef SIMULATOR_TESTS_HOSTTEST_H_
+#define SIMULATOR_TESTS_HOSTTEST_H_
+#include <stdint.h>
+
+void	testCheck(const char* name, double value, double min, double max);
+void	testCheckInteger(const char* name, int64_t value, int64_t expected);
+int		testResult();
+
+#endif /* SIMULATOR_TESTS_HOSTTEST_H_ */
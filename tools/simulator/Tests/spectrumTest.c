@@ -0,0 +1,176 @@
+/**
+ * @file spectrumTest.c
+ * @brief Compare the Q15 FFT and the spectrum peak detection to a floating-point reference
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * - the Q15 transform (with and without the Hann window) is compared bin by bin to a double precision DFT
+ *   of the same input, scaled down by FFT_SIZE as the Q15 one : the error energy gives the transform SNR
+ * - known tones (on gravity, as the Z axis sees them) are fed to the spectrum window block by block,
+ *   and the dominant component found is compared to the tone : frequency error (interpolated between bins)
+ *   and amplitude error (Hann scalloping loss included, the peak amplitude not being interpolated)
+ */
+#include "hostTest.h"
+#include "spectrum.h"
+#include "fft.h"
+#include <math.h>
+#include <stdio.h>
+
+//definitions
+#define SAMPLE_RATE_HZ		3200.0		///< Output data rate used in spectrum mode (in Hz)
+#define SAMPLE_PERIOD_NS	312500U		///< Sample period at the spectrum mode output data rate (in ns)
+#define BLOCK_SIZE			32U			///< Number of samples per FIFO block
+#define GRAVITY_LSB			256.0		///< Gravity seen on Z (in LSB)
+#define Q15_HALF			16384.0		///< 0.5 in Q15
+#define MIN_TONE_SNR_DB		50.0		///< Lowest transform SNR accepted on a tone at half the Q15 range (in dB)
+#define MIN_MIX_SNR_DB		42.0		///< Lowest transform SNR accepted on the tones mix (in dB, each tone 17 dB lower)
+#define HANN_SNR_LOSS_DB	4.0			///< SNR lost to the window (half the signal energy, and its own rounding)
+#define MAX_FREQUENCY_ERROR	2.0			///< Highest peak frequency error accepted (in Hz, 1/6th of a bin)
+#define MAX_AMPLITUDE_ERROR	0.18		///< Highest peak relative amplitude error accepted (Hann scalloping loss of 15 %, plus rounding)
+#define NB_TONES			7U			///< Number of tones checked
+
+/**
+ * @brief Structure describing a tone fed to the spectrum
+ */
+typedef struct{
+	double	frequency_Hz;	///< Frequency of the tone (in Hz)
+	double	amplitude;		///< Peak amplitude of the tone (in LSB)
+}tone_t;
+
+//tool functions
+static double transformSNR(const double input[FFT_SIZE], uint8_t windowed);
+static void checkTone(const tone_t* tone, double* frequencyError, double* amplitudeError);
+
+/**
+ * @brief Tones fed to the spectrum, on and between bins (12.5 Hz apart), from a few to a thousand mg
+ */
+static const tone_t tones[NB_TONES] = {
+	{  40.0,	 50.0},
+	{  87.5,	400.0},
+	{ 153.1,	100.0},
+	{ 333.3,	 20.0},
+	{ 512.5,	800.0},
+	{1000.0,	250.0},
+	{1418.75,	 60.0},
+};
+
+
+/********************************************************************************************************************************************/
+/********************************************************************************************************************************************/
+
+
+int main(){
+	double input[FFT_SIZE];
+	double snr, worstSNR = INFINITY, worstWindowedSNR = INFINITY;
+	double frequencyError, amplitudeError;
+	double maxFrequencyError = 0.0, maxAmplitudeError = 0.0;
+	char name[64];
+
+	//transform SNR on single tones, at half the Q15 range
+	for(uint8_t t = 0 ; t < NB_TONES ; t++){
+		for(uint16_t i = 0 ; i < FFT_SIZE ; i++)
+			input[i] = Q15_HALF * sin(2.0 * M_PI * tones[t].frequency_Hz * i / SAMPLE_RATE_HZ);
+
+		snr = transformSNR(input, 0);
+		worstSNR = fmin(worstSNR, snr);
+		snr = transformSNR(input, 1);
+		worstWindowedSNR = fmin(worstWindowedSNR, snr);
+	}
+	testCheck("fft.tone.snr_db.min", worstSNR, MIN_TONE_SNR_DB, INFINITY);
+	testCheck("fft.tone.hann.snr_db.min", worstWindowedSNR, MIN_TONE_SNR_DB - HANN_SNR_LOSS_DB, INFINITY);
+
+	//transform SNR on all the tones mixed, sharing half the Q15 range
+	for(uint16_t i = 0 ; i < FFT_SIZE ; i++){
+		input[i] = 0.0;
+		for(uint8_t t = 0 ; t < NB_TONES ; t++)
+			input[i] += (Q15_HALF / NB_TONES) * sin(2.0 * M_PI * tones[t].frequency_Hz * i / SAMPLE_RATE_HZ);
+	}
+	testCheck("fft.mix.snr_db", transformSNR(input, 0), MIN_MIX_SNR_DB, INFINITY);
+	testCheck("fft.mix.hann.snr_db", transformSNR(input, 1), MIN_MIX_SNR_DB - HANN_SNR_LOSS_DB, INFINITY);
+
+	//dominant component of each tone
+	for(uint8_t t = 0 ; t < NB_TONES ; t++){
+		checkTone(&tones[t], &frequencyError, &amplitudeError);
+		snprintf(name, sizeof(name), "spectrum.tone_%.2f_hz.frequency_error_hz", tones[t].frequency_Hz);
+		testCheck(name, frequencyError, -MAX_FREQUENCY_ERROR, MAX_FREQUENCY_ERROR);
+		snprintf(name, sizeof(name), "spectrum.tone_%.2f_hz.amplitude_error", tones[t].frequency_Hz);
+		testCheck(name, amplitudeError, -MAX_AMPLITUDE_ERROR, MAX_AMPLITUDE_ERROR);
+
+		maxFrequencyError = fmax(maxFrequencyError, fabs(frequencyError));
+		maxAmplitudeError = fmax(maxAmplitudeError, fabs(amplitudeError));
+	}
+	printf("spectrum.frequency_error_hz.max = %.3f\n", maxFrequencyError);
+	printf("spectrum.amplitude_error.max = %.3f\n", maxAmplitudeError);
+
+	return (testResult());
+}
+
+/**
+ * @brief Compute the SNR of the Q15 transform of a signal against a double precision DFT
+ *
+ * @param input Signal to transform (in Q15 units)
+ * @param windowed 1 to apply the Hann window first
+ * @return SNR (in dB)
+ */
+static double transformSNR(const double input[FFT_SIZE], uint8_t windowed){
+	int16_t buffer[FFT_SIZE << 1];
+	double samples[FFT_SIZE];
+	double signal = 0.0, noise = 0.0;
+	double real, imaginary;
+
+	//quantise the signal, and apply the same window on the reference
+	for(uint16_t i = 0 ; i < FFT_SIZE ; i++){
+		buffer[i << 1] = (int16_t)lround(input[i]);
+		buffer[(i << 1) + 1] = 0;
+		samples[i] = buffer[i << 1];
+		if(windowed)
+			samples[i] *= 0.5 * (1.0 - cos(2.0 * M_PI * i / FFT_SIZE));
+	}
+
+	if(windowed)
+		fftQ15ApplyHann(buffer);
+	fftQ15Transform(buffer);
+
+	//compare each bin to the DFT scaled down by FFT_SIZE
+	for(uint16_t bin = 0 ; bin < FFT_SIZE ; bin++){
+		real = 0.0;
+		imaginary = 0.0;
+		for(uint16_t i = 0 ; i < FFT_SIZE ; i++){
+			real += samples[i] * cos(2.0 * M_PI * bin * i / FFT_SIZE);
+			imaginary -= samples[i] * sin(2.0 * M_PI * bin * i / FFT_SIZE);
+		}
+		real /= FFT_SIZE;
+		imaginary /= FFT_SIZE;
+
+		signal += (real * real) + (imaginary * imaginary);
+		noise += pow(buffer[bin << 1] - real, 2.0) + pow(buffer[(bin << 1) + 1] - imaginary, 2.0);
+	}
+
+	return (10.0 * log10(signal / noise));
+}
+
+/**
+ * @brief Feed a tone on gravity to the spectrum block by block, and measure the errors of the dominant component found
+ *
+ * @param tone Tone fed
+ * @param[out] frequencyError Frequency found minus the tone one (in Hz)
+ * @param[out] amplitudeError Amplitude found relative to the tone one, minus one
+ */
+static void checkTone(const tone_t* tone, double* frequencyError, double* amplitudeError){
+	int16_t block[BLOCK_SIZE];
+	spectrumPeak_t peak = {0};
+	uint32_t sample = 0;
+	uint8_t full = 0;
+
+	spectrumReset();
+	while(!full){
+		for(uint8_t i = 0 ; i < BLOCK_SIZE ; i++, sample++)
+			block[i] = (int16_t)lround(GRAVITY_LSB + (tone->amplitude * sin(2.0 * M_PI * tone->frequency_Hz * sample / SAMPLE_RATE_HZ)));
+		full = spectrumAddSamples(block, BLOCK_SIZE);
+	}
+	spectrumCompute(SAMPLE_PERIOD_NS, &peak);
+
+	*frequencyError = peak.frequency_Hz - tone->frequency_Hz;
+	*amplitudeError = (peak.amplitude / tone->amplitude) - 1.0;
+}
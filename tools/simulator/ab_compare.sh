@@ -0,0 +1,46 @@
+#!/bin/sh
+#############################################################################################################################
+# file:  ab_compare.sh
+# date:  17/10/2026
+# brief: Compare two simulator builds on the same capture
+#
+# The angles printed are diffed (same simulated timestamps expected if the timing did not change),
+# the last panel images are compared pixel-exactly, and the summaries are shown side by side,
+# the differing lines marked with '|'.
+#
+# usage: tools/simulator/ab_compare.sh build/simulator-a/simulator build/simulator-b/simulator capture.txt
+#
+# return: 0 if the angles printed and the last panel images are identical, 1 otherwise
+#############################################################################################################################
+set -eu
+
+if [ $# -ne 3 ]; then
+	echo "usage: $0 simulator-a simulator-b capture.txt" >&2
+	exit 2
+fi
+
+work=$(mktemp -d)
+trap 'rm -rf "$work"' EXIT
+
+"$1" -a "$work/a.csv" -s "$work/a.txt" -p "$work/a.pbm" "$3"
+"$2" -a "$work/b.csv" -s "$work/b.txt" -p "$work/b.pbm" "$3"
+
+echo "=== summaries (A | B)"
+diff --side-by-side --width=140 "$work/a.txt" "$work/b.txt" || true
+
+status=0
+echo "=== angles printed"
+if diff -u --label A --label B "$work/a.csv" "$work/b.csv"; then
+	echo "identical ($(($(wc -l < "$work/a.csv") - 1)) angles)"
+else
+	status=1
+fi
+
+echo "=== last panel image"
+if cmp -s "$work/a.pbm" "$work/b.pbm"; then
+	echo "identical"
+else
+	echo "different"
+	status=1
+fi
+exit $status
@@ -0,0 +1,92 @@
+/**
+ * @file stm32f1xx.h
+ * @brief Host stand-in of the CMSIS device header, used by the simulator
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Only the registers and intrinsics used by the firmware are declared.
+ * The peripherals are plain structures updated by the simulator,
+ * and the intrinsics touching the interrupts are implemented by the simulator core.
+ */
+#ifndef SIMULATOR_HAL_STM32F1XX_H_
+#define SIMULATOR_HAL_STM32F1XX_H_
+#include <stdint.h>
+#include <stddef.h>
+
+#define __IO				volatile
+#define __STATIC_INLINE		static inline
+
+//peripherals registers
+typedef struct{ __IO uint32_t CR1, CR2, SR, DR; } SPI_TypeDef;
+typedef struct{ __IO uint32_t CRL, CRH, IDR, ODR, BSRR, BRR, LCKR; } GPIO_TypeDef;
+typedef struct{ __IO uint32_t CCR, CNDTR, CPAR, CMAR; } DMA_Channel_TypeDef;
+typedef struct{ __IO uint32_t SR, CR1, CR2, SMPR1, SMPR2, JOFR[4], HTR, LTR, SQR1, SQR2, SQR3, JSQR, JDR[4], DR; } ADC_TypeDef;
+typedef struct{ __IO uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct{ __IO uint32_t DHCSR, DCRDR, DEMCR; } CoreDebug_Type;
+typedef struct{ __IO uint32_t SCR, ICSR; } SCB_Type;
+typedef struct{ __IO uint32_t CTRL, LOAD, VAL, CALIB; } SysTick_Type;
+
+extern SPI_TypeDef			simSPI1, simSPI2;
+extern GPIO_TypeDef			simGPIOA, simGPIOB;
+extern DMA_Channel_TypeDef	simDMA1channel1, simDMA1channel5;
+extern ADC_TypeDef			simADC1;
+extern DWT_Type				simDWT;
+extern CoreDebug_Type		simCoreDebug;
+extern SCB_Type				simSCB;
+extern SysTick_Type			simSysTick;
+
+#define SPI1				(&simSPI1)
+#define SPI2				(&simSPI2)
+#define GPIOA				(&simGPIOA)
+#define GPIOB				(&simGPIOB)
+#define DMA1_Channel1		(&simDMA1channel1)
+#define DMA1_Channel5		(&simDMA1channel5)
+#define ADC1				(&simADC1)
+#define DWT					(&simDWT)
+#define CoreDebug			(&simCoreDebug)
+#define SCB					(&simSCB)
+#define SysTick				(&simSysTick)
+
+#define FLASH_BASE					0x08000000UL
+#define DWT_CTRL_CYCCNTENA_Msk		1U
+#define CoreDebug_DEMCR_TRCENA_Msk	(1U << 24)
+#define SCB_SCR_SLEEPDEEP_Msk		(1U << 2)
+#define SCB_ICSR_PENDSTSET_Msk		(1U << 26)
+#define SPI_CR1_BR					(7U << 3)
+#define SPI_CR1_SPE					(1U << 6)
+#define DMA_CCR_CIRC				(1U << 5)
+
+//registers manipulation macros
+#define UNUSED(x)								((void)(x))
+#define SET_BIT(REG, BIT)						((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)						((REG) &= ~(BIT))
+#define READ_BIT(REG, BIT)						((REG) & (BIT))
+#define MODIFY_REG(REG, CLEARMASK, SETMASK)		((REG) = (((REG) & (~(CLEARMASK))) | (SETMASK)))
+
+//interrupts intrinsics (implemented by the simulator core)
+void		__WFI(void);
+void		__disable_irq(void);
+void		__enable_irq(void);
+uint32_t	__get_PRIMASK(void);
+void		__set_PRIMASK(uint32_t priMask);
+uint32_t	__get_IPSR(void);
+
+//other intrinsics
+static inline void __DMB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __DSB(void){ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __ISB(void){}
+static inline void __NOP(void){}
+static inline uint8_t __CLZ(uint32_t value){ return ((uint8_t)(value ? __builtin_clz(value) : 32)); }
+static inline int32_t __SSAT(int32_t value, uint32_t bits){
+	const int32_t max = (int32_t)((1U << (bits - 1U)) - 1U);
+	return ((value > max) ? max : ((value < -max - 1) ? -max - 1 : value));
+}
+static inline uint32_t __USAT(int32_t value, uint32_t bits){
+	const int32_t max = (int32_t)((1U << bits) - 1U);
+	return ((uint32_t)((value > max) ? max : ((value < 0) ? 0 : value)));
+}
+
+#include "stm32f1xx_hal.h"
+
+#endif /* SIMULATOR_HAL_STM32F1XX_H_ */
@@ -0,0 +1,231 @@
+/**
+ * @file stm32f1xx_hal.h
+ * @brief Host stand-in of the STM32F1 HAL, used by the simulator
+ * @author Gilles Henrard
+ * @date 17/10/2026
+ *
+ * @details
+ * Only the types, constants and functions used by the firmware are declared.
+ * The functions are implemented in halStandin.c, on top of the simulator core.
+ */
+#ifndef SIMULATOR_HAL_STM32F1XX_HAL_H_
+#define SIMULATOR_HAL_STM32F1XX_HAL_H_
+#include "stm32f1xx.h"
+
+//generic types
+typedef enum{ HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef enum{ HAL_UNLOCKED = 0, HAL_LOCKED } HAL_LockTypeDef;
+typedef int32_t IRQn_Type;
+
+#define HAL_MAX_DELAY		0xFFFFFFFFU
+#define ENABLE				1U
+#define DISABLE				0U
+
+//interrupts numbers
+#define EXTI0_IRQn			6
+#define DMA1_Channel1_IRQn	11
+#define DMA1_Channel5_IRQn	15
+
+//clocks
+typedef struct{ uint32_t PLLState, PLLSource, PLLMUL; } RCC_PLLInitTypeDef;
+typedef struct{ uint32_t OscillatorType, HSEState, HSEPredivValue, HSIState; RCC_PLLInitTypeDef PLL; } RCC_OscInitTypeDef;
+typedef struct{ uint32_t ClockType, SYSCLKSource, AHBCLKDivider, APB1CLKDivider, APB2CLKDivider; } RCC_ClkInitTypeDef;
+typedef struct{ uint32_t PeriphClockSelection, RTCClockSelection, AdcClockSelection, UsbClockSelection; } RCC_PeriphCLKInitTypeDef;
+
+#define RCC_OSCILLATORTYPE_HSE		0x01U
+#define RCC_HSE_ON					0x01U
+#define RCC_HSE_PREDIV_DIV1			0x00U
+#define RCC_HSI_ON					0x01U
+#define RCC_PLL_ON					0x02U
+#define RCC_PLLSOURCE_HSE			0x01U
+#define RCC_PLL_MUL9				0x07U
+#define RCC_CLOCKTYPE_SYSCLK		0x01U
+#define RCC_CLOCKTYPE_HCLK			0x02U
+#define RCC_CLOCKTYPE_PCLK1			0x04U
+#define RCC_CLOCKTYPE_PCLK2			0x08U
+#define RCC_SYSCLKSOURCE_PLLCLK		0x02U
+#define RCC_SYSCLK_DIV1				0x00U
+#define RCC_HCLK_DIV1				0x00U
+#define RCC_HCLK_DIV2				0x04U
+#define RCC_PERIPHCLK_ADC			0x02U
+#define RCC_ADCPCLK2_DIV6			0x8000U
+#define FLASH_LATENCY_2				0x02U
+
+#define __HAL_RCC_AFIO_CLK_ENABLE()		do{}while(0)
+#define __HAL_RCC_PWR_CLK_ENABLE()		do{}while(0)
+#define __HAL_RCC_GPIOA_CLK_ENABLE()	do{}while(0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()	do{}while(0)
+#define __HAL_RCC_GPIOD_CLK_ENABLE()	do{}while(0)
+#define __HAL_RCC_DMA1_CLK_ENABLE()		do{}while(0)
+#define __HAL_RCC_ADC1_CLK_ENABLE()		do{}while(0)
+#define __HAL_RCC_ADC1_CLK_DISABLE()	do{}while(0)
+#define __HAL_RCC_SPI1_CLK_ENABLE()		do{}while(0)
+#define __HAL_RCC_SPI1_CLK_DISABLE()	do{}while(0)
+#define __HAL_RCC_SPI2_CLK_ENABLE()		do{}while(0)
+#define __HAL_RCC_SPI2_CLK_DISABLE()	do{}while(0)
+#define __HAL_AFIO_REMAP_SWJ_NOJTAG()	do{}while(0)
+
+//GPIO
+typedef enum{ GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+typedef struct{ uint32_t Pin, Mode, Pull, Speed; } GPIO_InitTypeDef;
+
+#define GPIO_PIN_0				0x0001U
+#define GPIO_PIN_1				0x0002U
+#define GPIO_PIN_3				0x0008U
+#define GPIO_PIN_4				0x0010U
+#define GPIO_PIN_5				0x0020U
+#define GPIO_PIN_6				0x0040U
+#define GPIO_PIN_7				0x0080U
+#define GPIO_PIN_8				0x0100U
+#define GPIO_PIN_9				0x0200U
+#define GPIO_PIN_10				0x0400U
+#define GPIO_PIN_13				0x2000U
+#define GPIO_PIN_14				0x4000U
+#define GPIO_PIN_15				0x8000U
+#define GPIO_MODE_INPUT			0x00U
+#define GPIO_MODE_OUTPUT_PP		0x01U
+#define GPIO_MODE_AF_PP			0x02U
+#define GPIO_MODE_ANALOG		0x03U
+#define GPIO_MODE_IT_FALLING	0x10U
+#define GPIO_NOPULL				0x00U
+#define GPIO_SPEED_FREQ_LOW		0x02U
+#define GPIO_SPEED_FREQ_HIGH	0x03U
+
+//DMA
+typedef struct{ uint32_t Direction, PeriphInc, MemInc, PeriphDataAlignment, MemDataAlignment, Mode, Priority; } DMA_InitTypeDef;
+typedef struct __DMA_HandleTypeDef{
+	DMA_Channel_TypeDef*	Instance;
+	DMA_InitTypeDef			Init;
+	void*					Parent;
+}DMA_HandleTypeDef;
+
+#define DMA_PERIPH_TO_MEMORY		0x00U
+#define DMA_MEMORY_TO_PERIPH		0x10U
+#define DMA_PINC_DISABLE			0x00U
+#define DMA_MINC_ENABLE				0x80U
+#define DMA_PDATAALIGN_BYTE			0x00U
+#define DMA_PDATAALIGN_HALFWORD		0x100U
+#define DMA_MDATAALIGN_BYTE			0x00U
+#define DMA_MDATAALIGN_HALFWORD		0x400U
+#define DMA_NORMAL					0x00U
+#define DMA_CIRCULAR				0x20U
+#define DMA_PRIORITY_LOW			0x00U
+
+#define __HAL_LINKDMA(HANDLE, PPP_DMA_FIELD, DMA_HANDLE)	do{ (HANDLE)->PPP_DMA_FIELD = &(DMA_HANDLE); (DMA_HANDLE).Parent = (HANDLE); }while(0)
+
+//SPI
+typedef enum{ HAL_SPI_STATE_RESET = 0, HAL_SPI_STATE_READY, HAL_SPI_STATE_BUSY, HAL_SPI_STATE_BUSY_TX, HAL_SPI_STATE_BUSY_RX } HAL_SPI_StateTypeDef;
+typedef struct{ uint32_t Mode, Direction, DataSize, CLKPolarity, CLKPhase, NSS, BaudRatePrescaler, FirstBit, TIMode, CRCCalculation, CRCPolynomial; } SPI_InitTypeDef;
+typedef struct __SPI_HandleTypeDef{
+	SPI_TypeDef*					Instance;
+	SPI_InitTypeDef					Init;
+	DMA_HandleTypeDef*				hdmatx;
+	DMA_HandleTypeDef*				hdmarx;
+	volatile HAL_SPI_StateTypeDef	State;
+	volatile uint32_t				ErrorCode;
+}SPI_HandleTypeDef;
+
+#define SPI_MODE_MASTER				0x0104U
+#define SPI_DIRECTION_2LINES		0x00U
+#define SPI_DATASIZE_8BIT			0x00U
+#define SPI_POLARITY_LOW			0x00U
+#define SPI_POLARITY_HIGH			0x02U
+#define SPI_PHASE_1EDGE				0x00U
+#define SPI_PHASE_2EDGE				0x01U
+#define SPI_NSS_SOFT				0x0200U
+#define SPI_FIRSTBIT_MSB			0x00U
+#define SPI_TIMODE_DISABLE			0x00U
+#define SPI_CRCCALCULATION_DISABLE	0x00U
+#define SPI_BAUDRATEPRESCALER_2		(0U << 3)
+#define SPI_BAUDRATEPRESCALER_4		(1U << 3)
+#define SPI_BAUDRATEPRESCALER_8		(2U << 3)
+#define SPI_BAUDRATEPRESCALER_16	(3U << 3)
+#define SPI_BAUDRATEPRESCALER_32	(4U << 3)
+#define SPI_BAUDRATEPRESCALER_64	(5U << 3)
+#define SPI_BAUDRATEPRESCALER_128	(6U << 3)
+#define SPI_BAUDRATEPRESCALER_256	(7U << 3)
+
+//ADC
+typedef struct{ uint32_t DataAlign, ScanConvMode, ContinuousConvMode, NbrOfConversion, DiscontinuousConvMode, NbrOfDiscConversion, ExternalTrigConv; } ADC_InitTypeDef;
+typedef struct{ uint32_t Channel, Rank, SamplingTime; } ADC_ChannelConfTypeDef;
+typedef struct __ADC_HandleTypeDef{
+	ADC_TypeDef*		Instance;
+	ADC_InitTypeDef		Init;
+	DMA_HandleTypeDef*	DMA_Handle;
+	volatile uint32_t	State;
+}ADC_HandleTypeDef;
+
+#define ADC_DATAALIGN_RIGHT				0x00U
+#define ADC_SCAN_DISABLE				0x00U
+#define ADC_SCAN_ENABLE					0x100U
+#define ADC_SOFTWARE_START				0xE0000U
+#define ADC_CHANNEL_1					1U
+#define ADC_CHANNEL_TEMPSENSOR			16U
+#define ADC_CHANNEL_VREFINT				17U
+#define ADC_REGULAR_RANK_1				1U
+#define ADC_REGULAR_RANK_2				2U
+#define ADC_REGULAR_RANK_3				3U
+#define ADC_SAMPLETIME_239CYCLES_5		7U
+
+//flash
+typedef struct{ uint32_t TypeErase, Banks, PageAddress, NbPages; } FLASH_EraseInitTypeDef;
+
+#define FLASH_TYPEERASE_PAGES		0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD	0x01U
+#define FLASH_TYPEPROGRAM_WORD		0x02U
+
+//core functions
+HAL_StatusTypeDef	HAL_Init(void);
+void				HAL_MspInit(void);
+uint32_t			HAL_GetTick(void);
+void				HAL_IncTick(void);
+void				HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void				HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+
+//clocks functions
+HAL_StatusTypeDef	HAL_RCC_OscConfig(RCC_OscInitTypeDef* RCC_OscInitStruct);
+HAL_StatusTypeDef	HAL_RCC_ClockConfig(RCC_ClkInitTypeDef* RCC_ClkInitStruct, uint32_t FLatency);
+HAL_StatusTypeDef	HAL_RCCEx_PeriphCLKConfig(RCC_PeriphCLKInitTypeDef* PeriphClkInit);
+uint32_t			HAL_RCC_GetHCLKFreq(void);
+uint32_t			HAL_RCC_GetPCLK1Freq(void);
+uint32_t			HAL_RCC_GetPCLK2Freq(void);
+
+//GPIO functions
+void				HAL_GPIO_Init(GPIO_TypeDef* GPIOx, GPIO_InitTypeDef* GPIO_Init);
+void				HAL_GPIO_DeInit(GPIO_TypeDef* GPIOx, uint32_t GPIO_Pin);
+GPIO_PinState		HAL_GPIO_ReadPin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin);
+void				HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+void				HAL_GPIO_EXTI_IRQHandler(uint16_t GPIO_Pin);
+
+//DMA functions
+HAL_StatusTypeDef	HAL_DMA_Init(DMA_HandleTypeDef* hdma);
+HAL_StatusTypeDef	HAL_DMA_DeInit(DMA_HandleTypeDef* hdma);
+void				HAL_DMA_IRQHandler(DMA_HandleTypeDef* hdma);
+
+//SPI functions
+HAL_StatusTypeDef		HAL_SPI_Init(SPI_HandleTypeDef* hspi);
+void					HAL_SPI_MspInit(SPI_HandleTypeDef* hspi);
+HAL_StatusTypeDef		HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef		HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef		HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef		HAL_SPI_DMAStop(SPI_HandleTypeDef* hspi);
+HAL_SPI_StateTypeDef	HAL_SPI_GetState(SPI_HandleTypeDef* hspi);
+void					HAL_SPI_TxHalfCpltCallback(SPI_HandleTypeDef* hspi);
+void					HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi);
+
+//ADC functions
+HAL_StatusTypeDef	HAL_ADC_Init(ADC_HandleTypeDef* hadc);
+void				HAL_ADC_MspInit(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef	HAL_ADC_ConfigChannel(ADC_HandleTypeDef* hadc, ADC_ChannelConfTypeDef* sConfig);
+HAL_StatusTypeDef	HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef	HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length);
+void				HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc);
+void				HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc);
+
+//flash functions
+HAL_StatusTypeDef	HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef	HAL_FLASH_Lock(void);
+HAL_StatusTypeDef	HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+HAL_StatusTypeDef	HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef* pEraseInit, uint32_t* PageError);
+
+#endif /* SIMULATOR_HAL_STM32F1XX_HAL_H_ */
@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+"""
+Decode the latency tracer snapshot dumped from the target.
+
+usage: (gdb) dump binary value trace.bin tracerSnapshot
+       tracer_decode.py trace.bin
+"""
+import struct
+import sys
+
+MAGIC = 0x45435254
+VERSION = 1
+NB_BINS = 18
+STAGES = ["acquisition", "queueing", "compute", "transfer", "total"]
+
+
+def bin_label(index):
+    if index == 0:
+        return "0 us"
+    if index == NB_BINS - 1:
+        return f">= {1 << (index - 1)} us"
+    return f"{1 << (index - 1)}-{(1 << index) - 1} us"
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(__doc__)
+
+    with open(sys.argv[1], "rb") as dump:
+        data = dump.read()
+
+    magic, version, nb_stages, nb_traces, last_tag = struct.unpack_from("<IHHII", data, 0)
+    if magic != MAGIC or version != VERSION:
+        sys.exit("not a tracer snapshot (or unsupported version)")
+
+    print(f"{nb_traces} blocks traced end to end, {last_tag - nb_traces} never displayed")
+    offset = struct.calcsize("<IHHII")
+    for stage in range(nb_stages):
+        fields = struct.unpack_from(f"<{NB_BINS + 2}I", data, offset)
+        offset += struct.calcsize(f"<{NB_BINS + 2}I")
+        bins, max_us, total_us = fields[:NB_BINS], fields[NB_BINS], fields[NB_BINS + 1]
+        count = sum(bins)
+
+        name = STAGES[stage] if stage < len(STAGES) else f"stage {stage}"
+        mean = total_us / count if count else 0
+        print(f"\n{name}: mean {mean:.0f} us, max {max_us} us")
+        for index, value in enumerate(bins):
+            if value:
+                bar = "#" * max(1, value * 50 // count)
+                print(f"  {bin_label(index):>14} {value:8} {bar}")
+
+
+if __name__ == "__main__":
+    main()